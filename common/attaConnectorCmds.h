@@ -16,6 +16,10 @@ enum CommandCode : uint8_t {
     MOTOR_STATE_CMD = 0x02,
     IMU_STATE_CMD = 0x03,
     SVPWM_CONTROL_CMD = 0x04,
+    VIBRATION_SPECTRUM_CMD = 0x05,
+    PROFILER_STATS_CMD = 0x06,
+    SYSTEM_HEALTH_CMD = 0x07,
+    TASK_TIMING_CMD = 0x08,
 };
 
 struct MyTest0 {
@@ -50,4 +54,68 @@ struct SVPWMControl {
     float magnitude;
 };
 
+struct VibrationSpectrum {
+    static constexpr uint8_t CMD_ID = VIBRATION_SPECTRUM_CMD;
+    static constexpr uint8_t NUM_BINS = 64;
+    static constexpr uint8_t NUM_PEAKS = 4;
+    float binWidth;                             // Width of each spectrum bin (Hz)
+    float scale;                                // Amplitude of one spectrum LSB (accelerometer LSB)
+    float rotorFrequency;                       // Rotor mechanical frequency used for the peaks (Hz)
+    std::array<uint16_t, NUM_BINS> spectrum;    // Averaged vector amplitude of the accelerometer axes
+    std::array<float, NUM_PEAKS> peakFrequency; // Peak frequency at each rotor speed multiple (Hz)
+    std::array<float, NUM_PEAKS> peakAmplitude; // Peak amplitude at each rotor speed multiple (accelerometer LSB)
+};
+
+struct ProfilerStats {
+    static constexpr uint8_t CMD_ID = PROFILER_STATS_CMD;
+    static constexpr uint8_t NAME_SIZE = 16;
+    static constexpr uint8_t NUM_BUCKETS = 24; // Bucket b counts samples in [2^(b-1), 2^b) cycles, the last one also above
+    std::array<char, NAME_SIZE> name;          // Probe name (null terminated)
+    uint32_t clock;                            // Cycle counter frequency (Hz)
+    uint32_t count;                            // Measurements since the last report
+    uint32_t minCycles;                        // Shortest measurement (cycles)
+    uint32_t maxCycles;                        // Longest measurement (cycles)
+    uint32_t meanCycles;                       // Mean measurement (cycles)
+    uint32_t minPeriod;                        // Shortest period between measurement starts (cycles)
+    uint32_t maxPeriod;                        // Longest period between measurement starts (cycles)
+    uint32_t meanPeriod;                       // Mean period between measurement starts (cycles)
+    uint32_t maxJitter;                        // Largest difference between consecutive periods (cycles)
+    std::array<uint16_t, NUM_BUCKETS> cycles;  // Measurement histogram (saturated counts)
+    std::array<uint16_t, NUM_BUCKETS> jitter;  // Period jitter histogram (saturated counts)
+};
+
+struct SystemHealth {
+    static constexpr uint8_t CMD_ID = SYSTEM_HEALTH_CMD;
+    static constexpr uint8_t NAME_SIZE = 16;
+    static constexpr uint8_t MAX_TASKS = 10;
+    struct Task {
+        std::array<char, NAME_SIZE> name; // Task name (null terminated)
+        uint16_t cpu;                     // CPU usage since the last report (0.01%)
+        uint16_t stackHighWater;          // Minimum free stack since the task was created (words)
+        uint8_t priority;                 // Current priority
+        uint8_t state;                    // FreeRTOS eTaskState
+    };
+    uint32_t heapFree;                 // Free heap (bytes)
+    uint32_t heapMinFree;              // Minimum free heap since boot (bytes)
+    uint16_t cpuLoad;                  // CPU usage of all tasks but the idle task since the last report (0.01%)
+    uint8_t numTasks;                  // Valid entries of tasks
+    std::array<Task, MAX_TASKS> tasks; // Tasks sorted by CPU usage
+};
+
+struct TaskTiming {
+    static constexpr uint8_t CMD_ID = TASK_TIMING_CMD;
+    static constexpr uint8_t NAME_SIZE = 16;
+    std::array<char, NAME_SIZE> name; // Task name (null terminated)
+    uint32_t clock;                   // Cycle counter frequency (Hz)
+    uint32_t period;                  // Release period (cycles, 0 for event tasks)
+    uint32_t deadline;                // Deadline relative to the release (cycles)
+    uint32_t count;                   // Activations since the last report
+    uint32_t minPeriod;               // Shortest period between activations (cycles)
+    uint32_t maxPeriod;               // Longest period between activations (cycles)
+    uint32_t meanPeriod;              // Mean period between activations (cycles)
+    uint32_t maxJitter;               // Largest release latency, or period change for event tasks (cycles)
+    uint32_t maxExecution;            // Longest activation (cycles)
+    uint32_t misses;                  // Deadline misses since the last report
+};
+
 #endif // BLDC_ATTA_CONNECTOR_PLATFORM_H
@@ -0,0 +1,221 @@
+//--------------------------------------------------
+// BLDC Controller
+// cascadeController.cpp
+// Date: 2026-10-19
+//--------------------------------------------------
+#include "cascadeController.h"
+
+namespace {
+
+constexpr float TWO_PI = 2 * M_PI;
+constexpr float INV_SQRT3 = 0.57735026919f;
+
+// Wrap angle to [-pi, pi)
+float wrapAngle(float angle) {
+    while (angle >= M_PI)
+        angle -= TWO_PI;
+    while (angle < -M_PI)
+        angle += TWO_PI;
+    return angle;
+}
+
+float clamp(float x, float limit) { return x > limit ? limit : (x < -limit ? -limit : x); }
+
+} // namespace
+
+CascadeController::CascadeController()
+    : _dt(0.0f), _velocityAlpha(1.0f), _velocityInvDt(0.0f), _currentPerTorque(0.0f), _velocityPi{}, _currentDPi{}, _currentQPi{}, _mode(Mode::IDLE), _velocityCount(0),
+      _positionCount(0), _lastTheta(NAN), _position(0.0f), _velocity(0.0f), _velocityRef(0.0f), _currentQRef(0.0f), _feedforward(0.0f),
+      _voltageAngle(0.0f), _voltageMagnitude(0.0f) {
+    _gains.positionKp = 20.0f;
+    _gains.velocityKp = 0.05f;
+    _gains.velocityKi = 1.0f;
+    _gains.currentKp = 1.0f;
+    _gains.currentKi = 500.0f;
+    _gains.torqueConstant = 0.02f;
+    _gains.velocityCutoff = 200.0f;
+    _gains.velocityLimit = 300.0f;
+    _gains.currentLimit = 1.0f;
+    _gains.velocityDecim = 8;
+    _gains.positionDecim = 4;
+}
+
+Controller::Output CascadeController::control(State s, Control c, float dt) {
+    if (dt != _dt)
+        updateCoefficients(dt);
+
+    // Select mode from NAN pattern
+    Mode mode = Mode::IDLE;
+    if (!std::isnan(c.position))
+        mode = Mode::POSITION;
+    else if (!std::isnan(c.velocity))
+        mode = Mode::VELOCITY;
+    else if (!std::isnan(c.torque))
+        mode = Mode::TORQUE;
+    if (mode != _mode)
+        setMode(mode);
+
+    if (std::isnan(_lastTheta))
+        _position = _lastTheta = s.theta;
+
+    if (_mode == Mode::IDLE) {
+        // Estimates keep running so the next mode starts from the actual velocity
+        if (_velocityCount == 0)
+            updateEstimates(s);
+        if (++_velocityCount >= _gains.velocityDecim)
+            _velocityCount = 0;
+        _voltageMagnitude = 0.0f;
+        return spaceVectorPWM(_voltageAngle, _voltageMagnitude);
+    }
+
+    // Outer loops (decimated)
+    if (_velocityCount == 0) {
+        if (_positionCount == 0 && _mode == Mode::POSITION)
+            positionLoop(c);
+        velocityLoop(s, c);
+        if (++_positionCount >= _gains.positionDecim)
+            _positionCount = 0;
+    }
+    if (++_velocityCount >= _gains.velocityDecim)
+        _velocityCount = 0;
+
+    // Inner loop
+    currentLoop(s);
+    return spaceVectorPWM(_voltageAngle, _voltageMagnitude);
+}
+
+void CascadeController::setGains(const Gains& gains) {
+    _gains = gains;
+    if (_gains.velocityDecim == 0)
+        _gains.velocityDecim = 1;
+    if (_gains.positionDecim == 0)
+        _gains.positionDecim = 1;
+    updateCoefficients(_dt);
+}
+
+const CascadeController::Gains& CascadeController::getGains() const { return _gains; }
+
+CascadeController::Mode CascadeController::getMode() const { return _mode; }
+
+float CascadeController::getVelocity() const { return _velocity; }
+
+float CascadeController::getCurrentReference() const { return _currentQRef; }
+
+float CascadeController::getVoltageAngle() const { return _voltageAngle; }
+
+float CascadeController::getVoltageMagnitude() const { return _voltageMagnitude; }
+
+void CascadeController::updateCoefficients(float dt) {
+    _dt = dt;
+    float velocityDt = dt * _gains.velocityDecim;
+
+    _velocityInvDt = velocityDt > 0.0f ? 1.0f / velocityDt : 0.0f;
+    float rc = 1.0f / (TWO_PI * _gains.velocityCutoff);
+    _velocityAlpha = velocityDt / (rc + velocityDt);
+    _currentPerTorque = 1.0f / _gains.torqueConstant;
+
+    _velocityPi.kp = _gains.velocityKp;
+    _velocityPi.kiT = _gains.velocityKi * velocityDt;
+    _currentDPi.kp = _gains.currentKp;
+    _currentDPi.kiT = _gains.currentKi * dt;
+    _currentQPi.kp = _gains.currentKp;
+    _currentQPi.kiT = _gains.currentKi * dt;
+}
+
+void CascadeController::setMode(Mode mode) {
+    if (mode == Mode::IDLE) {
+        // Release the motor, next mode starts from zero
+        _velocityPi.integral = 0.0f;
+        _currentDPi.integral = 0.0f;
+        _currentQPi.integral = 0.0f;
+        _velocityRef = 0.0f;
+        _currentQRef = 0.0f;
+        _feedforward = 0.0f;
+    } else if (mode != Mode::TORQUE) {
+        // Bumpless transfer, the velocity loop starts from the current Q reference being applied (the integral has no feedforward)
+        if (_mode == Mode::IDLE || _mode == Mode::TORQUE) {
+            _velocityPi.integral = _currentQRef - _feedforward;
+            _velocityRef = _velocity;
+        }
+    }
+    // Run outer loops in the next iteration
+    _velocityCount = 0;
+    _positionCount = 0;
+    _mode = mode;
+}
+
+void CascadeController::positionLoop(const Control& c) {
+    float feedforward = std::isnan(c.velocity) ? 0.0f : c.velocity;
+    _velocityRef = clamp(_gains.positionKp * (c.position - _position) + feedforward, _gains.velocityLimit);
+}
+
+void CascadeController::updateEstimates(const State& s) {
+    float delta = wrapAngle(s.theta - _lastTheta);
+    _lastTheta = s.theta;
+    _position += delta;
+    if (std::isnan(s.velocity))
+        _velocity += _velocityAlpha * (delta * _velocityInvDt - _velocity);
+    else
+        _velocity = s.velocity; // Velocity estimated by the encoder PLL
+}
+
+void CascadeController::velocityLoop(const State& s, const Control& c) {
+    updateEstimates(s);
+
+    float torque = std::isnan(c.torque) ? 0.0f : c.torque;
+    float feedforward = torque * _currentPerTorque;
+    _feedforward = feedforward;
+    if (_mode == Mode::TORQUE) {
+        _currentQRef = clamp(feedforward, _gains.currentLimit);
+        return;
+    }
+    if (_mode == Mode::VELOCITY)
+        _velocityRef = clamp(c.velocity, _gains.velocityLimit);
+
+    // Integral is kept in the reference frame without feedforward so the feedforward can change without windup
+    float limit = _gains.currentLimit;
+    _currentQRef = clamp(piUpdate(_velocityPi, _velocityRef - _velocity, limit) + feedforward, limit);
+}
+
+void CascadeController::currentLoop(const State& s) {
+    float thetaE = s.theta * NUM_POLE_PAIRS;
+    float sinT = std::sin(thetaE);
+    float cosT = std::cos(thetaE);
+
+    // Clarke (balanced currents) and Park transforms
+    float iAlpha = s.currents[0];
+    float iBeta = (s.currents[0] + 2.0f * s.currents[1]) * INV_SQRT3;
+    float iD = iAlpha * cosT + iBeta * sinT;
+    float iQ = -iAlpha * sinT + iBeta * cosT;
+
+    // Linear SVPWM region, D axis has priority over Q axis
+    float vMax = s.voltage * INV_SQRT3;
+    float vD = piUpdate(_currentDPi, -iD, vMax);
+    float vQMax = vMax * vMax - vD * vD;
+    float vQ = piUpdate(_currentQPi, _currentQRef - iQ, vQMax > 0.0f ? std::sqrt(vQMax) : 0.0f);
+
+    _voltageAngle = thetaE + std::atan2(vQ, vD);
+    _voltageAngle = std::fmod(_voltageAngle, TWO_PI);
+    if (_voltageAngle < 0.0f)
+        _voltageAngle += TWO_PI;
+    _voltageMagnitude = vMax > 0.0f ? std::sqrt(vD * vD + vQ * vQ) / vMax : 0.0f;
+}
+
+float CascadeController::piUpdate(Pi& pi, float error, float limit) {
+    float p = pi.kp * error;
+    float integral = pi.integral + pi.kiT * error;
+    float out = p + integral;
+
+    // Only integrate when not saturated or when the error moves the output away from saturation
+    if (out > limit) {
+        out = limit;
+        if (error < 0.0f)
+            pi.integral = integral;
+    } else if (out < -limit) {
+        out = -limit;
+        if (error > 0.0f)
+            pi.integral = integral;
+    } else
+        pi.integral = integral;
+    return out;
+}
@@ -0,0 +1,135 @@
+//--------------------------------------------------
+// BLDC Controller
+// cascadeController.h
+// Date: 2026-10-19
+//--------------------------------------------------
+#ifndef BLDC_CASCADE_CONTROLLER_H
+#define BLDC_CASCADE_CONTROLLER_H
+#include "focController.h"
+
+// Cascaded Position/Velocity/Current Controller
+class CascadeController : public FocController {
+  public:
+    // Controller gains
+    struct Gains {
+        float positionKp;      // Position proportional gain ((rad/s)/rad)
+        float velocityKp;      // Velocity proportional gain (A/(rad/s))
+        float velocityKi;      // Velocity integral gain (A/rad)
+        float currentKp;       // D/Q current proportional gain (V/A)
+        float currentKi;       // D/Q current integral gain (V/(A*s))
+        float torqueConstant;  // Motor torque constant (Nm/A)
+        float velocityCutoff;  // Velocity estimate low pass cutoff frequency (Hz)
+        float velocityLimit;   // Maximum velocity reference (rad/s)
+        float currentLimit;    // Maximum Q current reference (A)
+        uint8_t velocityDecim; // Current loop iterations per velocity loop iteration
+        uint8_t positionDecim; // Velocity loop iterations per position loop iteration
+    };
+
+    // Control mode, selected from the NAN pattern of the control signals
+    enum class Mode { IDLE = 0, TORQUE, VELOCITY, POSITION };
+
+    CascadeController();
+
+    /**
+     * @brief Cascaded control
+     *
+     * Must be called at the current loop rate (PWM rate), the outer loops are decimated internally
+     *
+     * @param s Plant state
+     * @param c Control signals, the first one that is not NAN (position, velocity, torque) selects the mode
+     * @param dt Current loop period in seconds
+     *
+     * @return Switch state that generates the desired voltage vector
+     */
+    Output control(State s, Control c, float dt) override;
+
+    /**
+     * @brief Set controller gains
+     *
+     * The discrete coefficients are only recomputed here (or when dt changes), so control() only performs multiply-adds
+     *
+     * @param gains New gains
+     */
+    void setGains(const Gains& gains);
+    const Gains& getGains() const;
+
+    Mode getMode() const;
+    float getVelocity() const;         ///< Velocity estimate in rad/s (filtered or from State::velocity)
+    float getCurrentReference() const; ///< Q current reference in A (velocity loop output)
+    float getVoltageAngle() const;     ///< Last voltage vector angle in radians (space vector diagram)
+    float getVoltageMagnitude() const; ///< Last voltage vector magnitude (between 0 and 1)
+
+  private:
+    // Discrete PI with conditional integration anti-windup
+    struct Pi {
+        float kp;       // Proportional coefficient
+        float kiT;      // Integral coefficient multiplied by the loop period
+        float integral; // Integral term (already multiplied by ki)
+    };
+
+    /**
+     * @brief Recompute discrete coefficients from the gains and current loop period
+     *
+     * @param dt Current loop period in seconds
+     */
+    void updateCoefficients(float dt);
+
+    /**
+     * @brief Change control mode without output bump
+     *
+     * @param mode New mode
+     */
+    void setMode(Mode mode);
+
+    /**
+     * @brief Update position and velocity estimates
+     *
+     * Runs at the velocity loop rate, also while idle
+     *
+     * @param s Plant state
+     */
+    void updateEstimates(const State& s);
+
+    void positionLoop(const Control& c);
+    void velocityLoop(const State& s, const Control& c);
+    void currentLoop(const State& s);
+
+    /**
+     * @brief PI step with output saturation
+     *
+     * Integration is stopped while the output is saturated (conditional integration anti-windup)
+     *
+     * @param pi PI state
+     * @param error Control error
+     * @param limit Symmetric output limit
+     *
+     * @return Saturated output
+     */
+    static float piUpdate(Pi& pi, float error, float limit);
+
+    Gains _gains;
+    float _dt; // Current loop period used to compute the coefficients
+
+    // Precomputed coefficients
+    float _velocityAlpha;    // Velocity low pass filter coefficient
+    float _velocityInvDt;    // Inverse of the velocity loop period
+    float _currentPerTorque; // Inverse of the torque constant
+    Pi _velocityPi;
+    Pi _currentDPi;
+    Pi _currentQPi;
+
+    // Loop state
+    Mode _mode;
+    uint8_t _velocityCount; // Current loop iterations since last velocity loop iteration
+    uint8_t _positionCount; // Velocity loop iterations since last position loop iteration
+    float _lastTheta;       // Rotor angle at last estimate update
+    float _position;        // Multi-turn rotor position
+    float _velocity;        // Rotor velocity (filtered or from State::velocity)
+    float _velocityRef;
+    float _currentQRef;
+    float _feedforward; // Q current feedforward of the last velocity loop iteration
+    float _voltageAngle;
+    float _voltageMagnitude;
+};
+
+#endif // BLDC_CASCADE_CONTROLLER_H
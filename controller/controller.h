@@ -17,9 +17,11 @@ class Controller {
 
     // Plant state
     struct State {
-        float voltage;                 // Supply voltage
-        std::array<float, 3> currents; // Phase currents
-        float theta;                   // Rotor angular position
+        float voltage;                      // Supply voltage
+        std::array<float, 3> currents;      // Phase currents
+        float theta;                        // Rotor angular position
+        float velocity;                     // Rotor angular velocity (NAN if not estimated)
+        std::array<float, 3> phaseVoltages; // Phase voltages (sampled synchronously with PWM)
     };
 
     // Control signals
@@ -45,7 +47,8 @@ class Controller {
 
     virtual Output control(State s, Control c, float dt) = 0;
 
-    static constexpr uint8_t NUM_POLES = 8;
+    static constexpr uint8_t NUM_POLES = 14;
+    static constexpr uint8_t NUM_POLE_PAIRS = NUM_POLES / 2;
 };
 constexpr Controller::Output::Phase LOW = Controller::Output::LOW;
 constexpr Controller::Output::Phase HIGH = Controller::Output::HIGH;
@@ -0,0 +1,32 @@
+//--------------------------------------------------
+// BLDC Controller
+// deadTimeCompensation.cpp
+// Date: 2026-10-19
+//--------------------------------------------------
+#include "deadTimeCompensation.h"
+#include <algorithm>
+
+DeadTimeCompensation::DeadTimeCompensation() : _correction(0.0f), _band(0.05f), _gain(0.0f) {}
+
+std::array<float, 3> DeadTimeCompensation::compute(const std::array<float, 3>& currents) const {
+    std::array<float, 3> correction;
+    for (size_t i = 0; i < 3; i++)
+        correction[i] = std::clamp(currents[i] * _gain, -_correction, _correction);
+    return correction;
+}
+
+void DeadTimeCompensation::setDeadTime(float deadTime, float pwmPeriod) {
+    _correction = pwmPeriod > 0.0f ? std::max(deadTime, 0.0f) / pwmPeriod : 0.0f;
+    updateGain();
+}
+
+void DeadTimeCompensation::setBand(float band) {
+    _band = band;
+    updateGain();
+}
+
+float DeadTimeCompensation::getBand() const { return _band; }
+
+float DeadTimeCompensation::getCorrection() const { return _correction; }
+
+void DeadTimeCompensation::updateGain() { _gain = _band > 0.0f ? _correction / _band : 0.0f; }
@@ -0,0 +1,57 @@
+//--------------------------------------------------
+// BLDC Controller
+// deadTimeCompensation.h
+// Date: 2026-10-19
+//--------------------------------------------------
+#ifndef BLDC_DEAD_TIME_COMPENSATION_H
+#define BLDC_DEAD_TIME_COMPENSATION_H
+#include "controller.h"
+
+// Dead time voltage error compensation
+//
+// While both switches of a phase are off, the phase current flows through the body diode selected by its sign. A
+// positive current (out of the inverter) keeps the phase low, so the phase loses dead time / PWM period of its duty
+// cycle, and a negative current gains the same amount. The lost duty cycle is added back with the sign of the current
+class DeadTimeCompensation {
+  public:
+    DeadTimeCompensation();
+
+    /**
+     * @brief Duty cycle correction of each phase
+     *
+     * The sign is ramped linearly inside +-band, so current noise around zero does not toggle the correction. The
+     * cost is fixed (three clamps, no branches on the current sign), so it fits in the current loop
+     *
+     * @param currents Phase currents in amperes (positive out of the inverter)
+     *
+     * @return Correction to add to the duty cycle of each phase (fraction of the PWM period)
+     */
+    std::array<float, 3> compute(const std::array<float, 3>& currents) const;
+
+    /**
+     * @brief Set dead time
+     *
+     * @param deadTime Dead time inserted at each switching edge in seconds
+     * @param pwmPeriod PWM period in seconds
+     */
+    void setDeadTime(float deadTime, float pwmPeriod);
+
+    /**
+     * @brief Set current band of the sign ramp
+     *
+     * @param band Current above which the full correction is applied in amperes (positive, above the current noise)
+     */
+    void setBand(float band);
+    float getBand() const;
+
+    float getCorrection() const; ///< Full correction (dead time / PWM period)
+
+  private:
+    void updateGain();
+
+    float _correction; // Full correction (duty cycle)
+    float _band;       // Current band of the sign ramp
+    float _gain;       // Correction per ampere inside the band
+};
+
+#endif // BLDC_DEAD_TIME_COMPENSATION_H
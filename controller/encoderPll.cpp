@@ -0,0 +1,86 @@
+//--------------------------------------------------
+// BLDC Controller
+// encoderPll.cpp
+// Date: 2026-10-19
+//--------------------------------------------------
+#include "encoderPll.h"
+
+namespace {
+
+constexpr float RAD_PER_COUNT = 2 * M_PI / EncoderPll::COUNTS_PER_TURN;
+
+} // namespace
+
+EncoderPll::EncoderPll()
+    : _bandwidth(2000.0f), _latency(0.0f), _dt(0.0f), _kPos(0.0f), _kVel(0.0f), _kAcc(0.0f), _lastCounts(0), _measured(0), _posInt(0),
+      _posFrac(0.0f), _vel(0.0f), _acc(0.0f) {}
+
+void EncoderPll::update(uint16_t counts, float dt) {
+    if (_dt == 0.0f || std::fabs(dt - _dt) > DT_TOLERANCE * _dt)
+        updateCoefficients(dt);
+
+    // Multi-turn unwrap (sign extend 14-bit difference)
+    int16_t delta = int16_t(uint16_t(counts - _lastCounts) << (16 - COUNTS_BITS)) >> (16 - COUNTS_BITS);
+    _lastCounts = counts;
+    _measured += delta;
+
+    // Predict
+    _posFrac += (_vel + 0.5f * _acc * dt) * dt;
+    _vel += _acc * dt;
+
+    // Correct
+    float err = float(int32_t(_measured - _posInt)) - _posFrac;
+    _posFrac += _kPos * err;
+    _vel += _kVel * err;
+    _acc += _kAcc * err;
+
+    // Move integer part out of the fraction
+    int32_t whole = int32_t(std::floor(_posFrac));
+    _posInt += whole;
+    _posFrac -= whole;
+}
+
+EncoderPll::State EncoderPll::getState() const { return predict(_latency); }
+
+EncoderPll::State EncoderPll::predict(float latency) const {
+    float frac = _posFrac + (_vel + 0.5f * _acc * latency) * latency;
+    int32_t whole = int32_t(std::floor(frac));
+    int64_t pos = _posInt + whole;
+    frac -= whole;
+
+    State s;
+    s.turns = int32_t(pos >> COUNTS_BITS); // Arithmetic shift floors negative positions
+    s.angle = (float(int32_t(pos & (COUNTS_PER_TURN - 1))) + frac) * RAD_PER_COUNT;
+    s.velocity = (_vel + _acc * latency) * RAD_PER_COUNT;
+    s.acceleration = _acc * RAD_PER_COUNT;
+    return s;
+}
+
+void EncoderPll::setBandwidth(float bandwidth) {
+    _bandwidth = bandwidth;
+    updateCoefficients(_dt);
+}
+
+float EncoderPll::getBandwidth() const { return _bandwidth; }
+
+void EncoderPll::setLatency(float latency) { _latency = latency; }
+
+float EncoderPll::getLatency() const { return _latency; }
+
+void EncoderPll::reset(uint16_t counts) {
+    _lastCounts = counts & (COUNTS_PER_TURN - 1);
+    _measured = _lastCounts;
+    _posInt = _lastCounts;
+    _posFrac = 0.0f;
+    _vel = 0.0f;
+    _acc = 0.0f;
+}
+
+void EncoderPll::updateCoefficients(float dt) {
+    _dt = dt;
+    // Triple pole at -bandwidth: s^3 + 3w s^2 + 3w^2 s + w^3
+    float w = _bandwidth;
+    _kPos = 3.0f * w * dt;
+    _kVel = 3.0f * w * w * dt;
+    _kAcc = w * w * w * dt;
+}
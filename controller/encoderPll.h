@@ -0,0 +1,102 @@
+//--------------------------------------------------
+// BLDC Controller
+// encoderPll.h
+// Date: 2026-10-19
+//--------------------------------------------------
+#ifndef BLDC_ENCODER_PLL_H
+#define BLDC_ENCODER_PLL_H
+#include "controller.h"
+
+// Encoder tracking PLL (position, velocity and acceleration from raw encoder counts)
+class EncoderPll {
+  public:
+    // Rotor state consumed by the controllers
+    struct State {
+        int32_t turns;      // Full mechanical turns
+        float angle;        // Single-turn mechanical angle in radians [0, 2pi)
+        float velocity;     // Mechanical velocity in rad/s
+        float acceleration; // Mechanical acceleration in rad/s^2
+    };
+
+    EncoderPll();
+
+    /**
+     * @brief Tracking loop step
+     *
+     * Raw counts are unwrapped with integer arithmetic, so the multi-turn position never loses resolution. The gains
+     * are only recomputed when dt moves more than DT_TOLERANCE from the period they were computed for, so the jitter
+     * of a measured dt does not cost a recomputation every sample
+     *
+     * @param counts Raw encoder counts (14-bit)
+     * @param dt Time since last update in seconds
+     */
+    void update(uint16_t counts, float dt);
+
+    /**
+     * @brief Estimated state predicted forward by the configured latency
+     *
+     * @return Rotor state at the PWM update instant
+     */
+    State getState() const;
+
+    /**
+     * @brief Estimated state predicted forward
+     *
+     * @param latency Prediction horizon in seconds
+     *
+     * @return Rotor state latency seconds after the last sample
+     */
+    State predict(float latency) const;
+
+    /**
+     * @brief Set tracking loop bandwidth
+     *
+     * Gains are placed as a triple pole at -bandwidth, can be changed at runtime
+     *
+     * @param bandwidth Bandwidth in rad/s
+     */
+    void setBandwidth(float bandwidth);
+    float getBandwidth() const;
+
+    /**
+     * @brief Set latency between the encoder sample and the PWM update
+     *
+     * @param latency Latency in seconds (SPI transfer and processing)
+     */
+    void setLatency(float latency);
+    float getLatency() const;
+
+    /**
+     * @brief Restart tracking from a raw reading
+     *
+     * @param counts Raw encoder counts (14-bit)
+     */
+    void reset(uint16_t counts);
+
+    static constexpr uint8_t COUNTS_BITS = 14;
+    static constexpr int32_t COUNTS_PER_TURN = 1 << COUNTS_BITS;
+    static constexpr float DT_TOLERANCE = 0.01f; ///< Relative change of dt that recomputes the gains
+
+  private:
+    void updateCoefficients(float dt);
+
+    // Configuration
+    float _bandwidth;
+    float _latency;
+    float _dt; // Loop period used to compute the coefficients
+
+    // Precomputed coefficients (already multiplied by dt)
+    float _kPos;
+    float _kVel;
+    float _kAcc;
+
+    // State in counts, the position is split in integer and fractional parts (64-bit, 2^31 counts are only 131072 turns)
+    uint16_t _lastCounts;
+    int64_t _measured; // Unwrapped measured position
+    int64_t _posInt;   // Estimated position (integer part)
+    float _posFrac;    // Estimated position (fractional part)
+    float _vel;        // Estimated velocity (counts/s)
+    float _acc;        // Estimated acceleration (counts/s^2)
+};
+
+#endif // BLDC_ENCODER_PLL_H
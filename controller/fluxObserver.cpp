@@ -0,0 +1,104 @@
+//--------------------------------------------------
+// BLDC Controller
+// fluxObserver.cpp
+// Date: 2026-10-19
+//--------------------------------------------------
+#include "fluxObserver.h"
+
+namespace {
+
+constexpr float TWO_PI = 2 * M_PI;
+constexpr float INV_SQRT3 = 0.57735026919f;
+
+// Wrap angle to [-pi, pi)
+float wrapAngle(float angle) {
+    if (angle >= M_PI)
+        angle -= TWO_PI;
+    else if (angle < -M_PI)
+        angle += TWO_PI;
+    return angle;
+}
+
+} // namespace
+
+FluxObserver::FluxObserver() : _xAlpha(0.0f), _xBeta(0.0f), _angle(0.0f), _speed(0.0f) {
+    _config.resistance = 3.6f;
+    _config.inductance = 0.0004f;
+    _config.fluxLinkage = 0.002f;
+    _config.gain = 1e6f;
+    _config.pllBandwidth = 1000.0f;
+    _config.blendLow = 200.0f;
+    _config.blendHigh = 400.0f;
+    updateCoefficients();
+}
+
+void FluxObserver::update(const std::array<float, 3>& currents, const std::array<float, 3>& voltages, float dt) {
+    // Clarke transforms (common mode removed)
+    float iAlpha = (2.0f * currents[0] - currents[1] - currents[2]) * (1.0f / 3.0f);
+    float iBeta = (currents[1] - currents[2]) * INV_SQRT3;
+    float vAlpha = (2.0f * voltages[0] - voltages[1] - voltages[2]) * (1.0f / 3.0f);
+    float vBeta = (voltages[1] - voltages[2]) * INV_SQRT3;
+
+    // Rotor flux is stator flux minus inductance flux, its magnitude must match the flux linkage
+    float etaAlpha = _xAlpha - _config.inductance * iAlpha;
+    float etaBeta = _xBeta - _config.inductance * iBeta;
+    float err = _fluxSq - (etaAlpha * etaAlpha + etaBeta * etaBeta);
+    _xAlpha += (vAlpha - _config.resistance * iAlpha + _halfGain * etaAlpha * err) * dt;
+    _xBeta += (vBeta - _config.resistance * iBeta + _halfGain * etaBeta * err) * dt;
+
+    // PLL locks to the rotor flux direction (cross product phase detector)
+    float phaseErr = (etaBeta * std::cos(_angle) - etaAlpha * std::sin(_angle)) * _invFlux;
+    _speed += _pllKi * phaseErr * dt;
+    _angle += (_speed + _pllKp * phaseErr) * dt;
+    if (_angle >= TWO_PI)
+        _angle -= TWO_PI;
+    else if (_angle < 0.0f)
+        _angle += TWO_PI;
+}
+
+float FluxObserver::blend(float encoderAngle) const {
+    if (std::isnan(encoderAngle))
+        return _angle;
+
+    float w = (std::fabs(_speed) - _config.blendLow) * _invBlend;
+    if (w <= 0.0f)
+        return encoderAngle;
+    if (w >= 1.0f)
+        return _angle;
+
+    float angle = encoderAngle + w * wrapAngle(_angle - encoderAngle);
+    if (angle >= TWO_PI)
+        angle -= TWO_PI;
+    else if (angle < 0.0f)
+        angle += TWO_PI;
+    return angle;
+}
+
+void FluxObserver::setConfig(const Config& config) {
+    _config = config;
+    updateCoefficients();
+}
+
+const FluxObserver::Config& FluxObserver::getConfig() const { return _config; }
+
+void FluxObserver::reset() {
+    _xAlpha = 0.0f;
+    _xBeta = 0.0f;
+    _angle = 0.0f;
+    _speed = 0.0f;
+}
+
+float FluxObserver::getAngle() const { return _angle; }
+
+float FluxObserver::getSpeed() const { return _speed; }
+
+void FluxObserver::updateCoefficients() {
+    _fluxSq = _config.fluxLinkage * _config.fluxLinkage;
+    _halfGain = 0.5f * _config.gain;
+    _invFlux = 1.0f / _config.fluxLinkage;
+    // Critically damped second order PLL
+    _pllKp = 2.0f * _config.pllBandwidth;
+    _pllKi = _config.pllBandwidth * _config.pllBandwidth;
+    float range = _config.blendHigh - _config.blendLow;
+    _invBlend = range > 0.0f ? 1.0f / range : 1e9f;
+}
@@ -0,0 +1,79 @@
+//--------------------------------------------------
+// BLDC Controller
+// fluxObserver.h
+// Date: 2026-10-19
+//--------------------------------------------------
+#ifndef BLDC_FLUX_OBSERVER_H
+#define BLDC_FLUX_OBSERVER_H
+#include "controller.h"
+
+// Sensorless rotor angle observer (nonlinear flux observer + PLL)
+class FluxObserver {
+  public:
+    // Motor and observer parameters
+    struct Config {
+        float resistance;   // Phase resistance (Ohm)
+        float inductance;   // Phase inductance (H)
+        float fluxLinkage;  // Rotor flux linkage (Wb)
+        float gain;         // Flux observer gain
+        float pllBandwidth; // PLL bandwidth (rad/s)
+        float blendLow;     // Electrical speed below which only the encoder is used (rad/s)
+        float blendHigh;    // Electrical speed above which only the observer is used (rad/s)
+    };
+
+    FluxObserver();
+
+    /**
+     * @brief Observer step
+     *
+     * Must be called at PWM rate. The cost is fixed (no loops, one sin/cos pair), so it fits in the current loop
+     *
+     * @param currents Measured phase currents
+     * @param voltages Commanded phase voltages
+     * @param dt Time since last call in seconds
+     */
+    void update(const std::array<float, 3>& currents, const std::array<float, 3>& voltages, float dt);
+
+    /**
+     * @brief Blend observer angle with encoder angle
+     *
+     * At low speed the flux estimate is not observable, so the encoder is used. Between blendLow and blendHigh the
+     * weight moves linearly from the encoder to the observer
+     *
+     * @param encoderAngle Electrical angle from the encoder (NAN if not available)
+     *
+     * @return Blended electrical angle in radians
+     */
+    float blend(float encoderAngle) const;
+
+    void setConfig(const Config& config);
+    const Config& getConfig() const;
+
+    void reset();
+    float getAngle() const; ///< Electrical angle in radians (rotor flux direction)
+    float getSpeed() const; ///< Electrical speed in rad/s
+
+  private:
+    /**
+     * @brief Recompute discrete coefficients from the configuration
+     */
+    void updateCoefficients();
+
+    Config _config;
+
+    // Precomputed coefficients
+    float _fluxSq;   // Squared flux linkage
+    float _halfGain; // Half observer gain
+    float _invFlux;  // Inverse flux linkage (PLL error normalization)
+    float _pllKp;    // PLL proportional gain
+    float _pllKi;    // PLL integral gain
+    float _invBlend; // Inverse of the blend speed range
+
+    // State
+    float _xAlpha; // Stator flux estimate (alpha)
+    float _xBeta;  // Stator flux estimate (beta)
+    float _angle;  // PLL angle
+    float _speed;  // PLL speed
+};
+
+#endif // BLDC_FLUX_OBSERVER_H
@@ -4,7 +4,6 @@
 // Date: 2023-10-25
 //--------------------------------------------------
 #include "focController.h"
-#include <utils/log.h>
 
 const std::array<Controller::Output, 8> FocController::_v = {Output(HIGH, LOW, LOW),  Output(HIGH, HIGH, LOW), Output(LOW, HIGH, LOW),
                                                              Output(LOW, HIGH, HIGH), Output(LOW, LOW, HIGH),  Output(HIGH, LOW, HIGH),
@@ -14,7 +14,7 @@ class FocController : public Controller {
 
     Output control(State s, Control c, float dt) override;
 
-  private:
+  protected:
     /**
      * Vectors from space vector diagram
      *
@@ -0,0 +1,120 @@
+//--------------------------------------------------
+// BLDC Controller
+// sensorlessController.cpp
+// Date: 2026-10-19
+//--------------------------------------------------
+#include "sensorlessController.h"
+
+const std::array<Controller::Output, 6> SensorlessController::_commutations = {
+    Output(Output::HIGH, Output::LOW, Output::Z), Output(Output::HIGH, Output::Z, Output::LOW), Output(Output::Z, Output::HIGH, Output::LOW),
+    Output(Output::LOW, Output::HIGH, Output::Z), Output(Output::LOW, Output::Z, Output::HIGH), Output(Output::Z, Output::LOW, Output::HIGH),
+};
+
+const std::array<uint8_t, 6> SensorlessController::_floating = {2, 1, 0, 2, 1, 0};
+
+SensorlessController::SensorlessController()
+    : _stage(Stage::IDLE), _step(5), _lockIn(0), _zcSeen(false), _commutated(false), _time(0.0f), _sinceZc(0.0f), _stepPeriod(0.0f),
+      _commutateAt(0.0f) {
+    _config.alignTime = 0.2f;
+    _config.rampStartPeriod = 0.02f;
+    _config.rampEndPeriod = 0.002f;
+    _config.rampFactor = 0.95f;
+    _config.blanking = 0.2f;
+    _config.periodFilter = 0.25f;
+    _config.lockInSteps = 12;
+}
+
+Controller::Output SensorlessController::control(State s, Control c, float dt) {
+    _commutated = false;
+    if (std::isnan(c.position) && std::isnan(c.velocity) && std::isnan(c.torque)) {
+        _stage = Stage::IDLE;
+        return Output();
+    }
+    if (_stage == Stage::IDLE)
+        restart();
+
+    _time += dt;
+    _sinceZc += dt;
+    switch (_stage) {
+        case Stage::ALIGN:
+            if (_time >= _config.alignTime) {
+                _stage = Stage::RAMP;
+                _stepPeriod = _config.rampStartPeriod;
+                commutate();
+            }
+            break;
+        case Stage::RAMP:
+            if (!_zcSeen && _time >= _config.blanking * _stepPeriod && detectZeroCrossing(s)) {
+                _zcSeen = true;
+                _sinceZc = 0.0f;
+            }
+            if (_time >= _stepPeriod) {
+                // Back-EMF must cross zero inside every ramp step to lock in
+                _lockIn = _zcSeen ? _lockIn + 1 : 0;
+                if (_lockIn >= _config.lockInSteps)
+                    _stage = Stage::RUN;
+                else if (_stepPeriod * _config.rampFactor > _config.rampEndPeriod)
+                    _stepPeriod *= _config.rampFactor;
+                commutate();
+            }
+            break;
+        case Stage::RUN:
+            if (!_zcSeen && _time >= _config.blanking * _stepPeriod && detectZeroCrossing(s)) {
+                // Commutate 30 degrees (half step) after the zero crossing
+                _stepPeriod += _config.periodFilter * (_sinceZc - _stepPeriod);
+                _sinceZc = 0.0f;
+                _zcSeen = true;
+                _commutateAt = _time + 0.5f * _stepPeriod;
+            }
+            if (_zcSeen && _time >= _commutateAt)
+                commutate();
+            else if (_time >= 2.0f * _stepPeriod)
+                restart(); // Zero crossing lost
+            break;
+        default:
+            break;
+    }
+    return _commutations[_step];
+}
+
+void SensorlessController::setConfig(const Config& config) { _config = config; }
+
+const SensorlessController::Config& SensorlessController::getConfig() const { return _config; }
+
+SensorlessController::Stage SensorlessController::getStage() const { return _stage; }
+
+uint8_t SensorlessController::getStep() const { return _step; }
+
+float SensorlessController::getStepPeriod() const { return _stepPeriod; }
+
+float SensorlessController::getVelocity() const {
+    if (_stage != Stage::RAMP && _stage != Stage::RUN)
+        return 0.0f;
+    return (M_PI / 3.0f) / (_stepPeriod * NUM_POLE_PAIRS);
+}
+
+bool SensorlessController::hasCommutated() const { return _commutated; }
+
+bool SensorlessController::detectZeroCrossing(const State& s) const {
+    uint8_t f = _floating[_step];
+    float neutral = 0.5f * (s.phaseVoltages[(f + 1) % 3] + s.phaseVoltages[(f + 2) % 3]);
+    float emf = s.phaseVoltages[f] - neutral;
+    // Floating phase back-EMF falls on even steps and rises on odd steps
+    return (_step & 1) ? emf >= 0.0f : emf <= 0.0f;
+}
+
+void SensorlessController::commutate() {
+    _step = _step == 5 ? 0 : _step + 1;
+    _time = 0.0f;
+    _zcSeen = false;
+    _commutated = true;
+}
+
+void SensorlessController::restart() {
+    _stage = Stage::ALIGN;
+    _step = 5;
+    _lockIn = 0;
+    _time = 0.0f;
+    _sinceZc = 0.0f;
+    _zcSeen = false;
+}
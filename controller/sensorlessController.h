@@ -0,0 +1,88 @@
+//--------------------------------------------------
+// BLDC Controller
+// sensorlessController.h
+// Date: 2026-10-19
+//--------------------------------------------------
+#ifndef BLDC_SENSORLESS_CONTROLLER_H
+#define BLDC_SENSORLESS_CONTROLLER_H
+#include "controller.h"
+
+// Sensorless Six-Step Controller (back-EMF zero crossing)
+class SensorlessController : public Controller {
+  public:
+    // Controller stage
+    enum class Stage {
+        IDLE = 0, // Motor released
+        ALIGN,    // Rotor aligned to the last step before starting
+        RAMP,     // Open-loop commutation with increasing speed
+        RUN,      // Closed-loop commutation from back-EMF zero crossings
+    };
+
+    // Controller configuration
+    struct Config {
+        float alignTime;       // Time holding the align step (s)
+        float rampStartPeriod; // Step period when the ramp starts (s)
+        float rampEndPeriod;   // Minimum step period of the ramp (s)
+        float rampFactor;      // Step period multiplier after each ramp step
+        float blanking;        // Fraction of the step period ignored after commutation (demagnetization)
+        float periodFilter;    // Step period low pass filter coefficient (between 0 and 1)
+        uint8_t lockInSteps;   // Consecutive valid zero crossings during the ramp needed to enter RUN
+    };
+
+    SensorlessController();
+
+    /**
+     * @brief Six-step commutation from back-EMF zero crossings
+     *
+     * Must be called once per PWM period with phase voltages sampled synchronously with the PWM. The rotor angle
+     * is not used. Any control signal that is not NAN starts the motor, all NAN releases it
+     *
+     * @param s Plant state (voltage and phaseVoltages are used)
+     * @param c Control signals
+     * @param dt Time since last call in seconds
+     *
+     * @return Commutation for the current step
+     */
+    Output control(State s, Control c, float dt) override;
+
+    void setConfig(const Config& config);
+    const Config& getConfig() const;
+
+    Stage getStage() const;
+    uint8_t getStep() const;
+    float getStepPeriod() const; ///< Estimated time between zero crossings (60 electrical degrees)
+    float getVelocity() const;   ///< Estimated mechanical velocity in rad/s
+    bool hasCommutated() const;  ///< If the last call to control() changed the step
+
+  private:
+    /**
+     * @brief Check floating phase against the neutral point
+     *
+     * The neutral point is estimated as the mean of the two driven phases, so the floating phase crosses it when
+     * its back-EMF crosses zero
+     *
+     * @param s Plant state
+     *
+     * @return True if the back-EMF already crossed zero in the current step
+     */
+    bool detectZeroCrossing(const State& s) const;
+
+    void commutate();
+    void restart();
+
+    static const std::array<Output, 6> _commutations;
+    static const std::array<uint8_t, 6> _floating; // Floating phase of each step
+
+    Config _config;
+    Stage _stage;
+    uint8_t _step;
+    uint8_t _lockIn;    // Consecutive valid zero crossings during the ramp
+    bool _zcSeen;       // If the zero crossing was already detected in the current step
+    bool _commutated;   // If the step changed during the last call
+    float _time;        // Time since last commutation
+    float _sinceZc;     // Time since last zero crossing
+    float _stepPeriod;  // Current step period
+    float _commutateAt; // Time since commutation of the next commutation (RUN)
+};
+
+#endif // BLDC_SENSORLESS_CONTROLLER_H
@@ -5,21 +5,32 @@
 //--------------------------------------------------
 #include "trapezoidalController.h"
 
+const std::array<Controller::Output, 6> TrapezoidalController::_commutations = {
+    Output(Output::HIGH, Output::LOW, Output::Z), Output(Output::HIGH, Output::Z, Output::LOW), Output(Output::Z, Output::HIGH, Output::LOW),
+    Output(Output::LOW, Output::HIGH, Output::Z), Output(Output::LOW, Output::Z, Output::HIGH), Output(Output::Z, Output::LOW, Output::HIGH),
+};
+
+TrapezoidalController::TrapezoidalController() : _numPoles(NUM_POLES), _polePairs(NUM_POLE_PAIRS), _offset(DEFAULT_OFFSET) {}
+
 Controller::Output TrapezoidalController::control(State s, Control c, float dt) {
-    static std::array<Output, 6> commutations = {
-        Output(Output::HIGH, Output::LOW, Output::Z), Output(Output::HIGH, Output::Z, Output::LOW), Output(Output::Z, Output::HIGH, Output::LOW),
-        Output(Output::LOW, Output::HIGH, Output::Z), Output(Output::LOW, Output::Z, Output::HIGH), Output(Output::Z, Output::LOW, Output::HIGH),
-    };
-
-    float theta = s.theta * NUM_POLES; // Electrical angular position
-    theta = std::fmod(theta, 2 * M_PI);
-    if (theta < 0)
-        theta += 2 * M_PI;
-
-    const float sectionSize = 2 * M_PI / 6;
-    float section = ((theta + M_PI) / sectionSize) + 0.5f; // Section where magnet north pole is
-    if (section > 6.0f)
-        section -= 6.0f;
-    // LOG_DEBUG("TrapezoidalController", "Theta $0 section $1", theta, section);
-    return commutations[(int)section];
+    float turns = s.theta * float(1.0 / (2 * M_PI)); // Mechanical turns
+    turns -= std::floor(turns);
+    return commutate(uint16_t(turns * COUNTS_PER_TURN) & (COUNTS_PER_TURN - 1));
 }
+
+Controller::Output TrapezoidalController::commutate(uint16_t counts) const {
+    uint16_t angle = uint16_t(counts * _polePairs) << (16 - COUNTS_BITS); // Electrical angle (overflow wraps the turn)
+    angle += _offset;
+    return _commutations[(uint32_t(angle) * 6) >> 16]; // Sector where the magnet north pole is
+}
+
+void TrapezoidalController::setNumPoles(uint8_t numPoles) {
+    _numPoles = numPoles;
+    _polePairs = numPoles / 2;
+}
+
+uint8_t TrapezoidalController::getNumPoles() const { return _numPoles; }
+
+void TrapezoidalController::setOffset(uint16_t offset) { _offset = offset; }
+
+uint16_t TrapezoidalController::getOffset() const { return _offset; }
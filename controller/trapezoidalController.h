@@ -10,9 +10,54 @@
 // Trapezoidal Commutation Controller
 class TrapezoidalController : public Controller {
   public:
-    TrapezoidalController() = default;
+    TrapezoidalController();
 
+    /**
+     * @brief Commutation from the rotor angle
+     *
+     * The angle is quantized to encoder counts and commutated with commutate(), so simulated and encoder driven
+     * commutation use the same sector selection
+     */
     Output control(State s, Control c, float dt) override;
+
+    /**
+     * @brief Integer commutation from raw encoder counts
+     *
+     * The electrical angle is computed in 16-bit fixed point (65536 = one electrical turn), so the sector is
+     * selected exactly with a multiply and a shift
+     *
+     * @param counts Rotor position in encoder counts (14-bit, 16384 = one mechanical turn)
+     *
+     * @return Commutation for the current sector
+     */
+    Output commutate(uint16_t counts) const;
+
+    /**
+     * @brief Set number of motor poles
+     *
+     * @param numPoles Number of poles (must be even)
+     */
+    void setNumPoles(uint8_t numPoles);
+    uint8_t getNumPoles() const;
+
+    /**
+     * @brief Set electrical angle offset
+     *
+     * @param offset Offset added to the electrical angle before sector selection (65536 = one electrical turn)
+     */
+    void setOffset(uint16_t offset);
+    uint16_t getOffset() const;
+
+    static constexpr uint8_t COUNTS_BITS = 14;                    ///< Encoder resolution
+    static constexpr uint16_t COUNTS_PER_TURN = 1 << COUNTS_BITS; ///< Encoder counts per mechanical turn
+    static constexpr uint16_t DEFAULT_OFFSET = 38229;             ///< 3.5 sectors, north pole between commutations
+
+  private:
+    static const std::array<Output, 6> _commutations;
+
+    uint8_t _numPoles;
+    uint8_t _polePairs;
+    uint16_t _offset;
 };
 
 #endif // BLDC_TRAPEZOIDAL_CONTROLLER_H
@@ -10,6 +10,7 @@ BUILD_PATH="$SCRIPT_DIR/build"
 # Output files from the build
 FIRMWARE_ELF="$BUILD_PATH/bin/firmware.elf"
 FIRMWARE_BIN="$BUILD_PATH/bin/firmware.bin"
+TRACE_FILE="$BUILD_PATH/trace.swo"
 
 # --- Functions ---
 
@@ -24,6 +25,7 @@ help()
     echo "  -c, --clean       Clean previous build"
     echo "  -f, --flash       Flash firmware (implies --build if not already built)"
     echo "  -t, --trace       Trace debugging. Print SWO output"
+    echo "  -r, --record      Record raw SWO output to build/trace.swo (decode with tools/swoTrace.py)"
     echo "  -g, --gdb         Open OpenOCD and GDB session"
     echo
     echo "Other Options:"
@@ -69,6 +71,16 @@ trace()
     st-trace --clock=144m --trace=2m
 }
 
+record()
+{
+    echo "--- Recording SWO trace to $TRACE_FILE (Ctrl+C to stop) ---"
+    mkdir -p "$BUILD_PATH"
+    openocd -f "$SCRIPT_DIR/base/openocd/stm32f4.cfg" -c "init" \
+        -c "STM32F446RETx.tpiu configure -protocol uart -traceclk 144000000 -pin-freq 2000000 -output $TRACE_FILE" \
+        -c "STM32F446RETx.tpiu enable" \
+        -c "itm ports on"
+}
+
 gdb()
 {
     # Ensure OpenOCD is killed when the script exits (e.g., Ctrl+C)
@@ -93,6 +105,7 @@ DO_CLEAN=false
 DO_BUILD=false
 DO_FLASH=false
 DO_TRACE=false
+DO_RECORD=false
 DO_GDB=false
 IS_DEBUG_BUILD=false
 
@@ -122,6 +135,10 @@ while [[ $# -gt 0 ]]; do
       DO_TRACE=true
       shift
       ;;
+    -r|--record)
+      DO_RECORD=true
+      shift
+      ;;
     -g|--gdb)
       DO_GDB=true
       shift
@@ -161,9 +178,11 @@ if [ "$DO_FLASH" = true ]; then
     flash
 fi
 
-# GDB and Trace are mutually exclusive; they both try to talk to the chip
+# GDB, Trace and Record are mutually exclusive; they all try to talk to the chip
 if [ "$DO_GDB" = true ]; then
     gdb
+elif [ "$DO_RECORD" = true ]; then
+    record
 elif [ "$DO_TRACE" = true ]; then
     trace
 fi
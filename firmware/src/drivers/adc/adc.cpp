@@ -5,132 +5,165 @@
 // By Breno Cunha Queiroz
 //--------------------------------------------------
 #include <drivers/adc/adc.h>
+#include <drivers/dma/streamBuffer.h>
 #include <drivers/gpio/gpio.h>
+#include <drivers/timer/timer.h>
 #include <system/hal.h>
+#include <utils/log.h>
 
 namespace Adc {
 
-constexpr uint32_t timeout = 100; ///< Timeout 100ms
+constexpr size_t NUM_PERIPHERALS = 3;
 
 ADC_HandleTypeDef hadc1;
 ADC_HandleTypeDef hadc2;
 ADC_HandleTypeDef hadc3;
 
-enum Channel : uint32_t {
-    CH0 = ADC_CHANNEL_0,
-    CH1 = ADC_CHANNEL_1,
-    CH2 = ADC_CHANNEL_2,
-    CH3 = ADC_CHANNEL_3,
-    CH4 = ADC_CHANNEL_4,
-    CH5 = ADC_CHANNEL_5,
-    CH6 = ADC_CHANNEL_6,
-    CH7 = ADC_CHANNEL_7,
-    CH8 = ADC_CHANNEL_8,
-    CH9 = ADC_CHANNEL_9,
-    CH10 = ADC_CHANNEL_10,
-    CH11 = ADC_CHANNEL_11,
-    CH12 = ADC_CHANNEL_12,
-    CH13 = ADC_CHANNEL_13,
-    CH14 = ADC_CHANNEL_14,
-    CH15 = ADC_CHANNEL_15,
-    CH16 = ADC_CHANNEL_16,
-    CH17 = ADC_CHANNEL_17,
-    CH18 = ADC_CHANNEL_18,
-    CH_INVALID,
-};
-// ADC additional functions
-struct AdcAF {
-    Gpio::Gpio gpio;
-    Peripheral peripheral;
-    Channel channel;
+// Acquisition state of a peripheral
+struct Acquisition {
+    uint8_t numChannels;             ///< Frame length
+    uint8_t numInjected;             ///< Injected channels (0 or 1)
+    const uint16_t* volatile latest; ///< Last completed frame (nullptr if none)
+    Callback callback;
 };
+std::array<Acquisition, NUM_PERIPHERALS> _acquisitions{};
 
-// clang-format off
-static const std::array _adcAF{
-    AdcAF{Gpio::PA0, Peripheral::ADC1, Channel::CH0},
-    AdcAF{Gpio::PA0, Peripheral::ADC2, Channel::CH0},
-    AdcAF{Gpio::PA0, Peripheral::ADC3, Channel::CH0},
-    AdcAF{Gpio::PA1, Peripheral::ADC1, Channel::CH1},
-    AdcAF{Gpio::PA1, Peripheral::ADC2, Channel::CH1},
-    AdcAF{Gpio::PA1, Peripheral::ADC3, Channel::CH1},
-    AdcAF{Gpio::PA2, Peripheral::ADC1, Channel::CH2},
-    AdcAF{Gpio::PA2, Peripheral::ADC2, Channel::CH2},
-    AdcAF{Gpio::PA2, Peripheral::ADC3, Channel::CH2},
-    AdcAF{Gpio::PA3, Peripheral::ADC1, Channel::CH3},
-    AdcAF{Gpio::PA3, Peripheral::ADC2, Channel::CH3},
-    AdcAF{Gpio::PA3, Peripheral::ADC3, Channel::CH3},
-    AdcAF{Gpio::PA4, Peripheral::ADC1, Channel::CH4},
-    AdcAF{Gpio::PA4, Peripheral::ADC2, Channel::CH4},
-    AdcAF{Gpio::PA5, Peripheral::ADC1, Channel::CH5},
-    AdcAF{Gpio::PA5, Peripheral::ADC2, Channel::CH5},
-    AdcAF{Gpio::PA6, Peripheral::ADC1, Channel::CH6},
-    AdcAF{Gpio::PA6, Peripheral::ADC2, Channel::CH6},
-    AdcAF{Gpio::PA7, Peripheral::ADC1, Channel::CH7},
-    AdcAF{Gpio::PA7, Peripheral::ADC2, Channel::CH7},
-    AdcAF{Gpio::PB0, Peripheral::ADC1, Channel::CH8},
-    AdcAF{Gpio::PB0, Peripheral::ADC2, Channel::CH8},
-    AdcAF{Gpio::PB1, Peripheral::ADC1, Channel::CH9},
-    AdcAF{Gpio::PB1, Peripheral::ADC2, Channel::CH9},
-    AdcAF{Gpio::PC0, Peripheral::ADC1, Channel::CH10},
-    AdcAF{Gpio::PC0, Peripheral::ADC2, Channel::CH10},
-    AdcAF{Gpio::PC0, Peripheral::ADC3, Channel::CH10},
-    AdcAF{Gpio::PC1, Peripheral::ADC1, Channel::CH11},
-    AdcAF{Gpio::PC1, Peripheral::ADC2, Channel::CH11},
-    AdcAF{Gpio::PC1, Peripheral::ADC3, Channel::CH11},
-    AdcAF{Gpio::PC2, Peripheral::ADC1, Channel::CH12},
-    AdcAF{Gpio::PC2, Peripheral::ADC2, Channel::CH12},
-    AdcAF{Gpio::PC2, Peripheral::ADC3, Channel::CH12},
-    AdcAF{Gpio::PC3, Peripheral::ADC1, Channel::CH13},
-    AdcAF{Gpio::PC3, Peripheral::ADC2, Channel::CH13},
-    AdcAF{Gpio::PC3, Peripheral::ADC3, Channel::CH13},
-    AdcAF{Gpio::PC4, Peripheral::ADC1, Channel::CH14},
-    AdcAF{Gpio::PC4, Peripheral::ADC2, Channel::CH14},
-    AdcAF{Gpio::PC5, Peripheral::ADC1, Channel::CH15},
-    AdcAF{Gpio::PC5, Peripheral::ADC2, Channel::CH15}
-};
-// clang-format on
+// Regular frames, the DMA fills one buffer while the other one holds the last frame
+static_assert(countChannels(Peripheral::ADC2, Group::REGULAR) == 0 && countChannels(Peripheral::ADC3, Group::REGULAR) == 0,
+              "Only ADC1 has a regular group DMA stream (ADC_VOLT_STREAM)");
+Dma::StreamBuffer<Dma::ADC_DMA, Dma::ADC_VOLT_STREAM, uint16_t, countChannels(Peripheral::ADC1, Group::REGULAR)> _frames;
+
+// Injected conversions
+std::array<uint16_t, NUM_PERIPHERALS> _injected{}; ///< Last injected sample of each ADC
+volatile uint32_t _injectedSequence = 0;           ///< Number of injected conversions (odd while writing)
+InjectedCallback _injectedCallback = nullptr;
 
-Peripheral getPeripheral(Gpio::Gpio gpio);
-ADC_HandleTypeDef* getHandle(Peripheral peripheral);
+// Internal functions to be called by the DMA complete ISR and the injected complete ISR
+void frameComplete(uint16_t* frame, void* context);
+void injectedComplete(ADC_HandleTypeDef* hadc);
+
+bool initInjected(Peripheral peripheral, const AdcConfig& cfg, Channel channel);
 ADC_TypeDef* getInstance(Peripheral peripheral);
-Channel getChannel(Gpio::Gpio gpio, Peripheral peripheral);
 void enableClock(Peripheral peripheral);
 void disableClock(Peripheral peripheral);
 
+uint32_t convert(SampleTime sampleTime);
+
 } // namespace Adc
 
 bool Adc::init() {
-    // Initialize ADCs
-    std::array<bool, 3> usedAdc = {false, false, false};
-    for (const AdcConfig& adcConfig : adcList)
-        usedAdc[int(adcConfig.peripheral) - 1] = true;
-    for (size_t i = 0; i < usedAdc.size(); i++) {
-        if (usedAdc[i]) {
-            Peripheral peripheral = Peripheral(i + 1);
-            enableClock(peripheral);
-
-            ADC_HandleTypeDef* handle = getHandle(peripheral);
-            handle->Instance = getInstance(peripheral);
-            handle->Init.ClockPrescaler = ADC_CLOCK_SYNC_PCLK_DIV2;
-            handle->Init.Resolution = ADC_RESOLUTION_12B;
-            handle->Init.ScanConvMode = DISABLE;
-            handle->Init.ContinuousConvMode = DISABLE;
-            handle->Init.DiscontinuousConvMode = DISABLE;
-            handle->Init.NbrOfDiscConversion = 0;
-            handle->Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
-            handle->Init.ExternalTrigConv = ADC_SOFTWARE_START;
-            handle->Init.DataAlign = ADC_DATAALIGN_RIGHT;
-            handle->Init.NbrOfConversion = 1;
-            handle->Init.DMAContinuousRequests = DISABLE;
-            handle->Init.EOCSelection = ADC_EOC_SINGLE_CONV;
-            if (HAL_ADC_Init(handle) != HAL_OK)
+    // Regular group has no TIM1 trigger, the motor timer update is relayed by ADC_TIM
+    static_assert(Timer::ADC_TIM == Timer::TIM3, "ADC external trigger is configured as T3_TRGO");
+    // Injected group is triggered by the motor timer compare channel
+    static_assert(Timer::MOTOR_TIM == Timer::TIM1 && Timer::MOTOR_CH_ADC == Timer::CH4, "ADC injected trigger is configured as T1_CC4");
+
+    // Initialize ADCs (channel counts and routes are resolved at compile time)
+    constexpr std::array<uint8_t, NUM_PERIPHERALS> numChannels = {
+        countChannels(Peripheral::ADC1, Group::REGULAR),
+        countChannels(Peripheral::ADC2, Group::REGULAR),
+        countChannels(Peripheral::ADC3, Group::REGULAR),
+    };
+    constexpr std::array<uint8_t, NUM_PERIPHERALS> numInjected = {
+        countChannels(Peripheral::ADC1, Group::INJECTED),
+        countChannels(Peripheral::ADC2, Group::INJECTED),
+        countChannels(Peripheral::ADC3, Group::INJECTED),
+    };
+    for (size_t i = 0; i < NUM_PERIPHERALS; i++) {
+        if (numChannels[i] == 0 && numInjected[i] == 0)
+            continue;
+        Peripheral peripheral = Peripheral(i + 1);
+        Acquisition& acq = _acquisitions[i];
+        acq.numChannels = numChannels[i];
+        acq.numInjected = numInjected[i];
+        acq.latest = nullptr;
+        enableClock(peripheral);
+
+        ADC_HandleTypeDef* handle = getHandle(peripheral);
+        handle->Instance = getInstance(peripheral);
+        handle->Init.ClockPrescaler = ADC_CLOCK_SYNC_PCLK_DIV2;
+        handle->Init.Resolution = ADC_RESOLUTION_12B;
+        handle->Init.ScanConvMode = acq.numChannels ? ENABLE : DISABLE;
+        handle->Init.ContinuousConvMode = DISABLE;
+        handle->Init.DiscontinuousConvMode = DISABLE;
+        handle->Init.NbrOfDiscConversion = 0;
+        // ADCs with only injected channels must not run regular conversions on the trigger
+        handle->Init.ExternalTrigConvEdge = acq.numChannels ? ADC_EXTERNALTRIGCONVEDGE_RISING : ADC_EXTERNALTRIGCONVEDGE_NONE;
+        handle->Init.ExternalTrigConv = acq.numChannels ? ADC_EXTERNALTRIGCONV_T3_TRGO : ADC_SOFTWARE_START;
+        handle->Init.DataAlign = ADC_DATAALIGN_RIGHT;
+        handle->Init.NbrOfConversion = acq.numChannels ? acq.numChannels : 1;
+        handle->Init.DMAContinuousRequests = ENABLE;
+        handle->Init.EOCSelection = ADC_EOC_SEQ_CONV;
+        if (HAL_ADC_Init(handle) != HAL_OK) {
+            LOG_ERROR("Adc", "Failed to initialize ADC$0", i + 1);
+            return false;
+        }
+
+        // Regular sequence in adcList order
+        for (size_t j = 0; j < adcList.size(); j++) {
+            const Route& route = routes[j];
+            if (route.peripheral != peripheral)
+                continue;
+            if (route.group == Group::INJECTED) {
+                if (!initInjected(peripheral, adcList[j], route.channel))
+                    return false;
+                continue;
+            }
+            ADC_ChannelConfTypeDef sConfig = {0};
+            sConfig.Channel = static_cast<uint32_t>(route.channel);
+            sConfig.Rank = route.index + 1;
+            sConfig.SamplingTime = convert(adcList[j].sampleTime);
+            if (HAL_ADC_ConfigChannel(handle, &sConfig) != HAL_OK)
                 return false;
         }
     }
+
+    // Triple simultaneous injected mode, regular groups keep converting independently
+    if (_acquisitions[0].numInjected || _acquisitions[1].numInjected || _acquisitions[2].numInjected) {
+        ADC_MultiModeTypeDef multiMode{};
+        multiMode.Mode = ADC_TRIPLEMODE_INJECSIMULT;
+        multiMode.DMAAccessMode = ADC_DMAACCESSMODE_DISABLED;
+        multiMode.TwoSamplingDelay = ADC_TWOSAMPLINGDELAY_5CYCLES;
+        if (HAL_ADCEx_MultiModeConfigChannel(getHandle(Peripheral::ADC1), &multiMode) != HAL_OK) {
+            LOG_ERROR("Adc", "Failed to configure triple injected simultaneous mode");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Adc::initInjected(Peripheral peripheral, const AdcConfig& cfg, Channel channel) {
+    // Only the master (ADC1) trigger is used in multimode
+    ADC_InjectionConfTypeDef sConfigInjected{};
+    sConfigInjected.InjectedChannel = static_cast<uint32_t>(channel);
+    sConfigInjected.InjectedRank = 1;
+    sConfigInjected.InjectedNbrOfConversion = 1;
+    sConfigInjected.InjectedSamplingTime = convert(cfg.sampleTime);
+    sConfigInjected.InjectedOffset = 0;
+    sConfigInjected.InjectedDiscontinuousConvMode = DISABLE;
+    sConfigInjected.AutoInjectedConv = DISABLE;
+    if (peripheral == Peripheral::ADC1) {
+        sConfigInjected.ExternalTrigInjecConv = ADC_EXTERNALTRIGINJECCONV_T1_CC4;
+        sConfigInjected.ExternalTrigInjecConvEdge = ADC_EXTERNALTRIGINJECCONVEDGE_RISING;
+    } else {
+        sConfigInjected.ExternalTrigInjecConv = ADC_INJECTED_SOFTWARE_START;
+        sConfigInjected.ExternalTrigInjecConvEdge = ADC_EXTERNALTRIGINJECCONVEDGE_NONE;
+    }
+    if (HAL_ADCEx_InjectedConfigChannel(getHandle(peripheral), &sConfigInjected) != HAL_OK) {
+        LOG_ERROR("Adc", "Failed to configure injected channel of ADC$0", int(peripheral));
+        return false;
+    }
     return true;
 }
 
 bool Adc::deinit() {
+    if (_acquisitions[0].numChannels) {
+        ADC_HandleTypeDef* handle = getHandle(Peripheral::ADC1);
+        HAL_ADC_Stop(handle);
+        CLEAR_BIT(handle->Instance->CR2, ADC_CR2_DMA);
+        _frames.stop();
+    }
+    if (_acquisitions[0].numInjected)
+        HAL_ADCEx_InjectedStop_IT(getHandle(Peripheral::ADC1));
     HAL_ADC_DeInit(getHandle(Peripheral::ADC1));
     HAL_ADC_DeInit(getHandle(Peripheral::ADC2));
     HAL_ADC_DeInit(getHandle(Peripheral::ADC3));
@@ -140,45 +173,96 @@ bool Adc::deinit() {
     return true;
 }
 
-uint16_t Adc::read(Gpio::Gpio gpio) {
-    Peripheral peripheral = getPeripheral(gpio);
-    Channel channel = getChannel(gpio, peripheral);
-    if (channel == Channel::CH_INVALID)
-        return 0xFFFF;
+bool Adc::start() {
+    // Regular sequence of ADC1, each trigger requests one DMA item per channel and the stream switches buffers after a frame
+    Acquisition& acq = _acquisitions[0];
+    if (acq.numChannels) {
+        ADC_HandleTypeDef* handle = getHandle(Peripheral::ADC1);
+        acq.latest = nullptr;
+        if (!_frames.start(uint32_t(uintptr_t(&handle->Instance->DR)), frameComplete)) {
+            LOG_ERROR("Adc", "Failed to start ADC1 DMA stream");
+            return false;
+        }
+        SET_BIT(handle->Instance->CR2, ADC_CR2_DMA);
+        if (HAL_ADC_Start(handle) != HAL_OK) {
+            LOG_ERROR("Adc", "Failed to start ADC1");
+            return false;
+        }
+    }
 
-    ADC_HandleTypeDef* handle = getHandle(peripheral);
+    // Slaves only need to be enabled, conversions are started by the master trigger
+    for (size_t i = NUM_PERIPHERALS; i-- > 0;) {
+        if (_acquisitions[i].numInjected == 0)
+            continue;
+        ADC_HandleTypeDef* handle = getHandle(Peripheral(i + 1));
+        if (i == 0) {
+            if (HAL_ADCEx_InjectedStart_IT(handle) != HAL_OK) {
+                LOG_ERROR("Adc", "Failed to start injected conversions");
+                return false;
+            }
+        } else
+            __HAL_ADC_ENABLE(handle);
+    }
 
-    // Configure the specific channel before reading
-    ADC_ChannelConfTypeDef sConfig = {0};
-    sConfig.Channel = static_cast<uint32_t>(channel);
-    sConfig.Rank = 1;
-    sConfig.SamplingTime = ADC_SAMPLETIME_480CYCLES; // Low noise setting
-    if (HAL_ADC_ConfigChannel(handle, &sConfig) != HAL_OK)
-        return 0xFFFF;
+    LOG_SUCCESS("Adc", "Acquisition started");
+    return true;
+}
 
-    // Start ADC conversion
-    if (HAL_ADC_Start(handle) != HAL_OK)
+uint16_t Adc::read(Source source) {
+    if (source >= routes.size())
         return 0xFFFF;
+    const Route& route = routes[source];
+    if (route.group == Group::INJECTED)
+        return _injectedSequence ? _injected[int(route.peripheral) - 1] : 0xFFFF;
 
-    // Wait for the ADC conversion to complete
-    if (HAL_ADC_PollForConversion(handle, timeout) != HAL_OK)
-        return 0xFFFF;
+    const uint16_t* frame = getFrame(route.peripheral);
+    return frame ? frame[route.index] : 0xFFFF;
+}
 
-    uint16_t value = HAL_ADC_GetValue(handle);
+const uint16_t* Adc::getFrame(Peripheral peripheral) { return _acquisitions[int(peripheral) - 1].latest; }
 
-    // Stop ADC
-    if (HAL_ADC_Stop(handle) != HAL_OK)
-        return 0xFFFF;
+void Adc::setCallback(Peripheral peripheral, Callback callback) { _acquisitions[int(peripheral) - 1].callback = callback; }
+
+bool Adc::readSimultaneous(const std::array<Source, 3>& sources, std::array<uint16_t, 3>& values) {
+    std::array<uint8_t, 3> index;
+    for (size_t i = 0; i < sources.size(); i++) {
+        if (sources[i] >= routes.size() || routes[sources[i]].group != Group::INJECTED)
+            return false;
+        index[i] = int(routes[sources[i]].peripheral) - 1;
+    }
+
+    uint32_t sequence;
+    do {
+        sequence = _injectedSequence;
+        for (size_t i = 0; i < values.size(); i++)
+            values[i] = _injected[index[i]];
+    } while ((sequence & 1) || sequence != _injectedSequence); // Written while copying
+    return sequence != 0;
+}
 
-    // Get
-    return value;
+void Adc::setInjectedCallback(InjectedCallback callback) { _injectedCallback = callback; }
+
+void Adc::injectedComplete(ADC_HandleTypeDef* hadc) {
+    if (hadc != &hadc1)
+        return;
+    Gpio::Probe probe(Gpio::DEBUG0_PIN); // Injected ISR duration (current loop budget)
+
+    // Conversions of the three ADCs finish together (same sampling time)
+    _injectedSequence = _injectedSequence + 1;
+    for (size_t i = 0; i < NUM_PERIPHERALS; i++)
+        if (_acquisitions[i].numInjected)
+            _injected[i] = getInstance(Peripheral(i + 1))->JDR1;
+    _injectedSequence = _injectedSequence + 1;
+
+    if (_injectedCallback)
+        _injectedCallback(_injected);
 }
 
-Adc::Peripheral Adc::getPeripheral(Gpio::Gpio gpio) {
-    for (size_t i = 0; i < adcList.size(); i++)
-        if (adcList[i].gpio == gpio)
-            return adcList[i].peripheral;
-    return Peripheral::ADC1;
+void Adc::frameComplete(uint16_t* frame, void*) {
+    Acquisition& acq = _acquisitions[0];
+    acq.latest = frame;
+    if (acq.callback)
+        acq.callback(Peripheral::ADC1, frame);
 }
 
 ADC_HandleTypeDef* Adc::getHandle(Peripheral peripheral) {
@@ -211,13 +295,6 @@ ADC_TypeDef* Adc::getInstance(Peripheral peripheral) {
     return nullptr;
 }
 
-Adc::Channel Adc::getChannel(Gpio::Gpio gpio, Peripheral peripheral) {
-    for (const auto& af : _adcAF)
-        if (af.gpio == gpio && af.peripheral == peripheral)
-            return af.channel;
-    return Channel::CH_INVALID;
-}
-
 void Adc::enableClock(Peripheral peripheral) {
     switch (peripheral) {
         case Peripheral::ADC1:
@@ -245,3 +322,33 @@ void Adc::disableClock(Peripheral peripheral) {
             break;
     }
 }
+
+uint32_t Adc::convert(SampleTime sampleTime) {
+    switch (sampleTime) {
+        case SampleTime::CYCLES_3:
+            return ADC_SAMPLETIME_3CYCLES;
+        case SampleTime::CYCLES_15:
+            return ADC_SAMPLETIME_15CYCLES;
+        case SampleTime::CYCLES_28:
+            return ADC_SAMPLETIME_28CYCLES;
+        case SampleTime::CYCLES_56:
+            return ADC_SAMPLETIME_56CYCLES;
+        case SampleTime::CYCLES_84:
+            return ADC_SAMPLETIME_84CYCLES;
+        case SampleTime::CYCLES_112:
+            return ADC_SAMPLETIME_112CYCLES;
+        case SampleTime::CYCLES_144:
+            return ADC_SAMPLETIME_144CYCLES;
+        case SampleTime::CYCLES_480:
+            return ADC_SAMPLETIME_480CYCLES;
+        default:
+            return ADC_SAMPLETIME_480CYCLES; // Default to low noise
+    }
+}
+
+// --- HAL Callback Implementations ---
+extern "C" {
+
+void HAL_ADCEx_InjectedConvCpltCallback(ADC_HandleTypeDef* hadc) { Adc::injectedComplete(hadc); }
+
+} // extern "C"
@@ -6,40 +6,322 @@
 //--------------------------------------------------
 #ifndef BLDC_DRIVERS_ADC_ADC_H
 #define BLDC_DRIVERS_ADC_ADC_H
+#include <drivers/dma/dma.h>
 #include <drivers/gpio/gpio.h>
+#include <system/hal.h>
 
 namespace Adc {
 
+enum class Peripheral : uint8_t { ADC1 = 1, ADC2, ADC3 };
+using Source = uint8_t; ///< Index of a channel in adcList, resolved at compile time with getSource()
+
+/**
+ * @brief Initialize ADC driver
+ *
+ * Each ADC in use scans its channels from adcList (in list order) on every trigger timer event
+ */
 bool init();
 
 bool deinit();
 
-uint16_t read(Gpio::Gpio gpio);
+/**
+ * @brief Start acquisition
+ *
+ * Must be called after Dma::init(). Conversions are written by the DMA into a Dma::StreamBuffer of frames, one frame
+ * (one sample per channel) is completed every trigger
+ *
+ * @return True if all ADCs in use were started
+ */
+bool start();
+
+/**
+ * @brief Read latest sample
+ *
+ * Does not block, returns the sample of the last completed frame. The frame position was resolved at compile time,
+ * so no lookup is performed
+ *
+ * @param source ADC source
+ *
+ * @return Raw 12-bit value, 0xFFFF if the source is invalid or no frame was completed yet
+ */
+uint16_t read(Source source);
+
+/**
+ * @brief Get latest completed frame
+ *
+ * @param peripheral ADC peripheral
+ *
+ * @return Raw samples in adcList order (only channels of this peripheral), nullptr if no frame was completed yet
+ */
+const uint16_t* getFrame(Peripheral peripheral);
+
+/**
+ * @brief Frame complete callback
+ *
+ * Called from the DMA interrupt when a frame is completed, the frame stays valid until the next trigger
+ *
+ * @param peripheral ADC peripheral
+ * @param frame Raw samples in adcList order
+ */
+using Callback = void (*)(Peripheral peripheral, const uint16_t* frame);
+
+/**
+ * @brief Set frame complete callback
+ *
+ * @param peripheral ADC peripheral
+ * @param callback Callback (nullptr to disable)
+ */
+void setCallback(Peripheral peripheral, Callback callback);
+
+/**
+ * @brief Read injected samples taken at the same instant
+ *
+ * Injected channels of ADC1, ADC2 and ADC3 are converted in triple simultaneous mode, so the samples returned come
+ * from the same trigger
+ *
+ * @param sources Injected sources (each one on a different ADC)
+ * @param values Raw 12-bit values
+ *
+ * @return False if a source is not an injected channel or no conversion was completed yet
+ */
+bool readSimultaneous(const std::array<Source, 3>& sources, std::array<uint16_t, 3>& values);
+
+/**
+ * @brief Injected conversion complete callback
+ *
+ * Called from the ADC interrupt after the simultaneous injected conversion
+ *
+ * @param samples Raw injected sample of each ADC (ADC1, ADC2, ADC3)
+ */
+using InjectedCallback = void (*)(const std::array<uint16_t, 3>& samples);
+
+/**
+ * @brief Set injected conversion complete callback
+ *
+ * @param callback Callback (nullptr to disable)
+ */
+void setInjectedCallback(InjectedCallback callback);
+
+/**
+ * @brief Get ADC handle
+ *
+ * @param peripheral ADC peripheral
+ *
+ * @return ADC handle
+ */
+ADC_HandleTypeDef* getHandle(Peripheral peripheral);
 
 constexpr float MAX_READ = 4095;
 
 //---------- ADC configs ----------//
-enum class Peripheral : uint8_t { ADC1 = 1, ADC2, ADC3 };
+// ADC clock is 36MHz (APB2/2), conversion time is sampling time + 12 cycles
+enum class SampleTime : uint8_t { CYCLES_3 = 0, CYCLES_15, CYCLES_28, CYCLES_56, CYCLES_84, CYCLES_112, CYCLES_144, CYCLES_480 };
+
+/**
+ * @brief Conversion group
+ *
+ * Regular channels are scanned on ADC_TIM events and written by DMA. Injected channels (one per ADC) are converted
+ * simultaneously on the motor timer compare trigger, placed at the center of the low-side on-time
+ */
+enum class Group : uint8_t { REGULAR = 0, INJECTED };
 
 struct AdcConfig {
     Gpio::Gpio gpio;
     Peripheral peripheral;
+    SampleTime sampleTime;
+    Group group = Group::REGULAR;
+};
+
+// clang-format off
+inline constexpr std::array adcList{
+    // Voltage sense (4 x 68 cycles, 7.6us)
+    AdcConfig{Gpio::VOLT_SRC_PIN, Peripheral::ADC1, SampleTime::CYCLES_56},
+    AdcConfig{Gpio::VOLT_U_PIN,   Peripheral::ADC1, SampleTime::CYCLES_56},
+    AdcConfig{Gpio::VOLT_V_PIN,   Peripheral::ADC1, SampleTime::CYCLES_56},
+    AdcConfig{Gpio::VOLT_W_PIN,   Peripheral::ADC1, SampleTime::CYCLES_56},
+    // Current sense (simultaneous, 40 cycles, 1.1us)
+    AdcConfig{Gpio::CURR_U_PIN,   Peripheral::ADC1, SampleTime::CYCLES_28, Group::INJECTED},
+    AdcConfig{Gpio::CURR_V_PIN,   Peripheral::ADC2, SampleTime::CYCLES_28, Group::INJECTED},
+    AdcConfig{Gpio::CURR_W_PIN,   Peripheral::ADC3, SampleTime::CYCLES_28, Group::INJECTED},
+};
+// clang-format on
+
+//---------- Compile-time routing ----------//
+constexpr size_t MAX_CHANNELS = 16; ///< Maximum regular sequence length
+constexpr Source INVALID_SOURCE = 0xFF;
+
+enum Channel : uint32_t {
+    CH0 = ADC_CHANNEL_0,
+    CH1 = ADC_CHANNEL_1,
+    CH2 = ADC_CHANNEL_2,
+    CH3 = ADC_CHANNEL_3,
+    CH4 = ADC_CHANNEL_4,
+    CH5 = ADC_CHANNEL_5,
+    CH6 = ADC_CHANNEL_6,
+    CH7 = ADC_CHANNEL_7,
+    CH8 = ADC_CHANNEL_8,
+    CH9 = ADC_CHANNEL_9,
+    CH10 = ADC_CHANNEL_10,
+    CH11 = ADC_CHANNEL_11,
+    CH12 = ADC_CHANNEL_12,
+    CH13 = ADC_CHANNEL_13,
+    CH14 = ADC_CHANNEL_14,
+    CH15 = ADC_CHANNEL_15,
+    CH16 = ADC_CHANNEL_16,
+    CH17 = ADC_CHANNEL_17,
+    CH18 = ADC_CHANNEL_18,
+    CH_INVALID,
+};
+
+// ADC additional functions
+struct AdcAF {
+    Gpio::Gpio gpio;
+    Peripheral peripheral;
+    Channel channel;
 };
 
 // clang-format off
-inline const std::array adcList{
-    // Voltage sense
-    AdcConfig{Gpio::VOLT_SRC_PIN, Peripheral::ADC1},
-    AdcConfig{Gpio::VOLT_U_PIN, Peripheral::ADC1},
-    AdcConfig{Gpio::VOLT_V_PIN, Peripheral::ADC1},
-    AdcConfig{Gpio::VOLT_W_PIN, Peripheral::ADC1},
-    // Current sense
-    AdcConfig{Gpio::CURR_U_PIN, Peripheral::ADC2},
-    AdcConfig{Gpio::CURR_V_PIN, Peripheral::ADC2},
-    AdcConfig{Gpio::CURR_W_PIN, Peripheral::ADC2},
+inline constexpr std::array adcAF{
+    AdcAF{Gpio::PA0, Peripheral::ADC1, Channel::CH0},
+    AdcAF{Gpio::PA0, Peripheral::ADC2, Channel::CH0},
+    AdcAF{Gpio::PA0, Peripheral::ADC3, Channel::CH0},
+    AdcAF{Gpio::PA1, Peripheral::ADC1, Channel::CH1},
+    AdcAF{Gpio::PA1, Peripheral::ADC2, Channel::CH1},
+    AdcAF{Gpio::PA1, Peripheral::ADC3, Channel::CH1},
+    AdcAF{Gpio::PA2, Peripheral::ADC1, Channel::CH2},
+    AdcAF{Gpio::PA2, Peripheral::ADC2, Channel::CH2},
+    AdcAF{Gpio::PA2, Peripheral::ADC3, Channel::CH2},
+    AdcAF{Gpio::PA3, Peripheral::ADC1, Channel::CH3},
+    AdcAF{Gpio::PA3, Peripheral::ADC2, Channel::CH3},
+    AdcAF{Gpio::PA3, Peripheral::ADC3, Channel::CH3},
+    AdcAF{Gpio::PA4, Peripheral::ADC1, Channel::CH4},
+    AdcAF{Gpio::PA4, Peripheral::ADC2, Channel::CH4},
+    AdcAF{Gpio::PA5, Peripheral::ADC1, Channel::CH5},
+    AdcAF{Gpio::PA5, Peripheral::ADC2, Channel::CH5},
+    AdcAF{Gpio::PA6, Peripheral::ADC1, Channel::CH6},
+    AdcAF{Gpio::PA6, Peripheral::ADC2, Channel::CH6},
+    AdcAF{Gpio::PA7, Peripheral::ADC1, Channel::CH7},
+    AdcAF{Gpio::PA7, Peripheral::ADC2, Channel::CH7},
+    AdcAF{Gpio::PB0, Peripheral::ADC1, Channel::CH8},
+    AdcAF{Gpio::PB0, Peripheral::ADC2, Channel::CH8},
+    AdcAF{Gpio::PB1, Peripheral::ADC1, Channel::CH9},
+    AdcAF{Gpio::PB1, Peripheral::ADC2, Channel::CH9},
+    AdcAF{Gpio::PC0, Peripheral::ADC1, Channel::CH10},
+    AdcAF{Gpio::PC0, Peripheral::ADC2, Channel::CH10},
+    AdcAF{Gpio::PC0, Peripheral::ADC3, Channel::CH10},
+    AdcAF{Gpio::PC1, Peripheral::ADC1, Channel::CH11},
+    AdcAF{Gpio::PC1, Peripheral::ADC2, Channel::CH11},
+    AdcAF{Gpio::PC1, Peripheral::ADC3, Channel::CH11},
+    AdcAF{Gpio::PC2, Peripheral::ADC1, Channel::CH12},
+    AdcAF{Gpio::PC2, Peripheral::ADC2, Channel::CH12},
+    AdcAF{Gpio::PC2, Peripheral::ADC3, Channel::CH12},
+    AdcAF{Gpio::PC3, Peripheral::ADC1, Channel::CH13},
+    AdcAF{Gpio::PC3, Peripheral::ADC2, Channel::CH13},
+    AdcAF{Gpio::PC3, Peripheral::ADC3, Channel::CH13},
+    AdcAF{Gpio::PC4, Peripheral::ADC1, Channel::CH14},
+    AdcAF{Gpio::PC4, Peripheral::ADC2, Channel::CH14},
+    AdcAF{Gpio::PC5, Peripheral::ADC1, Channel::CH15},
+    AdcAF{Gpio::PC5, Peripheral::ADC2, Channel::CH15}
 };
 // clang-format on
 
+/**
+ * @brief Get ADC channel of a GPIO
+ *
+ * @param gpio ADC GPIO
+ * @param peripheral ADC peripheral
+ *
+ * @return ADC channel, CH_INVALID if the GPIO is not an input of the peripheral
+ */
+constexpr Channel getChannel(Gpio::Gpio gpio, Peripheral peripheral) {
+    for (const AdcAF& af : adcAF)
+        if (af.gpio == gpio && af.peripheral == peripheral)
+            return af.channel;
+    return Channel::CH_INVALID;
+}
+
+/**
+ * @brief Get source of a GPIO
+ *
+ * Meant to be evaluated at compile time (or once at init), the hot paths only use the returned index
+ *
+ * @param gpio ADC GPIO
+ *
+ * @return Index in adcList, INVALID_SOURCE if the GPIO is not in adcList
+ */
+constexpr Source getSource(Gpio::Gpio gpio) {
+    for (size_t i = 0; i < adcList.size(); i++)
+        if (adcList[i].gpio == gpio)
+            return Source(i);
+    return INVALID_SOURCE;
+}
+
+/**
+ * @brief Count channels of a peripheral
+ *
+ * @param peripheral ADC peripheral
+ * @param group Conversion group
+ *
+ * @return Number of channels in adcList
+ */
+constexpr uint8_t countChannels(Peripheral peripheral, Group group) {
+    uint8_t count = 0;
+    for (const AdcConfig& adcConfig : adcList)
+        if (adcConfig.peripheral == peripheral && adcConfig.group == group)
+            count++;
+    return count;
+}
+
+// Channel and frame position of each adcList entry
+struct Route {
+    Peripheral peripheral;
+    Group group;
+    Channel channel;
+    uint8_t index; ///< Position in the regular frame (0 for injected channels)
+};
+
+constexpr std::array<Route, adcList.size()> resolveRoutes() {
+    std::array<Route, adcList.size()> routes{};
+    std::array<uint8_t, 3> numRegular = {0, 0, 0};
+    for (size_t i = 0; i < adcList.size(); i++) {
+        const AdcConfig& cfg = adcList[i];
+        uint8_t index = cfg.group == Group::REGULAR ? numRegular[int(cfg.peripheral) - 1]++ : 0;
+        routes[i] = Route{cfg.peripheral, cfg.group, getChannel(cfg.gpio, cfg.peripheral), index};
+    }
+    return routes;
+}
+inline constexpr std::array routes = resolveRoutes();
+
+constexpr bool validAdcList() {
+    for (size_t i = 0; i < adcList.size(); i++) {
+        if (routes[i].channel == Channel::CH_INVALID)
+            return false;
+        for (size_t j = i + 1; j < adcList.size(); j++)
+            if (adcList[i].gpio == adcList[j].gpio)
+                return false;
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        Peripheral peripheral = Peripheral(i + 1);
+        uint8_t numRegular = countChannels(peripheral, Group::REGULAR);
+        if (numRegular > MAX_CHANNELS || countChannels(peripheral, Group::INJECTED) > 1)
+            return false;
+        // Regular frames are written by DMA
+        if (numRegular && !Dma::isUsed(Dma::Request(Dma::ADC1 + i)))
+            return false;
+    }
+    return true;
+}
+static_assert(validAdcList(), "adcList has a GPIO that is not an ADC input, too many channels or a regular group without DMA");
+
+/**
+ * @brief Read latest sample
+ *
+ * @param gpio ADC GPIO (resolved at compile time when it is a constant)
+ *
+ * @return Raw 12-bit value, 0xFFFF if the GPIO is not in adcList or no frame was completed yet
+ */
+inline uint16_t read(Gpio::Gpio gpio) { return read(getSource(gpio)); }
+
 } // namespace Adc
 
 #endif // BLDC_DRIVERS_ADC_ADC_H
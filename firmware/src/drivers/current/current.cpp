@@ -4,35 +4,160 @@
 // Date: 2025-08-31
 // By Breno Cunha Queiroz
 //--------------------------------------------------
+#include <cmath>
 #include <drivers/adc/adc.h>
 #include <drivers/current/current.h>
+#include <drivers/hardware.h>
+#include <drivers/motor/motor.h>
+#include <drivers/storage/storage.h>
 #include <utils/log.h>
 
+uint16_t Current::_zeroVectorPeriods = 0;
+
 bool Current::init(Gpio::Gpio gpio) {
     _gpio = gpio;
-    Log::success("Current", "Initialized for GPIO $0", gpio.toString());
+    _source = Adc::getSource(gpio);
+    if (_source == Adc::INVALID_SOURCE) {
+        LOG_ERROR("Current", "GPIO $0 is not in adcList", gpio.toString());
+        return false;
+    }
+
+    // Nominal calibration (0A at ADC_VREF/2)
+    setCalibration({int32_t(NOMINAL_SCALE), -int32_t(NOMINAL_SCALE * Adc::MAX_READ / 2.0f)});
+    LOG_SUCCESS("Current", "Initialized for GPIO $0", gpio.toString());
     return true;
 }
 
 float Current::read() {
     // Read the raw 12-bit value from the ADC pin
-    uint16_t rawValue = Adc::read(_gpio);
+    uint16_t rawValue = Adc::read(_source);
 
     if (rawValue == 0xFFFF)
         return -1.0f; // Return error value
 
-    // Convert raw ADC value to the voltage at the amplifier's output pin
-    float vOut = (static_cast<float>(rawValue) / Adc::MAX_READ) * ADC_VREF;
+    return convert(rawValue);
+}
+
+std::optional<std::array<float, 3>> Current::readPhases(uint8_t sector) {
+    static_assert(Adc::routes[PHASE_SOURCES[0]].group == Adc::Group::INJECTED && Adc::routes[PHASE_SOURCES[1]].group == Adc::Group::INJECTED &&
+                      Adc::routes[PHASE_SOURCES[2]].group == Adc::Group::INJECTED,
+                  "Phase currents must be injected channels");
+    std::array<uint16_t, 3> raw;
+    if (!Adc::readSimultaneous(PHASE_SOURCES, raw))
+        return std::nullopt;
+    std::array<float, 3> currents = {curr_u_phase.convert(raw[0]), curr_v_phase.convert(raw[1]), curr_w_phase.convert(raw[2])};
+
+    // Phase with the highest duty in each sector (shortest low-side on-time)
+    constexpr std::array<uint8_t, 6> worstPhase = {0, 1, 1, 2, 2, 0};
+    uint8_t worst = worstPhase[sector % 6];
+    currents[worst] = -(currents[(worst + 1) % 3] + currents[(worst + 2) % 3]);
+    return currents;
+}
+
+bool Current::calibrateOffsets(uint16_t numSamples) {
+    std::array<uint32_t, 3> sums;
+    if (numSamples == 0 || !sample(numSamples, sums)) {
+        LOG_ERROR("Current", "Failed to sample offsets");
+        return false;
+    }
+
+    std::array<Current*, 3> phases = {&curr_u_phase, &curr_v_phase, &curr_w_phase};
+    for (size_t i = 0; i < phases.size(); i++) {
+        int32_t rawOffset = (int64_t(sums[i]) << OFFSET_FRACTION) / numSamples;
+        Calibration calibration = phases[i]->_calibration;
+        calibration.offset = -int32_t((int64_t(rawOffset) * calibration.scale) >> OFFSET_FRACTION);
+        phases[i]->setCalibration(calibration);
+    }
+    constexpr float toRaw = 1.0f / (1 << OFFSET_FRACTION);
+    LOG_SUCCESS("Current", "Offsets calibrated: U=$0 V=$1 W=$2", curr_u_phase._rawOffset * toRaw, curr_v_phase._rawOffset * toRaw,
+                curr_w_phase._rawOffset * toRaw);
+    return true;
+}
+
+bool Current::calibrateGain(float expected, uint16_t numSamples) {
+    std::array<uint32_t, 3> sums;
+    if (numSamples == 0 || !sample(numSamples, sums)) {
+        LOG_ERROR("Current", "Failed to sample gain");
+        return false;
+    }
+
+    size_t phase = this == &curr_u_phase ? 0 : (this == &curr_v_phase ? 1 : 2);
+    float measured = convert(sums[phase] / numSamples);
+    if (std::abs(measured) < 0.1f * std::abs(expected) || expected == 0.0f) {
+        LOG_ERROR("Current", "Measured $0A for an injection of $1A, gain not calibrated", measured, expected);
+        return false;
+    }
+
+    // Scale both terms so the zero current point does not move
+    float gain = expected / measured;
+    Calibration calibration = _calibration;
+    calibration.scale = int32_t(calibration.scale * gain);
+    calibration.offset = -int32_t((int64_t(_rawOffset) * calibration.scale) >> OFFSET_FRACTION);
+    setCalibration(calibration);
+    LOG_SUCCESS("Current", "Gain calibrated for GPIO $0 (x$1)", _gpio.toString(), gain);
+    return true;
+}
+
+void Current::startOnlineCalibration() {
+    _zeroVectorPeriods = 0;
+    Adc::setInjectedCallback(refine);
+}
+
+void Current::stopOnlineCalibration() { Adc::setInjectedCallback(nullptr); }
+
+bool Current::loadCalibration() {
+    std::array<Calibration, 3> calibrations;
+    if (!Storage::load(Storage::Id::CURRENT_CALIBRATION, calibrations.data(), sizeof(calibrations)))
+        return false;
+    curr_u_phase.setCalibration(calibrations[0]);
+    curr_v_phase.setCalibration(calibrations[1]);
+    curr_w_phase.setCalibration(calibrations[2]);
+    LOG_SUCCESS("Current", "Calibration loaded");
+    return true;
+}
+
+bool Current::saveCalibration() {
+    std::array<Calibration, 3> calibrations = {curr_u_phase._calibration, curr_v_phase._calibration, curr_w_phase._calibration};
+    return Storage::store(Storage::Id::CURRENT_CALIBRATION, calibrations.data(), sizeof(calibrations));
+}
+
+Current::Calibration Current::getCalibration() const { return _calibration; }
 
-    // For bidirectional mode, subtract the reference offset (Vref/2).
-    // 0A of current corresponds to an output voltage of Vref/2.
-    float vOutSigned = vOut - (ADC_VREF / 2.0f);
+void Current::setCalibration(const Calibration& calibration) {
+    _calibration = calibration;
+    _rawOffset = calibration.scale ? int32_t((-int64_t(calibration.offset) << OFFSET_FRACTION) / calibration.scale) : 0;
+}
 
-    // Convert the signed amplifier output voltage to the voltage across the shunt resistor
-    float vShunt = vOutSigned / AMPLIFIER_GAIN;
+float Current::convert(uint16_t raw) const { return (int32_t(raw) * _calibration.scale + _calibration.offset) * SCALE_TO_AMPS; }
+
+bool Current::sample(uint16_t numSamples, std::array<uint32_t, 3>& sums) {
+    sums = {0, 0, 0};
+    for (uint16_t i = 0; i < numSamples; i++) {
+        std::array<uint16_t, 3> raw;
+        if (!Adc::readSimultaneous(PHASE_SOURCES, raw))
+            return false;
+        for (size_t j = 0; j < raw.size(); j++)
+            sums[j] += raw[j];
+        Hardware::delayUs(50); // One conversion per PWM period (41.7us)
+    }
+    return true;
+}
 
-    // Use Ohm's Law to calculate the current
-    float current = vShunt / SHUNT_RESISTANCE;
+void Current::refine(const std::array<uint16_t, 3>&) {
+    // Current decays after the last active vector, wait before using the samples
+    if (!motor.isZeroVector()) {
+        _zeroVectorPeriods = 0;
+        return;
+    }
+    if (_zeroVectorPeriods < ONLINE_SETTLE) {
+        _zeroVectorPeriods++;
+        return;
+    }
 
-    return current;
+    // The state keeps ONLINE_SHIFT bits below Q8, so the floor of the shift does not bias the offset low
+    for (Current* phase : {&curr_u_phase, &curr_v_phase, &curr_w_phase}) {
+        int32_t raw = Adc::read(phase->_source);
+        phase->_rawOffset += ((raw << OFFSET_FRACTION) - phase->_rawOffset) >> ONLINE_SHIFT;
+        phase->_calibration.offset = -int32_t((int64_t(phase->_rawOffset) * phase->_calibration.scale) >> OFFSET_FRACTION);
+    }
 }
@@ -6,21 +6,127 @@
 //--------------------------------------------------
 #ifndef BLDC_DRIVERS_CURRENT_CURRENT_H
 #define BLDC_DRIVERS_CURRENT_CURRENT_H
+#include <array>
+#include <cstdint>
+#include <drivers/adc/adc.h>
 #include <drivers/gpio/gpio.h>
+#include <optional>
 
 class Current {
   public:
+    /**
+     * @brief Sensor calibration
+     *
+     * Raw value to current is a single integer multiply-add: amps = (raw * scale + offset) * SCALE_TO_AMPS
+     */
+    struct Calibration {
+        int32_t scale;  ///< Milliamps per LSB in Q16
+        int32_t offset; ///< Zero current offset (-rawOffset * scale)
+    };
+
     bool init(Gpio::Gpio gpio);
 
     float read();
 
+    /**
+     * @brief Read the three phase currents from the same simultaneous sample
+     *
+     * Two-shunt reconstruction: the phase with the highest duty in the sector has the shortest low-side on-time, so
+     * its sample is the least reliable one and it is computed from the other two (iu + iv + iw = 0)
+     *
+     * @param sector Space vector sector (0-5) of the applied voltage, from Motor::getSector()
+     *
+     * @return U, V and W currents in amperes, nullopt if no sample was taken yet
+     */
+    static std::optional<std::array<float, 3>> readPhases(uint8_t sector);
+
+    //---------- Calibration ----------//
+    /**
+     * @brief Measure the offset of the three phases
+     *
+     * The motor must be applying the zero vector (PWM idle), so no current flows through the shunts
+     *
+     * @param numSamples Number of PWM periods to average
+     *
+     * @return True if calibrated successfully
+     */
+    static bool calibrateOffsets(uint16_t numSamples = 1024);
+
+    /**
+     * @brief Match the gain to a known current
+     *
+     * A known DC current must be flowing through this phase (the offset must be calibrated before)
+     *
+     * @param expected Injected current in amperes
+     * @param numSamples Number of PWM periods to average
+     *
+     * @return True if calibrated successfully
+     */
+    bool calibrateGain(float expected, uint16_t numSamples = 1024);
+
+    /**
+     * @brief Start online offset refinement
+     *
+     * Offsets track the measured value while the motor is applying the zero vector, after the current had time to decay
+     */
+    static void startOnlineCalibration();
+    static void stopOnlineCalibration();
+
+    static bool loadCalibration(); ///< Load calibration of the three phases from storage
+    static bool saveCalibration(); ///< Save calibration of the three phases to storage
+
+    Calibration getCalibration() const;
+    void setCalibration(const Calibration& calibration);
+
   private:
+    /**
+     * @brief Convert raw ADC value to current
+     *
+     * @param raw Raw 12-bit value
+     *
+     * @return Current in amperes
+     */
+    float convert(uint16_t raw) const;
+
+    /**
+     * @brief Average raw samples of the three phases
+     *
+     * @param numSamples Number of PWM periods to average
+     * @param sums Sum of the samples of each phase
+     *
+     * @return True if all samples were read
+     */
+    static bool sample(uint16_t numSamples, std::array<uint32_t, 3>& sums);
+
+    /**
+     * @brief Online refinement step, called on every injected conversion
+     *
+     * @param samples Raw injected samples (ADC1, ADC2, ADC3)
+     */
+    static void refine(const std::array<uint16_t, 3>& samples);
+
     // Physical Constants
     static constexpr float AMPLIFIER_GAIN = 20.0f;    // From INA240A1 datasheet
     static constexpr float SHUNT_RESISTANCE = 0.050f; // Shunt resistor value in ohms
     static constexpr float ADC_VREF = 3.3f;           // ADC reference voltage
 
+    // Calibration constants
+    static constexpr float SCALE_TO_AMPS = 1.0f / (1000.0f * 65536.0f);
+    static constexpr float NOMINAL_SCALE = ADC_VREF / Adc::MAX_READ / (AMPLIFIER_GAIN * SHUNT_RESISTANCE) * 1000.0f * 65536.0f;
+    static constexpr uint8_t ONLINE_SHIFT = 10;                  // Online offset filter time constant (2^10 PWM periods, ~43ms)
+    static constexpr uint16_t ONLINE_SETTLE = 240;               // Zero vector periods before refining (~10ms)
+    static constexpr uint8_t OFFSET_FRACTION = 8 + ONLINE_SHIFT; // Raw offset fraction bits (Q8 plus the filter shift, small errors are not floored)
+
+    // Phase sources, resolved at compile time
+    static constexpr std::array<Adc::Source, 3> PHASE_SOURCES = {Adc::getSource(Gpio::CURR_U_PIN), Adc::getSource(Gpio::CURR_V_PIN),
+                                                                 Adc::getSource(Gpio::CURR_W_PIN)};
+
     Gpio::Gpio _gpio;
+    Adc::Source _source; ///< ADC source resolved at init
+    Calibration _calibration;
+    int32_t _rawOffset; ///< Zero current raw value in Q18 (online refinement state)
+
+    static uint16_t _zeroVectorPeriods; ///< Consecutive PWM periods applying the zero vector
 };
 
 inline Current curr_u_phase;
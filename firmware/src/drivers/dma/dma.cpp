@@ -4,6 +4,7 @@
 // Date: 2023-12-01
 // By Breno Cunha Queiroz
 //--------------------------------------------------
+#include <algorithm>
 #include <drivers/dma/dma.h>
 #include <utils/log.h>
 
@@ -18,10 +19,24 @@ uint32_t convert(Increment increment, Source source);
 uint32_t convert(Alignment alignment, Source source);
 uint32_t convert(Mode mode);
 uint32_t convert(Priority priority);
+uint32_t convert(Fifo fifo);
+uint32_t convert(Burst burst, Source source);
+
+// HAL callbacks of streams started by the driver
+void halfComplete(Handle* hdma);
+void m1HalfComplete(Handle* hdma);
+void complete(Handle* hdma);
+void m1Complete(Handle* hdma);
+void error(Handle* hdma);
+void dispatch(Handle* hdma, Event event, uint8_t buffer);
 
 // DMA handles
 Handle _dmaHandles[2][8]; // [dma][stream]
 
+// Stream callbacks
+Callback _callbacks[2][8] = {}; // [dma][stream]
+void* _contexts[2][8] = {};     // [dma][stream]
+
 // DMA instances
 static DMA_Stream_TypeDef* _dmaInstances[2][8] = {
     {DMA1_Stream0, DMA1_Stream1, DMA1_Stream2, DMA1_Stream3, DMA1_Stream4, DMA1_Stream5, DMA1_Stream6, DMA1_Stream7},
@@ -31,23 +46,7 @@ static DMA_Stream_TypeDef* _dmaInstances[2][8] = {
 } // namespace Dma
 
 bool Dma::init() {
-    // Check for dma/stream conflicts
-    for (uint32_t i = 0; i < dmaList.size(); i++)
-        for (uint32_t j = i + 1; j < dmaList.size(); j++)
-            if (dmaList[i].dma == dmaList[j].dma && dmaList[i].stream == dmaList[j].stream) {
-                Log::error("Dma", "Found conflict in dmaList: DMA$0 STREAM$1", int(dmaList[i].dma), int(dmaList[i].stream));
-                return false;
-            }
-
-    // Check for request conflict
-    for (uint32_t i = 0; i < dmaList.size(); i++) {
-        const auto& mapping = dmaList[i].dma == DMA1 ? dma1Mapping : dma2Mapping;
-        if (mapping[dmaList[i].channel][dmaList[i].stream] != dmaList[i].request) {
-            Log::error("Dma", "Request for DMA$0 STREAM$1 CH$2 does not match dma mapping", int(dmaList[i].dma), int(dmaList[i].stream),
-                       int(dmaList[i].channel));
-            return false;
-        }
-    }
+    // Stream conflicts and request mapping are checked at compile time (validDmaList)
 
     // Initialize DMA
     bool usingDma1 = false;
@@ -75,14 +74,18 @@ bool Dma::init() {
         hdma->Init.MemDataAlignment = convert(dmaList[i].alignment, MEMORY);
         hdma->Init.Mode = convert(dmaList[i].mode);
         hdma->Init.Priority = convert(dmaList[i].priority);
-        hdma->Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+        // Double buffer mode is enabled by startDoubleBuffer(), the stream is circular
+        hdma->Init.FIFOMode = dmaList[i].fifo == FIFO_DIRECT ? DMA_FIFOMODE_DISABLE : DMA_FIFOMODE_ENABLE;
+        hdma->Init.FIFOThreshold = convert(dmaList[i].fifo);
+        hdma->Init.MemBurst = convert(dmaList[i].memBurst, MEMORY);
+        hdma->Init.PeriphBurst = convert(dmaList[i].perBurst, PERIPHERAL);
         if (HAL_DMA_Init(hdma) != HAL_OK) {
-            Log::error("Dma", "Failed to initialize DMA$0 STREAM$1 CH$2", int(dmaList[i].dma), int(dmaList[i].stream), int(dmaList[i].channel));
+            LOG_ERROR("Dma", "Failed to initialize DMA$0 STREAM$1 CH$2", int(dmaList[i].dma), int(dmaList[i].stream), int(dmaList[i].channel));
             return false;
         }
     }
 
-    Log::success("Dma", "Initialized");
+    LOG_SUCCESS("Dma", "Initialized");
     return true;
 }
 
@@ -98,6 +101,94 @@ Dma::Handle* Dma::getHandle(Dma dma, Stream stream) {
     return nullptr;
 }
 
+void Dma::setCallback(Dma dma, Stream stream, Callback callback, void* context) {
+    if (dma < 1 || dma > 2)
+        return;
+    _contexts[dma - 1][stream] = context;
+    _callbacks[dma - 1][stream] = callback;
+}
+
+bool Dma::start(Dma dma, Stream stream, uint32_t peripheral, void* memory, uint16_t count) {
+    Handle* hdma = getHandle(dma, stream);
+    if (hdma == nullptr)
+        return false;
+    hdma->XferHalfCpltCallback = halfComplete;
+    hdma->XferCpltCallback = complete;
+    hdma->XferErrorCallback = error;
+
+    uint32_t src = peripheral;
+    uint32_t dst = uint32_t(uintptr_t(memory));
+    if (hdma->Init.Direction == DMA_MEMORY_TO_PERIPH)
+        std::swap(src, dst);
+    if (HAL_DMA_Start_IT(hdma, src, dst, count) != HAL_OK) {
+        LOG_ERROR("Dma", "Failed to start DMA$0 STREAM$1", int(dma), int(stream));
+        return false;
+    }
+    return true;
+}
+
+bool Dma::startDoubleBuffer(Dma dma, Stream stream, uint32_t peripheral, void* memory0, void* memory1, uint16_t count) {
+    Handle* hdma = getHandle(dma, stream);
+    if (hdma == nullptr)
+        return false;
+    hdma->XferHalfCpltCallback = halfComplete;
+    hdma->XferM1HalfCpltCallback = m1HalfComplete;
+    hdma->XferCpltCallback = complete;
+    hdma->XferM1CpltCallback = m1Complete;
+    hdma->XferErrorCallback = error;
+
+    // Memory addresses are M0AR and M1AR in both directions
+    uint32_t src = peripheral;
+    uint32_t dst = uint32_t(uintptr_t(memory0));
+    if (hdma->Init.Direction == DMA_MEMORY_TO_PERIPH)
+        std::swap(src, dst);
+    if (HAL_DMAEx_MultiBufferStart_IT(hdma, src, dst, uint32_t(uintptr_t(memory1)), count) != HAL_OK) {
+        LOG_ERROR("Dma", "Failed to start DMA$0 STREAM$1 double buffer", int(dma), int(stream));
+        return false;
+    }
+    return true;
+}
+
+void Dma::stop(Dma dma, Stream stream) {
+    Handle* hdma = getHandle(dma, stream);
+    if (hdma == nullptr)
+        return;
+    HAL_DMA_Abort(hdma);
+    hdma->Instance->CR &= ~DMA_SxCR_DBM;
+}
+
+uint8_t Dma::getTarget(Dma dma, Stream stream) {
+    DMA_Stream_TypeDef* instance = getInstance(dma, stream);
+    return (instance != nullptr && (instance->CR & DMA_SxCR_CT)) ? 1 : 0;
+}
+
+uint16_t Dma::getRemaining(Dma dma, Stream stream) {
+    DMA_Stream_TypeDef* instance = getInstance(dma, stream);
+    return instance != nullptr ? instance->NDTR : 0;
+}
+
+void Dma::halfComplete(Handle* hdma) { dispatch(hdma, EVENT_HALF, 0); }
+
+void Dma::m1HalfComplete(Handle* hdma) { dispatch(hdma, EVENT_HALF, 1); }
+
+void Dma::complete(Handle* hdma) { dispatch(hdma, EVENT_COMPLETE, 0); }
+
+void Dma::m1Complete(Handle* hdma) { dispatch(hdma, EVENT_COMPLETE, 1); }
+
+void Dma::error(Handle* hdma) {
+    // FIFO errors are reported for every underrun/overrun in direct mode, the transfer goes on
+    if (hdma->ErrorCode == HAL_DMA_ERROR_FE)
+        return;
+    dispatch(hdma, EVENT_ERROR, (hdma->Instance->CR & DMA_SxCR_CT) ? 1 : 0);
+}
+
+void Dma::dispatch(Handle* hdma, Event event, uint8_t buffer) {
+    size_t index = hdma - &_dmaHandles[0][0];
+    Callback callback = _callbacks[index >> 3][index & 7];
+    if (callback)
+        callback(event, buffer, _contexts[index >> 3][index & 7]);
+}
+
 DMA_Stream_TypeDef* Dma::getInstance(Dma dma, Stream stream) {
     if (dma >= 1 && dma <= 2)
         return _dmaInstances[dma - 1][stream];
@@ -174,6 +265,7 @@ uint32_t Dma::convert(Mode mode) {
         case MODE_NORMAL:
             return DMA_NORMAL;
         case MODE_CIRCULAR:
+        case MODE_DOUBLE_BUFFER:
             return DMA_CIRCULAR;
     }
     return 0;
@@ -192,3 +284,45 @@ uint32_t Dma::convert(Priority priority) {
     }
     return 0;
 }
+
+uint32_t Dma::convert(Fifo fifo) {
+    switch (fifo) {
+        case FIFO_DIRECT:
+        case FIFO_1_4:
+            return DMA_FIFO_THRESHOLD_1QUARTERFULL;
+        case FIFO_1_2:
+            return DMA_FIFO_THRESHOLD_HALFFULL;
+        case FIFO_3_4:
+            return DMA_FIFO_THRESHOLD_3QUARTERSFULL;
+        case FIFO_FULL:
+            return DMA_FIFO_THRESHOLD_FULL;
+    }
+    return 0;
+}
+
+uint32_t Dma::convert(Burst burst, Source source) {
+    if (source == PERIPHERAL) {
+        switch (burst) {
+            case BURST_SINGLE:
+                return DMA_PBURST_SINGLE;
+            case BURST_INC4:
+                return DMA_PBURST_INC4;
+            case BURST_INC8:
+                return DMA_PBURST_INC8;
+            case BURST_INC16:
+                return DMA_PBURST_INC16;
+        }
+    } else if (source == MEMORY) {
+        switch (burst) {
+            case BURST_SINGLE:
+                return DMA_MBURST_SINGLE;
+            case BURST_INC4:
+                return DMA_MBURST_INC4;
+            case BURST_INC8:
+                return DMA_MBURST_INC8;
+            case BURST_INC16:
+                return DMA_MBURST_INC16;
+        }
+    }
+    return 0;
+}
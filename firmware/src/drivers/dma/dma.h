@@ -18,8 +18,15 @@ enum Direction : uint8_t { PER_TO_MEM = 0, MEM_TO_PER, MEM_TO_MEM };
 enum Channel : uint8_t { CH0 = 0, CH1, CH2, CH3, CH4, CH5, CH6, CH7 };
 enum Alignment : uint8_t { ALIGN_8BIT = 0, ALIGN_16BIT, ALIGN_32BIT };
 enum Increment : uint8_t { INC_NONE = 0, INC_PER, INC_MEM, INC_MEM_PER };
-enum Mode : uint8_t { MODE_NORMAL = 0, MODE_CIRCULAR };
+enum Mode : uint8_t {
+    MODE_NORMAL = 0,
+    MODE_CIRCULAR,
+    MODE_DOUBLE_BUFFER, ///< Circular over two memory buffers (startDoubleBuffer() only)
+};
 enum Priority : uint8_t { PRIORITY_LOW = 0, PRIORITY_MEDIUM, PRIORITY_HIGH, PRIORITY_VERY_HIGH };
+enum Fifo : uint8_t { FIFO_DIRECT = 0, FIFO_1_4, FIFO_1_2, FIFO_3_4, FIFO_FULL }; ///< Direct mode or FIFO threshold
+enum Burst : uint8_t { BURST_SINGLE = 0, BURST_INC4, BURST_INC8, BURST_INC16 };   ///< Beats per burst (FIFO only)
+enum Event : uint8_t { EVENT_HALF = 0, EVENT_COMPLETE, EVENT_ERROR };
 using Handle = DMA_HandleTypeDef;
 
 /**
@@ -46,6 +53,90 @@ bool deinit();
  */
 Handle* getHandle(Dma dma, Stream stream);
 
+/**
+ * @brief DMA stream callback
+ *
+ * Called from the DMA interrupt
+ *
+ * @param event Half transfer, transfer complete or transfer error
+ * @param buffer Memory buffer of the event (always 0 outside double buffer mode)
+ * @param context Context given to setCallback()
+ */
+using Callback = void (*)(Event event, uint8_t buffer, void* context);
+
+/**
+ * @brief Set stream callback
+ *
+ * Only used by streams started with start() or startDoubleBuffer(). Streams linked to a peripheral handle get their
+ * callbacks from the peripheral driver
+ *
+ * @param dma DMA peripheral
+ * @param stream DMA stream
+ * @param callback Callback (nullptr to disable)
+ * @param context Passed to the callback
+ */
+void setCallback(Dma dma, Stream stream, Callback callback, void* context = nullptr);
+
+/**
+ * @brief Start transfer
+ *
+ * The peripheral must be configured to issue the DMA requests
+ *
+ * @param dma DMA peripheral
+ * @param stream DMA stream
+ * @param peripheral Peripheral data register address (source address for MEM_TO_MEM)
+ * @param memory Memory buffer
+ * @param count Number of data items (alignment size of the dmaList entry)
+ *
+ * @return True if started
+ */
+bool start(Dma dma, Stream stream, uint32_t peripheral, void* memory, uint16_t count);
+
+/**
+ * @brief Start double buffer transfer
+ *
+ * The stream switches between the two buffers at every transfer complete without CPU intervention, so the buffer that
+ * is not the current target can be processed (or refilled) while the other one is transferred
+ *
+ * @param dma DMA peripheral
+ * @param stream DMA stream (MODE_DOUBLE_BUFFER in dmaList)
+ * @param peripheral Peripheral data register address
+ * @param memory0 First memory buffer
+ * @param memory1 Second memory buffer
+ * @param count Number of data items of each buffer
+ *
+ * @return True if started
+ */
+bool startDoubleBuffer(Dma dma, Stream stream, uint32_t peripheral, void* memory0, void* memory1, uint16_t count);
+
+/**
+ * @brief Stop transfer started by start() or startDoubleBuffer()
+ *
+ * @param dma DMA peripheral
+ * @param stream DMA stream
+ */
+void stop(Dma dma, Stream stream);
+
+/**
+ * @brief Get memory buffer being transferred
+ *
+ * @param dma DMA peripheral
+ * @param stream DMA stream
+ *
+ * @return Current target (0 or 1) of a double buffer transfer
+ */
+uint8_t getTarget(Dma dma, Stream stream);
+
+/**
+ * @brief Get remaining data items of the current buffer
+ *
+ * @param dma DMA peripheral
+ * @param stream DMA stream
+ *
+ * @return Data items left to transfer
+ */
+uint16_t getRemaining(Dma dma, Stream stream);
+
 //---------- DMA streams ----------//
 static constexpr Dma LED_DMA = DMA1;
 static constexpr Stream LED_STREAM = STREAM5;
@@ -56,6 +147,20 @@ static constexpr Stream UART_RX_STREAM = STREAM1;
 static constexpr Stream UART_TX_STREAM = STREAM6;
 static constexpr Channel UART_CHANNEL = CH5;
 
+static constexpr Dma IMU_DMA = DMA1;
+static constexpr Stream IMU_RX_STREAM = STREAM3;
+static constexpr Stream IMU_TX_STREAM = STREAM4;
+static constexpr Channel IMU_CHANNEL = CH0;
+
+static constexpr Dma ENC_DMA = DMA1;
+static constexpr Stream ENC_RX_STREAM = STREAM0;
+static constexpr Stream ENC_TX_STREAM = STREAM7;
+static constexpr Channel ENC_CHANNEL = CH0;
+
+static constexpr Dma ADC_DMA = DMA2;
+static constexpr Stream ADC_VOLT_STREAM = STREAM0;
+static constexpr Channel ADC_VOLT_CHANNEL = CH0;
+
 //---------- DMA configs ----------//
 struct DmaConfig {
     Request request;
@@ -67,14 +172,86 @@ struct DmaConfig {
     Increment increment = INC_NONE;
     Mode mode = MODE_NORMAL;
     Priority priority = PRIORITY_LOW;
+    Fifo fifo = FIFO_DIRECT;       ///< FIFO threshold (required by bursts and MEM_TO_MEM)
+    Burst memBurst = BURST_SINGLE; ///< Memory burst
+    Burst perBurst = BURST_SINGLE; ///< Peripheral burst
 };
 
-inline const std::array dmaList{
-    DmaConfig{TIM2_CH1, LED_DMA, LED_STREAM, LED_CHANNEL, MEM_TO_PER, ALIGN_32BIT, INC_MEM, MODE_NORMAL, PRIORITY_LOW},
+inline constexpr std::array dmaList{
+    DmaConfig{TIM2_CH1, LED_DMA, LED_STREAM, LED_CHANNEL, MEM_TO_PER, ALIGN_32BIT, INC_MEM, MODE_CIRCULAR, PRIORITY_LOW},
     DmaConfig{USART6_TX, UART_DMA, UART_TX_STREAM, UART_CHANNEL, MEM_TO_PER, ALIGN_8BIT, INC_MEM, MODE_NORMAL, PRIORITY_LOW},
     DmaConfig{USART6_RX, UART_DMA, UART_RX_STREAM, UART_CHANNEL, PER_TO_MEM, ALIGN_8BIT, INC_MEM, MODE_CIRCULAR, PRIORITY_LOW},
+    DmaConfig{SPI2_TX, IMU_DMA, IMU_TX_STREAM, IMU_CHANNEL, MEM_TO_PER, ALIGN_8BIT, INC_MEM, MODE_NORMAL, PRIORITY_MEDIUM},
+    DmaConfig{SPI2_RX, IMU_DMA, IMU_RX_STREAM, IMU_CHANNEL, PER_TO_MEM, ALIGN_8BIT, INC_MEM, MODE_NORMAL, PRIORITY_HIGH},
+    DmaConfig{SPI3_TX, ENC_DMA, ENC_TX_STREAM, ENC_CHANNEL, MEM_TO_PER, ALIGN_16BIT, INC_MEM, MODE_NORMAL, PRIORITY_HIGH},
+    DmaConfig{SPI3_RX, ENC_DMA, ENC_RX_STREAM, ENC_CHANNEL, PER_TO_MEM, ALIGN_16BIT, INC_MEM, MODE_NORMAL, PRIORITY_VERY_HIGH},
+    DmaConfig{ADC1, ADC_DMA, ADC_VOLT_STREAM, ADC_VOLT_CHANNEL, PER_TO_MEM, ALIGN_16BIT, INC_MEM, MODE_DOUBLE_BUFFER, PRIORITY_MEDIUM},
 };
 
+//---------- Compile-time routing ----------//
+/**
+ * @brief Check if a request is served by a stream in dmaList
+ *
+ * @param request DMA request
+ *
+ * @return True if the request is in dmaList
+ */
+constexpr bool isUsed(Request request) {
+    for (const DmaConfig& dmaConfig : dmaList)
+        if (dmaConfig.request == request)
+            return true;
+    return false;
+}
+
+/**
+ * @brief Find the dmaList entry of a stream
+ *
+ * @param dma DMA peripheral
+ * @param stream DMA stream
+ *
+ * @return Index in dmaList, dmaList.size() if the stream is not used
+ */
+constexpr size_t findConfig(Dma dma, Stream stream) {
+    for (size_t i = 0; i < dmaList.size(); i++)
+        if (dmaList[i].dma == dma && dmaList[i].stream == stream)
+            return i;
+    return dmaList.size();
+}
+
+constexpr uint32_t alignmentSize(Alignment alignment) { return 1u << alignment; }
+constexpr uint32_t burstBeats(Burst burst) { return burst == BURST_SINGLE ? 1 : 2u << burst; }
+
+constexpr bool validFifo(const DmaConfig& cfg) {
+    if (cfg.fifo == FIFO_DIRECT)
+        return cfg.direction != MEM_TO_MEM && cfg.memBurst == BURST_SINGLE && cfg.perBurst == BURST_SINGLE;
+    // A burst must fit in 16 bytes, and the FIFO threshold must be a whole number of memory bursts
+    uint32_t thresholdBytes = 4 * cfg.fifo;
+    uint32_t memBytes = burstBeats(cfg.memBurst) * alignmentSize(cfg.alignment);
+    uint32_t perBytes = burstBeats(cfg.perBurst) * alignmentSize(cfg.alignment);
+    return memBytes <= 16 && perBytes <= 16 && thresholdBytes % memBytes == 0;
+}
+
+constexpr bool validDmaList() {
+    for (size_t i = 0; i < dmaList.size(); i++) {
+        // Request must be mapped to the stream/channel
+        const auto& mapping = dmaList[i].dma == DMA1 ? dma1Mapping : dma2Mapping;
+        if (mapping[dmaList[i].channel][dmaList[i].stream] != dmaList[i].request)
+            return false;
+        // Memory to memory transfers can not be circular, and need the FIFO
+        if (dmaList[i].direction == MEM_TO_MEM && (dmaList[i].mode != MODE_NORMAL || dmaList[i].dma != DMA2))
+            return false;
+        if (!validFifo(dmaList[i]))
+            return false;
+        // Stream can only serve one request
+        for (size_t j = i + 1; j < dmaList.size(); j++)
+            if (dmaList[i].dma == dmaList[j].dma && dmaList[i].stream == dmaList[j].stream)
+                return false;
+    }
+    return true;
+}
+static_assert(validDmaList(), "dmaList has a stream used twice, a request that does not match the DMA mapping, a circular memory to "
+                              "memory stream or a burst that does not fit the FIFO threshold");
+
 }; // namespace Dma
 
 #endif // BLDC_DRIVERS_DMA_DMA_H
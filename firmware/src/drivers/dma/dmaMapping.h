@@ -102,7 +102,7 @@ constexpr uint8_t NUM_CHANNELS = 8; ///< Number of stream channels
 /**
  * @brief DMA1 request mapping
  */
-inline const std::array<std::array<Request, NUM_STREAMS>, NUM_CHANNELS> dma1Mapping{{
+inline constexpr std::array<std::array<Request, NUM_STREAMS>, NUM_CHANNELS> dma1Mapping{{
     {SPI3_RX,     SPDIFRX_DT,    SPI3_RX,     SPI2_RX,       SPI2_TX,       SPI3_TX,    SPDIFRX_CS,   SPI3_TX},
     {I2C1_RX,     I2C3_RX,       TIM7_UP,     NA,            TIM7_UP,       I2C1_RX,    I2C1_TX,      I2C1_TX},
     {TIM4_CH1,    NA,            FMPI2C1_RX,  TIM4_CH2,      NA,            FMPI2C1_TX, TIM4_UP,      TIM4_CH3},
@@ -116,7 +116,7 @@ inline const std::array<std::array<Request, NUM_STREAMS>, NUM_CHANNELS> dma1Mapp
 /**
  * @brief DMA2 request mapping
  */
-inline const std::array<std::array<Request, NUM_STREAMS>, NUM_CHANNELS> dma2Mapping{{
+inline constexpr std::array<std::array<Request, NUM_STREAMS>, NUM_CHANNELS> dma2Mapping{{
     {ADC1,      SAI1_A,    TIM8_CH1_CH2_CH3, SAI1_A,   ADC1,              SAI1_B,    TIM1_CH1_CH2_CH3, SAI2_B},
     {NA,        DCMI,      ADC2,             ADC2,     SAI1_B,            NA,        NA,               DCMI},
     {ADC3,      ADC3,      NA,               NA,       NA,                NA,        NA,               NA},
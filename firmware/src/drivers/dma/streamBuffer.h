@@ -0,0 +1,122 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// streamBuffer.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_DRIVERS_DMA_STREAM_BUFFER_H
+#define BLDC_DRIVERS_DMA_STREAM_BUFFER_H
+#include <array>
+#include <drivers/dma/dma.h>
+
+namespace Dma {
+
+/**
+ * @brief Zero-copy ping-pong buffer on a double buffer DMA stream
+ *
+ * The stream transfers one buffer while the consumer holds the other one. For peripheral to memory streams the
+ * acquired buffer holds the last received data, for memory to peripheral streams it is the buffer to refill before
+ * the stream switches back to it. No data is copied, and the CPU only runs when a buffer is complete
+ *
+ * @tparam DMA DMA peripheral
+ * @tparam STREAM DMA stream (MODE_DOUBLE_BUFFER in dmaList)
+ * @tparam T Data item (same size as the dmaList alignment)
+ * @tparam N Data items per buffer
+ */
+template <Dma DMA, Stream STREAM, typename T, size_t N>
+class StreamBuffer {
+    static constexpr size_t CONFIG = findConfig(DMA, STREAM);
+    static_assert(CONFIG < dmaList.size() && dmaList[CONFIG].mode == MODE_DOUBLE_BUFFER, "Stream must be MODE_DOUBLE_BUFFER in dmaList");
+    static_assert(sizeof(T) == alignmentSize(dmaList[CONFIG].alignment), "Data item size must match the stream alignment");
+    static_assert(N > 0 && N <= 0xFFFF, "DMA transfers at most 65535 data items");
+
+  public:
+    /**
+     * @brief Buffer complete callback
+     *
+     * Called from the DMA interrupt with the buffer the stream just completed, which stays valid until the stream
+     * completes the other one. Buffers handed to the callback are not returned by acquire()
+     *
+     * @param buffer Completed buffer of N items
+     * @param context Context given to start()
+     */
+    using Callback = void (*)(T* buffer, void* context);
+
+    /**
+     * @brief Start streaming
+     *
+     * The peripheral must be configured to issue the DMA requests
+     *
+     * @param peripheral Peripheral data register address
+     * @param callback Buffer complete callback (nullptr to use acquire())
+     * @param context Passed to the callback
+     *
+     * @return True if the stream was started
+     */
+    bool start(uint32_t peripheral, Callback callback = nullptr, void* context = nullptr) {
+        _ready = NO_BUFFER;
+        _held = NO_BUFFER;
+        _overruns = 0;
+        _callback = callback;
+        _context = context;
+        setCallback(DMA, STREAM, handler, this);
+        return startDoubleBuffer(DMA, STREAM, peripheral, _buffers[0].data(), _buffers[1].data(), N);
+    }
+
+    void stop() {
+        ::Dma::stop(DMA, STREAM);
+        setCallback(DMA, STREAM, nullptr);
+    }
+
+    /**
+     * @brief Take the buffer the stream is not using
+     *
+     * Must be released before the stream completes the other buffer, otherwise the stream is already transferring
+     * the held buffer again and an overrun is counted
+     *
+     * @return Completed buffer of N items, nullptr if no buffer was completed since the last acquire()
+     */
+    T* acquire() {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        int8_t ready = _ready;
+        if (ready != NO_BUFFER) {
+            _held = ready;
+            _ready = NO_BUFFER;
+        }
+        __set_PRIMASK(primask);
+        return ready != NO_BUFFER ? _buffers[ready].data() : nullptr;
+    }
+
+    void release() { _held = NO_BUFFER; }
+
+    uint32_t getOverruns() const { return _overruns; } ///< Buffers completed while the other one was held
+
+  private:
+    static constexpr int8_t NO_BUFFER = -1;
+
+    static void handler(Event event, uint8_t buffer, void* context) {
+        StreamBuffer* self = static_cast<StreamBuffer*>(context);
+        if (event != EVENT_COMPLETE)
+            return;
+        if (self->_callback) {
+            self->_callback(self->_buffers[buffer].data(), self->_context);
+            return;
+        }
+        // The stream is now transferring the other buffer, if it was still held (or never taken) it is overwritten
+        if (self->_held == 1 - buffer || self->_ready == 1 - buffer)
+            self->_overruns = self->_overruns + 1;
+        self->_ready = buffer;
+    }
+
+    alignas(16) std::array<std::array<T, N>, 2> _buffers; ///< Burst aligned buffers
+    volatile int8_t _ready = NO_BUFFER;                   ///< Completed buffer not acquired yet
+    volatile int8_t _held = NO_BUFFER;                    ///< Buffer held by the consumer
+    volatile uint32_t _overruns = 0;
+    Callback _callback = nullptr;
+    void* _context = nullptr;
+};
+
+}; // namespace Dma
+
+#endif // BLDC_DRIVERS_DMA_STREAM_BUFFER_H
@@ -8,10 +8,16 @@
 #include <drivers/hardware.h>
 #include <utils/log.h>
 
+Encoder* Encoder::_pipeline = nullptr;
+
 bool Encoder::init(Spi::Peripheral peripheral, Gpio::Gpio chipSelect) {
-    _peripheral = peripheral;
-    _chipSelect = chipSelect;
-    Gpio::write(_chipSelect, true);
+    _device = {peripheral, chipSelect, Spi::SpiConfig::MODE_1, Spi::SpiConfig::DATA_SIZE_16BIT, Spi::SpiConfig::PRESCALER_4};
+    _pipelineTimer = Timer::TIM_NONE;
+    _busy = false;
+    _sequence = 0;
+    _errors = 0;
+    _overruns = 0;
+    _device.chipSelect.set();
 
     // Initial NOP to initialize SPI (first transaction often fails and triggers the encoder's error flag)
     uint16_t nop_cmd = createCommandFrame(REG_NOP, false);
@@ -19,24 +25,43 @@ bool Encoder::init(Spi::Peripheral peripheral, Gpio::Gpio chipSelect) {
 
     // Verify communication by reading a known register
     if (!verifyCommunication()) {
-        Log::error("Encoder", "Failed to initialize");
+        LOG_ERROR("Encoder", "Failed to initialize");
         return false;
     }
 
-    Log::success("Encoder", "Initialized");
+    LOG_SUCCESS("Encoder", "Initialized");
     return true;
 }
 
 std::optional<float> Encoder::readAngle() {
-    auto response = readRegister(REG_ANGLE);
-    if (!response)
+    auto counts = readCounts();
+    if (!counts)
         return std::nullopt;
 
     // Convert the raw 14-bit angle (0-16383) to degrees
-    return (response->fields.data / 16383.0f) * 360.0f;
+    return (*counts / 16383.0f) * 360.0f;
+}
+
+std::optional<uint16_t> Encoder::readCounts() {
+    if (_pipeline == this) {
+        auto sample = getSample();
+        if (!sample)
+            return std::nullopt;
+        return sample->counts;
+    }
+
+    auto response = readRegister(REG_ANGLE);
+    if (!response)
+        return std::nullopt;
+    return uint16_t(response->fields.data);
 }
 
 std::optional<uint16_t> Encoder::readMagnitude() {
+    if (_pipeline == this) {
+        LOG_WARNING("Encoder", "Magnitude can not be read while the pipeline is running");
+        return std::nullopt;
+    }
+
     auto response = readRegister(REG_MAGNITUDE);
     if (!response)
         return std::nullopt;
@@ -61,7 +86,7 @@ std::optional<Encoder::ReadFrame> Encoder::readRegister(Reg address) {
     auto raw_response = transmitReceive(nop_cmd);
 
     if (!raw_response) {
-        Log::error("Encoder", "SPI communication failed at HAL level.");
+        LOG_ERROR("Encoder", "SPI communication failed at HAL level.");
         return std::nullopt;
     }
 
@@ -70,7 +95,7 @@ std::optional<Encoder::ReadFrame> Encoder::readRegister(Reg address) {
 
     // 5. Check for sensor-level errors (bad parity or error flag set).
     if (!response.parityOK || response.fields.errorFlag) {
-        Log::warning("Encoder", "Received frame with error. Parity OK: $0, Error Flag: $1", response.parityOK, uint16_t(response.fields.errorFlag));
+        LOG_WARNING("Encoder", "Received frame with error. Parity OK: $0, Error Flag: $1", response.parityOK, uint16_t(response.fields.errorFlag));
         return std::nullopt;
     }
 
@@ -80,16 +105,136 @@ std::optional<Encoder::ReadFrame> Encoder::readRegister(Reg address) {
 std::optional<uint16_t> Encoder::transmitReceive(uint16_t txData) {
     uint16_t rxData = 0;
 
-    Gpio::write(_chipSelect, false); // CS Low
-    bool success = Spi::transmitReceive(_peripheral, reinterpret_cast<uint8_t*>(&txData), reinterpret_cast<uint8_t*>(&rxData), 1);
-    Gpio::write(_chipSelect, true); // CS High
-    Hardware::delayMs(1);           // Short delay to ensure sensor is ready
+    // CS is driven by the scheduler (350ns minimum high time is covered by the transaction overhead)
+    if (!Spi::transfer(_device, reinterpret_cast<uint8_t*>(&txData), reinterpret_cast<uint8_t*>(&rxData), 1, Spi::Priority::HIGH))
+        return std::nullopt;
+    return rxData;
+}
+
+bool Encoder::startPipeline(Timer::Timer timer) {
+    if (_pipeline != nullptr) {
+        LOG_ERROR("Encoder", "Pipeline already running");
+        return false;
+    }
+
+    _busy = false;
+    _sequence = 0;
+    _errors = 0;
+    _overruns = 0;
+    _lastCommand = createCommandFrame(REG_NOP, false); // First frame returns the result of the last blocking read
+    _nextCommand = createCommandFrame(REG_ANGLE, true);
+    _transaction.device = &_device;
+    _transaction.txData = reinterpret_cast<uint8_t*>(&_txFrame);
+    _transaction.rxData = reinterpret_cast<uint8_t*>(&_rxFrame);
+    _transaction.len = 1;
+    _transaction.priority = Spi::Priority::HIGH; // Never waits behind other devices on the same bus
+    _transaction.callback = pipelineComplete;
+    _transaction.context = this;
+    _pipelineTimer = timer;
+    _pll.setLatency(2 * Timer::getUpdatePeriod(timer) - FRAME_TIME);
+    _pipeline = this;
+    Timer::setUpdateCallback(timer, pipelineTrigger);
+
+    LOG_SUCCESS("Encoder", "Pipeline started");
+    return true;
+}
 
-    if (!success)
+void Encoder::stopPipeline() {
+    if (_pipeline != this)
+        return;
+    Timer::setUpdateCallback(_pipelineTimer, nullptr);
+    while (_busy) {
+    }
+    _pipeline = nullptr;
+}
+
+std::optional<Encoder::Sample> Encoder::getSample() const {
+    uint32_t sequence;
+    Sample sample;
+    do {
+        sequence = _sequence;
+        sample = _samples[sequence & 1];
+    } while (sequence != _sequence); // Published again while copying
+    if (sequence == 0)
         return std::nullopt;
+    return sample;
+}
 
-    // Swap the bytes of the received data back to the correct order for the CPU.
-    return rxData;
+uint32_t Encoder::getPipelineErrors() const { return _errors; }
+
+uint32_t Encoder::getPipelineOverruns() const { return _overruns; }
+
+void Encoder::setPllBandwidth(float bandwidth) {
+    // The coefficients must not change while the frame interrupt updates the PLL
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    _pll.setBandwidth(bandwidth);
+    __set_PRIMASK(primask);
+}
+
+float Encoder::getPllBandwidth() const { return _pll.getBandwidth(); }
+
+void Encoder::setPllLatency(float latency) { _pll.setLatency(latency); }
+
+float Encoder::getPllLatency() const { return _pll.getLatency(); }
+
+void Encoder::pipelineTrigger() {
+    Encoder* enc = _pipeline;
+    if (enc == nullptr)
+        return;
+    if (enc->_busy) {
+        enc->_overruns = enc->_overruns + 1;
+        return;
+    }
+
+    enc->_busy = true;
+    enc->_txFrame = enc->_nextCommand;
+    if (!Spi::submit(&enc->_transaction)) {
+        enc->_errors = enc->_errors + 1;
+        enc->_busy = false;
+    }
+}
+
+void Encoder::pipelineComplete(Spi::Transaction* transaction, bool success) {
+    Encoder* enc = static_cast<Encoder*>(transaction->context);
+
+    // This frame carries the result of the previous command
+    uint16_t command = enc->_lastCommand;
+    enc->_lastCommand = enc->_txFrame;
+    enc->_nextCommand = createCommandFrame(REG_ANGLE, true);
+    enc->_busy = false;
+
+    if (!success) {
+        enc->_errors = enc->_errors + 1;
+        return;
+    }
+    if (command != createCommandFrame(REG_ANGLE, true))
+        return;
+
+    ReadFrame frame = parseReadFrame(enc->_rxFrame);
+    if (!frame.parityOK || frame.fields.errorFlag) {
+        enc->_errors = enc->_errors + 1;
+        // Error flag stays set until the error register is read, unless the frame in flight already reads it
+        if (frame.fields.errorFlag && enc->_lastCommand != createCommandFrame(REG_CLEAR_ERROR, true))
+            enc->_nextCommand = createCommandFrame(REG_CLEAR_ERROR, true);
+        return;
+    }
+    enc->publish(frame.fields.data);
+}
+
+void Encoder::publish(uint16_t counts) {
+    uint32_t cycles = DWT->CYCCNT;
+    if (_sequence == 0)
+        _pll.reset(counts);
+    else
+        _pll.update(counts, float(cycles - _samples[_sequence & 1].cycles) / SystemCoreClock);
+
+    // Write the buffer not being read, then switch
+    Sample& sample = _samples[(_sequence + 1) & 1];
+    sample.counts = counts;
+    sample.cycles = cycles;
+    sample.state = _pll.getState();
+    _sequence = _sequence + 1;
 }
 
 Encoder::ReadFrame Encoder::parseReadFrame(uint16_t rawFrame) {
@@ -6,8 +6,10 @@
 //--------------------------------------------------
 #ifndef BLDC_DRIVERS_ENCODER_ENCODER_H
 #define BLDC_DRIVERS_ENCODER_ENCODER_H
+#include <controller/encoderPll.h>
 #include <drivers/gpio/gpio.h>
 #include <drivers/spi/spi.h>
+#include <drivers/timer/timer.h>
 #include <optional>
 
 /**
@@ -17,12 +19,67 @@
  */
 class Encoder {
   public:
+    /// Angle sample published by the pipeline
+    struct Sample {
+        uint16_t counts;         ///< Raw 14-bit angle
+        uint32_t cycles;         ///< DWT cycle counter when the frame finished
+        EncoderPll::State state; ///< Tracking PLL estimate (State::theta and State::velocity of the controllers)
+    };
+
     bool init(Spi::Peripheral peripheral, Gpio::Gpio chipSelect);
 
     std::optional<float> readAngle();
+    std::optional<uint16_t> readCounts();
     std::optional<uint16_t> readMagnitude();
     bool verifyCommunication();
 
+    /**
+     * @brief Start pipelined angle reads
+     *
+     * A READ ANGLE frame is sent with DMA on every timer update, and each frame returns the result of the previous
+     * command. While the pipeline is running, readAngle() and readCounts() return the latest sample without blocking
+     *
+     * Every angle also updates an EncoderPll with the measured time between samples, so the published velocity does
+     * not alias as a difference of samples taken by a slower task would. The PLL latency is set to two timer update
+     * periods minus one frame: the angle is latched at the end of a READ ANGLE frame, read back by the frame of the
+     * next update, and the duty cycles computed from it are applied at the update after that
+     *
+     * @param timer Timer that triggers the reads
+     *
+     * @return True if the pipeline was started
+     */
+    bool startPipeline(Timer::Timer timer);
+    void stopPipeline();
+
+    /**
+     * @brief Latest parity-checked sample from the pipeline
+     *
+     * @return Sample, or nullopt if no valid frame was received yet
+     */
+    std::optional<Sample> getSample() const;
+    uint32_t getPipelineErrors() const;   ///< Frames with parity error, error flag or SPI failure
+    uint32_t getPipelineOverruns() const; ///< Triggers skipped because the previous frame was not finished
+
+    /**
+     * @brief Set the tracking PLL bandwidth
+     *
+     * Safe to call while the pipeline is running
+     *
+     * @param bandwidth Bandwidth in rad/s (triple pole, see EncoderPll::setBandwidth())
+     */
+    void setPllBandwidth(float bandwidth);
+    float getPllBandwidth() const;
+
+    /**
+     * @brief Set the prediction horizon of the published state
+     *
+     * Overrides the latency set by startPipeline()
+     *
+     * @param latency Time from the angle sample to the PWM update in seconds
+     */
+    void setPllLatency(float latency);
+    float getPllLatency() const;
+
   private:
     // clang-format off
     enum Reg : uint16_t {
@@ -56,16 +113,37 @@ class Encoder {
     };
 
     // Private helper functions for the driver logic
-    uint16_t createCommandFrame(Reg address, bool isRead);
-    ReadFrame parseReadFrame(uint16_t rawFrame);
+    static uint16_t createCommandFrame(Reg address, bool isRead);
+    static ReadFrame parseReadFrame(uint16_t rawFrame);
     std::optional<uint16_t> transmitReceive(uint16_t txData);
     std::optional<ReadFrame> readRegister(Reg address);
 
     static uint8_t calculateParityBit(uint16_t value);
     static bool validateReceivedParity(uint16_t rawFrame);
 
-    Spi::Peripheral _peripheral; ///< SPI peripheral
-    Gpio::Gpio _chipSelect;      ///< SPI chip select
+    static constexpr float FRAME_TIME = 16 * 4 / 36e6f; // 16-bit frame at PRESCALER_4 of the 36MHz APB1
+
+    // Pipeline interrupt handlers
+    static void pipelineTrigger();
+    static void pipelineComplete(Spi::Transaction* transaction, bool success);
+    void publish(uint16_t counts);
+
+    Spi::Device _device; ///< SPI device
+
+    // Pipeline
+    static Encoder* _pipeline;     ///< Encoder running the pipeline
+    Timer::Timer _pipelineTimer;   ///< Timer triggering the reads
+    Spi::Transaction _transaction; ///< Pipeline frame transaction
+    volatile bool _busy;           ///< Frame in progress
+    uint16_t _txFrame;             ///< DMA transmit frame
+    uint16_t _rxFrame;             ///< DMA receive frame
+    uint16_t _lastCommand;         ///< Command whose result arrives in the next frame
+    uint16_t _nextCommand;         ///< Command to send in the next frame
+    EncoderPll _pll;               ///< Velocity and multi-turn position tracking
+    Sample _samples[2];            ///< Double buffer
+    volatile uint32_t _sequence;   ///< Number of published samples (selects the buffer)
+    volatile uint32_t _errors;
+    volatile uint32_t _overruns;
 };
 
 inline Encoder encoder;
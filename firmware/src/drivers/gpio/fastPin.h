@@ -0,0 +1,93 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// fastPin.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_DRIVERS_GPIO_FAST_PIN_H
+#define BLDC_DRIVERS_GPIO_FAST_PIN_H
+#include <drivers/gpio/modes.h>
+#include <drivers/gpio/ports.h>
+#include <system/hal.h>
+
+namespace Gpio {
+
+/**
+ * @brief Direct register GPIO output
+ *
+ * Port address and pin mask are computed when the pin is created (at compile time for constant GPIOs), so set() and
+ * clear() are a single store to BSRR. BSRR writes are atomic, no read-modify-write is needed when ISRs toggle pins of
+ * the same port
+ *
+ * @note The GPIO must be configured as output in gpioList
+ */
+class FastPin {
+  public:
+    constexpr FastPin() : _port(GPIOA_BASE), _mask(0) {} ///< Unassigned pin, writes have no effect
+    constexpr FastPin(Gpio gpio) : _port(GPIOA_BASE + uint32_t(gpio.port) * PORT_STRIDE), _mask(1u << gpio.pin) {}
+
+    void set() const { reg()->BSRR = _mask; }
+    void clear() const { reg()->BSRR = _mask << 16; }
+    void write(bool high) const { reg()->BSRR = high ? _mask : _mask << 16; }
+    void toggle() const { reg()->BSRR = (reg()->ODR & _mask) ? _mask << 16 : _mask; }
+    bool read() const { return reg()->IDR & _mask; }
+
+  private:
+    static constexpr uint32_t PORT_STRIDE = GPIOB_BASE - GPIOA_BASE; // GPIO ports are contiguous in AHB1
+
+    GPIO_TypeDef* reg() const { return reinterpret_cast<GPIO_TypeDef*>(_port); }
+
+    uint32_t _port; ///< GPIO port base address
+    uint32_t _mask; ///< Pin mask (BSRR set bit)
+};
+
+/**
+ * @brief Scoped chip select
+ *
+ * Drives the chip select low while in scope. Asynchronous transfers call hold() once started so the chip select is
+ * released by the transfer complete handler instead
+ */
+class ChipSelect {
+  public:
+    explicit ChipSelect(FastPin pin) : _pin(pin), _held(false) { _pin.clear(); }
+    ~ChipSelect() {
+        if (!_held)
+            _pin.set();
+    }
+    ChipSelect(const ChipSelect&) = delete;
+    ChipSelect& operator=(const ChipSelect&) = delete;
+
+    void hold() { _held = true; } ///< Keep the chip select low after leaving the scope
+
+  private:
+    FastPin _pin;
+    bool _held;
+};
+
+/**
+ * @brief Scoped timing probe
+ *
+ * Drives a debug pin high for the duration of a block, so the block can be measured with a logic analyzer
+ *
+ * Example:
+ * @code
+ * {
+ *     Gpio::Probe probe(Gpio::DEBUG0_PIN);
+ *     // Code to measure
+ * }
+ * @endcode
+ */
+class Probe {
+  public:
+    explicit Probe(FastPin pin) : _pin(pin) { _pin.set(); }
+    ~Probe() { _pin.clear(); }
+    Probe(const Probe&) = delete;
+    Probe& operator=(const Probe&) = delete;
+
+  private:
+    FastPin _pin;
+};
+
+} // namespace Gpio
+
+#endif // BLDC_DRIVERS_GPIO_FAST_PIN_H
@@ -13,6 +13,7 @@ namespace Gpio {
 void initInput(Gpio gpio);
 void initOutput(Gpio gpio);
 void initAnalog(Gpio gpio);
+void initExti(Gpio gpio, Mode mode);
 void initI2c(Gpio gpio);
 void initSpi(Gpio gpio, Mode mode);
 void initUart(Gpio gpio, Mode mode);
@@ -20,30 +21,7 @@ void initTimer(Gpio gpio, Mode mode);
 void initTrace(Gpio gpio, Mode mode);
 void initUsb(Gpio gpio, Mode mode);
 
-/**
- * @brief Check if GPIO configuration is valid
- *
- * It will check the GPIO mode with alternate function table to check if the selected mode is available for that GPIO.
- *
- * @param gpioConfig GPIO configuration to check
- *
- * @return True if GPIO configuration is valid
- */
-bool validGpioConfig(GpioConfig gpioConfig);
-
-/**
- * @brief Get alternate function number given the gpio and mode
- *
- * The alternate function list is checked to get the number from the table
- *
- * @warning It will return NUM_AFS if could not find
- *
- * @param gpio Gpio port
- * @param mode Alternate function mode
- *
- * @return Column number in the alternate function table
- */
-static uint8_t getAlternateFunc(Gpio gpio, Mode mode);
+Callback _extiCallbacks[16] = {}; ///< External interrupt callbacks (one per EXTI line)
 
 static constexpr GPIO_TypeDef* convert(Port port);
 static constexpr uint16_t convert(Pin pin);
@@ -51,15 +29,6 @@ static constexpr uint16_t convert(Pin pin);
 } // namespace Gpio
 
 bool Gpio::init() {
-    // Check for conflicts
-    bool conflict = false;
-    for (uint32_t i = 0; i < gpioList.size(); i++)
-        for (uint32_t j = i + 1; j < gpioList.size(); j++)
-            if (gpioList[i].gpio == gpioList[j].gpio)
-                conflict = true;
-    if (conflict)
-        return false;
-
     // Enable GPIOs clock
     __HAL_RCC_GPIOA_CLK_ENABLE();
     __HAL_RCC_GPIOB_CLK_ENABLE();
@@ -72,17 +41,15 @@ bool Gpio::init() {
 
     // Initialize GPIOs
     for (GpioConfig gpioConfig : gpioList) {
-        // Check if mode is available for that GPIO
-        if (!validGpioConfig(gpioConfig))
-            return false;
-
-        // Initialize GPIO
+        // Initialize GPIO (configurations are checked at compile time)
         if (gpioConfig.mode == Mode::INPUT)
             initInput(gpioConfig.gpio);
         else if (gpioConfig.mode == Mode::OUTPUT)
             initOutput(gpioConfig.gpio);
         else if (gpioConfig.mode == Mode::ANALOG)
             initAnalog(gpioConfig.gpio);
+        else if (isExti(gpioConfig.mode))
+            initExti(gpioConfig.gpio, gpioConfig.mode);
         else if (gpioConfig.mode >= Mode::TIM1_CH1 && gpioConfig.mode <= Mode::TIM14_CH1)
             initTimer(gpioConfig.gpio, gpioConfig.mode);
         else if (gpioConfig.mode >= Mode::I2C1_SDA && gpioConfig.mode <= Mode::FMPI2C1_SMBA)
@@ -99,15 +66,17 @@ bool Gpio::init() {
             return false;
     }
 
-    Log::success("Gpio", "Initialized");
+    LOG_SUCCESS("Gpio", "Initialized");
     return true;
 }
 
 bool Gpio::deinit() { return true; }
 
-void Gpio::write(Gpio gpio, bool high) { HAL_GPIO_WritePin(convert(gpio.port), convert(gpio.pin), high ? GPIO_PIN_SET : GPIO_PIN_RESET); }
+void Gpio::write(Gpio gpio, bool high) { FastPin(gpio).write(high); }
+
+bool Gpio::read(Gpio gpio) { return FastPin(gpio).read(); }
 
-bool Gpio::read(Gpio gpio) { return HAL_GPIO_ReadPin(convert(gpio.port), convert(gpio.pin)) == GPIO_PIN_SET; }
+void Gpio::setInterruptCallback(Gpio gpio, Callback callback) { _extiCallbacks[gpio.pin] = callback; }
 
 void Gpio::initInput(Gpio gpio) {
     GPIO_InitTypeDef gpioInit{};
@@ -134,6 +103,14 @@ void Gpio::initAnalog(Gpio gpio) {
     HAL_GPIO_Init(convert(gpio.port), &gpioInit);
 }
 
+void Gpio::initExti(Gpio gpio, Mode mode) {
+    GPIO_InitTypeDef gpioInit{};
+    gpioInit.Pin = convert(gpio.pin);
+    gpioInit.Mode = mode == Mode::EXTI_RISING ? GPIO_MODE_IT_RISING : GPIO_MODE_IT_FALLING;
+    gpioInit.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(convert(gpio.port), &gpioInit);
+}
+
 void Gpio::initI2c(Gpio gpio) {
     constexpr uint8_t alternateFuncI2C = 0x04;
     GPIO_InitTypeDef gpioInit{};
@@ -210,30 +187,6 @@ void Gpio::initUsb(Gpio gpio, Mode mode) {
     HAL_GPIO_Init(convert(gpio.port), &gpioInit);
 }
 
-bool Gpio::validGpioConfig(GpioConfig gpioConfig) {
-    Gpio gpio = gpioConfig.gpio;
-    Mode mode = gpioConfig.mode;
-
-    // Return true if mode is always valid
-    if (mode == Mode::NA || mode == Mode::INPUT || mode == Mode::OUTPUT || mode == Mode::ANALOG)
-        return true;
-
-    // Check alternate function list
-    std::array<Mode, NUM_AFS> afs = afList[gpio.getIdx()];
-    for (size_t i = 0; i < afs.size(); i++)
-        if (afs[i] == mode)
-            return true;
-    return false;
-}
-
-uint8_t Gpio::getAlternateFunc(Gpio gpio, Mode mode) {
-    std::array<Mode, NUM_AFS> afs = afList[gpio.getIdx()];
-    for (size_t i = 0; i < NUM_AFS; i++)
-        if (afs[i] == mode)
-            return i;
-    return NUM_AFS;
-}
-
 constexpr GPIO_TypeDef* Gpio::convert(Port port) {
     switch (port) {
         case Port::A:
@@ -254,3 +207,14 @@ constexpr GPIO_TypeDef* Gpio::convert(Port port) {
 }
 
 constexpr uint16_t Gpio::convert(Pin pin) { return 1 << (uint8_t)pin; }
+
+// --- HAL Callback Implementations ---
+extern "C" {
+
+void HAL_GPIO_EXTI_Callback(uint16_t pin) {
+    for (uint8_t i = 0; i < 16; i++)
+        if ((pin & (1 << i)) && Gpio::_extiCallbacks[i])
+            Gpio::_extiCallbacks[i]();
+}
+
+} // extern "C"
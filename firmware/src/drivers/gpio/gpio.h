@@ -6,6 +6,7 @@
 //--------------------------------------------------
 #ifndef BLDC_DRIVERS_GPIO_GPIO_H
 #define BLDC_DRIVERS_GPIO_GPIO_H
+#include <drivers/gpio/fastPin.h>
 #include <drivers/gpio/modes.h>
 #include <drivers/gpio/ports.h>
 
@@ -17,6 +18,24 @@ bool deinit();
 void write(Gpio gpio, bool high);
 bool read(Gpio gpio);
 
+/**
+ * @brief External interrupt callback
+ *
+ * Called from the EXTI interrupt
+ */
+using Callback = void (*)();
+
+/**
+ * @brief Set external interrupt callback
+ *
+ * The GPIO must be configured as EXTI_RISING or EXTI_FALLING in gpioList, and its EXTI IRQ enabled in the interrupt
+ * driver. Only one GPIO per pin number can have an interrupt (EXTI lines are shared between ports)
+ *
+ * @param gpio GPIO
+ * @param callback Callback (nullptr to disable)
+ */
+void setInterruptCallback(Gpio gpio, Callback callback);
+
 static constexpr bool HIGH = true;
 static constexpr bool LOW = false;
 
@@ -76,7 +95,7 @@ struct GpioConfig {
 };
 
 // clang-format off
-inline const std::array gpioList{
+inline constexpr std::array gpioList{
     GpioConfig{SWO_PIN,        Mode::SWO},
     GpioConfig{SWDIO_PIN,      Mode::SWDIO},
     GpioConfig{SWCLK_PIN,      Mode::SWCLK},
@@ -88,6 +107,7 @@ inline const std::array gpioList{
     GpioConfig{IMU_CLK_PIN ,   Mode::SPI2_SCK},
     GpioConfig{IMU_POCI_PIN,   Mode::SPI2_MISO},
     GpioConfig{IMU_PICO_PIN,   Mode::SPI2_MOSI},
+    GpioConfig{IMU_INT1_PIN,   Mode::EXTI_RISING},
     GpioConfig{LED_DI_PIN,     Mode::TIM2_CH1},
     GpioConfig{ENC_CS_PIN,     Mode::OUTPUT},
     GpioConfig{ENC_CLK_PIN,    Mode::SPI3_SCK},
@@ -106,12 +126,93 @@ inline const std::array gpioList{
     GpioConfig{MOTOR_VL_PIN,   Mode::TIM1_CH2N},
     GpioConfig{MOTOR_WH_PIN,   Mode::TIM1_CH3},
     GpioConfig{MOTOR_WL_PIN,   Mode::TIM1_CH3N},
+    GpioConfig{MOTOR_DIAG_PIN, Mode::EXTI_RISING},
     GpioConfig{DEBUG0_PIN,     Mode::OUTPUT},
     GpioConfig{DEBUG1_PIN,     Mode::OUTPUT},
     GpioConfig{DEBUG2_PIN,     Mode::OUTPUT},
 };
 // clang-format on
 
+//---------- Compile-time routing ----------//
+/**
+ * @brief Get alternate function number given the gpio and mode
+ *
+ * @param gpio Gpio port
+ * @param mode Alternate function mode
+ *
+ * @return Column number in the alternate function table, NUM_AFS if the mode is not available for that GPIO
+ */
+constexpr uint8_t getAlternateFunc(Gpio gpio, Mode mode) {
+    for (uint8_t i = 0; i < NUM_AFS; i++)
+        if (afList[gpio.getIdx()][i] == mode)
+            return i;
+    return NUM_AFS;
+}
+
+/**
+ * @brief Check if GPIO configuration is valid
+ *
+ * @param gpioConfig GPIO configuration to check
+ *
+ * @return True if the mode does not need an alternate function or is available for that GPIO
+ */
+constexpr bool isValid(GpioConfig gpioConfig) {
+    Mode mode = gpioConfig.mode;
+    if (mode == Mode::NA || mode == Mode::INPUT || mode == Mode::OUTPUT || mode == Mode::ANALOG || mode == Mode::EXTI_RISING ||
+        mode == Mode::EXTI_FALLING)
+        return true;
+    return getAlternateFunc(gpioConfig.gpio, mode) != NUM_AFS;
+}
+
+/**
+ * @brief Check if any GPIO in gpioList is configured with one of the modes
+ *
+ * Used by the drivers to know which peripherals are in use without scanning gpioList at runtime
+ *
+ * @param modes Modes to look for
+ *
+ * @return True if at least one GPIO uses one of the modes
+ */
+template <typename... Modes>
+constexpr bool isUsed(Modes... modes) {
+    for (const GpioConfig& gpioConfig : gpioList)
+        if (((gpioConfig.mode == modes) || ...))
+            return true;
+    return false;
+}
+
+/**
+ * @brief Get mode of a GPIO in gpioList
+ *
+ * @param gpio GPIO to look for
+ *
+ * @return GPIO mode, NA if the GPIO is not in gpioList
+ */
+constexpr Mode getMode(Gpio gpio) {
+    for (const GpioConfig& gpioConfig : gpioList)
+        if (gpioConfig.gpio == gpio)
+            return gpioConfig.mode;
+    return Mode::NA;
+}
+
+constexpr bool isExti(Mode mode) { return mode == Mode::EXTI_RISING || mode == Mode::EXTI_FALLING; }
+
+constexpr bool validGpioList() {
+    for (size_t i = 0; i < gpioList.size(); i++) {
+        if (!isValid(gpioList[i]))
+            return false;
+        for (size_t j = i + 1; j < gpioList.size(); j++) {
+            if (gpioList[i].gpio == gpioList[j].gpio)
+                return false;
+            // EXTI lines are shared by the pins with the same number
+            if (isExti(gpioList[i].mode) && isExti(gpioList[j].mode) && gpioList[i].gpio.pin == gpioList[j].gpio.pin)
+                return false;
+        }
+    }
+    return true;
+}
+static_assert(validGpioList(), "gpioList has a GPIO used twice, an EXTI line used twice or a mode that is not available for its GPIO");
+
 } // namespace Gpio
 
 #endif // BLDC_DRIVERS_GPIO_GPIO_H
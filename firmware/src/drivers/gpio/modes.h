@@ -15,6 +15,10 @@ enum Mode {
     OUTPUT, ///< Output
     ANALOG, ///< Analog
 
+    //----- External interrupt -----//
+    EXTI_RISING,  ///< Input with rising edge interrupt
+    EXTI_FALLING, ///< Input with falling edge interrupt
+
     //----- I2C -----//
     I2C1_SDA,     ///< I2C1 SDA
     I2C1_SCL,     ///< I2C1 SCL
@@ -39,10 +39,10 @@ struct Gpio {
     Port port;
     Pin pin;
 
-    bool operator==(const Gpio& o) const { return port == o.port && pin == o.pin; }
-    bool operator!=(const Gpio& o) const { return !(*this == o); }
-    bool operator<(const Gpio& o) const { return port < o.port || pin < o.pin; }
-    uint8_t getIdx() const { return uint8_t(port) * 16 + pin; }
+    constexpr bool operator==(const Gpio& o) const { return port == o.port && pin == o.pin; }
+    constexpr bool operator!=(const Gpio& o) const { return !(*this == o); }
+    constexpr bool operator<(const Gpio& o) const { return port < o.port || (port == o.port && pin < o.pin); }
+    constexpr uint8_t getIdx() const { return uint8_t(port) * 16 + pin; }
     std::string toString() const { return char('A' + (int)port) + std::to_string(pin); }
 };
 
@@ -59,7 +59,7 @@ constexpr uint8_t NUM_AFS = 16; ///< Number of alternate functions
 /**
  * @brief Alternate functions available for each Gpio
  */
-inline const std::array<std::array<Mode, NUM_AFS>, 112> afList{{
+inline constexpr std::array<std::array<Mode, NUM_AFS>, 112> afList{{
     /* PA0 */ {NA, TIM2_CH1, TIM5_CH1, TIM8_ETR, NA, NA, NA, USART2_CTS, UART4_TX, NA, NA, NA, NA, NA, NA, NA},
     /* PA1 */ {NA, TIM2_CH2, TIM5_CH2, NA, NA, NA, NA, USART2_RTS, UART4_RX, QUADSPI_BK1_IO3, SAI2_MCLK_B, NA, NA, NA, NA, NA},
     /* PA2 */ {NA, TIM2_CH3, TIM5_CH3, TIM9_CH1, NA, NA, NA, USART2_TX, SAI2_SCK_B, NA, NA, NA, NA, NA, NA, NA},
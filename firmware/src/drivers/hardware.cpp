@@ -4,6 +4,7 @@
 // Date: 2023-09-07
 // By Breno Cunha Queiroz
 //--------------------------------------------------
+#include <common/attaConnector.h>
 #include <drivers/adc/adc.h>
 #include <drivers/clock/clock.h>
 #include <drivers/current/current.h>
@@ -15,6 +16,7 @@
 #include <drivers/interrupt/interrupt.h>
 #include <drivers/motor/motor.h>
 #include <drivers/spi/spi.h>
+#include <drivers/storage/storage.h>
 #include <drivers/timer/timer.h>
 #include <drivers/uart/uart.h>
 #include <drivers/voltage/voltage.h>
@@ -25,6 +27,11 @@
 bool Hardware::init() {
     HAL_Init();
     Clock::init();
+
+    // Enable cycle counter (delayUs and SPI statistics)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
     if (!Gpio::init())
         Error::hardFault("Failed to initialize GPIO driver");
 
@@ -44,9 +51,9 @@ bool Hardware::init() {
         Error::hardFault("Failed to initialize Interrupt driver");
 
     // Initialize debug pins as LOW
-    Gpio::write(Gpio::DEBUG0_PIN, Gpio::LOW);
-    Gpio::write(Gpio::DEBUG1_PIN, Gpio::LOW);
-    Gpio::write(Gpio::DEBUG2_PIN, Gpio::LOW);
+    Gpio::FastPin(Gpio::DEBUG0_PIN).clear();
+    Gpio::FastPin(Gpio::DEBUG1_PIN).clear();
+    Gpio::FastPin(Gpio::DEBUG2_PIN).clear();
 
     // Timer-DMA
     Timer::linkDma(Timer::LED_TIM, Timer::LED_CH, Dma::getHandle(Dma::LED_DMA, Dma::LED_STREAM));
@@ -54,6 +61,18 @@ bool Hardware::init() {
     // Link DMA to UART
     Uart::linkDmaTx(Uart::Peripheral::UART6, Dma::getHandle(Dma::UART_DMA, Dma::UART_TX_STREAM));
     Uart::linkDmaRx(Uart::Peripheral::UART6, Dma::getHandle(Dma::UART_DMA, Dma::UART_RX_STREAM));
+
+    // Link DMA to IMU SPI
+    Spi::linkDmaTx(Spi::Peripheral::SPI2, Dma::getHandle(Dma::IMU_DMA, Dma::IMU_TX_STREAM));
+    Spi::linkDmaRx(Spi::Peripheral::SPI2, Dma::getHandle(Dma::IMU_DMA, Dma::IMU_RX_STREAM));
+
+    // Link DMA to encoder SPI
+    Spi::linkDmaTx(Spi::Peripheral::SPI3, Dma::getHandle(Dma::ENC_DMA, Dma::ENC_TX_STREAM));
+    Spi::linkDmaRx(Spi::Peripheral::SPI3, Dma::getHandle(Dma::ENC_DMA, Dma::ENC_RX_STREAM));
+
+    // Start ADC sampling (the ADC driver starts its DMA stream)
+    if (!Adc::start())
+        Error::hardFault("Failed to start ADC acquisition");
     Hardware::delayMs(1);
 
     // Initialize voltage sense
@@ -77,6 +96,8 @@ bool Hardware::init() {
     // Initialize IMU
     if (!imu.init(Spi::Peripheral::SPI2, Gpio::IMU_CS_PIN))
         Error::hardFault("Failed to initialize IMU");
+    if (!imu.startFifo())
+        Error::hardFault("Failed to start IMU FIFO acquisition");
 
     // Initialize encoder
     if (!encoder.init(Spi::Peripheral::SPI3, Gpio::ENC_CS_PIN))
@@ -86,8 +107,23 @@ bool Hardware::init() {
     //    Error::hardFault("Failed to initialize led driver");
     if (!motor.init())
         Error::hardFault("Failed to initialize motor driver");
-    // if (!AttaConnector::init())
-    //     Error::hardFault("Failed to initialize atta connector");
+
+    // Current calibration, offsets are measured with the motor idle if there is no stored calibration
+    if (!Storage::init())
+        Error::hardFault("Failed to initialize storage");
+    if (!Current::loadCalibration()) {
+        if (!Current::calibrateOffsets())
+            Error::hardFault("Failed to calibrate current offsets");
+        if (!Current::saveCalibration())
+            LOG_WARNING("Hardware", "Failed to save current calibration");
+    }
+    Current::startOnlineCalibration();
+
+    // Encoder reads in lockstep with motor PWM
+    if (!encoder.startPipeline(Timer::MOTOR_TIM))
+        Error::hardFault("Failed to start encoder pipeline");
+    if (!AttaConnector::init())
+        Error::hardFault("Failed to initialize atta connector");
 
     return true;
 }
@@ -25,19 +25,15 @@ I2C_HandleTypeDef hi2c3;
 } // namespace I2c
 
 bool I2c::init() {
-    // Get peripherals in use
-    std::array<bool, size_t(Peripheral::NUM)> inUse;
-    for (Gpio::GpioConfig conf : Gpio::gpioList) {
-        if (conf.mode == Gpio::Mode::I2C1_SDA || conf.mode == Gpio::Mode::I2C1_SCL)
-            inUse[int(Peripheral::I2C1)] = true;
-        else if (conf.mode == Gpio::Mode::I2C2_SDA || conf.mode == Gpio::Mode::I2C2_SCL)
-            inUse[int(Peripheral::I2C2)] = true;
-        else if (conf.mode == Gpio::Mode::I2C3_SDA || conf.mode == Gpio::Mode::I2C3_SCL)
-            inUse[int(Peripheral::I2C3)] = true;
-    }
+    // Get peripherals in use (resolved from gpioList at compile time)
+    constexpr std::array<bool, size_t(Peripheral::NUM)> inUse = {
+        Gpio::isUsed(Gpio::Mode::I2C1_SDA, Gpio::Mode::I2C1_SCL),
+        Gpio::isUsed(Gpio::Mode::I2C2_SDA, Gpio::Mode::I2C2_SCL),
+        Gpio::isUsed(Gpio::Mode::I2C3_SDA, Gpio::Mode::I2C3_SCL),
+    };
 
     // Initialize peripherals
-    for (size_t i = 0; i <= inUse.size(); i++) {
+    for (size_t i = 0; i < inUse.size(); i++) {
         Peripheral peripheral = Peripheral(i);
         if (!inUse[int(peripheral)])
             continue;
@@ -54,7 +50,7 @@ bool I2c::init() {
         hi2c->Init.OwnAddress1 = 0;
         hi2c->Init.OwnAddress2 = 0;
         if (HAL_I2C_Init(hi2c) != HAL_OK) {
-            Log::error("I2c", "Failed to initialize peripheral $0", i + 1);
+            LOG_ERROR("I2c", "Failed to initialize peripheral $0", i + 1);
             return false;
         }
     }
@@ -62,16 +58,16 @@ bool I2c::init() {
     // Check slaves
     for (I2cConfig cfg : i2cList) {
         if (!inUse[int(cfg.peripheral)]) {
-            Log::error("I2c", "Slave $x1 in peripheral $0, but peripheal was not initialized", (int)cfg.peripheral + 1, (int)cfg.address);
+            LOG_ERROR("I2c", "Slave $x1 in peripheral $0, but peripheal was not initialized", (int)cfg.peripheral + 1, (int)cfg.address);
             return false;
         }
         if (!checkReady(cfg.peripheral, cfg.address)) {
-            Log::error("I2c", "Slave $x1 in peripheral $0 not responding", (int)cfg.peripheral + 1, (int)cfg.address);
+            LOG_ERROR("I2c", "Slave $x1 in peripheral $0 not responding", (int)cfg.peripheral + 1, (int)cfg.address);
             return false;
         }
     }
 
-    Log::success("I2c", "Initialized");
+    LOG_SUCCESS("I2c", "Initialized");
     return true;
 }
 
@@ -92,7 +88,7 @@ bool I2c::checkReady(Peripheral peripheral, Address address) {
 
 bool I2c::transmit(Peripheral peripheral, Address address, uint8_t* data, uint16_t len) {
     if (HAL_I2C_Master_Transmit(getHandle(peripheral), address, data, len, timeout) != HAL_OK) {
-        Log::error("I2c", "Failed to transmit $0 bytes to slave $x1 (peripheral $2)", len, (int)address, (int)peripheral + 1);
+        LOG_ERROR("I2c", "Failed to transmit $0 bytes to slave $x1 (peripheral $2)", len, (int)address, (int)peripheral + 1);
         return false;
     }
     return true;
@@ -100,7 +96,7 @@ bool I2c::transmit(Peripheral peripheral, Address address, uint8_t* data, uint16
 
 bool I2c::receive(Peripheral peripheral, Address address, uint8_t* data, uint16_t len) {
     if (HAL_I2C_Master_Receive(getHandle(peripheral), address, data, len, timeout) != HAL_OK) {
-        Log::error("I2c", "Failed to receive $0 bytes from slave $x1 (peripheral $2)", len, (int)address, (int)peripheral + 1);
+        LOG_ERROR("I2c", "Failed to receive $0 bytes from slave $x1 (peripheral $2)", len, (int)address, (int)peripheral + 1);
         return false;
     }
     return true;
@@ -4,15 +4,17 @@
 // Date: 2023-11-25
 // By Breno Cunha Queiroz
 //--------------------------------------------------
+#include <algorithm>
 #include <drivers/hardware.h>
 #include <drivers/imu/imu.h>
 #include <limits>
 #include <utils/log.h>
-#include <vector>
+
+Imu* Imu::_fifoImu = nullptr;
 
 bool Imu::init(Spi::Peripheral peripheral, Gpio::Gpio chipSelect) {
-    _peripheral = peripheral;
-    _chipSelect = chipSelect;
+    _device = {peripheral, chipSelect, Spi::SpiConfig::MODE_3, Spi::SpiConfig::DATA_SIZE_8BIT, Spi::SpiConfig::PRESCALER_4};
+    _device.chipSelect.set();
 
     // Initial read to initialize SPI (not sure why, but first transaction always fails)
     readReg(REG_WHO_AM_I);
@@ -20,7 +22,7 @@ bool Imu::init(Spi::Peripheral peripheral, Gpio::Gpio chipSelect) {
     // Check WHO_AM_I
     uint8_t whoAmI = readReg(REG_WHO_AM_I);
     if (whoAmI != WHO_AM_I_DEFAULT) {
-        Log::error("Imu", "WHO_AM_I mismatch! It is $x0 but it should be $x1", int(whoAmI), int(WHO_AM_I_DEFAULT));
+        LOG_ERROR("Imu", "WHO_AM_I mismatch! It is $x0 but it should be $x1", int(whoAmI), int(WHO_AM_I_DEFAULT));
         return false;
     }
 
@@ -37,7 +39,7 @@ bool Imu::init(Spi::Peripheral peripheral, Gpio::Gpio chipSelect) {
     ctrl2.fullScale = Ctrl2G::FS_500DPS;
     writeReg(REG_CTRL2_G, ctrl2);
 
-    Log::success("Imu", "Initialized");
+    LOG_SUCCESS("Imu", "Initialized");
     return true;
 }
 
@@ -71,41 +73,165 @@ float Imu::getTemp() {
     return (float)tempRaw / 256.0f + 25.0f;
 }
 
+bool Imu::startFifo() {
+    if (_fifoImu != nullptr) {
+        LOG_ERROR("Imu", "FIFO acquisition already running");
+        return false;
+    }
+    _fifo.reset();
+    _fifoOverflows = 0;
+    _draining = false;
+
+    // Transactions are reused on every drain
+    _statusTx = {uint8_t(REG_FIFO_STATUS1 | 0x80), 0x00, 0x00};
+    _statusTransaction = {};
+    _statusTransaction.device = &_device;
+    _statusTransaction.txData = _statusTx.data();
+    _statusTransaction.rxData = _statusRx.data();
+    _statusTransaction.len = _statusTx.size();
+    _statusTransaction.callback = statusComplete;
+    _statusTransaction.context = this;
+    _drainTx.fill(0x00);
+    _drainTx[0] = uint8_t(REG_FIFO_DATA_OUT_TAG | 0x80); // Address wraps from OUT_Z_H back to OUT_TAG
+    _drainTransaction = _statusTransaction;
+    _drainTransaction.txData = _drainTx.data();
+    _drainTransaction.rxData = _drainRx.data();
+    _drainTransaction.callback = drainComplete;
+    _drainTransaction.notify = _notify;
+
+    // Block data update, register address auto increment
+    writeReg(REG_CTRL3_C, 0x44);
+    // Accelerometer/gyroscope at the batch rate
+    Ctrl1XL ctrl1;
+    ctrl1.odr = FIFO_ODR;
+    ctrl1.fullScale = Ctrl1XL::FS_4G;
+    ctrl1.enableLPF2 = true;
+    writeReg(REG_CTRL1_XL, ctrl1);
+    Ctrl2G ctrl2;
+    ctrl2.odr = FIFO_ODR;
+    ctrl2.fullScale = Ctrl2G::FS_500DPS;
+    writeReg(REG_CTRL2_G, ctrl2);
+    // Timestamp counter
+    writeReg(REG_CTRL10_C, 0x20);
+
+    // Watermark, batch rates (BDR_GY | BDR_XL), timestamp every batch + continuous mode
+    writeReg(REG_FIFO_CTRL1, FIFO_WATERMARK & 0xFF);
+    writeReg(REG_FIFO_CTRL2, FIFO_WATERMARK >> 8);
+    writeReg(REG_FIFO_CTRL3, (FIFO_ODR << 4) | FIFO_ODR);
+    writeReg(REG_FIFO_CTRL4, 0x46);
+
+    // Watermark on INT1
+    _fifoImu = this;
+    Gpio::setInterruptCallback(Gpio::IMU_INT1_PIN, watermark);
+    writeReg(REG_INT1_CTRL, 0x08);
+
+    // Watermark may already be reached (no rising edge)
+    if (Gpio::read(Gpio::IMU_INT1_PIN))
+        watermark();
+
+    LOG_SUCCESS("Imu", "FIFO acquisition started");
+    return true;
+}
+
+void Imu::stopFifo() {
+    if (_fifoImu != this)
+        return;
+    writeReg(REG_INT1_CTRL, 0x00);
+    Gpio::setInterruptCallback(Gpio::IMU_INT1_PIN, nullptr);
+    Spi::cancel(&_statusTransaction);
+    Spi::cancel(&_drainTransaction);
+    writeReg(REG_FIFO_CTRL4, 0x00); // Bypass mode
+    _draining = false;
+    _fifoImu = nullptr;
+}
+
+bool Imu::readSample(ImuFifo::Sample& sample) { return _fifo.pop(sample); }
+
+void Imu::setNotify(TaskHandle_t task) {
+    // Single word writes, the drain interrupt sees either task
+    _notify = task;
+    _drainTransaction.notify = task;
+}
+
+const ImuFifo::Stats& Imu::getFifoStats() const { return _fifo.getStats(); }
+
+uint32_t Imu::getFifoOverflows() const { return _fifoOverflows; }
+
 uint8_t Imu::readReg(Reg reg) {
     uint8_t txBuffer[2] = {uint8_t(uint8_t(reg) | 0x80), 0x00}; // Read bit + dummy byte
     uint8_t rxBuffer[2] = {0, 0};
-
-    Gpio::write(_chipSelect, false);
-    Spi::transmitReceive(_peripheral, txBuffer, rxBuffer, 2);
-    Gpio::write(_chipSelect, true);
-
+    Spi::transfer(_device, txBuffer, rxBuffer, 2);
     return rxBuffer[1];
 }
 
 void Imu::writeReg(Reg reg, uint8_t data) {
     uint8_t txBuffer[2] = {uint8_t(reg), data};
-
-    Gpio::write(_chipSelect, false);
-    Spi::transmit(_peripheral, txBuffer, 2);
-    Gpio::write(_chipSelect, true);
+    Spi::transfer(_device, txBuffer, nullptr, 2);
 }
 
 bool Imu::readMultiReg(Reg startReg, uint8_t* data, uint16_t len) {
-    uint8_t address = uint8_t(startReg) | 0x80; // Set read bit
-
-    // Create a transmit buffer with the address and dummy bytes for the read
-    std::vector<uint8_t> txBuffer(len + 1, 0x00);
-    txBuffer[0] = address;
-
-    // Create a receive buffer
-    std::vector<uint8_t> rxBuffer(len + 1, 0x00);
+    if (len > MAX_BURST) {
+        LOG_ERROR("Imu", "Can not read $0 bytes at once (maximum is $1)", len, MAX_BURST);
+        return false;
+    }
 
-    Gpio::write(_chipSelect, false);
-    bool result = Spi::transmitReceive(_peripheral, txBuffer.data(), rxBuffer.data(), len + 1);
-    Gpio::write(_chipSelect, true);
+    // Address followed by dummy bytes for the read
+    uint8_t txBuffer[MAX_BURST + 1] = {uint8_t(uint8_t(startReg) | 0x80)};
+    uint8_t rxBuffer[MAX_BURST + 1];
+    bool result = Spi::transfer(_device, txBuffer, rxBuffer, len + 1);
 
     // Copy the received data (skipping the first dummy byte)
     if (result)
-        std::copy(rxBuffer.begin() + 1, rxBuffer.end(), data);
+        std::copy(rxBuffer + 1, rxBuffer + len + 1, data);
     return result;
 }
+
+void Imu::watermark() {
+    Imu* imu = _fifoImu;
+    if (imu == nullptr || imu->_draining)
+        return; // Checked again when the current drain finishes
+    imu->startStatus();
+}
+
+bool Imu::startStatus() {
+    _draining = true;
+    if (!Spi::submit(&_statusTransaction)) {
+        _draining = false;
+        return false;
+    }
+    return true;
+}
+
+void Imu::statusComplete(Spi::Transaction* transaction, bool success) {
+    Imu* imu = static_cast<Imu*>(transaction->context);
+    if (!success) {
+        imu->_draining = false;
+        return;
+    }
+
+    // FIFO_STATUS1: DIFF_FIFO[7:0], FIFO_STATUS2: WTM_IA[7], OVR_IA[6], FULL_IA[5], DIFF_FIFO[9:8]
+    uint8_t status2 = imu->_statusRx[2];
+    uint16_t words = imu->_statusRx[1] | ((status2 & 0x03) << 8);
+    if (status2 & 0x40)
+        imu->_fifoOverflows++;
+    if (words == 0) {
+        imu->_draining = false;
+        return;
+    }
+    if (words > MAX_DRAIN)
+        words = MAX_DRAIN;
+    imu->_drainTransaction.len = 1 + words * ImuFifo::WORD_SIZE;
+    if (!Spi::submit(&imu->_drainTransaction))
+        imu->_draining = false;
+}
+
+void Imu::drainComplete(Spi::Transaction* transaction, bool success) {
+    Imu* imu = static_cast<Imu*>(transaction->context);
+    if (success)
+        imu->_fifo.decode(imu->_drainRx.data() + 1, transaction->len - 1); // Skip address byte
+    imu->_draining = false;
+
+    // Interrupt line still high, FIFO is above the watermark
+    if (Gpio::read(Gpio::IMU_INT1_PIN))
+        imu->startStatus();
+}
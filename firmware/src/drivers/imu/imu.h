@@ -8,6 +8,7 @@
 #define BLDC_DRIVERS_IMU_IMU_H
 #include <cstdint>
 #include <drivers/gpio/gpio.h>
+#include <drivers/imu/imuFifo.h>
 #include <drivers/spi/spi.h>
 
 // clang-format off
@@ -22,6 +23,8 @@
  */
 class Imu {
   public:
+    static constexpr float FIFO_RATE = 1666.0f; ///< FIFO sample rate in Hz (FIFO_ODR)
+
     bool init(Spi::Peripheral peripheral, Gpio::Gpio chipSelect);
 
     void getGyrAcc(int16_t* gx, int16_t* gy, int16_t* gz, int16_t* ax, int16_t* ay, int16_t* az);
@@ -29,6 +32,44 @@ class Imu {
     std::array<int16_t, 3> getGyr();
     float getTemp();
 
+    /**
+     * @brief Start FIFO acquisition
+     *
+     * Accelerometer and gyroscope are batched in the IMU FIFO at FIFO_ODR with a timestamp per batch. The watermark
+     * interrupt (INT1) starts a DMA drain of the FIFO, and the records are decoded into a sample ring without blocking
+     *
+     * @return True if the FIFO was configured
+     */
+    bool startFifo();
+
+    /**
+     * @brief Stop FIFO acquisition
+     *
+     * The FIFO is set to bypass mode and the watermark interrupt is disabled
+     */
+    void stopFifo();
+
+    /**
+     * @brief Pop oldest FIFO sample
+     *
+     * @param sample Decoded sample
+     *
+     * @return False if no sample is available
+     */
+    bool readSample(ImuFifo::Sample& sample);
+
+    /**
+     * @brief Task notified when drained samples are ready
+     *
+     * The task is given a direct-to-task notification from the drain interrupt, after the samples were decoded
+     *
+     * @param task Task to notify (nullptr to disable)
+     */
+    void setNotify(TaskHandle_t task);
+
+    const ImuFifo::Stats& getFifoStats() const;
+    uint32_t getFifoOverflows() const; ///< Number of drains that found the IMU FIFO overrun
+
   private:
     // clang-format off
     enum Reg : uint8_t {
@@ -173,10 +214,35 @@ class Imu {
     void writeReg(Reg reg, uint8_t data);
     bool readMultiReg(Reg startReg, uint8_t* data, uint16_t len);
 
+    // FIFO drain (interrupt context)
+    static void watermark();
+    static void statusComplete(Spi::Transaction* transaction, bool success);
+    static void drainComplete(Spi::Transaction* transaction, bool success);
+    bool startStatus();
+
     static constexpr uint8_t WHO_AM_I_DEFAULT = 0x6B;
+    static constexpr uint16_t MAX_BURST = 32; ///< Maximum readMultiReg length in bytes
+
+    // FIFO configuration
+    static constexpr uint8_t FIFO_ODR = Ctrl1XL::ODR_1666Hz;                   ///< Accelerometer/gyroscope ODR and batch rate
+    static constexpr uint16_t FIFO_WATERMARK = 48;                             ///< Words (16 batches of acc, gyr and timestamp, ~9.6ms)
+    static constexpr uint16_t MAX_DRAIN = 64;                                  ///< Maximum words per drain
+    static constexpr uint16_t DRAIN_SIZE = 1 + MAX_DRAIN * ImuFifo::WORD_SIZE; ///< Address + FIFO words
+
+    Spi::Device _device; ///< SPI device
 
-    Spi::Peripheral _peripheral; ///< SPI peripehral
-    Gpio::Gpio _chipSelect;      ///< SPI chip select
+    // FIFO state
+    ImuFifo _fifo;
+    Spi::Transaction _statusTransaction;
+    Spi::Transaction _drainTransaction;
+    std::array<uint8_t, 3> _statusTx;
+    std::array<uint8_t, 3> _statusRx;
+    std::array<uint8_t, DRAIN_SIZE> _drainTx;
+    std::array<uint8_t, DRAIN_SIZE> _drainRx;
+    volatile bool _draining = false; ///< Status or drain transaction in progress
+    uint32_t _fifoOverflows = 0;
+    TaskHandle_t _notify = nullptr; ///< Task notified after each drain
+    static Imu* _fifoImu;           ///< IMU running the FIFO acquisition
 };
 
 inline Imu imu;
@@ -0,0 +1,89 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// imuFifo.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <drivers/imu/imuFifo.h>
+
+ImuFifo::ImuFifo() { reset(); }
+
+void ImuFifo::decode(const uint8_t* data, size_t len) {
+    for (size_t i = 0; i + WORD_SIZE <= len; i += WORD_SIZE) {
+        const uint8_t* word = data + i;
+        uint8_t tag = word[0] >> 3;
+        uint8_t count = (word[0] >> 1) & 0x03;
+        _stats.words++;
+
+        // New batch, publish the previous one
+        if (count != _pendingCount) {
+            publish();
+            _pendingCount = count;
+        }
+
+        switch (tag) {
+            case TAG_GYRO_NC:
+                _pending.gyr = {toInt16(word + 1), toInt16(word + 3), toInt16(word + 5)};
+                _pendingFlags |= HAS_GYR;
+                break;
+            case TAG_ACC_NC:
+                _pending.acc = {toInt16(word + 1), toInt16(word + 3), toInt16(word + 5)};
+                _pendingFlags |= HAS_ACC;
+                break;
+            case TAG_TIMESTAMP:
+                _timestamp = uint32_t(word[1]) | (uint32_t(word[2]) << 8) | (uint32_t(word[3]) << 16) | (uint32_t(word[4]) << 24);
+                break;
+            case TAG_TEMPERATURE:
+            case TAG_CFG_CHANGE:
+                break;
+            default:
+                _stats.unknown++;
+                break;
+        }
+    }
+}
+
+bool ImuFifo::pop(Sample& sample) {
+    size_t tail = _tail;
+    if (tail == _head)
+        return false;
+    sample = _ring[tail];
+    _tail = (tail + 1) & (RING_SIZE - 1);
+    return true;
+}
+
+size_t ImuFifo::size() const { return (_head - _tail) & (RING_SIZE - 1); }
+
+void ImuFifo::reset() {
+    _head = 0;
+    _tail = 0;
+    _pending = {};
+    _pendingCount = 0;
+    _pendingFlags = 0;
+    _timestamp = 0;
+    _stats = {};
+}
+
+const ImuFifo::Stats& ImuFifo::getStats() const { return _stats; }
+
+void ImuFifo::publish() {
+    uint8_t flags = _pendingFlags;
+    _pendingFlags = 0;
+    if (flags == 0)
+        return; // Only timestamp/temperature records
+    if (flags != (HAS_ACC | HAS_GYR)) {
+        _stats.incomplete++;
+        return;
+    }
+
+    size_t head = _head;
+    size_t next = (head + 1) & (RING_SIZE - 1);
+    if (next == _tail) {
+        _stats.overruns++;
+        return;
+    }
+    _pending.timestamp = _timestamp;
+    _ring[head] = _pending;
+    _head = next;
+    _stats.samples++;
+}
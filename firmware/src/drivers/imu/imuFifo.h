@@ -0,0 +1,98 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// imuFifo.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_DRIVERS_IMU_IMU_FIFO_H
+#define BLDC_DRIVERS_IMU_IMU_FIFO_H
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Decoder of the ISM330DHCX FIFO records
+ *
+ * Each FIFO word is 7 bytes: a tag (sensor[7:3], batch counter[2:1], parity[0]) followed by 6 data bytes. Records of
+ * the same batch share the tag counter, so gyroscope, accelerometer and timestamp records are grouped by counter and
+ * published as one sample when the counter changes
+ *
+ * Does not depend on the HAL, so it can be built on the host and fed captured FIFO byte streams
+ */
+class ImuFifo {
+  public:
+    static constexpr size_t WORD_SIZE = 7;            ///< Tag + 6 data bytes
+    static constexpr size_t RING_SIZE = 64;           ///< Decoded samples (power of two)
+    static constexpr float TIMESTAMP_PERIOD = 25e-6f; ///< Timestamp LSB in seconds (nominal)
+
+    /// Decoded sample
+    struct Sample {
+        uint32_t timestamp;         ///< Timestamp of the batch (TIMESTAMP_PERIOD ticks)
+        std::array<int16_t, 3> acc; ///< Raw accelerometer
+        std::array<int16_t, 3> gyr; ///< Raw gyroscope
+    };
+
+    struct Stats {
+        uint32_t words;      ///< Decoded words
+        uint32_t samples;    ///< Published samples
+        uint32_t incomplete; ///< Batches dropped without accelerometer or gyroscope record
+        uint32_t unknown;    ///< Words with unknown tag
+        uint32_t overruns;   ///< Samples dropped because the ring was full
+    };
+
+    ImuFifo();
+
+    /**
+     * @brief Decode FIFO words
+     *
+     * Called from the drain complete ISR. The last batch is kept pending until a word of the next batch arrives
+     *
+     * @param data FIFO bytes (multiple of WORD_SIZE)
+     * @param len Number of bytes
+     */
+    void decode(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Pop oldest sample
+     *
+     * Single consumer, can run concurrently with decode()
+     *
+     * @param sample Output sample
+     *
+     * @return False if the ring is empty
+     */
+    bool pop(Sample& sample);
+
+    size_t size() const; ///< Samples in the ring
+    void reset();        ///< Clear ring, pending batch and statistics
+    const Stats& getStats() const;
+
+  private:
+    // clang-format off
+    enum Tag : uint8_t {
+        TAG_GYRO_NC      = 0x01,
+        TAG_ACC_NC       = 0x02,
+        TAG_TEMPERATURE  = 0x03,
+        TAG_TIMESTAMP    = 0x04,
+        TAG_CFG_CHANGE   = 0x05,
+    };
+    // clang-format on
+
+    static constexpr uint8_t HAS_ACC = 0x01;
+    static constexpr uint8_t HAS_GYR = 0x02;
+
+    void publish();
+    static int16_t toInt16(const uint8_t* data) { return int16_t(data[0] | (data[1] << 8)); }
+
+    std::array<Sample, RING_SIZE> _ring;
+    volatile size_t _head; ///< Next write position (producer)
+    volatile size_t _tail; ///< Next read position (consumer)
+
+    Sample _pending;       ///< Batch being assembled
+    uint8_t _pendingCount; ///< Tag counter of the pending batch
+    uint8_t _pendingFlags; ///< Records received for the pending batch
+    uint32_t _timestamp;   ///< Last timestamp (batches without timestamp record keep the previous one)
+    Stats _stats;
+};
+
+#endif // BLDC_DRIVERS_IMU_IMU_FIFO_H
@@ -0,0 +1,187 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// vibration.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <drivers/imu/vibration.h>
+
+static_assert((Vibration::FFT_SIZE & (Vibration::FFT_SIZE - 1)) == 0, "FFT size must be a power of two");
+
+Vibration::Vibration(float sampleRate, float average) : _sampleRate(sampleRate), _average(average) {
+    float sum = 0.0f;
+    for (size_t n = 0; n < FFT_SIZE; n++) {
+        _window[n] = 0.5f - 0.5f * std::cos(2.0f * float(M_PI) * n / FFT_SIZE);
+        sum += _window[n];
+    }
+    _scale = 2.0f / sum;
+
+    for (size_t k = 0; k < FFT_SIZE / 2; k++) {
+        _cos[k] = std::cos(2.0f * float(M_PI) * k / FFT_SIZE);
+        _sin[k] = std::sin(2.0f * float(M_PI) * k / FFT_SIZE);
+    }
+    reset();
+}
+
+bool Vibration::push(const std::array<int16_t, 3>& acc) {
+    for (size_t axis = 0; axis < NUM_AXES; axis++)
+        _input[axis][_fill] = acc[axis];
+    if (++_fill < FFT_SIZE)
+        return false;
+
+    process();
+    return true;
+}
+
+float Vibration::getAmplitude(size_t axis, size_t bin) const {
+    if (bin >= NUM_BINS)
+        return 0.0f;
+    float power = 0.0f;
+    if (axis < NUM_AXES)
+        power = _power[axis][bin];
+    else
+        for (size_t a = 0; a < NUM_AXES; a++)
+            power += _power[a][bin];
+    return std::sqrt(power) * _scale;
+}
+
+std::array<Vibration::Peak, Vibration::NUM_HARMONICS> Vibration::findPeaks(float rotorFrequency) const {
+    std::array<Peak, NUM_HARMONICS> peaks{};
+    if (!(rotorFrequency > 0.0f) || _frames == 0)
+        return peaks;
+
+    float binWidth = getBinWidth();
+    for (size_t h = 0; h < NUM_HARMONICS; h++) {
+        size_t center = size_t(std::lround((h + 1) * rotorFrequency / binWidth));
+        if (center + 1 >= NUM_BINS)
+            break;
+
+        // Largest bin around the harmonic (DC and last bin are excluded so both neighbours exist)
+        size_t lo = center > PEAK_SEARCH ? center - PEAK_SEARCH : 1;
+        size_t hi = std::min(center + PEAK_SEARCH, NUM_BINS - 2);
+        size_t best = lo;
+        for (size_t bin = lo + 1; bin <= hi; bin++)
+            if (getAmplitude(NUM_AXES, bin) > getAmplitude(NUM_AXES, best))
+                best = bin;
+
+        // Hann window interpolation: for a single tone the ratio r of the largest neighbour to the peak bin gives the
+        // offset d = (2r - 1) / (r + 1) exactly, and the window response at d corrects the amplitude (scalloping loss)
+        float a = getAmplitude(NUM_AXES, best - 1);
+        float b = getAmplitude(NUM_AXES, best);
+        float c = getAmplitude(NUM_AXES, best + 1);
+        float ratio = b > 0.0f ? std::max(a, c) / b : 0.0f;
+        float offset = std::max((2.0f * ratio - 1.0f) / (ratio + 1.0f), 0.0f);
+        float gain = offset > 0.0f ? std::sin(float(M_PI) * offset) / (float(M_PI) * offset * (1.0f - offset * offset)) : 1.0f;
+        peaks[h].frequency = (best + (c > a ? offset : -offset)) * binWidth;
+        peaks[h].amplitude = b / gain;
+    }
+    return peaks;
+}
+
+float Vibration::compress(uint16_t* spectrum, size_t size) const {
+    if (size == 0 || NUM_BINS % size != 0)
+        return 0.0f;
+    size_t group = NUM_BINS / size;
+
+    float max = 0.0f;
+    for (size_t bin = 1; bin < NUM_BINS; bin++)
+        max = std::max(max, getAmplitude(NUM_AXES, bin));
+    float lsb = max / UINT16_MAX;
+
+    for (size_t i = 0; i < size; i++) {
+        float amplitude = 0.0f;
+        for (size_t bin = i * group; bin < (i + 1) * group; bin++)
+            amplitude = std::max(amplitude, getAmplitude(NUM_AXES, bin));
+        spectrum[i] = lsb > 0.0f ? uint16_t(std::min(amplitude / lsb + 0.5f, float(UINT16_MAX))) : 0;
+    }
+    return lsb;
+}
+
+void Vibration::setAverage(float average) { _average = std::clamp(average, 0.0f, 1.0f); }
+
+float Vibration::getBinWidth() const { return _sampleRate / FFT_SIZE; }
+
+uint32_t Vibration::getFrames() const { return _frames; }
+
+void Vibration::reset() {
+    _fill = 0;
+    _frames = 0;
+    for (auto& power : _power)
+        power.fill(0.0f);
+}
+
+void Vibration::process() {
+    for (size_t axis = 0; axis < NUM_AXES; axis++) {
+        transform(_input[axis].data());
+
+        // Split step, X[k] = E[k] + W^k O[k] where E and O are the spectra of the even and odd samples
+        constexpr size_t M = FFT_SIZE / 2;
+        const float* z = _work.data();
+        for (size_t k = 0; k < NUM_BINS; k++) {
+            size_t c = (M - k) & (M - 1);
+            float er = 0.5f * (z[2 * k] + z[2 * c]);
+            float ei = 0.5f * (z[2 * k + 1] - z[2 * c + 1]);
+            float or_ = 0.5f * (z[2 * k + 1] + z[2 * c + 1]);
+            float oi = -0.5f * (z[2 * k] - z[2 * c]);
+            float xr = er + _cos[k] * or_ + _sin[k] * oi;
+            float xi = ei + _cos[k] * oi - _sin[k] * or_;
+
+            float power = xr * xr + xi * xi;
+            float& average = _power[axis][k];
+            average = _frames == 0 ? power : average + _average * (power - average);
+        }
+    }
+    _frames++;
+
+    // Keep the second half for the next (overlapping) frame
+    for (auto& input : _input)
+        std::copy(input.begin() + HOP_SIZE, input.end(), input.begin());
+    _fill = FFT_SIZE - HOP_SIZE;
+}
+
+void Vibration::transform(const float* input) {
+    constexpr size_t M = FFT_SIZE / 2; // Complex points, even samples are the real part and odd samples the imaginary part
+    float* z = _work.data();
+
+    // Remove mean (gravity) and apply window
+    float mean = 0.0f;
+    for (size_t n = 0; n < FFT_SIZE; n++)
+        mean += input[n];
+    mean /= FFT_SIZE;
+    for (size_t n = 0; n < FFT_SIZE; n++)
+        z[n] = (input[n] - mean) * _window[n];
+
+    // Bit reversal permutation
+    for (size_t i = 1, j = 0; i < M; i++) {
+        size_t bit = M >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j |= bit;
+        if (i < j) {
+            std::swap(z[2 * i], z[2 * j]);
+            std::swap(z[2 * i + 1], z[2 * j + 1]);
+        }
+    }
+
+    // Radix-2 decimation in time butterflies
+    for (size_t len = 2; len <= M; len <<= 1) {
+        size_t half = len / 2;
+        size_t stride = FFT_SIZE / len; // Twiddle index step (W_M^j = W_N^(2j))
+        for (size_t i = 0; i < M; i += len) {
+            for (size_t j = 0; j < half; j++) {
+                float wr = _cos[j * stride];
+                float wi = -_sin[j * stride];
+                float* a = z + 2 * (i + j);
+                float* b = z + 2 * (i + j + half);
+                float br = b[0] * wr - b[1] * wi;
+                float bi = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - br;
+                b[1] = a[1] - bi;
+                a[0] += br;
+                a[1] += bi;
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// vibration.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_DRIVERS_IMU_VIBRATION_H
+#define BLDC_DRIVERS_IMU_VIBRATION_H
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Accelerometer vibration spectrum
+ *
+ * Accelerometer samples are split in Hann windowed frames of FFT_SIZE samples with 50% overlap. Each frame is
+ * transformed with an in-place radix-2 real FFT (FFT_SIZE / 2 complex FFT and split step) and the power of each bin is
+ * averaged with an exponential running average per axis
+ *
+ * Does not depend on the HAL, so it can be built on the host and fed recorded samples
+ */
+class Vibration {
+  public:
+    static constexpr size_t FFT_SIZE = 256;          ///< Frame length in samples (power of two)
+    static constexpr size_t NUM_BINS = FFT_SIZE / 2; ///< One-sided bins from DC to fs/2 (Nyquist bin dropped)
+    static constexpr size_t HOP_SIZE = FFT_SIZE / 2; ///< New samples per frame (50% overlap)
+    static constexpr size_t NUM_AXES = 3;
+    static constexpr size_t NUM_HARMONICS = 4; ///< Rotor speed multiples searched by findPeaks()
+    static constexpr size_t PEAK_SEARCH = 2;   ///< Bins searched on each side of a harmonic
+
+    /// Spectrum peak
+    struct Peak {
+        float frequency; ///< Interpolated peak frequency in Hz (zero if out of range)
+        float amplitude; ///< Peak amplitude in accelerometer LSB
+    };
+
+    /**
+     * @brief Constructor
+     *
+     * @param sampleRate Accelerometer sample rate in Hz
+     * @param average Running average coefficient (weight of the newest frame, between 0 and 1)
+     */
+    Vibration(float sampleRate, float average = 0.125f);
+
+    /**
+     * @brief Push accelerometer sample
+     *
+     * The frame is transformed when HOP_SIZE new samples are available, so some calls take longer than others
+     *
+     * @param acc Raw accelerometer sample
+     *
+     * @return True if a new frame was added to the average
+     */
+    bool push(const std::array<int16_t, 3>& acc);
+
+    /**
+     * @brief Sinusoid amplitude of one bin
+     *
+     * @param axis Accelerometer axis, or NUM_AXES for the vector amplitude of all axes
+     * @param bin Bin index (frequency bin * getBinWidth())
+     *
+     * @return Averaged amplitude in accelerometer LSB
+     */
+    float getAmplitude(size_t axis, size_t bin) const;
+
+    /**
+     * @brief Find spectrum peaks at multiples of the rotor speed
+     *
+     * The largest bin around each harmonic is refined with the Hann window response, so a single tone is found within
+     * 0.02 bins and 1% of its amplitude wherever it falls between two bins
+     *
+     * @param rotorFrequency Rotor mechanical frequency in Hz
+     *
+     * @return Peak of each harmonic, harmonics above fs/2 have zero frequency and amplitude
+     */
+    std::array<Peak, NUM_HARMONICS> findPeaks(float rotorFrequency) const;
+
+    /**
+     * @brief Compress vector amplitude spectrum
+     *
+     * Adjacent bins are merged by their maximum and scaled to the full uint16 range, so small peaks keep resolution
+     *
+     * @param spectrum Output spectrum
+     * @param size Number of output bins (must divide NUM_BINS)
+     *
+     * @return Amplitude of one output LSB
+     */
+    float compress(uint16_t* spectrum, size_t size) const;
+
+    void setAverage(float average);
+    float getBinWidth() const;
+    uint32_t getFrames() const; ///< Number of averaged frames
+    void reset();               ///< Clear samples and average
+
+  private:
+    void process();
+    void transform(const float* input);
+
+    float _sampleRate;
+    float _average;
+    float _scale; ///< Bin magnitude to sinusoid amplitude (window gain and FFT length)
+
+    std::array<float, FFT_SIZE> _window;                      ///< Hann window
+    std::array<float, FFT_SIZE / 2> _cos;                     ///< Twiddle factors cos(2pi k / FFT_SIZE)
+    std::array<float, FFT_SIZE / 2> _sin;                     ///< Twiddle factors sin(2pi k / FFT_SIZE)
+    std::array<std::array<float, FFT_SIZE>, NUM_AXES> _input; ///< Sample history
+    std::array<float, FFT_SIZE> _work;                        ///< FFT buffer (interleaved complex)
+    std::array<std::array<float, NUM_BINS>, NUM_AXES> _power; ///< Averaged bin power
+    size_t _fill;                                             ///< Samples in _input
+    uint32_t _frames;
+};
+
+#endif // BLDC_DRIVERS_IMU_VIBRATION_H
@@ -4,14 +4,18 @@
 // Date: 2023-12-01
 // By Breno Cunha Queiroz
 //--------------------------------------------------
+#include <drivers/adc/adc.h>
 #include <drivers/dma/dma.h>
 #include <drivers/interrupt/interrupt.h>
+#include <drivers/spi/spi.h>
 #include <drivers/timer/timer.h>
 #include <drivers/uart/uart.h>
 #include <drivers/usb/usb.h>
 #include <system/hal.h>
 #include <utils/error.h>
 #include <utils/log.h>
+#include <utils/profiler.h>
+#include <utils/trace.h>
 // FreeRTOS includes
 #include <FreeRTOS.h>
 #include <task.h>
@@ -20,14 +24,63 @@ bool Interrupt::init() {
     // All peripheral interrupt priorities MUST be >= configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY (5)
     const uint32_t safePrio = configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY;
 
+    // EXTI line 4 (motor driver DIAG), above every other interrupt so the outputs are disabled immediately. The handler
+    // does not call FreeRTOS, so it can be above configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+    HAL_NVIC_SetPriority(EXTI4_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(EXTI4_IRQn);
+
+    // TIM1 update (encoder pipeline trigger)
+    HAL_NVIC_SetPriority(TIM1_UP_TIM10_IRQn, safePrio, 0);
+    HAL_NVIC_EnableIRQ(TIM1_UP_TIM10_IRQn);
+
     // TIM2
     HAL_NVIC_SetPriority(TIM2_IRQn, safePrio, 0);
     HAL_NVIC_EnableIRQ(TIM2_IRQn);
 
+    // TIM6 (control loop tick)
+    HAL_NVIC_SetPriority(TIM6_DAC_IRQn, safePrio, 0);
+    HAL_NVIC_EnableIRQ(TIM6_DAC_IRQn);
+
     // DMA TIM2 CH1
     HAL_NVIC_SetPriority(DMA1_Stream5_IRQn, safePrio, 0);
     HAL_NVIC_EnableIRQ(DMA1_Stream5_IRQn);
 
+    // SPI2 (IMU)
+    HAL_NVIC_SetPriority(SPI2_IRQn, safePrio, 0);
+    HAL_NVIC_EnableIRQ(SPI2_IRQn);
+
+    // DMA SPI2 RX
+    HAL_NVIC_SetPriority(DMA1_Stream3_IRQn, safePrio, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream3_IRQn);
+
+    // DMA SPI2 TX
+    HAL_NVIC_SetPriority(DMA1_Stream4_IRQn, safePrio, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream4_IRQn);
+
+    // EXTI lines 5-9 (IMU INT1 FIFO watermark)
+    HAL_NVIC_SetPriority(EXTI9_5_IRQn, safePrio, 0);
+    HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+
+    // SPI3 (encoder)
+    HAL_NVIC_SetPriority(SPI3_IRQn, safePrio, 0);
+    HAL_NVIC_EnableIRQ(SPI3_IRQn);
+
+    // DMA SPI3 RX
+    HAL_NVIC_SetPriority(DMA1_Stream0_IRQn, safePrio, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream0_IRQn);
+
+    // DMA SPI3 TX
+    HAL_NVIC_SetPriority(DMA1_Stream7_IRQn, safePrio, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream7_IRQn);
+
+    // DMA ADC1 (voltage sense)
+    HAL_NVIC_SetPriority(DMA2_Stream0_IRQn, safePrio, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+
+    // ADC (injected current sense)
+    HAL_NVIC_SetPriority(ADC_IRQn, safePrio, 0);
+    HAL_NVIC_EnableIRQ(ADC_IRQn);
+
     // USART6
     HAL_NVIC_SetPriority(USART6_IRQn, safePrio, 0);
     HAL_NVIC_EnableIRQ(USART6_IRQn);
@@ -44,7 +97,7 @@ bool Interrupt::init() {
     // HAL_NVIC_SetPriority(OTG_FS_IRQn, 0, 0);
     // HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
 
-    Log::success("Interrupt", "Initialized");
+    LOG_SUCCESS("Interrupt", "Initialized");
     return true;
 }
 
@@ -72,10 +125,79 @@ void SysTick_Handler() {
 }
 
 //----- Peripheral interrupts -----//
-void TIM2_IRQHandler() { HAL_TIM_IRQHandler(Timer::getHandle(Timer::TIM2)); }
-void DMA1_Stream5_IRQHandler() { HAL_DMA_IRQHandler(Dma::getHandle(Dma::DMA1, Dma::STREAM5)); }
-void USART6_IRQHandler() { HAL_UART_IRQHandler(Uart::getHandle(Uart::Peripheral::UART6)); }
-void DMA2_Stream1_IRQHandler() { HAL_DMA_IRQHandler(Dma::getHandle(Dma::DMA2, Dma::STREAM1)); }
-void DMA2_Stream6_IRQHandler() { HAL_DMA_IRQHandler(Dma::getHandle(Dma::DMA2, Dma::STREAM6)); }
-void OTG_FS_IRQHandler() { HAL_PCD_IRQHandler(Usb::getHandle()); }
+void ADC_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_ADC);
+    HAL_ADC_IRQHandler(Adc::getHandle(Adc::Peripheral::ADC1));
+}
+void TIM1_UP_TIM10_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_TIM1);
+    HAL_TIM_IRQHandler(Timer::getHandle(Timer::TIM1));
+}
+void TIM2_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_TIM2);
+    HAL_TIM_IRQHandler(Timer::getHandle(Timer::TIM2));
+}
+void TIM6_DAC_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_LOOP);
+    PROFILE_SCOPE(Profiler::PROBE_LOOP);
+    HAL_TIM_IRQHandler(Timer::getHandle(Timer::TIM6));
+}
+void SPI2_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_SPI2);
+    HAL_SPI_IRQHandler(Spi::getHandle(Spi::Peripheral::SPI2));
+}
+void SPI3_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_SPI3);
+    HAL_SPI_IRQHandler(Spi::getHandle(Spi::Peripheral::SPI3));
+}
+void DMA1_Stream0_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_DMA1_STREAM0);
+    HAL_DMA_IRQHandler(Dma::getHandle(Dma::DMA1, Dma::STREAM0));
+}
+void DMA1_Stream3_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_DMA1_STREAM3);
+    HAL_DMA_IRQHandler(Dma::getHandle(Dma::DMA1, Dma::STREAM3));
+}
+void DMA1_Stream4_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_DMA1_STREAM4);
+    HAL_DMA_IRQHandler(Dma::getHandle(Dma::DMA1, Dma::STREAM4));
+}
+void DMA1_Stream5_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_DMA1_STREAM5);
+    HAL_DMA_IRQHandler(Dma::getHandle(Dma::DMA1, Dma::STREAM5));
+}
+void DMA1_Stream7_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_DMA1_STREAM7);
+    HAL_DMA_IRQHandler(Dma::getHandle(Dma::DMA1, Dma::STREAM7));
+}
+void USART6_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_USART6);
+    HAL_UART_IRQHandler(Uart::getHandle(Uart::Peripheral::UART6));
+}
+void DMA2_Stream0_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_DMA2_STREAM0);
+    HAL_DMA_IRQHandler(Dma::getHandle(Dma::DMA2, Dma::STREAM0));
+}
+void DMA2_Stream1_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_DMA2_STREAM1);
+    HAL_DMA_IRQHandler(Dma::getHandle(Dma::DMA2, Dma::STREAM1));
+}
+void DMA2_Stream6_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_DMA2_STREAM6);
+    HAL_DMA_IRQHandler(Dma::getHandle(Dma::DMA2, Dma::STREAM6));
+}
+void OTG_FS_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_USB);
+    HAL_PCD_IRQHandler(Usb::getHandle());
+}
+void EXTI4_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_EXTI4);
+    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_4);
+}
+void EXTI9_5_IRQHandler() {
+    TRACE_SCOPE(Trace::ISR_EXTI9_5);
+    // Pending flags are checked by the HAL, lines without pending interrupt are skipped
+    for (uint16_t pin = GPIO_PIN_5; pin <= GPIO_PIN_9; pin <<= 1)
+        HAL_GPIO_EXTI_IRQHandler(pin);
+}
 }
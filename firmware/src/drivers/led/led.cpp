@@ -4,21 +4,35 @@
 // Date: 2023-11-24
 // By Breno Cunha Queiroz
 //--------------------------------------------------
+#include <algorithm>
+#include <cmath>
 #include <drivers/gpio/gpio.h>
 #include <drivers/led/led.h>
 #include <drivers/timer/timer.h>
+#include <utils/log.h>
+
+Led* Led::_active = nullptr;
 
 bool Led::init() {
-    setColorAll(0, 0, 0);
+    _slots.fill(0);
+    _colors.fill(0);
+    _dirty = (1u << NUM_LEDS) - 1; // Clear LEDs left on by a previous run
+    _busy = false;
+    _active = this;
+    Timer::setDmaCallback(Timer::LED_TIM, halfComplete, transferComplete);
     show();
     return true;
 }
 
 void Led::setColor(uint8_t i, uint8_t r, uint8_t g, uint8_t b) {
     if (i < NUM_LEDS) {
-        _colors[i * 3 + 0] = g;
-        _colors[i * 3 + 1] = r;
-        _colors[i * 3 + 2] = b;
+        uint8_t* color = &_colors[i * 3];
+        if (color[0] == g && color[1] == r && color[2] == b)
+            return;
+        color[0] = g;
+        color[1] = r;
+        color[2] = b;
+        _dirty = _dirty | (1u << i);
     }
 }
 
@@ -28,18 +42,131 @@ void Led::setColorAll(uint8_t r, uint8_t g, uint8_t b) {
 }
 
 bool Led::show() {
-    // Write color bits
-    for (size_t i = 0; i < _colors.size(); i++) {
-        for (size_t b = 0; b < 8; b++) {
-            bool high = (_colors[i] & (1 << (7 - b))) > 0;
-            _pwm[i * 8 + b] = Timer::PERIOD * (high ? DUTY1 : DUTY0);
-        }
+    if (_dirty == 0 || _busy)
+        return true; // Nothing changed, or restarted by the transfer complete interrupt
+    startFrame();
+    return true;
+}
+
+bool Led::startAnimation() {
+    if (_timer == nullptr)
+        _timer = xTimerCreate("Led", pdMS_TO_TICKS(ANIMATION_PERIOD), pdTRUE, this, animate);
+    if (_timer == nullptr || xTimerStart(_timer, 0) != pdPASS) {
+        LOG_ERROR("Led", "Failed to start animation timer");
+        return false;
     }
+    return true;
+}
 
-    // Reset code
-    for (size_t i = NUM_LEDS * 24; i < _pwm.size(); i++)
-        _pwm[i] = 0;
+void Led::stopAnimation() {
+    if (_timer != nullptr)
+        xTimerStop(_timer, 0);
+}
 
-    Timer::startPwmDma(Timer::LED_TIM, Timer::LED_CH, _pwm.data(), _pwm.size());
-    return true;
+void Led::setAnimation(Animation animation) {
+    _animation = animation;
+    _step = 0;
+}
+
+void Led::setStatusColor(uint8_t r, uint8_t g, uint8_t b) { _statusColor = {r, g, b}; }
+
+void Led::setFaultCode(uint8_t code) { _faultCode = code; }
+
+void Led::setRotorAngle(float angle) {
+    float turns = angle * float(0.5 / M_PI);
+    _rotorAngle = uint16_t(int32_t((turns - std::floor(turns)) * 65536.0f));
+}
+
+void Led::startFrame() {
+    // All LEDs are sent in a frame, the colors changed until here are included
+    _busy = true;
+    _dirty = 0;
+    _filled = 0;
+    _sent = 0;
+    fill(0);
+    fill(1);
+    Timer::startPwmDma(Timer::LED_TIM, Timer::LED_CH, _slots.data(), _slots.size());
+}
+
+void Led::fill(size_t half) {
+    uint32_t* slot = &_slots[half * LED_SLOTS];
+    size_t i = _filled++;
+    if (i >= NUM_LEDS) {
+        std::fill(slot, slot + LED_SLOTS, 0); // Reset code (line low)
+        return;
+    }
+
+    // GRB, most significant bit first
+    uint32_t grb = (uint32_t(_colors[i * 3 + 0]) << 16) | (uint32_t(_colors[i * 3 + 1]) << 8) | _colors[i * 3 + 2];
+    for (size_t b = 0; b < LED_SLOTS; b++)
+        slot[b] = (grb & (1u << (LED_SLOTS - 1 - b))) ? DUTY1 : DUTY0;
+}
+
+void Led::halfComplete() {
+    if (_active != nullptr)
+        _active->refill(0);
+}
+
+void Led::transferComplete() {
+    if (_active != nullptr)
+        _active->refill(1);
+}
+
+void Led::refill(size_t half) {
+    if (!_busy)
+        return;
+    if (++_sent < FRAME_LEDS) {
+        if (_filled < FRAME_LEDS)
+            fill(half);
+        return;
+    }
+
+    // Frame finished (the half being sent after the last one only has reset slots)
+    Timer::stopPwmDma(Timer::LED_TIM, Timer::LED_CH);
+    _busy = false;
+    if (_dirty != 0)
+        startFrame();
+}
+
+void Led::animate(TimerHandle_t timer) {
+    Led* led = static_cast<Led*>(pvTimerGetTimerID(timer));
+    led->render();
+    led->show();
+    led->_step++;
+}
+
+void Led::render() {
+    const std::array<uint8_t, 3>& c = _statusColor;
+    switch (_animation) {
+        case Animation::NONE:
+            break;
+        case Animation::STATUS: {
+            // Triangle wave brightness, 2 s period
+            constexpr uint32_t HALF = 1000 / ANIMATION_PERIOD;
+            uint32_t p = _step % (2 * HALF);
+            uint32_t level = p < HALF ? p : 2 * HALF - p;
+            setColorAll(c[0] * level / HALF, c[1] * level / HALF, c[2] * level / HALF);
+            break;
+        }
+        case Animation::FAULT: {
+            // Blinks of 240 ms every 500 ms, then 1 s off
+            constexpr uint32_t BLINK = 500 / ANIMATION_PERIOD;
+            constexpr uint32_t ON = 240 / ANIMATION_PERIOD;
+            constexpr uint32_t PAUSE = 1000 / ANIMATION_PERIOD;
+            uint32_t p = _step % (_faultCode * BLINK + PAUSE);
+            bool on = p < _faultCode * BLINK && p % BLINK < ON;
+            setColorAll(on ? 64 : 0, 0, 0);
+            break;
+        }
+        case Animation::ROTOR: {
+            // LED nearest to the rotor angle lit, neighbours dimmed
+            uint32_t nearest = ((uint32_t(_rotorAngle) * NUM_LEDS + 32768) >> 16) % NUM_LEDS;
+            for (uint32_t i = 0; i < NUM_LEDS; i++) {
+                uint32_t distance = std::min((i - nearest) % NUM_LEDS, (nearest - i) % NUM_LEDS);
+                uint32_t shift = distance == 0 ? 0 : (distance == 1 ? 2 : 8);
+                setColor(i, c[0] >> shift, c[1] >> shift, c[2] >> shift);
+            }
+            break;
+        }
+    }
 }
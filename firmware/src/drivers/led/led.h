@@ -7,26 +7,95 @@
 #ifndef BLDC_DRIVERS_LED_LED_H
 #define BLDC_DRIVERS_LED_LED_H
 #include <drivers/gpio/gpio.h>
+#include <drivers/timer/timer.h>
 
+// FreeRTOS includes
+#include <FreeRTOS.h>
+#include <timers.h>
+
+/**
+ * @brief Driver for the WS2812/SK6805 LED ring
+ *
+ * LEDs are streamed through a circular DMA buffer of two LEDs (48 PWM slots). When one half is sent, the half transfer
+ * or transfer complete interrupt encodes the next LED into it, so only the colors are kept in RAM
+ */
 class Led {
   public:
+    enum class Animation : uint8_t {
+        NONE = 0, ///< Colors only change with setColor()
+        STATUS,   ///< Status color breathing
+        FAULT,    ///< Fault code blinks in red (code blinks, then a pause)
+        ROTOR,    ///< Status color following the rotor angle
+    };
+
     bool init();
 
     void setColor(uint8_t i, uint8_t r, uint8_t g, uint8_t b);
     void setColorAll(uint8_t r, uint8_t g, uint8_t b);
+
+    /**
+     * @brief Send colors to the LEDs
+     *
+     * Does nothing if no LED changed since the last frame. If a frame is being sent, the next one starts when it ends
+     *
+     * @return True if the frame was started or is pending
+     */
     bool show();
 
+    /**
+     * @brief Start animations
+     *
+     * Animations are rendered by a FreeRTOS software timer every ANIMATION_PERIOD, no task is blocked on the LEDs
+     *
+     * @return True if the timer was started
+     */
+    bool startAnimation();
+    void stopAnimation();
+
+    void setAnimation(Animation animation);
+    void setStatusColor(uint8_t r, uint8_t g, uint8_t b);
+    void setFaultCode(uint8_t code); ///< Number of blinks of the fault animation
+    void setRotorAngle(float angle); ///< Rotor angle in radians for the rotor animation (can be called from ISRs)
+
     static constexpr uint32_t NUM_LEDS = 16;
 
   private:
-    static constexpr float SYMBOL_PERIOD = 1.2f;        // 1.2uF (800kHz)
-    static constexpr float T0H = 0.3f;                  // Symbol 0 -> high period (uS)
-    static constexpr float DUTY0 = T0H / SYMBOL_PERIOD; // Symbol 0 -> duty cycle
-    static constexpr float T1H = 0.6f;                  // Symbol 1 -> high period (uS)
-    static constexpr float DUTY1 = T1H / SYMBOL_PERIOD; // Symbol 1 -> duty cycle
-    static constexpr float RST = 85.0f;                 // Reset period (at least 80uS)
+    static constexpr float SYMBOL_PERIOD = 1.2f;                                         // 1.2uF (800kHz)
+    static constexpr float T0H = 0.3f;                                                   // Symbol 0 -> high period (uS)
+    static constexpr uint16_t DUTY0 = uint16_t(Timer::LED_PERIOD * T0H / SYMBOL_PERIOD); // Symbol 0 -> CCR
+    static constexpr float T1H = 0.6f;                                                   // Symbol 1 -> high period (uS)
+    static constexpr uint16_t DUTY1 = uint16_t(Timer::LED_PERIOD * T1H / SYMBOL_PERIOD); // Symbol 1 -> CCR
+    static constexpr float RST = 85.0f;                                                  // Reset period (at least 80uS)
+
+    static constexpr size_t LED_SLOTS = 24;                                                       // PWM periods per LED
+    static constexpr size_t RESET_LEDS = size_t(RST / SYMBOL_PERIOD + LED_SLOTS - 1) / LED_SLOTS; // Reset in LED units
+    static constexpr size_t FRAME_LEDS = NUM_LEDS + RESET_LEDS;                                   // Halves per frame
+    static constexpr uint32_t ANIMATION_PERIOD = 20;                                              // Animation step (ms)
+    static_assert(RESET_LEDS >= 2, "Buffer halves sent after the last refill must be reset slots");
+
+    void startFrame();
+    void fill(size_t half);
+    void refill(size_t half);
+    static void halfComplete();
+    static void transferComplete();
+    static void animate(TimerHandle_t timer);
+    void render();
+
     std::array<uint8_t, NUM_LEDS * 3> _colors;
-    std::array<uint32_t, NUM_LEDS * 24 + size_t(RST / SYMBOL_PERIOD)> _pwm;
+    std::array<uint32_t, 2 * LED_SLOTS> _slots; ///< Circular DMA buffer (CCR is 32-bit on TIM2)
+    volatile uint32_t _dirty;                   ///< LEDs changed since the last frame
+    volatile bool _busy;                        ///< Frame being sent
+    size_t _filled;                             ///< Halves encoded in the current frame
+    size_t _sent;                               ///< Halves sent in the current frame
+    static Led* _active;                        ///< LED ring being streamed
+
+    // Animation
+    TimerHandle_t _timer = nullptr;
+    Animation _animation = Animation::NONE;
+    std::array<uint8_t, 3> _statusColor = {0, 32, 0};
+    uint8_t _faultCode = 0;
+    volatile uint16_t _rotorAngle = 0; ///< Rotor angle (full turn is 65536)
+    uint32_t _step = 0;                ///< Animation steps since the animation was set
 };
 
 inline Led led;
@@ -4,22 +4,92 @@
 // Date: 2023-09-18
 // By Breno Cunha Queiroz
 //--------------------------------------------------
+#include <algorithm>
+#include <drivers/gpio/gpio.h>
 #include <drivers/hardware.h>
 #include <drivers/motor/motor.h>
 #include <drivers/timer/timer.h>
 #include <utils/log.h>
+#include <utils/profiler.h>
+#include <utils/trace.h>
+
+Motor* Motor::_active = nullptr;
 
 bool Motor::init() {
-    setPwm(Timer::MOTOR_TIM, Timer::MOTOR_CH_U, 0);
-    setPwm(Timer::MOTOR_TIM, Timer::MOTOR_CH_V, 0);
-    setPwm(Timer::MOTOR_TIM, Timer::MOTOR_CH_W, 0);
+    static_assert(Timer::MOTOR_CH_U == Timer::CH1 && Timer::MOTOR_CH_V == Timer::CH2 && Timer::MOTOR_CH_W == Timer::CH3,
+                  "Motor phases are committed as CH1, CH2 and CH3");
+    Timer::commitPwm(Timer::MOTOR_TIM, 0, 0, 0);
     startPwm(Timer::MOTOR_TIM, Timer::MOTOR_CH_U);
     startPwm(Timer::MOTOR_TIM, Timer::MOTOR_CH_V);
     startPwm(Timer::MOTOR_TIM, Timer::MOTOR_CH_W);
+
+    // Injected current sampling at the center of the low-side on-time
+    Timer::startCompareTrigger(Timer::MOTOR_TIM, Timer::MOTOR_CH_ADC, Timer::MOTOR_ADC_CCR);
+
+    // Center aligned PWM period is twice the auto-reload value
+    float pwmPeriod = 2.0f * Timer::MOTOR_PERIOD / Timer::getClock(Timer::MOTOR_TIM);
+    _compensation.setDeadTime(Timer::getDeadTime(Timer::MOTOR_TIM) * 1e-9f, pwmPeriod);
+
+    // Driver fault shutdown (the edge is missed if DIAG was already high)
+    _active = this;
+    _fault = false;
+    _faults = 0;
+    Gpio::setInterruptCallback(Gpio::MOTOR_DIAG_PIN, diagHandler);
+    if (Gpio::read(Gpio::MOTOR_DIAG_PIN)) {
+        diagHandler();
+        LOG_WARNING("Motor", "Driver reports a fault");
+    }
     return true;
 }
 
 void Motor::set(float angle, float magnitude) {
+    PROFILE_SCOPE(Profiler::PROBE_MOTOR);
+    std::array<float, 3> duty;
+    TRACE_BEGIN(Trace::MOTOR_MODULATE);
+    bool modulated = modulate(angle, magnitude, duty);
+    TRACE_END(Trace::MOTOR_MODULATE);
+    if (modulated)
+        commit(duty);
+}
+
+void Motor::set(float angle, float magnitude, const std::array<float, 3>& currents) {
+    PROFILE_SCOPE(Profiler::PROBE_MOTOR);
+    std::array<float, 3> duty;
+    TRACE_BEGIN(Trace::MOTOR_MODULATE);
+    bool modulated = modulate(angle, magnitude, duty);
+    TRACE_END(Trace::MOTOR_MODULATE);
+    if (!modulated)
+        return;
+
+    TRACE_BEGIN(Trace::MOTOR_COMPENSATE);
+    std::array<float, 3> correction = _compensation.compute(currents);
+    for (size_t i = 0; i < 3; i++)
+        duty[i] += correction[i];
+    TRACE_END(Trace::MOTOR_COMPENSATE);
+    commit(duty);
+}
+
+void Motor::setCompensationBand(float band) { _compensation.setBand(band); }
+
+uint8_t Motor::getSector() const { return _sector; }
+
+bool Motor::isZeroVector() const { return _magnitude == 0.0f; }
+
+bool Motor::clearFault() {
+    if (Gpio::read(Gpio::MOTOR_DIAG_PIN))
+        return false;
+    _magnitude = 0.0f;
+    Timer::commitPwm(Timer::MOTOR_TIM, 0, 0, 0);
+    _fault = false;
+    Timer::enableOutputs(Timer::MOTOR_TIM);
+    return true;
+}
+
+bool Motor::hasFault() const { return _fault; }
+
+uint32_t Motor::getFaultCount() const { return _faults; }
+
+bool Motor::modulate(float angle, float magnitude, std::array<float, 3>& duty) {
     // Sector from the space vector diagram
     int sector = static_cast<int>(angle / (M_PI / 3));
 
@@ -29,49 +99,69 @@ void Motor::set(float angle, float magnitude) {
     float t2 = magnitude * std::sin(sectorAngle);            // Time ratio second vector from sector
     float t0 = 1.0 - t1 - t2;                                // Time ratio null vector
 
-    // Calculate channel CCR for each phase
-    constexpr uint16_t maxPeriod = Timer::MOTOR_PERIOD;
-    uint16_t uPeriod = maxPeriod;
-    uint16_t vPeriod = maxPeriod;
-    uint16_t wPeriod = maxPeriod;
+    // Calculate duty cycle for each phase
+    float& u = duty[0];
+    float& v = duty[1];
+    float& w = duty[2];
+    u = v = w = 1.0f;
 
     switch (sector) {
         case 0:
-            uPeriod -= (t0 / 2) * maxPeriod;
-            vPeriod -= ((t0 / 2) + t1) * maxPeriod;
-            wPeriod -= ((t0 / 2) + t1 + t2) * maxPeriod;
+            u -= t0 / 2;
+            v -= (t0 / 2) + t1;
+            w -= (t0 / 2) + t1 + t2;
             break;
         case 1:
-            uPeriod -= ((t0 / 2) + t2) * maxPeriod;
-            vPeriod -= (t0 / 2) * maxPeriod;
-            wPeriod -= ((t0 / 2) + t1 + t2) * maxPeriod;
+            u -= (t0 / 2) + t2;
+            v -= t0 / 2;
+            w -= (t0 / 2) + t1 + t2;
             break;
         case 2:
-            uPeriod -= ((t0 / 2) + t1 + t2) * maxPeriod;
-            vPeriod -= (t0 / 2) * maxPeriod;
-            wPeriod -= ((t0 / 2) + t1) * maxPeriod;
+            u -= (t0 / 2) + t1 + t2;
+            v -= t0 / 2;
+            w -= (t0 / 2) + t1;
             break;
         case 3:
-            uPeriod -= ((t0 / 2) + t1 + t2) * maxPeriod;
-            vPeriod -= ((t0 / 2) + t2) * maxPeriod;
-            wPeriod -= (t0 / 2) * maxPeriod;
+            u -= (t0 / 2) + t1 + t2;
+            v -= (t0 / 2) + t2;
+            w -= t0 / 2;
             break;
         case 4:
-            uPeriod -= ((t0 / 2) + t1) * maxPeriod;
-            vPeriod -= ((t0 / 2) + t1 + t2) * maxPeriod;
-            wPeriod -= (t0 / 2) * maxPeriod;
+            u -= (t0 / 2) + t1;
+            v -= (t0 / 2) + t1 + t2;
+            w -= t0 / 2;
             break;
         case 5:
-            uPeriod -= (t0 / 2) * maxPeriod;
-            vPeriod -= ((t0 / 2) + t1 + t2) * maxPeriod;
-            wPeriod -= ((t0 / 2) + t2) * maxPeriod;
+            u -= t0 / 2;
+            v -= (t0 / 2) + t1 + t2;
+            w -= (t0 / 2) + t2;
             break;
         default:
-            Log::error("Motor", "Invalid section");
-            return;
+            LOG_ERROR("Motor", "Invalid section");
+            return false;
     }
+    _sector = sector;
+    _magnitude = magnitude;
+    return true;
+}
+
+void Motor::commit(const std::array<float, 3>& duty) {
+    TRACE_SCOPE(Trace::MOTOR_COMMIT);
+    // PWM mode 1 in center mode, the high side is on while the counter is below the CCR
+    constexpr float maxPeriod = Timer::MOTOR_PERIOD;
+    std::array<uint16_t, 3> ccr;
+    for (size_t i = 0; i < 3; i++)
+        ccr[i] = std::clamp(duty[i], 0.0f, 1.0f) * maxPeriod;
 
-    Timer::setPwm(Timer::MOTOR_TIM, Timer::MOTOR_CH_U, uPeriod);
-    Timer::setPwm(Timer::MOTOR_TIM, Timer::MOTOR_CH_V, vPeriod);
-    Timer::setPwm(Timer::MOTOR_TIM, Timer::MOTOR_CH_W, wPeriod);
+    // All phases switch at the same update event
+    Timer::commitPwm(Timer::MOTOR_TIM, ccr[0], ccr[1], ccr[2]);
+}
+
+void Motor::diagHandler() {
+    // Highest priority interrupt, must not call FreeRTOS
+    Timer::disableOutputs(Timer::MOTOR_TIM);
+    if (_active != nullptr) {
+        _active->_fault = true;
+        _active->_faults = _active->_faults + 1;
+    }
 }
@@ -7,13 +7,85 @@
 #ifndef BLDC_DRIVERS_MOTOR_MOTOR_H
 #define BLDC_DRIVERS_MOTOR_MOTOR_H
 #include <controller/controller.h>
+#include <controller/deadTimeCompensation.h>
 
+/**
+ * @brief Three phase inverter driven by TIM1 complementary outputs
+ *
+ * A rising edge on the TMC6300 DIAG output clears the TIM1 main output enable from the highest priority interrupt, so
+ * every switch is turned off without waiting for any task. The outputs stay off until clearFault()
+ */
 class Motor {
   public:
     bool init();
 
     // void set(Controller::Output control);
     void set(float angle, float magnitude);
+
+    /**
+     * @brief Set voltage vector with dead time compensation
+     *
+     * The duty cycle lost (or gained) to the dead time is added back to each phase with the sign of its current
+     *
+     * @param angle Voltage vector angle in radians [0, 2pi)
+     * @param magnitude Voltage vector magnitude [0, 1]
+     * @param currents Phase currents in amperes (positive out of the inverter), from Current::readPhases()
+     */
+    void set(float angle, float magnitude, const std::array<float, 3>& currents);
+
+    /**
+     * @brief Set current band of the compensation sign ramp
+     *
+     * @param band Current above which the full dead time is compensated in amperes
+     */
+    void setCompensationBand(float band);
+
+    /**
+     * @brief Sector of the last voltage vector set
+     *
+     * @return Space vector sector (0-5)
+     */
+    uint8_t getSector() const;
+
+    /**
+     * @brief Check if the zero vector is applied for the whole PWM period
+     *
+     * @return True if the last magnitude set was zero (or the motor was never set)
+     */
+    bool isZeroVector() const;
+
+    /**
+     * @brief Enable the outputs again after a driver fault
+     *
+     * The zero vector is applied before the outputs are enabled
+     *
+     * @return False if the driver still reports a fault
+     */
+    bool clearFault();
+    bool hasFault() const;          ///< Check if the outputs were disabled by a driver fault
+    uint32_t getFaultCount() const; ///< Driver faults since init
+
+  private:
+    /**
+     * @brief Space vector modulation
+     *
+     * @param angle Voltage vector angle in radians [0, 2pi)
+     * @param magnitude Voltage vector magnitude [0, 1]
+     * @param duty Duty cycle of each phase
+     *
+     * @return False if the angle is out of range
+     */
+    bool modulate(float angle, float magnitude, std::array<float, 3>& duty);
+    void commit(const std::array<float, 3>& duty);
+    static void diagHandler();
+
+    uint8_t _sector = 0;
+    float _magnitude = 0.0f;
+    DeadTimeCompensation _compensation;
+
+    volatile bool _fault = false;
+    volatile uint32_t _faults = 0;
+    static Motor* _active; ///< Motor shut down by the DIAG interrupt
 };
 
 inline Motor motor;
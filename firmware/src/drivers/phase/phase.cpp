@@ -7,33 +7,36 @@
 #include <cstring>
 #include <drivers/hardware.h>
 #include <drivers/phase/phase.h>
+#include <system/hal.h>
 #include <utils/log.h>
 
-// Phase::PhaseId overload
-template <typename Tstream>
-std::ostream& operator<<(Tstream& s, const Phase::PhaseId& p) {
-    s << char('U' + int(p));
-    return s;
+Phase* Phase::_continuous[Phase::NUM] = {};
+uint8_t Phase::_continuousCount = 0;
+uint32_t Phase::_alignStart = 0;
+
+// Phase::PhaseId log overload
+size_t logFormat(char* buffer, size_t size, const Phase::PhaseId& p) {
+    if (size == 0)
+        return 0;
+    buffer[0] = char('U' + int(p));
+    return 1;
 }
 
 bool Phase::init(PhaseId phase, Spi::Peripheral peripheral, Gpio::Gpio chipSelect) {
     _phase = phase;
-    _peripheral = peripheral;
-    _chipSelect = chipSelect;
-
-    // XXX Quick fix to make sure SPI clock is low
-    uint8_t fix;
-    Spi::receive(_peripheral, &fix, sizeof(uint8_t));
+    // Scheduler switches the bus to mode 1 (clock idle low) before asserting the chip select
+    _device = {peripheral, chipSelect, Spi::SpiConfig::MODE_1, Spi::SpiConfig::DATA_SIZE_8BIT, Spi::SpiConfig::PRESCALER_4};
+    _device.chipSelect.set();
 
     // Check DEV_ID (device identification)
     uint16_t manfId = readReg(REG_MANUFACTURER_ID);
     DeviceId devIdReg = readReg(REG_DEVICE_ID);
     if (manfId != MANUFACTURER_ID_DEFAULT) {
-        Log::error("Phase", "MANUFACTURER_ID mismatch! It is $x0 but it should be $x1", int(manfId), int(MANUFACTURER_ID_DEFAULT));
+        LOG_ERROR("Phase", "MANUFACTURER_ID mismatch! It is $x0 but it should be $x1", int(manfId), int(MANUFACTURER_ID_DEFAULT));
         return false;
     }
     if (devIdReg.devId != DEVICE_ID_DEFAULT) {
-        Log::error("Phase", "DEVICE_ID mismatch! It is $x0 but it should be $x1", int(devIdReg.devId), int(DEVICE_ID_DEFAULT));
+        LOG_ERROR("Phase", "DEVICE_ID mismatch! It is $x0 but it should be $x1", int(devIdReg.devId), int(DEVICE_ID_DEFAULT));
         return false;
     }
 
@@ -50,7 +53,7 @@ bool Phase::init(PhaseId phase, Spi::Peripheral peripheral, Gpio::Gpio chipSelec
     writeReg(REG_CONFIG, config);
     _regConfigValue = readReg(REG_CONFIG);
     if (_regConfigValue != config) {
-        Log::error("Phase", "Could not configure CONFIG register for phase $0 ($1 instead of $2)", _phase, _regConfigValue, config);
+        LOG_ERROR("Phase", "Could not configure CONFIG register for phase $0 ($1 instead of $2)", _phase, _regConfigValue, config);
         return false;
     }
 
@@ -65,63 +68,214 @@ bool Phase::init(PhaseId phase, Spi::Peripheral peripheral, Gpio::Gpio chipSelec
     writeReg(REG_ADC_CONFIG, adcConfig);
     _regAdcConfigValue = readReg(REG_ADC_CONFIG);
     if (_regAdcConfigValue != adcConfig) {
-        Log::error("Phase", "Could not configure ADC_CONFIG register for phase $0 ($1 instead of $2)", _phase, _regAdcConfigValue, adcConfig);
+        LOG_ERROR("Phase", "Could not configure ADC_CONFIG register for phase $0 ($1 instead of $2)", _phase, _regAdcConfigValue, adcConfig);
+        return false;
+    }
+
+    LOG_SUCCESS("Phase", "$0 initialized", phase);
+    return true;
+}
+
+float Phase::readCurrent() { return decodeCurrent(readReg(REG_VSHUNT), _regConfigValue.adcRange); }
+
+float Phase::readVoltage() { return decodeVoltage(readReg(REG_VBUS)); }
+
+float Phase::readTemperature() { return decodeTemperature(readReg(REG_DIETEMP)); }
+
+bool Phase::startContinuous(Gpio::Gpio alert) {
+    if (_phase >= NUM || _continuous[_phase] != nullptr) {
+        LOG_ERROR("Phase", "Continuous conversion of phase $0 already started", _phase);
+        return false;
+    }
+    constexpr Gpio::Callback alerts[NUM] = {alertHandler<U>, alertHandler<V>, alertHandler<W>};
+
+    // Stop conversions while the sensor is configured
+    AdcConfig adcConfig = _regAdcConfigValue;
+    adcConfig.mode = AdcConfig::MODE_SHUTDOWN;
+    writeReg(REG_ADC_CONFIG, adcConfig);
+
+    // Alert pin (active low) on conversion ready
+    DiagAlrt diag{};
+    diag.cnvr = 1;
+    writeReg(REG_DIAG_ALRT, diag);
+    readReg(REG_DIAG_ALRT); // Clear pending flags
+
+    // Conversion delay relative to the first started sensor (rounded to the nearest 2 ms step)
+    uint32_t now = DWT->CYCCNT;
+    if (_continuousCount == 0)
+        _alignStart = now;
+    uint32_t stepCycles = SystemCoreClock / 500;
+    uint32_t elapsed = (now - _alignStart + stepCycles / 2) / stepCycles;
+    if (elapsed > CONT_DELAY)
+        LOG_WARNING("Phase", "Phase $0 started $1 ms after the first sensor, conversions will not be aligned", _phase, elapsed * 2);
+    Config config = _regConfigValue;
+    config.convDly = elapsed < CONT_DELAY ? CONT_DELAY - elapsed : 0;
+    writeReg(REG_CONFIG, config);
+    _regConfigValue = config;
+
+    // Reads queued on conversion ready
+    _alert = alert;
+    _reading = false;
+    _sequence = 0;
+    _errors = 0;
+    _overruns = 0;
+    const Reg regs[NUM_READS] = {REG_VSHUNT, REG_VBUS, REG_DIETEMP, REG_DIAG_ALRT};
+    for (size_t i = 0; i < NUM_READS; i++) {
+        _readTx[i] = {uint8_t(uint8_t(regs[i]) << 2 | 0b00000001), 0x00, 0x00};
+        _reads[i] = {};
+        _reads[i].device = &_device;
+        _reads[i].txData = _readTx[i].data();
+        _reads[i].rxData = _readRx[i].data();
+        _reads[i].len = 3;
+    }
+    _reads[NUM_READS - 1].callback = readComplete; // Transactions complete in order
+    _reads[NUM_READS - 1].context = this;
+    _continuous[_phase] = this;
+    _continuousCount++;
+    Gpio::setInterruptCallback(alert, alerts[_phase]);
+
+    // Start conversions, the first one after the conversion delay
+    adcConfig.avg = CONT_AVG;
+    adcConfig.vbusct = CONT_VBUSCT;
+    adcConfig.vshct = CONT_VSHCT;
+    adcConfig.vtct = CONT_VTCT;
+    adcConfig.mode = AdcConfig::MODE_CONT_BUS_SHUNT_TEMP;
+    writeReg(REG_ADC_CONFIG, adcConfig);
+    _regAdcConfigValue = readReg(REG_ADC_CONFIG);
+    if (_regAdcConfigValue != adcConfig) {
+        LOG_ERROR("Phase", "Could not configure ADC_CONFIG register for phase $0 ($1 instead of $2)", _phase, _regAdcConfigValue, adcConfig);
+        stopContinuous();
         return false;
     }
 
-    Log::success("Phase", "$0 initialized", phase);
+    LOG_SUCCESS("Phase", "$0 continuous conversion started (delay $1 ms)", _phase, config.convDly * 2);
     return true;
 }
 
-float Phase::readCurrent() {
-    constexpr float shuntResistance = 0.150f; // 0.150 Ohms
+void Phase::stopContinuous() {
+    if (_phase >= NUM || _continuous[_phase] != this)
+        return;
+    Gpio::setInterruptCallback(_alert, nullptr);
+    for (Spi::Transaction& read : _reads)
+        Spi::cancel(&read);
+    _reading = false;
+    _continuous[_phase] = nullptr;
+    _continuousCount--;
+
+    AdcConfig adcConfig = _regAdcConfigValue;
+    adcConfig.mode = AdcConfig::MODE_SHUTDOWN;
+    writeReg(REG_ADC_CONFIG, adcConfig);
+    _regAdcConfigValue = adcConfig;
+    writeReg(REG_DIAG_ALRT, DiagAlrt{});
+}
+
+std::optional<Phase::Snapshot> Phase::getSnapshot() const {
+    uint32_t sequence;
+    Snapshot snapshot;
+    do {
+        sequence = _sequence;
+        snapshot = _snapshots[sequence & 1];
+    } while (sequence != _sequence); // Published again while copying
+    if (sequence == 0)
+        return std::nullopt;
+    return snapshot;
+}
+
+uint32_t Phase::getErrors() const { return _errors; }
+
+uint32_t Phase::getOverruns() const { return _overruns; }
 
-    // Read shunt voltage drop
-    uint16_t raw = readReg(REG_VSHUNT);
+float Phase::decodeCurrent(uint16_t raw, uint8_t adcRange) {
+    // Shunt voltage drop
     int16_t raw2Comp;
     std::memcpy(&raw2Comp, &raw, sizeof(int16_t));
-    float shuntVoltDrop = raw2Comp * (_regConfigValue.adcRange == Config::ADC_RANGE_163_84_V ? 5e-6f : 1.25e-6f);
+    float shuntVoltDrop = raw2Comp * (adcRange == Config::ADC_RANGE_163_84_V ? 5e-6f : 1.25e-6f);
 
     // Convert to current
-    float current = shuntVoltDrop / shuntResistance;
-    return current;
+    return shuntVoltDrop / SHUNT_RESISTANCE;
 }
 
-float Phase::readVoltage() {
-    // Read voltage
-    uint16_t raw = readReg(REG_VBUS);
+float Phase::decodeVoltage(uint16_t raw) {
     int16_t raw2Comp;
     std::memcpy(&raw2Comp, &raw, sizeof(int16_t));
     // Convert to volts
-    float busVolt = raw2Comp * 3.125e-3f;
-    return busVolt;
+    return raw2Comp * 3.125e-3f;
 }
 
-float Phase::readTemperature() {
-    // Read temperature
-    uint16_t raw = readReg(REG_DIETEMP);
-    raw = (raw & 0x8000) | (raw >> 4); // Fix 12-bit instead 16-bit
+float Phase::decodeTemperature(uint16_t raw) {
+    // 12-bit two's complement value in the upper bits, arithmetic shift keeps the sign
     int16_t raw2Comp;
     std::memcpy(&raw2Comp, &raw, sizeof(int16_t));
     // Convert to celcius
-    float temp = raw2Comp * 0.125f;
-    return temp;
+    return (raw2Comp >> 4) * 0.125f;
+}
+
+bool Phase::isConversionValid(uint16_t raw) {
+    DiagAlrt diag = raw;
+    return diag.memStat && !diag.mathof;
 }
 
 uint16_t Phase::readReg(Reg reg) {
     uint8_t address = uint8_t(reg) << 2 | 0b00000001;
     uint8_t tx[3] = {address, 0x00, 0x00};
-    uint8_t rx[3];
-    Gpio::write(_chipSelect, false);
-    Spi::transmitReceive(_peripheral, tx, rx, 3);
-    Gpio::write(_chipSelect, true);
+    uint8_t rx[3] = {0, 0, 0};
+    Spi::transfer(_device, tx, rx, 3);
     return (rx[1] << 8) | rx[2];
 }
 
 void Phase::writeReg(Reg reg, uint16_t data) {
     uint8_t address = uint8_t(reg) << 2;
     uint8_t tx[3] = {address, uint8_t(data >> 8), uint8_t(data & 0xFF)};
-    Gpio::write(_chipSelect, false);
-    Spi::transmit(_peripheral, tx, 3);
-    Gpio::write(_chipSelect, true);
+    Spi::transfer(_device, tx, nullptr, 3);
+}
+
+template <Phase::PhaseId P>
+void Phase::alertHandler() {
+    Phase* phase = _continuous[P];
+    if (phase == nullptr)
+        return;
+    if (phase->_reading) {
+        phase->_overruns++;
+        return;
+    }
+    phase->_alertCycles = DWT->CYCCNT;
+    phase->startRead();
+}
+
+void Phase::startRead() {
+    _reading = true;
+    for (Spi::Transaction& read : _reads) {
+        if (!Spi::submit(&read)) {
+            for (Spi::Transaction& queued : _reads)
+                Spi::cancel(&queued);
+            _errors++;
+            _reading = false;
+            return;
+        }
+    }
+}
+
+void Phase::readComplete(Spi::Transaction* transaction, bool success) {
+    Phase* phase = static_cast<Phase*>(transaction->context);
+    for (const Spi::Transaction& read : phase->_reads)
+        success = success && read.success;
+
+    uint16_t diag = uint16_t((phase->_readRx[NUM_READS - 1][1] << 8) | phase->_readRx[NUM_READS - 1][2]);
+    if (!success || !isConversionValid(diag))
+        phase->_errors++;
+    else
+        phase->publish();
+    phase->_reading = false;
+}
+
+void Phase::publish() {
+    auto reg = [this](size_t i) { return uint16_t((_readRx[i][1] << 8) | _readRx[i][2]); };
+
+    // Write the buffer not being read, then switch
+    Snapshot& snapshot = _snapshots[(_sequence + 1) & 1];
+    snapshot.current = decodeCurrent(reg(0), _regConfigValue.adcRange);
+    snapshot.voltage = decodeVoltage(reg(1));
+    snapshot.temperature = decodeTemperature(reg(2));
+    snapshot.cycles = _alertCycles;
+    _sequence = _sequence + 1;
 }
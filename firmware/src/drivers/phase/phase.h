@@ -6,8 +6,10 @@
 //--------------------------------------------------
 #ifndef BLDC_DRIVERS_PHASE_PHASE_H
 #define BLDC_DRIVERS_PHASE_PHASE_H
+#include <array>
 #include <drivers/gpio/gpio.h>
 #include <drivers/spi/spi.h>
+#include <optional>
 
 // clang-format off
 // Used to cast register structs to uint16_t
@@ -23,7 +25,15 @@
  */
 class Phase {
   public:
-    enum PhaseId { U = 0, V, W };
+    enum PhaseId { U = 0, V, W, NUM };
+
+    /// Conversion published by the continuous mode
+    struct Snapshot {
+        float current;     ///< Phase current in amperes
+        float voltage;     ///< Bus voltage in volts
+        float temperature; ///< Die temperature in celsius
+        uint32_t cycles;   ///< DWT cycle counter when conversion ready was signaled
+    };
 
     bool init(PhaseId phase, Spi::Peripheral peripheral, Gpio::Gpio chipSelect);
 
@@ -31,6 +41,52 @@ class Phase {
     float readVoltage();
     float readTemperature();
 
+    /**
+     * @brief Start continuous conversion
+     *
+     * Bus, shunt and temperature are converted continuously with the CONT_* averaging and conversion times. The ALERT
+     * pin signals conversion ready, and its interrupt queues the VSHUNT, VBUS, DIETEMP and DIAG_ALRT reads as DMA
+     * transactions (reading DIAG_ALRT clears the flag), so the results are published without blocking
+     *
+     * The conversion delay is set so the first conversion starts CONT_DELAY steps after the first sensor was started.
+     * Sensors started back to back (U, V, W) then convert at the same time, up to the 2 ms conversion delay resolution
+     *
+     * @param alert ALERT pin (active low), must be EXTI_FALLING in gpioList
+     *
+     * @return True if the sensor was configured
+     */
+    bool startContinuous(Gpio::Gpio alert);
+
+    /**
+     * @brief Stop continuous conversion
+     *
+     * The ADC is set to shutdown mode and the ALERT interrupt is disabled
+     */
+    void stopContinuous();
+
+    /**
+     * @brief Latest continuous conversion
+     *
+     * @return Snapshot, or nullopt if no conversion was read yet
+     */
+    std::optional<Snapshot> getSnapshot() const;
+    uint32_t getErrors() const;   ///< Reads that failed or returned a memory/overflow error
+    uint32_t getOverruns() const; ///< Conversions signaled while the previous read was not finished
+
+    //---------- Register decoding ----------//
+    /**
+     * @brief Shunt voltage to phase current
+     *
+     * @param raw VSHUNT register
+     * @param adcRange CONFIG ADC range
+     *
+     * @return Current in amperes
+     */
+    static float decodeCurrent(uint16_t raw, uint8_t adcRange);
+    static float decodeVoltage(uint16_t raw);     ///< VBUS register to volts
+    static float decodeTemperature(uint16_t raw); ///< DIETEMP register to celsius
+    static bool isConversionValid(uint16_t raw);  ///< DIAG_ALRT register, false on memory error or math overflow
+
   private:
     // clang-format off
     enum Reg : uint8_t {
@@ -57,6 +113,13 @@ class Phase {
     uint16_t readReg(Reg reg);
     void writeReg(Reg reg, uint16_t data);
 
+    // Continuous conversion (interrupt context)
+    template <PhaseId P>
+    static void alertHandler();
+    static void readComplete(Spi::Transaction* transaction, bool success);
+    void startRead();
+    void publish();
+
     /* @brief Register config
      * Conversion delay can be used to have all phase sensors reading at approximately the same time. Keep in mind that there may be clock drift.
      */
@@ -172,13 +235,36 @@ class Phase {
     static constexpr uint16_t MANUFACTURER_ID_DEFAULT = 0x5449;
     static constexpr uint16_t DEVICE_ID_DEFAULT = 0x0239;
     static constexpr uint16_t REV_ID_DEFAULT = 0x001;
+    static constexpr float SHUNT_RESISTANCE = 0.150f; ///< Shunt resistance in ohms
+
+    // Continuous conversion configuration (16 * (150 + 540 + 150) us = 13.4 ms per conversion)
+    static constexpr uint8_t CONT_AVG = AdcConfig::AVR_16;       ///< Averaging count
+    static constexpr uint8_t CONT_VBUSCT = AdcConfig::CT_150_US; ///< Bus voltage conversion time
+    static constexpr uint8_t CONT_VSHCT = AdcConfig::CT_540_US;  ///< Shunt voltage conversion time (lowest noise)
+    static constexpr uint8_t CONT_VTCT = AdcConfig::CT_150_US;   ///< Temperature conversion time
+    static constexpr uint8_t CONT_DELAY = 4;                     ///< First conversion delay (2 ms steps)
+    static constexpr size_t NUM_READS = 4;                       ///< VSHUNT, VBUS, DIETEMP and DIAG_ALRT
 
-    PhaseId _phase;              ///< Motor phase
-    Spi::Peripheral _peripheral; ///< SPI peripehral
-    Gpio::Gpio _chipSelect;      ///< SPI chip select
+    PhaseId _phase;      ///< Motor phase
+    Spi::Device _device; ///< SPI device
 
     Config _regConfigValue;       ///< Register config value
     AdcConfig _regAdcConfigValue; ///< Register ADC config value
+
+    // Continuous conversion state
+    Gpio::Gpio _alert;
+    std::array<Spi::Transaction, NUM_READS> _reads;
+    std::array<std::array<uint8_t, 3>, NUM_READS> _readTx;
+    std::array<std::array<uint8_t, 3>, NUM_READS> _readRx;
+    uint32_t _alertCycles;       ///< Cycle counter of the conversion being read
+    volatile bool _reading;      ///< Reads in progress
+    Snapshot _snapshots[2];      ///< Double buffer
+    volatile uint32_t _sequence; ///< Number of published snapshots (selects the buffer)
+    volatile uint32_t _errors;
+    volatile uint32_t _overruns;
+    static Phase* _continuous[NUM];  ///< Sensors in continuous mode
+    static uint8_t _continuousCount; ///< Number of sensors in continuous mode
+    static uint32_t _alignStart;     ///< Cycle counter when the first sensor was started
 };
 
 inline Phase phaseU;
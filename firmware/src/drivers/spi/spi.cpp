@@ -8,13 +8,15 @@
 #include <drivers/spi/spi.h>
 #include <system/hal.h>
 #include <utils/log.h>
+#include <utils/profiler.h>
+#include <utils/trace.h>
 
 namespace Spi {
 
 constexpr uint32_t timeout = 100; ///< Timeout 100ms
 
-SPI_HandleTypeDef* getHandle(Peripheral peripheral);
 SPI_TypeDef* getInstance(Peripheral peripheral);
+Peripheral getPeripheral(SPI_HandleTypeDef* hspi);
 void enableClock(Peripheral peripheral);
 void disableClock(Peripheral peripheral);
 
@@ -26,19 +28,37 @@ SPI_HandleTypeDef hspi2;
 SPI_HandleTypeDef hspi3;
 SPI_HandleTypeDef hspi4;
 
+// Transaction queue and statistics of a peripheral
+struct Bus {
+    std::array<Transaction*, size_t(Priority::NUM)> head; ///< First queued transaction of each priority
+    std::array<Transaction*, size_t(Priority::NUM)> tail; ///< Last queued transaction of each priority
+    Transaction* active;                                  ///< Transaction in progress
+    const Device* device;                                 ///< Device the peripheral is configured for
+    uint32_t started;                                     ///< Cycle counter when the active transaction started
+    Stats stats;
+};
+std::array<Bus, size_t(Peripheral::NUM)> _buses{};
+
+void startNext(Bus& bus);
+bool start(Transaction* transaction);
+void finish(Bus& bus, Transaction* transaction, bool success);
+void configure(Bus& bus, const Device* device);
+bool unlink(Bus& bus, Transaction* transaction);
+Trace::Id transferTraceId(const Transaction* transaction) { return Trace::Id(Trace::SPI1_TRANSFER + int(transaction->device->peripheral)); }
+
+// Internal function to be called by the transfer complete/error ISR
+void transferComplete(SPI_HandleTypeDef* hspi, bool success);
+
 } // namespace Spi
 
 bool Spi::init() {
-    // Get peripherals in use
-    std::array<bool, size_t(Peripheral::NUM)> inUse = {false, false, false, false};
-    for (Gpio::GpioConfig conf : Gpio::gpioList) {
-        if (conf.mode == Gpio::Mode::SPI1_SCK || conf.mode == Gpio::Mode::SPI1_MISO || conf.mode == Gpio::Mode::SPI1_MOSI)
-            inUse[int(Peripheral::SPI1)] = true;
-        else if (conf.mode == Gpio::Mode::SPI2_SCK || conf.mode == Gpio::Mode::SPI2_MISO || conf.mode == Gpio::Mode::SPI2_MOSI)
-            inUse[int(Peripheral::SPI2)] = true;
-        else if (conf.mode == Gpio::Mode::SPI3_SCK || conf.mode == Gpio::Mode::SPI3_MISO || conf.mode == Gpio::Mode::SPI3_MOSI)
-            inUse[int(Peripheral::SPI3)] = true;
-    }
+    // Get peripherals in use (resolved from gpioList at compile time)
+    constexpr std::array<bool, size_t(Peripheral::NUM)> inUse = {
+        Gpio::isUsed(Gpio::Mode::SPI1_SCK, Gpio::Mode::SPI1_MISO, Gpio::Mode::SPI1_MOSI),
+        Gpio::isUsed(Gpio::Mode::SPI2_SCK, Gpio::Mode::SPI2_MISO, Gpio::Mode::SPI2_MOSI),
+        Gpio::isUsed(Gpio::Mode::SPI3_SCK, Gpio::Mode::SPI3_MISO, Gpio::Mode::SPI3_MOSI),
+        Gpio::isUsed(Gpio::Mode::SPI4_SCK, Gpio::Mode::SPI4_MISO, Gpio::Mode::SPI4_MOSI),
+    };
 
     // Initialize peripherals
     for (size_t i = 0; i < inUse.size(); i++) {
@@ -56,7 +76,7 @@ bool Spi::init() {
                 break;
             }
         if (!found) {
-            Log::error("Spi", "No SpiConfig found for peripheral $0. Peripheral will not be initilized", i + 1);
+            LOG_ERROR("Spi", "No SpiConfig found for peripheral $0. Peripheral will not be initilized", i + 1);
             continue;
         }
 
@@ -74,12 +94,12 @@ bool Spi::init() {
         hspi->Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
         hspi->Init.CRCPolynomial = 10;
         if (HAL_SPI_Init(hspi) != HAL_OK) {
-            Log::error("Spi", "Failed to initialize peripheral $0", i + 1);
+            LOG_ERROR("Spi", "Failed to initialize peripheral $0", i + 1);
             return false;
         }
     }
 
-    Log::success("Spi", "Initialized");
+    LOG_SUCCESS("Spi", "Initialized");
     return true;
 }
 
@@ -97,7 +117,7 @@ bool Spi::deinit() {
 
 bool Spi::transmit(Peripheral peripheral, uint8_t* data, uint16_t len) {
     if (HAL_SPI_Transmit(getHandle(peripheral), data, len, timeout) != HAL_OK) {
-        Log::error("Spi", "Failed to transmit $0 bytes", len);
+        LOG_ERROR("Spi", "Failed to transmit $0 bytes", len);
         return false;
     }
     return true;
@@ -105,7 +125,7 @@ bool Spi::transmit(Peripheral peripheral, uint8_t* data, uint16_t len) {
 
 bool Spi::receive(Peripheral peripheral, uint8_t* data, uint16_t len) {
     if (HAL_SPI_Receive(getHandle(peripheral), data, len, timeout) != HAL_OK) {
-        Log::error("Spi", "Failed to receive $0 bytes", len);
+        LOG_ERROR("Spi", "Failed to receive $0 bytes", len);
         return false;
     }
     return true;
@@ -113,12 +133,261 @@ bool Spi::receive(Peripheral peripheral, uint8_t* data, uint16_t len) {
 
 bool Spi::transmitReceive(Peripheral peripheral, uint8_t* txData, uint8_t* rxData, uint16_t len) {
     if (HAL_SPI_TransmitReceive(getHandle(peripheral), txData, rxData, len, timeout) != HAL_OK) {
-        Log::error("Spi", "Failed to transmit/receive $0 bytes", len);
+        LOG_ERROR("Spi", "Failed to transmit/receive $0 bytes", len);
+        return false;
+    }
+    return true;
+}
+
+// clang-format off
+#define LINK_DMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__) \
+    do {                                                         \
+        (__HANDLE__)->__PPP_DMA_FIELD__ = (__DMA_HANDLE__);     \
+        (__DMA_HANDLE__)->Parent = (__HANDLE__);                  \
+    } while (0U)
+// clang-format on
+
+void Spi::linkDmaTx(Peripheral peripheral, Dma::Handle* dmaHandle) { LINK_DMA(getHandle(peripheral), hdmatx, dmaHandle); }
+
+void Spi::linkDmaRx(Peripheral peripheral, Dma::Handle* dmaHandle) { LINK_DMA(getHandle(peripheral), hdmarx, dmaHandle); }
+
+bool Spi::submit(Transaction* transaction) {
+    const Device* device = transaction->device;
+    if (device == nullptr || device->peripheral >= Peripheral::NUM || transaction->len == 0 ||
+        (transaction->txData == nullptr && transaction->rxData == nullptr))
         return false;
+    SPI_HandleTypeDef* hspi = getHandle(device->peripheral);
+    if (hspi->hdmatx == nullptr || hspi->hdmarx == nullptr)
+        return false; // DMA not linked to the peripheral
+    Bus& bus = _buses[int(device->peripheral)];
+
+    transaction->done = false;
+    transaction->success = false;
+    transaction->submitted = DWT->CYCCNT;
+    transaction->next = nullptr;
+
+    UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    size_t p = size_t(transaction->priority) < size_t(Priority::NUM) ? size_t(transaction->priority) : size_t(Priority::LOW);
+    if (bus.tail[p])
+        bus.tail[p]->next = transaction;
+    else
+        bus.head[p] = transaction;
+    bus.tail[p] = transaction;
+    if (bus.active == nullptr)
+        startNext(bus);
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+    return true;
+}
+
+void Spi::cancel(Transaction* transaction) {
+    const Device* device = transaction->device;
+    if (device == nullptr || device->peripheral >= Peripheral::NUM)
+        return;
+    Bus& bus = _buses[int(device->peripheral)];
+
+    UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    if (bus.active == transaction) {
+        HAL_SPI_Abort(getHandle(device->peripheral));
+        bus.active = nullptr;
+        finish(bus, transaction, false);
+        if (bus.active == nullptr)
+            startNext(bus);
+    } else if (unlink(bus, transaction)) {
+        transaction->done = true;
+        transaction->success = false;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+bool Spi::transfer(const Device& device, uint8_t* txData, uint8_t* rxData, uint16_t len, Priority priority) {
+    Transaction transaction;
+    transaction.device = &device;
+    transaction.txData = txData;
+    transaction.rxData = rxData;
+    transaction.len = len;
+    transaction.priority = priority;
+    if (!submit(&transaction)) {
+        LOG_ERROR("Spi", "Failed to submit transaction of $0 words", len);
+        return false;
+    }
+
+    uint32_t tickStart = HAL_GetTick();
+    while (!transaction.done) {
+        if (HAL_GetTick() - tickStart > timeout) {
+            cancel(&transaction);
+            LOG_ERROR("Spi", "Transaction of $0 words timed out", len);
+            return false;
+        }
+    }
+    if (!transaction.success)
+        LOG_ERROR("Spi", "Failed to transmit/receive $0 words", len);
+    return transaction.success;
+}
+
+Spi::Stats Spi::getStats(Peripheral peripheral) {
+    Bus& bus = _buses[int(peripheral)];
+    UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    Stats stats = bus.stats;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+    return stats;
+}
+
+float Spi::getUtilization(Peripheral peripheral) {
+    Stats stats = getStats(peripheral);
+    uint32_t elapsed = DWT->CYCCNT - stats.resetCycles;
+    if (elapsed == 0)
+        return 0.0f;
+    float utilization = float(stats.busyCycles) / elapsed;
+    return utilization > 1.0f ? 1.0f : utilization; // Cycle counter wraps after ~30s at 144MHz
+}
+
+void Spi::resetStats(Peripheral peripheral) {
+    Bus& bus = _buses[int(peripheral)];
+    UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    bus.stats = Stats{};
+    bus.stats.resetCycles = DWT->CYCCNT;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+void Spi::startNext(Bus& bus) {
+    // Must be called with interrupts masked and the bus idle
+    for (size_t p = 0; p < size_t(Priority::NUM); p++) {
+        while (bus.head[p]) {
+            Transaction* transaction = bus.head[p];
+            bus.head[p] = transaction->next;
+            if (bus.head[p] == nullptr)
+                bus.tail[p] = nullptr;
+            transaction->next = nullptr;
+
+            bus.active = transaction;
+            bus.started = DWT->CYCCNT;
+            TRACE_BEGIN(transferTraceId(transaction));
+            configure(bus, transaction->device);
+            if (start(transaction))
+                return;
+
+            // Failed to start, complete it and try the next one
+            bus.active = nullptr;
+            finish(bus, transaction, false);
+            if (bus.active)
+                return; // Callback submitted a transaction that was started
+        }
     }
+}
+
+bool Spi::start(Transaction* transaction) {
+    const Device* device = transaction->device;
+    SPI_HandleTypeDef* hspi = getHandle(device->peripheral);
+    HAL_StatusTypeDef status;
+
+    Gpio::ChipSelect chipSelect(device->chipSelect);
+    if (transaction->txData && transaction->rxData)
+        status = HAL_SPI_TransmitReceive_DMA(hspi, transaction->txData, transaction->rxData, transaction->len);
+    else if (transaction->txData)
+        status = HAL_SPI_Transmit_DMA(hspi, transaction->txData, transaction->len);
+    else
+        status = HAL_SPI_Receive_DMA(hspi, transaction->rxData, transaction->len);
+
+    if (status != HAL_OK)
+        return false;
+    chipSelect.hold(); // Released by finish()
     return true;
 }
 
+void Spi::finish(Bus& bus, Transaction* transaction, bool success) {
+    uint32_t now = DWT->CYCCNT;
+    transaction->device->chipSelect.set();
+
+    // Statistics
+    uint32_t latency = now - transaction->submitted;
+    bus.stats.transactions++;
+    if (!success)
+        bus.stats.errors++;
+    bus.stats.lastLatency = latency;
+    if (latency > bus.stats.maxLatency)
+        bus.stats.maxLatency = latency;
+    bus.stats.sumLatency += latency;
+    bus.stats.busyCycles += now - bus.started;
+    TRACE_END(transferTraceId(transaction));
+    TRACE_VALUE(Trace::SPI_LATENCY, latency);
+
+    transaction->success = success;
+    transaction->done = true;
+    if (transaction->callback)
+        transaction->callback(transaction, success);
+    if (transaction->notify && xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(transaction->notify, &higherPriorityTaskWoken);
+        portYIELD_FROM_ISR(higherPriorityTaskWoken);
+    }
+}
+
+void Spi::configure(Bus& bus, const Device* device) {
+    if (bus.device == device)
+        return;
+    bus.device = device;
+
+    SPI_HandleTypeDef* hspi = getHandle(device->peripheral);
+    hspi->Init.DataSize = convert(device->dataSize);
+    hspi->Init.CLKPolarity = (device->mode == SpiConfig::MODE_0 || device->mode == SpiConfig::MODE_1) ? SPI_POLARITY_LOW : SPI_POLARITY_HIGH;
+    hspi->Init.CLKPhase = (device->mode == SpiConfig::MODE_0 || device->mode == SpiConfig::MODE_2) ? SPI_PHASE_1EDGE : SPI_PHASE_2EDGE;
+    hspi->Init.BaudRatePrescaler = convert(device->prescaler);
+
+    // Peripheral must be disabled to change the configuration (the bus is idle here)
+    SPI_TypeDef* spi = hspi->Instance;
+    spi->CR1 &= ~SPI_CR1_SPE;
+    spi->CR1 = (spi->CR1 & ~(SPI_CR1_CPOL | SPI_CR1_CPHA | SPI_CR1_DFF | SPI_CR1_BR)) | hspi->Init.DataSize | hspi->Init.CLKPolarity |
+               hspi->Init.CLKPhase | hspi->Init.BaudRatePrescaler;
+    spi->CR1 |= SPI_CR1_SPE; // Clock line settles to the new idle level before the chip select is asserted
+
+    // DMA transfer size must match the SPI data size
+    uint32_t peripheralSize = device->dataSize == SpiConfig::DATA_SIZE_16BIT ? DMA_PDATAALIGN_HALFWORD : DMA_PDATAALIGN_BYTE;
+    uint32_t memorySize = device->dataSize == SpiConfig::DATA_SIZE_16BIT ? DMA_MDATAALIGN_HALFWORD : DMA_MDATAALIGN_BYTE;
+    for (DMA_HandleTypeDef* hdma : {hspi->hdmatx, hspi->hdmarx}) {
+        if (hdma == nullptr)
+            continue;
+        hdma->Init.PeriphDataAlignment = peripheralSize;
+        hdma->Init.MemDataAlignment = memorySize;
+        hdma->Instance->CR = (hdma->Instance->CR & ~(DMA_SxCR_PSIZE | DMA_SxCR_MSIZE)) | peripheralSize | memorySize;
+    }
+}
+
+bool Spi::unlink(Bus& bus, Transaction* transaction) {
+    for (size_t p = 0; p < size_t(Priority::NUM); p++) {
+        Transaction* prev = nullptr;
+        for (Transaction* t = bus.head[p]; t; prev = t, t = t->next) {
+            if (t != transaction)
+                continue;
+            if (prev)
+                prev->next = t->next;
+            else
+                bus.head[p] = t->next;
+            if (bus.tail[p] == t)
+                bus.tail[p] = prev;
+            t->next = nullptr;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Spi::transferComplete(SPI_HandleTypeDef* hspi, bool success) {
+    PROFILE_SCOPE(Profiler::PROBE_SPI);
+    Peripheral peripheral = getPeripheral(hspi);
+    if (peripheral == Peripheral::NUM)
+        return;
+    Bus& bus = _buses[int(peripheral)];
+    Transaction* transaction = bus.active;
+    if (transaction == nullptr)
+        return;
+
+    // Chain the next transaction from the interrupt, so the bus does not wait for a task to run
+    bus.active = nullptr;
+    finish(bus, transaction, success);
+    if (bus.active == nullptr)
+        startNext(bus);
+}
+
 SPI_HandleTypeDef* Spi::getHandle(Peripheral peripheral) {
     switch (peripheral) {
         case Peripheral::SPI1:
@@ -139,6 +408,13 @@ SPI_HandleTypeDef* Spi::getHandle(Peripheral peripheral) {
     return nullptr;
 }
 
+Spi::Peripheral Spi::getPeripheral(SPI_HandleTypeDef* hspi) {
+    for (size_t i = 0; i < size_t(Peripheral::NUM); i++)
+        if (getHandle(Peripheral(i)) == hspi)
+            return Peripheral(i);
+    return Peripheral::NUM;
+}
+
 SPI_TypeDef* Spi::getInstance(Peripheral peripheral) {
     switch (peripheral) {
         case Peripheral::SPI1:
@@ -230,3 +506,16 @@ uint32_t Spi::convert(SpiConfig::DataSize ds) {
             return SPI_DATASIZE_8BIT; // Default to 8-bit
     }
 }
+
+// --- HAL Callback Implementations ---
+extern "C" {
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi) { Spi::transferComplete(hspi, true); }
+
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef* hspi) { Spi::transferComplete(hspi, true); }
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef* hspi) { Spi::transferComplete(hspi, true); }
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi) { Spi::transferComplete(hspi, false); }
+
+} // extern "C"
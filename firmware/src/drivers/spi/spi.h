@@ -8,6 +8,11 @@
 #define BLDC_DRIVERS_SPI_SPI_H
 #include <array>
 #include <cstdint>
+#include <drivers/dma/dma.h>
+#include <drivers/gpio/gpio.h>
+// FreeRTOS includes
+#include <FreeRTOS.h>
+#include <task.h>
 
 namespace Spi {
 
@@ -61,6 +66,31 @@ bool receive(Peripheral peripheral, uint8_t* data, uint16_t len);
  */
 bool transmitReceive(Peripheral peripheral, uint8_t* txData, uint8_t* rxData, uint16_t len);
 
+/**
+ * @brief Link DMA to SPI TX
+ *
+ * @param peripheral Spi peripheral
+ * @param dmaHandle DMA handle
+ */
+void linkDmaTx(Peripheral peripheral, Dma::Handle* dmaHandle);
+
+/**
+ * @brief Link DMA to SPI RX
+ *
+ * @param peripheral Spi peripheral
+ * @param dmaHandle DMA handle
+ */
+void linkDmaRx(Peripheral peripheral, Dma::Handle* dmaHandle);
+
+/**
+ * @brief Get SPI handle
+ *
+ * @param peripheral Spi peripheral
+ *
+ * @return SPI handle
+ */
+SPI_HandleTypeDef* getHandle(Peripheral peripheral);
+
 //---------- SPI configs ----------//
 struct SpiConfig {
     enum Mode { MODE_0 = 0, MODE_1, MODE_2, MODE_3 };
@@ -88,6 +118,132 @@ inline const std::array spiList{
     SpiConfig{Peripheral::SPI3, SpiConfig::MODE_1, SpiConfig::CS_SOFT, SpiConfig::PRESCALER_4, SpiConfig::DATA_SIZE_16BIT},
 };
 
+//---------- Transaction scheduler ----------//
+/**
+ * @brief Device connected to a SPI bus
+ *
+ * The scheduler drives the chip select and reconfigures the peripheral (mode, data size, prescaler) when the bus
+ * switches between devices, so devices with different settings can share the same peripheral
+ */
+struct Device {
+    Peripheral peripheral;
+    Gpio::FastPin chipSelect;
+    SpiConfig::Mode mode;
+    SpiConfig::DataSize dataSize;
+    SpiConfig::Prescaler prescaler;
+};
+
+/// Transaction priority, higher priority transactions are started first when the bus becomes free
+enum class Priority : uint8_t { HIGH = 0, NORMAL, LOW, NUM };
+
+struct Transaction;
+
+/**
+ * @brief Transaction complete callback
+ *
+ * Called from the interrupt, the next queued transaction is only started after it returns. It is allowed to submit
+ * new transactions (including the same one)
+ *
+ * @param transaction Completed transaction
+ * @param success False if the transfer failed
+ */
+using Callback = void (*)(Transaction* transaction, bool success);
+
+/**
+ * @brief DMA transaction
+ *
+ * Owned by the caller, the transaction and its buffers must stay valid until it completes. No memory is allocated by
+ * the scheduler, queued transactions are linked through the next pointer
+ */
+struct Transaction {
+    const Device* device = nullptr;
+    uint8_t* txData = nullptr; ///< Data to transmit (nullptr to only receive)
+    uint8_t* rxData = nullptr; ///< Received data (nullptr to only transmit)
+    uint16_t len = 0;          ///< Data length in words (dependent on device data size)
+    Priority priority = Priority::NORMAL;
+    Callback callback = nullptr;   ///< Called on completion (optional)
+    void* context = nullptr;       ///< User data for the callback
+    TaskHandle_t notify = nullptr; ///< Task notified on completion (optional)
+
+    // Scheduler state
+    volatile bool done = false;    ///< Transaction completed
+    volatile bool success = false; ///< Transaction completed successfully
+    uint32_t submitted = 0;        ///< Cycle counter when submitted
+    Transaction* next = nullptr;   ///< Next queued transaction
+};
+
+/// Bus statistics (times in CPU cycles)
+struct Stats {
+    uint32_t transactions; ///< Completed transactions
+    uint32_t errors;       ///< Failed transactions
+    uint32_t lastLatency;  ///< Time from submit to completion of the last transaction
+    uint32_t maxLatency;   ///< Maximum time from submit to completion
+    uint64_t sumLatency;   ///< Sum of the time from submit to completion
+    uint64_t busyCycles;   ///< Time with a transfer in progress
+    uint32_t resetCycles;  ///< Cycle counter when the statistics were reset
+};
+
+/**
+ * @brief Queue a transaction
+ *
+ * Returns immediately, the transaction is started as soon as the bus is free. Can be called from interrupts
+ *
+ * @param transaction Transaction to queue
+ *
+ * @return True if the transaction was queued
+ */
+bool submit(Transaction* transaction);
+
+/**
+ * @brief Remove a transaction from the queue
+ *
+ * If the transaction is in progress the transfer is aborted
+ *
+ * @param transaction Transaction to remove
+ */
+void cancel(Transaction* transaction);
+
+/**
+ * @brief Blocking transaction
+ *
+ * The transaction is queued as any other and the caller waits for its completion. The wait is busy because device
+ * transactions last only a few microseconds, shorter than a context switch
+ *
+ * @param device SPI device
+ * @param txData Data to transmit (nullptr to only receive)
+ * @param rxData Received data (nullptr to only transmit)
+ * @param len Data length in words (dependent on device data size)
+ * @param priority Transaction priority
+ *
+ * @return True if transmitted/received successfully
+ */
+bool transfer(const Device& device, uint8_t* txData, uint8_t* rxData, uint16_t len, Priority priority = Priority::NORMAL);
+
+/**
+ * @brief Get bus statistics
+ *
+ * @param peripheral Spi peripheral
+ *
+ * @return Statistics since the last reset
+ */
+Stats getStats(Peripheral peripheral);
+
+/**
+ * @brief Get bus utilization
+ *
+ * @param peripheral Spi peripheral
+ *
+ * @return Fraction of the time with a transfer in progress since the last reset (between 0 and 1)
+ */
+float getUtilization(Peripheral peripheral);
+
+/**
+ * @brief Reset bus statistics
+ *
+ * @param peripheral Spi peripheral
+ */
+void resetStats(Peripheral peripheral);
+
 }; // namespace Spi
 
 #endif // BLDC_DRIVERS_SPI_SPI_H
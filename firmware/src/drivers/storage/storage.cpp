@@ -0,0 +1,180 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// storage.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <array>
+#include <cstring>
+#include <drivers/storage/storage.h>
+#include <system/hal.h>
+#include <utils/log.h>
+
+namespace Storage {
+
+constexpr uint16_t MAGIC = 0xCA1B;
+constexpr uint32_t ERASED = 0xFFFFFFFF;
+constexpr uint32_t SECTOR = FLASH_SECTOR_7;
+
+// Record header, followed by the data padded to a word
+struct Header {
+    uint16_t magic;
+    uint8_t id;
+    uint8_t reserved;
+    uint16_t size;
+    uint16_t crc; ///< CRC of the data
+};
+static_assert(sizeof(Header) == 8, "Header must be two words");
+
+/**
+ * @brief Find latest valid record
+ *
+ * @param id Record id
+ * @param end End of the written area (first free address)
+ *
+ * @return Record address, 0 if not found
+ */
+uint32_t find(Id id, uint32_t* end);
+
+bool erase();
+bool program(uint32_t address, const void* data, uint16_t size);
+uint16_t crc16(const uint8_t* data, uint16_t size);
+uint16_t recordSize(uint16_t size);
+
+} // namespace Storage
+
+bool Storage::init() {
+    uint32_t end;
+    find(Id::NUM, &end);
+
+    // Anything after the last record must be erased, otherwise the sector is corrupted
+    for (uint32_t address = end; address < SECTOR_ADDRESS + SECTOR_SIZE; address += 4)
+        if (*reinterpret_cast<const volatile uint32_t*>(address) != ERASED) {
+            LOG_WARNING("Storage", "Corrupted sector, erasing");
+            if (!erase())
+                return false;
+            break;
+        }
+
+    LOG_SUCCESS("Storage", "Initialized ($0 bytes used)", end - SECTOR_ADDRESS);
+    return true;
+}
+
+bool Storage::load(Id id, void* data, uint16_t size) {
+    uint32_t end;
+    uint32_t address = find(id, &end);
+    if (address == 0)
+        return false;
+
+    Header header;
+    std::memcpy(&header, reinterpret_cast<const void*>(address), sizeof(Header));
+    if (header.size != size) {
+        LOG_WARNING("Storage", "Record $0 has $1 bytes, expected $2", int(id), header.size, size);
+        return false;
+    }
+    std::memcpy(data, reinterpret_cast<const void*>(address + sizeof(Header)), size);
+    return true;
+}
+
+bool Storage::store(Id id, const void* data, uint16_t size) {
+    if (size > MAX_RECORD_SIZE || id >= Id::NUM) {
+        LOG_ERROR("Storage", "Invalid record $0 ($1 bytes)", int(id), size);
+        return false;
+    }
+
+    uint32_t end;
+    find(Id::NUM, &end);
+    if (end + recordSize(size) > SECTOR_ADDRESS + SECTOR_SIZE) {
+        // Keep the latest record of the other ids
+        std::array<std::array<uint8_t, sizeof(Header) + MAX_RECORD_SIZE>, size_t(Id::NUM)> records;
+        std::array<uint16_t, size_t(Id::NUM)> sizes{};
+        for (size_t i = 1; i < size_t(Id::NUM); i++) {
+            uint32_t address = find(Id(i), &end);
+            if (address == 0 || Id(i) == id)
+                continue;
+            Header header;
+            std::memcpy(&header, reinterpret_cast<const void*>(address), sizeof(Header));
+            sizes[i] = header.size;
+            std::memcpy(records[i].data(), reinterpret_cast<const void*>(address + sizeof(Header)), header.size);
+        }
+
+        if (!erase())
+            return false;
+        end = SECTOR_ADDRESS;
+        for (size_t i = 1; i < size_t(Id::NUM); i++) {
+            if (sizes[i] == 0)
+                continue;
+            Header header{MAGIC, uint8_t(i), 0xFF, sizes[i], crc16(records[i].data(), sizes[i])};
+            if (!program(end, &header, sizeof(Header)) || !program(end + sizeof(Header), records[i].data(), sizes[i]))
+                return false;
+            end += recordSize(sizes[i]);
+        }
+    }
+
+    // Header first, a record interrupted while writing fails the CRC check
+    Header header{MAGIC, uint8_t(id), 0xFF, size, crc16(static_cast<const uint8_t*>(data), size)};
+    if (!program(end, &header, sizeof(Header)) || !program(end + sizeof(Header), data, size)) {
+        LOG_ERROR("Storage", "Failed to store record $0", int(id));
+        return false;
+    }
+    return true;
+}
+
+uint32_t Storage::find(Id id, uint32_t* end) {
+    uint32_t found = 0;
+    uint32_t address = SECTOR_ADDRESS;
+    while (address + sizeof(Header) <= SECTOR_ADDRESS + SECTOR_SIZE) {
+        Header header;
+        std::memcpy(&header, reinterpret_cast<const void*>(address), sizeof(Header));
+        if (header.magic != MAGIC || address + recordSize(header.size) > SECTOR_ADDRESS + SECTOR_SIZE)
+            break; // Erased or corrupted
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(address + sizeof(Header));
+        if (header.id == uint8_t(id) && crc16(data, header.size) == header.crc)
+            found = address;
+        address += recordSize(header.size);
+    }
+    *end = address;
+    return found;
+}
+
+bool Storage::erase() {
+    HAL_FLASH_Unlock();
+    FLASH_EraseInitTypeDef eraseInit{};
+    eraseInit.TypeErase = FLASH_TYPEERASE_SECTORS;
+    eraseInit.Sector = SECTOR;
+    eraseInit.NbSectors = 1;
+    eraseInit.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+    uint32_t sectorError;
+    HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&eraseInit, &sectorError);
+    HAL_FLASH_Lock();
+    if (status != HAL_OK) {
+        LOG_ERROR("Storage", "Failed to erase sector");
+        return false;
+    }
+    return true;
+}
+
+bool Storage::program(uint32_t address, const void* data, uint16_t size) {
+    HAL_FLASH_Unlock();
+    bool success = true;
+    for (uint16_t i = 0; i < size && success; i += 4) {
+        uint32_t word = ERASED;
+        std::memcpy(&word, static_cast<const uint8_t*>(data) + i, size - i < 4 ? size - i : 4);
+        success = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address + i, word) == HAL_OK;
+    }
+    HAL_FLASH_Lock();
+    return success;
+}
+
+uint16_t Storage::crc16(const uint8_t* data, uint16_t size) {
+    // CRC-16/CCITT-FALSE
+    uint16_t crc = 0xFFFF;
+    for (uint16_t i = 0; i < size; i++) {
+        crc ^= uint16_t(data[i]) << 8;
+        for (uint8_t b = 0; b < 8; b++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+uint16_t Storage::recordSize(uint16_t size) { return sizeof(Header) + ((size + 3) & ~3); }
@@ -0,0 +1,59 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// storage.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_DRIVERS_STORAGE_STORAGE_H
+#define BLDC_DRIVERS_STORAGE_STORAGE_H
+#include <cstdint>
+
+/**
+ * @brief Persistent storage
+ *
+ * Records are appended to the last flash sector (reserved in the linker script), and loading returns the latest valid
+ * record with the requested id. When the sector is full, the latest record of each id is kept and the sector is
+ * erased and rewritten
+ *
+ * @warning Erasing a 128KB sector takes ~1s and stalls code execution from flash, only store when the motor is idle
+ */
+namespace Storage {
+
+enum class Id : uint8_t { CURRENT_CALIBRATION = 1, NUM };
+
+/**
+ * @brief Initialize storage driver
+ *
+ * Scans the storage sector, erasing it if it does not contain valid records
+ */
+bool init();
+
+/**
+ * @brief Load record
+ *
+ * @param id Record id
+ * @param data Record data
+ * @param size Record size in bytes (must match the stored size)
+ *
+ * @return True if a valid record was found
+ */
+bool load(Id id, void* data, uint16_t size);
+
+/**
+ * @brief Store record
+ *
+ * @param id Record id
+ * @param data Record data
+ * @param size Record size in bytes (maximum MAX_RECORD_SIZE)
+ *
+ * @return True if stored successfully
+ */
+bool store(Id id, const void* data, uint16_t size);
+
+constexpr uint32_t SECTOR_ADDRESS = 0x08060000; ///< Flash sector 7
+constexpr uint32_t SECTOR_SIZE = 128 * 1024;
+constexpr uint16_t MAX_RECORD_SIZE = 64;
+
+}; // namespace Storage
+
+#endif // BLDC_DRIVERS_STORAGE_STORAGE_H
@@ -23,13 +23,69 @@ namespace Timer {
  */
 bool initPwm(Timer timer, TimerConfig cfg);
 
+/**
+ * @brief Initialize timer as trigger relay
+ *
+ * The timer is reset by the master TRGO (reset slave mode), and the reset is output on its own TRGO. Used to route a
+ * master trigger to peripherals that can not be triggered by the master directly
+ *
+ * @param timer Timer to configure
+ * @param cfg Timer configuration
+ *
+ * @return True if success
+ */
+bool initTrigger(Timer timer, TimerConfig cfg);
+
+/**
+ * @brief Initialize timer as periodic interrupt source
+ *
+ * Prescaler and period are computed from the frequency (checked at compile time to be exact). The update interrupt is
+ * enabled by setUpdateCallback()
+ *
+ * @param timer Timer to configure
+ * @param cfg Timer configuration
+ *
+ * @return True if success
+ */
+bool initInterrupt(Timer timer, TimerConfig cfg);
+
+/**
+ * @brief Initialize timer in PWM input mode
+ *
+ * The rising edge of the input resets the counter and is captured by the input channel, the falling edge is captured
+ * by the paired channel
+ *
+ * @param timer Timer to configure
+ * @param cfg Timer configuration
+ *
+ * @return True if success
+ */
+bool initCapture(Timer timer, TimerConfig cfg);
+
+/**
+ * @brief Initialize timer in encoder mode
+ *
+ * @param timer Timer to configure
+ * @param cfg Timer configuration
+ *
+ * @return True if success
+ */
+bool initEncoder(Timer timer, TimerConfig cfg);
+
+/**
+ * @brief Get internal trigger connecting two timers
+ *
+ * @param slave Slave timer
+ * @param master Master timer
+ *
+ * @return Trigger selection (TIM_TS_ITRx), TIM_TS_NONE if not connected
+ */
+uint32_t getInternalTrigger(Timer slave, Timer master);
+
 TIM_TypeDef* getInstance(Timer timer);
 void enableClock(Timer timer);
 void disableClock(Timer timer);
 
-Timer gpioModeToTimer(Gpio::Mode mode);
-Channel gpioModeToChannel(Gpio::Mode mode);
-
 static constexpr uint16_t convert(CounterMode counterMode);
 
 Handle hTIM1;
@@ -47,6 +103,18 @@ Handle hTIM12;
 Handle hTIM13;
 Handle hTIM14;
 
+// Update callbacks
+std::array<Callback, TIM14 + 1> _updateCallbacks{};
+
+// PWM DMA callbacks
+std::array<Callback, TIM14 + 1> _dmaHalfCallbacks{};
+std::array<Callback, TIM14 + 1> _dmaCallbacks{};
+
+// Input capture
+std::array<Callback, TIM14 + 1> _captureCallbacks{};
+std::array<Channel, TIM14 + 1> _captureInputs{}; ///< Input channel of INPUT_CAPTURE timers (CH_NONE for other timers)
+std::array<Capture, TIM14 + 1> _captures{};
+
 } // namespace Timer
 
 bool Timer::init() {
@@ -58,6 +126,7 @@ bool Timer::init() {
                 conflict = true;
     if (conflict)
         return false;
+    _captureInputs.fill(CH_NONE);
 
     // Initialize timers
     for (TimerConfig cfg : timerList) {
@@ -66,13 +135,26 @@ bool Timer::init() {
                 if (!initPwm(cfg.timer, cfg))
                     return false;
                 break;
-            default:
-                // Mode not implemented yet
-                return false;
+            case Mode::INTERRUPT:
+                if (!initInterrupt(cfg.timer, cfg))
+                    return false;
+                break;
+            case Mode::INPUT_CAPTURE:
+                if (!initCapture(cfg.timer, cfg))
+                    return false;
+                break;
+            case Mode::INPUT_ENCODER:
+                if (!initEncoder(cfg.timer, cfg))
+                    return false;
+                break;
+            case Mode::TRIGGER:
+                if (!initTrigger(cfg.timer, cfg))
+                    return false;
+                break;
         }
     }
 
-    Log::success("Timer", "Initialized");
+    LOG_SUCCESS("Timer", "Initialized");
     return true;
 }
 
@@ -95,23 +177,8 @@ bool Timer::deinit() {
 }
 
 bool Timer::initPwm(Timer timer, TimerConfig cfg) {
-    // Check if GPIO was initialized correctly
-    std::vector<Channel> channels;
-    for (Gpio::GpioConfig config : Gpio::gpioList) {
-        if (gpioModeToTimer(config.mode) == timer) {
-            Channel channel = gpioModeToChannel(config.mode);
-            bool newChannel = true;
-            for (size_t i = 0; i < channels.size(); i++)
-                if (channels[i] == channel)
-                    newChannel = false;
-            if (newChannel)
-                channels.push_back(channel);
-        }
-    }
-    if (channels.empty()) {
-        Log::error("Timer", "Trying to enable TIM$0 PWM, but no GPIO is using it", int(timer));
-        return false;
-    }
+    // Channels with a GPIO (timerList is checked at compile time, every PWM timer has at least one)
+    std::array<Channel, NUM_CHANNELS> channels = getChannels(timer);
 
     // Enable clock
     enableClock(timer);
@@ -123,13 +190,28 @@ bool Timer::initPwm(Timer timer, TimerConfig cfg) {
     htim->Init.Prescaler = 0;
     htim->Init.Period = cfg.period;
     htim->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
-    htim->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    htim->Init.RepetitionCounter = cfg.repetition;
+    htim->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE; // Period changes take effect at the update event
     if (HAL_TIM_PWM_Init(htim) != HAL_OK)
         return false;
 
+    if (timer == TIM1 || timer == TIM8) {
+        // Outputs driven to their idle level while MOE is cleared, the break input is not used (see disableOutputs())
+        TIM_BreakDeadTimeConfigTypeDef sBreakDeadTimeConfig{};
+        sBreakDeadTimeConfig.OffStateRunMode = TIM_OSSR_ENABLE;
+        sBreakDeadTimeConfig.OffStateIDLEMode = TIM_OSSI_ENABLE;
+        sBreakDeadTimeConfig.LockLevel = TIM_LOCKLEVEL_OFF;
+        sBreakDeadTimeConfig.DeadTime = 0;
+        sBreakDeadTimeConfig.BreakState = TIM_BREAK_DISABLE;
+        sBreakDeadTimeConfig.BreakPolarity = TIM_BREAKPOLARITY_HIGH;
+        sBreakDeadTimeConfig.AutomaticOutput = TIM_AUTOMATICOUTPUT_DISABLE; // Only software sets MOE again
+        if (HAL_TIMEx_ConfigBreakDeadTime(htim, &sBreakDeadTimeConfig) != HAL_OK || !setDeadTime(timer, cfg.deadTime))
+            return false;
+    }
+
     TIM_MasterConfigTypeDef sMasterConfig{};
-    sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
-    sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+    sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE; // Synchronize slave timers and ADC sampling with the PWM
+    sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_ENABLE;
     if (HAL_TIMEx_MasterConfigSynchronization(htim, &sMasterConfig) != HAL_OK)
         return false;
 
@@ -141,16 +223,187 @@ bool Timer::initPwm(Timer timer, TimerConfig cfg) {
     sConfigOC.OCIdleState = TIM_OCIDLESTATE_RESET;
     if (timer == TIM1 || timer == TIM8) {
         sConfigOC.OCNPolarity = TIM_OCNPOLARITY_HIGH;
-        sConfigOC.OCNIdleState = TIM_OCNIDLESTATE_SET;
+        sConfigOC.OCNIdleState = TIM_OCNIDLESTATE_RESET; // High and low sides off while MOE is cleared
     }
-    for (size_t i = 0; i < channels.size(); i++) {
-        if (HAL_TIM_PWM_ConfigChannel(htim, &sConfigOC, (uint32_t)channels[i]) != HAL_OK)
+    // Also enables the capture/compare preload (OCxPE) of each channel
+    for (Channel channel : channels) {
+        if (channel != CH_NONE && HAL_TIM_PWM_ConfigChannel(htim, &sConfigOC, (uint32_t)channel) != HAL_OK)
             return false;
     }
 
     return true;
 }
 
+bool Timer::initTrigger(Timer timer, TimerConfig cfg) {
+    uint32_t trigger = getInternalTrigger(timer, cfg.master);
+    if (trigger == TIM_TS_NONE) {
+        LOG_ERROR("Timer", "TIM$0 can not be triggered by TIM$1", int(timer), int(cfg.master));
+        return false;
+    }
+
+    // Enable clock
+    enableClock(timer);
+
+    TIM_HandleTypeDef* htim = getHandle(timer);
+    htim->Instance = getInstance(timer);
+    htim->Init.CounterMode = convert(cfg.counterMode);
+    htim->Init.Prescaler = 0;
+    htim->Init.Period = cfg.period;
+    htim->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(htim) != HAL_OK)
+        return false;
+
+    TIM_SlaveConfigTypeDef sSlaveConfig{};
+    sSlaveConfig.SlaveMode = TIM_SLAVEMODE_RESET;
+    sSlaveConfig.InputTrigger = trigger;
+    if (HAL_TIM_SlaveConfigSynchro(htim, &sSlaveConfig) != HAL_OK)
+        return false;
+
+    TIM_MasterConfigTypeDef sMasterConfig{};
+    sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET; // Reset by the slave mode controller is output on TRGO
+    sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+    if (HAL_TIMEx_MasterConfigSynchronization(htim, &sMasterConfig) != HAL_OK)
+        return false;
+
+    return HAL_TIM_Base_Start(htim) == HAL_OK;
+}
+
+bool Timer::initInterrupt(Timer timer, TimerConfig cfg) {
+    // Prescaler and period were computed for the nominal clock
+    if (getClock(timer) != getTimerClock(timer)) {
+        LOG_ERROR("Timer", "TIM$0 clock is not $1Hz", int(timer), int(getTimerClock(timer)));
+        return false;
+    }
+
+    // Enable clock
+    enableClock(timer);
+
+    TIM_HandleTypeDef* htim = getHandle(timer);
+    htim->Instance = getInstance(timer);
+    htim->Init.CounterMode = convert(cfg.counterMode);
+    htim->Init.Prescaler = frequencyToPrescaler(timer, cfg.frequency);
+    htim->Init.Period = frequencyToPeriod(timer, cfg.frequency);
+    htim->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+    if (HAL_TIM_Base_Init(htim) != HAL_OK)
+        return false;
+
+    return HAL_TIM_Base_Start(htim) == HAL_OK;
+}
+
+bool Timer::initCapture(Timer timer, TimerConfig cfg) {
+    if (getClock(timer) != getTimerClock(timer)) {
+        LOG_ERROR("Timer", "TIM$0 clock is not $1Hz", int(timer), int(getTimerClock(timer)));
+        return false;
+    }
+    // The input is on CH1 or CH2 (checked at compile time), the other channel captures the falling edge
+    Channel input = getChannels(timer)[0];
+    Channel paired = input == CH1 ? CH2 : CH1;
+
+    // Enable clock
+    enableClock(timer);
+
+    TIM_HandleTypeDef* htim = getHandle(timer);
+    htim->Instance = getInstance(timer);
+    htim->Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim->Init.Prescaler = getTimerClock(timer) / cfg.frequency - 1;
+    htim->Init.Period = cfg.period;
+    htim->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_IC_Init(htim) != HAL_OK)
+        return false;
+
+    TIM_IC_InitTypeDef sConfigIC{};
+    sConfigIC.ICPolarity = TIM_INPUTCHANNELPOLARITY_RISING;
+    sConfigIC.ICSelection = TIM_ICSELECTION_DIRECTTI;
+    sConfigIC.ICPrescaler = TIM_ICPSC_DIV1;
+    sConfigIC.ICFilter = 0x3; // Edges shorter than 8 timer clocks are ignored
+    if (HAL_TIM_IC_ConfigChannel(htim, &sConfigIC, input) != HAL_OK)
+        return false;
+    sConfigIC.ICPolarity = TIM_INPUTCHANNELPOLARITY_FALLING;
+    sConfigIC.ICSelection = TIM_ICSELECTION_INDIRECTTI;
+    if (HAL_TIM_IC_ConfigChannel(htim, &sConfigIC, paired) != HAL_OK)
+        return false;
+
+    // Rising edge resets the counter
+    TIM_SlaveConfigTypeDef sSlaveConfig{};
+    sSlaveConfig.SlaveMode = TIM_SLAVEMODE_RESET;
+    sSlaveConfig.InputTrigger = input == CH1 ? TIM_TS_TI1FP1 : TIM_TS_TI2FP2;
+    sSlaveConfig.TriggerPolarity = TIM_INPUTCHANNELPOLARITY_RISING;
+    sSlaveConfig.TriggerFilter = sConfigIC.ICFilter;
+    if (HAL_TIM_SlaveConfigSynchro(htim, &sSlaveConfig) != HAL_OK)
+        return false;
+
+    // Only counter overflows (no edge for a whole period) raise the update interrupt, not the resets
+    htim->Instance->CR1 |= TIM_CR1_URS;
+    _captureInputs[timer] = input;
+    _captures[timer] = {};
+    __HAL_TIM_ENABLE_IT(htim, TIM_IT_UPDATE);
+    return HAL_TIM_IC_Start(htim, paired) == HAL_OK && HAL_TIM_IC_Start_IT(htim, input) == HAL_OK;
+}
+
+bool Timer::initEncoder(Timer timer, TimerConfig cfg) {
+    // Enable clock
+    enableClock(timer);
+
+    TIM_HandleTypeDef* htim = getHandle(timer);
+    htim->Instance = getInstance(timer);
+    htim->Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim->Init.Prescaler = 0;
+    htim->Init.Period = cfg.period;
+    htim->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+
+    // Count both edges of both inputs
+    TIM_Encoder_InitTypeDef sConfig{};
+    sConfig.EncoderMode = TIM_ENCODERMODE_TI12;
+    sConfig.IC1Polarity = TIM_ICPOLARITY_RISING;
+    sConfig.IC1Selection = TIM_ICSELECTION_DIRECTTI;
+    sConfig.IC1Prescaler = TIM_ICPSC_DIV1;
+    sConfig.IC1Filter = 0x3; // Edges shorter than 8 timer clocks are ignored
+    sConfig.IC2Polarity = TIM_ICPOLARITY_RISING;
+    sConfig.IC2Selection = TIM_ICSELECTION_DIRECTTI;
+    sConfig.IC2Prescaler = TIM_ICPSC_DIV1;
+    sConfig.IC2Filter = sConfig.IC1Filter;
+    if (HAL_TIM_Encoder_Init(htim, &sConfig) != HAL_OK)
+        return false;
+
+    return HAL_TIM_Encoder_Start(htim, TIM_CHANNEL_ALL) == HAL_OK;
+}
+
+uint32_t Timer::getInternalTrigger(Timer slave, Timer master) {
+    // Internal trigger connections (ITR0, ITR1, ITR2, ITR3)
+    std::array<Timer, 4> masters;
+    switch (slave) {
+        case TIM1:
+            masters = {TIM5, TIM2, TIM3, TIM4};
+            break;
+        case TIM2:
+            masters = {TIM1, TIM8, TIM3, TIM4};
+            break;
+        case TIM3:
+            masters = {TIM1, TIM8, TIM5, TIM4};
+            break;
+        case TIM4:
+            masters = {TIM1, TIM2, TIM3, TIM8};
+            break;
+        case TIM5:
+            masters = {TIM2, TIM3, TIM4, TIM8};
+            break;
+        case TIM8:
+            masters = {TIM1, TIM2, TIM4, TIM5};
+            break;
+        default:
+            return TIM_TS_NONE;
+    }
+    constexpr std::array<uint32_t, 4> triggers = {TIM_TS_ITR0, TIM_TS_ITR1, TIM_TS_ITR2, TIM_TS_ITR3};
+    for (size_t i = 0; i < masters.size(); i++)
+        if (masters[i] == master)
+            return triggers[i];
+    return TIM_TS_NONE;
+}
+
 void Timer::setPwm(Timer timer, Channel channel, uint16_t ccr) {
     switch (channel) {
         case CH1:
@@ -168,7 +421,87 @@ void Timer::setPwm(Timer timer, Channel channel, uint16_t ccr) {
         default:
             break;
     }
-    Log::error("Timer", "Could not set TIM$0 PWM", int(timer));
+    LOG_ERROR("Timer", "Could not set TIM$0 PWM", int(timer));
+}
+
+void Timer::commitPwm(Timer timer, uint16_t ccr1, uint16_t ccr2, uint16_t ccr3) {
+    constexpr uint32_t COMMIT_GUARD = 16; // Ticks needed for the three writes (timer clock is the CPU clock)
+    TIM_TypeDef* tim = getInstance(timer);
+    uint32_t arr = tim->ARR;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    // Update events happen when the counter wraps (0 or ARR), a stopped counter has no update events
+    if ((tim->CR1 & TIM_CR1_CEN) && arr > 2 * COMMIT_GUARD) {
+        uint32_t cnt;
+        do {
+            cnt = tim->CNT;
+        } while (cnt < COMMIT_GUARD || cnt > arr - COMMIT_GUARD);
+    }
+    tim->CCR1 = ccr1;
+    tim->CCR2 = ccr2;
+    tim->CCR3 = ccr3;
+    __set_PRIMASK(primask);
+}
+
+void Timer::setRepetition(Timer timer, uint8_t repetition) {
+    if (timer != TIM1 && timer != TIM8) {
+        LOG_ERROR("Timer", "TIM$0 has no repetition counter", int(timer));
+        return;
+    }
+    getInstance(timer)->RCR = repetition;
+}
+
+bool Timer::setDeadTime(Timer timer, uint16_t deadTime) {
+    if (timer != TIM1 && timer != TIM8) {
+        LOG_ERROR("Timer", "TIM$0 has no dead time generator", int(timer));
+        return false;
+    }
+    uint32_t ticks = (uint64_t(deadTime) * getClock(timer) + 999999999) / 1000000000;
+    if (ticks > dtgToTicks(0xFF)) {
+        LOG_ERROR("Timer", "TIM$0 dead time of $1ns is too long", int(timer), int(deadTime));
+        return false;
+    }
+    // DTG is only written while the lock level is off (never set by initPwm)
+    MODIFY_REG(getInstance(timer)->BDTR, TIM_BDTR_DTG, ticksToDtg(ticks));
+    return true;
+}
+
+float Timer::getDeadTime(Timer timer) {
+    if (timer != TIM1 && timer != TIM8)
+        return 0.0f;
+    uint8_t dtg = getInstance(timer)->BDTR & TIM_BDTR_DTG;
+    return dtgToTicks(dtg) * 1e9f / getClock(timer);
+}
+
+void Timer::disableOutputs(Timer timer) {
+    if (timer == TIM1 || timer == TIM8)
+        getInstance(timer)->BDTR &= ~TIM_BDTR_MOE;
+}
+
+void Timer::enableOutputs(Timer timer) {
+    if (timer == TIM1 || timer == TIM8)
+        getInstance(timer)->BDTR |= TIM_BDTR_MOE;
+}
+
+bool Timer::areOutputsEnabled(Timer timer) {
+    if (timer != TIM1 && timer != TIM8)
+        return true;
+    return getInstance(timer)->BDTR & TIM_BDTR_MOE;
+}
+
+uint32_t Timer::getClock(Timer timer) {
+    bool apb2 = timer == TIM1 || timer == TIM8 || timer == TIM9 || timer == TIM10 || timer == TIM11;
+    uint32_t pclk = apb2 ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+    bool divided = RCC->CFGR & (apb2 ? RCC_CFGR_PPRE2_2 : RCC_CFGR_PPRE1_2);
+    return divided ? 2 * pclk : pclk;
+}
+
+float Timer::getUpdatePeriod(Timer timer) {
+    TIM_TypeDef* tim = getInstance(timer);
+    uint32_t ticks = (tim->CR1 & TIM_CR1_CMS) ? tim->ARR : tim->ARR + 1; // Center aligned: ARR ticks up, ARR ticks down
+    uint32_t repetitions = (timer == TIM1 || timer == TIM8) ? tim->RCR + 1 : 1;
+    return float(ticks) * (tim->PSC + 1) * repetitions / getClock(timer);
 }
 
 // clang-format off
@@ -196,23 +529,62 @@ void Timer::linkDma(Timer timer, Channel channel, Dma::Handle* dmaHandle) {
         default:
             break;
     }
-    Log::error("Timer", "Could not link DMA to TIM$0", int(timer));
+    LOG_ERROR("Timer", "Could not link DMA to TIM$0", int(timer));
 }
 
 void Timer::startPwm(Timer timer, Channel channel) {
     if (HAL_TIM_PWM_Start(getHandle(timer), channel) != HAL_OK)
-        Log::error("Timer", "Failed to start TIM$0 PWM", int(timer));
+        LOG_ERROR("Timer", "Failed to start TIM$0 PWM", int(timer));
     if (timer == TIM1 || timer == TIM8) {
         if (HAL_TIMEx_PWMN_Start(getHandle(timer), channel) != HAL_OK)
-            Log::error("Timer", "Failed to start TIM$0 PWMN", int(timer));
+            LOG_ERROR("Timer", "Failed to start TIM$0 PWMN", int(timer));
     }
 }
 
 void Timer::startPwmDma(Timer timer, Channel channel, uint32_t* data, uint16_t size) {
     if (HAL_TIM_PWM_Start_DMA(getHandle(timer), channel, data, size) != HAL_OK)
-        Log::error("Timer", "Failed to start TIM$0 PWM DMA", int(timer));
+        LOG_ERROR("Timer", "Failed to start TIM$0 PWM DMA", int(timer));
 }
 
+void Timer::stopPwmDma(Timer timer, Channel channel) { HAL_TIM_PWM_Stop_DMA(getHandle(timer), channel); }
+
+void Timer::startCompareTrigger(Timer timer, Channel channel, uint16_t ccr) {
+    TIM_OC_InitTypeDef sConfigOC{};
+    sConfigOC.OCMode = TIM_OCMODE_PWM2;
+    sConfigOC.Pulse = ccr;
+    sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+    sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+    sConfigOC.OCIdleState = TIM_OCIDLESTATE_RESET;
+    if (HAL_TIM_PWM_ConfigChannel(getHandle(timer), &sConfigOC, channel) != HAL_OK ||
+        HAL_TIM_PWM_Start(getHandle(timer), channel) != HAL_OK)
+        LOG_ERROR("Timer", "Failed to start TIM$0 compare trigger", int(timer));
+}
+
+void Timer::setUpdateCallback(Timer timer, Callback callback) {
+    _updateCallbacks[timer] = callback;
+    if (callback)
+        __HAL_TIM_ENABLE_IT(getHandle(timer), TIM_IT_UPDATE);
+    else
+        __HAL_TIM_DISABLE_IT(getHandle(timer), TIM_IT_UPDATE);
+}
+
+void Timer::setDmaCallback(Timer timer, Callback halfComplete, Callback complete) {
+    _dmaHalfCallbacks[timer] = halfComplete;
+    _dmaCallbacks[timer] = complete;
+}
+
+void Timer::setCaptureCallback(Timer timer, Callback callback) { _captureCallbacks[timer] = callback; }
+
+Timer::Capture Timer::getCapture(Timer timer) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    Capture capture = _captures[timer];
+    __set_PRIMASK(primask);
+    return capture;
+}
+
+uint32_t Timer::getCount(Timer timer) { return getInstance(timer)->CNT; }
+
 // clang-format off
 #define CASE_GET_HANDLE(x) \
     case x: \
@@ -318,85 +690,6 @@ void Timer::disableClock(Timer timer) {
     }
 }
 
-Timer::Timer Timer::gpioModeToTimer(Gpio::Mode mode) {
-    if (mode >= Gpio::TIM1_CH1 && mode < Gpio::TIM2_CH1)
-        return TIM1;
-    else if (mode >= Gpio::TIM2_CH1 && mode < Gpio::TIM3_CH1)
-        return TIM2;
-    else if (mode >= Gpio::TIM3_CH1 && mode < Gpio::TIM4_CH1)
-        return TIM3;
-    else if (mode >= Gpio::TIM4_CH1 && mode < Gpio::TIM5_CH1)
-        return TIM4;
-    else if (mode >= Gpio::TIM5_CH1 && mode < Gpio::TIM8_CH1)
-        return TIM5;
-    else if (mode >= Gpio::TIM8_CH1 && mode < Gpio::TIM9_CH1)
-        return TIM8;
-    else if (mode >= Gpio::TIM9_CH1 && mode < Gpio::TIM10_CH1)
-        return TIM9;
-    else if (mode >= Gpio::TIM10_CH1 && mode < Gpio::TIM11_CH1)
-        return TIM10;
-    else if (mode >= Gpio::TIM11_CH1 && mode < Gpio::TIM12_CH1)
-        return TIM11;
-    else if (mode >= Gpio::TIM12_CH1 && mode < Gpio::TIM13_CH1)
-        return TIM12;
-    else if (mode >= Gpio::TIM13_CH1 && mode < Gpio::TIM14_CH1)
-        return TIM13;
-    else if (mode == Gpio::TIM14_CH1)
-        return TIM14;
-    return TIM_NONE;
-}
-
-Timer::Channel Timer::gpioModeToChannel(Gpio::Mode mode) {
-    switch (mode) {
-        case Gpio::TIM1_CH1:
-        case Gpio::TIM1_CH1N:
-        case Gpio::TIM2_CH1:
-        case Gpio::TIM3_CH1:
-        case Gpio::TIM4_CH1:
-        case Gpio::TIM5_CH1:
-        case Gpio::TIM8_CH1:
-        case Gpio::TIM8_CH1N:
-        case Gpio::TIM9_CH1:
-        case Gpio::TIM10_CH1:
-        case Gpio::TIM11_CH1:
-        case Gpio::TIM12_CH1:
-        case Gpio::TIM13_CH1:
-        case Gpio::TIM14_CH1:
-            return CH1;
-        case Gpio::TIM1_CH2:
-        case Gpio::TIM1_CH2N:
-        case Gpio::TIM2_CH2:
-        case Gpio::TIM3_CH2:
-        case Gpio::TIM4_CH2:
-        case Gpio::TIM5_CH2:
-        case Gpio::TIM8_CH2:
-        case Gpio::TIM8_CH2N:
-        case Gpio::TIM9_CH2:
-        case Gpio::TIM12_CH2:
-            return CH2;
-        case Gpio::TIM1_CH3:
-        case Gpio::TIM1_CH3N:
-        case Gpio::TIM2_CH3:
-        case Gpio::TIM3_CH3:
-        case Gpio::TIM4_CH3:
-        case Gpio::TIM5_CH3:
-        case Gpio::TIM8_CH3:
-        case Gpio::TIM8_CH3N:
-            return CH3;
-        case Gpio::TIM1_CH4:
-        case Gpio::TIM2_CH4:
-        case Gpio::TIM3_CH4:
-        case Gpio::TIM4_CH4:
-        case Gpio::TIM5_CH4:
-        case Gpio::TIM8_CH4:
-            return CH4;
-        default:
-            return CH_NONE;
-    }
-
-    return CH_NONE;
-}
-
 constexpr uint16_t Timer::convert(CounterMode counterMode) {
     switch (counterMode) {
         case CounterMode::UP:
@@ -408,3 +701,55 @@ constexpr uint16_t Timer::convert(CounterMode counterMode) {
     }
     return TIM_COUNTERMODE_UP;
 }
+
+// --- HAL Callback Implementations ---
+extern "C" {
+
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim) {
+    for (uint8_t i = Timer::TIM1; i <= Timer::TIM14; i++)
+        if (Timer::getHandle(Timer::Timer(i)) == htim) {
+            // Input capture counter overflowed, no rising edge for a whole counter period
+            if (Timer::_captureInputs[i] != Timer::CH_NONE)
+                Timer::_captures[i] = {};
+            if (Timer::_updateCallbacks[i])
+                Timer::_updateCallbacks[i]();
+            return;
+        }
+}
+
+void HAL_TIM_PWM_PulseFinishedHalfCpltCallback(TIM_HandleTypeDef* htim) {
+    for (uint8_t i = Timer::TIM1; i <= Timer::TIM14; i++)
+        if (Timer::getHandle(Timer::Timer(i)) == htim) {
+            if (Timer::_dmaHalfCallbacks[i])
+                Timer::_dmaHalfCallbacks[i]();
+            return;
+        }
+}
+
+void HAL_TIM_PWM_PulseFinishedCallback(TIM_HandleTypeDef* htim) {
+    for (uint8_t i = Timer::TIM1; i <= Timer::TIM14; i++)
+        if (Timer::getHandle(Timer::Timer(i)) == htim) {
+            if (Timer::_dmaCallbacks[i])
+                Timer::_dmaCallbacks[i]();
+            return;
+        }
+}
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef* htim) {
+    for (uint8_t i = Timer::TIM1; i <= Timer::TIM14; i++)
+        if (Timer::getHandle(Timer::Timer(i)) == htim) {
+            Timer::Channel input = Timer::_captureInputs[i];
+            uint32_t active = input == Timer::CH1 ? HAL_TIM_ACTIVE_CHANNEL_1 : HAL_TIM_ACTIVE_CHANNEL_2;
+            if (input == Timer::CH_NONE || htim->Channel != active)
+                return;
+            // Rising edge captured the period, the paired channel holds the falling edge of the same period
+            uint32_t paired = input == Timer::CH1 ? Timer::CH2 : Timer::CH1;
+            Timer::_captures[i].period = HAL_TIM_ReadCapturedValue(htim, input);
+            Timer::_captures[i].pulse = HAL_TIM_ReadCapturedValue(htim, paired);
+            if (Timer::_captureCallbacks[i])
+                Timer::_captureCallbacks[i]();
+            return;
+        }
+}
+
+} // extern "C"
@@ -8,6 +8,7 @@
 #define BLDC_DRIVERS_TIMER_TIMER_H
 #include <cstdint>
 #include <drivers/dma/dma.h>
+#include <drivers/gpio/gpio.h>
 #include <system/hal.h>
 
 namespace Timer {
@@ -16,9 +17,10 @@ enum Timer : uint8_t { TIM_NONE = 0, TIM1, TIM2, TIM3, TIM4, TIM5, TIM6, TIM7, T
 enum Channel : uint32_t { CH_NONE = 0xFFFFFFFF, CH1 = TIM_CHANNEL_1, CH2 = TIM_CHANNEL_2, CH3 = TIM_CHANNEL_3, CH4 = TIM_CHANNEL_4 };
 enum class Mode {
     PWM = 0,       ///< Output pulse signal
-    INTERRUPT,     ///< **Not supported** Generate period interrupts
-    INPUT_CAPTURE, ///< **Not supported** Capture counter value when event happens
-    INPUT_ENCODER, ///< **Not supported** Count number of interrupts
+    INTERRUPT,     ///< Generate update interrupts at a fixed frequency
+    INPUT_CAPTURE, ///< Measure period and high time of the signal on CH1 or CH2
+    INPUT_ENCODER, ///< Count quadrature encoder edges on CH1 and CH2
+    TRIGGER,       ///< Relay the trigger output (TRGO) of a master timer
 };
 enum class CounterMode {
     UP = 0, ///< Count up
@@ -26,7 +28,6 @@ enum class CounterMode {
     CENTER, ///< Count up/down (center aligned 3)
 };
 using Handle = TIM_HandleTypeDef;
-constexpr uint16_t PERIOD = 112;
 
 /**
  * @brief Initialize timer driver
@@ -51,6 +52,89 @@ bool deinit();
  */
 void setPwm(Timer timer, Channel channel, uint16_t ccr);
 
+/**
+ * @brief Commit PWM duty cycles of channels 1 to 3
+ *
+ * Capture/compare preload is enabled on PWM channels, so the values only take effect at the next update event. The
+ * writes run with interrupts disabled and are delayed while the counter is less than 16 ticks from an update event,
+ * so the three channels always switch at the same update event
+ *
+ * @param timer Timer
+ * @param ccr1 CH1 capture/compare register value
+ * @param ccr2 CH2 capture/compare register value
+ * @param ccr3 CH3 capture/compare register value
+ */
+void commitPwm(Timer timer, uint16_t ccr1, uint16_t ccr2, uint16_t ccr3);
+
+/**
+ * @brief Set repetition counter
+ *
+ * The update event (preload transfer, update interrupt and TRGO) is generated every repetition + 1 counter overflows or
+ * underflows. In center mode, 0 updates at the peak and at the valley and 1 once per PWM period. Takes effect at the
+ * next update event. Only TIM1 and TIM8 have a repetition counter
+ *
+ * @param timer Timer
+ * @param repetition Repetition count
+ */
+void setRepetition(Timer timer, uint8_t repetition);
+
+/**
+ * @brief Set dead time of the complementary outputs
+ *
+ * Both outputs of a channel are kept low for the dead time after each switching edge. The dead time generator counts
+ * timer clock ticks (up to 1008 ticks, in steps of 2, 8 and 16 above 127 ticks), the dead time is rounded up to the
+ * next step. Only TIM1 and TIM8 have complementary outputs
+ *
+ * @param timer Timer
+ * @param deadTime Dead time in nanoseconds
+ *
+ * @return True if the dead time fits in the dead time generator
+ */
+bool setDeadTime(Timer timer, uint16_t deadTime);
+
+/**
+ * @brief Get dead time of the complementary outputs
+ *
+ * @param timer Timer
+ *
+ * @return Dead time applied by the dead time generator in nanoseconds
+ */
+float getDeadTime(Timer timer);
+
+/**
+ * @brief Disable outputs
+ *
+ * Clears the main output enable (MOE), all outputs go to their idle level (every switch off) in one timer clock. The
+ * counter keeps running, so the trigger output and the update interrupts are not affected. Only TIM1 and TIM8 have a
+ * main output enable. Safe to call from any interrupt
+ *
+ * @param timer Timer
+ */
+void disableOutputs(Timer timer);
+void enableOutputs(Timer timer);     ///< Set the main output enable cleared by disableOutputs()
+bool areOutputsEnabled(Timer timer); ///< Check the main output enable
+
+/**
+ * @brief Get timer counter clock
+ *
+ * @param timer Timer
+ *
+ * @return Clock in Hz (twice the APB clock when the APB prescaler is not 1)
+ */
+uint32_t getClock(Timer timer);
+
+/**
+ * @brief Get time between update events
+ *
+ * Read from the running configuration: a center aligned counter updates at the peak and at the valley, and the
+ * repetition counter of TIM1 and TIM8 skips updates
+ *
+ * @param timer Timer
+ *
+ * @return Update period in seconds
+ */
+float getUpdatePeriod(Timer timer);
+
 /**
  * @brief Get timer handle
  *
@@ -87,6 +171,102 @@ void startPwm(Timer timer, Channel channel);
  */
 void startPwmDma(Timer timer, Channel channel, uint32_t* data, uint16_t size);
 
+/**
+ * @brief Stop PWM with DMA transaction
+ *
+ * Required to end circular DMA transfers before the next startPwmDma()
+ *
+ * @param timer Timer
+ * @param channel Timer channel
+ */
+void stopPwmDma(Timer timer, Channel channel);
+
+/**
+ * @brief Start compare trigger
+ *
+ * Configures the channel in PWM mode 2 without output pin, so OCxREF rises once per period when the counter reaches the
+ * compare value while counting up. Used to trigger ADC conversions at a fixed point of the PWM period
+ *
+ * @param timer Timer
+ * @param channel Timer channel
+ * @param ccr Capture/compare register value
+ */
+void startCompareTrigger(Timer timer, Channel channel, uint16_t ccr);
+
+/**
+ * @brief Timer callback
+ *
+ * Called from the timer interrupt
+ */
+using Callback = void (*)();
+
+/**
+ * @brief Set update (period elapsed) callback
+ *
+ * Enables the timer update interrupt. The timer IRQ must be enabled in the interrupt driver
+ *
+ * @param timer Timer
+ * @param callback Callback called on every update event (nullptr to disable)
+ */
+void setUpdateCallback(Timer timer, Callback callback);
+
+/**
+ * @brief Set PWM DMA callbacks
+ *
+ * Called from the DMA interrupt when the first half (half transfer) and the second half (transfer complete) of the
+ * startPwmDma() buffer were transferred. With a circular DMA stream the buffer halves can be refilled while the other
+ * half is sent
+ *
+ * @param timer Timer
+ * @param halfComplete Half transfer callback (nullptr to disable)
+ * @param complete Transfer complete callback (nullptr to disable)
+ */
+void setDmaCallback(Timer timer, Callback halfComplete, Callback complete);
+
+/// Input capture measurement in counter ticks
+struct Capture {
+    uint32_t period; ///< Time between the last two rising edges (0 if no edge for a whole counter period)
+    uint32_t pulse;  ///< High time of the last signal period
+};
+
+/**
+ * @brief Set input capture callback
+ *
+ * Called from the timer interrupt on every rising edge of an INPUT_CAPTURE timer, getCapture() already returns the
+ * signal period that just ended
+ *
+ * @param timer Timer
+ * @param callback Callback (nullptr to disable)
+ */
+void setCaptureCallback(Timer timer, Callback callback);
+
+/**
+ * @brief Get last input capture measurement
+ *
+ * The input rising edge resets the counter (PWM input mode), so the period and the high time are captured by the
+ * hardware without CPU work. The counter runs at the frequency of the timerList entry
+ *
+ * @param timer Timer
+ *
+ * @return Last measurement, zero if the input stopped toggling
+ */
+Capture getCapture(Timer timer);
+
+/**
+ * @brief Get encoder count
+ *
+ * Counts the four edges of each quadrature period, wrapping at the period of the timerList entry
+ *
+ * @param timer Timer
+ *
+ * @return Counter value of an INPUT_ENCODER timer
+ */
+uint32_t getCount(Timer timer);
+
+//---------- Clocks ----------//
+static constexpr uint32_t APB1_TIMER_CLOCK = 72000000;  // TIM2-7 and TIM12-14 (36MHz APB1, doubled)
+static constexpr uint32_t APB2_TIMER_CLOCK = 144000000; // TIM1 and TIM8-11 (72MHz APB2, doubled)
+
 //---------- Timers ----------//
 static constexpr Timer LED_TIM = TIM2;
 static constexpr uint16_t LED_PERIOD = 112;
@@ -97,20 +277,261 @@ static constexpr uint16_t MOTOR_PERIOD = 3000 - 1; // ~24kHz in center mode, 144
 static constexpr Channel MOTOR_CH_U = CH1;
 static constexpr Channel MOTOR_CH_V = CH2;
 static constexpr Channel MOTOR_CH_W = CH3;
+static constexpr Channel MOTOR_CH_ADC = CH4;                 // Current sampling trigger (no output)
+static constexpr uint16_t MOTOR_ADC_CCR = MOTOR_PERIOD - 56; // Sampling window (0.78us) centered on the counter peak
+static constexpr uint8_t MOTOR_REPETITION = 0;               // Update at the peak and at the valley
+static constexpr uint16_t MOTOR_DEAD_TIME = 100;             // Complementary output dead time (ns)
+
+static constexpr Timer ADC_TIM = TIM3; ///< Triggers the ADC scans on every MOTOR_TIM update
+
+static constexpr Timer LOOP_TIM = TIM6;           ///< Fixed rate control loop tick (setUpdateCallback())
+static constexpr uint32_t LOOP_FREQUENCY = 10000; // Control loop tick (Hz)
 
 //---------- Timer configs ----------//
 struct TimerConfig {
     Timer timer;
     Mode mode;
     CounterMode counterMode;
-    uint16_t period;
+    uint16_t period;         ///< Auto-reload value (computed from the frequency in INTERRUPT mode)
+    Timer master = TIM_NONE; ///< Master timer (TRIGGER mode only)
+    uint8_t repetition = 0;  ///< Repetition counter (PWM mode, TIM1 and TIM8 only)
+    uint16_t deadTime = 0;   ///< Complementary output dead time in ns (PWM mode, TIM1 and TIM8 only)
+    uint32_t frequency = 0;  ///< Update frequency (INTERRUPT mode) or counter frequency (INPUT_CAPTURE mode) in Hz
 };
 
-inline const std::array timerList{
+inline constexpr std::array timerList{
     TimerConfig{LED_TIM, Mode::PWM, CounterMode::UP, LED_PERIOD},
-    TimerConfig{MOTOR_TIM, Mode::PWM, CounterMode::CENTER, MOTOR_PERIOD},
+    TimerConfig{MOTOR_TIM, Mode::PWM, CounterMode::CENTER, MOTOR_PERIOD, TIM_NONE, MOTOR_REPETITION, MOTOR_DEAD_TIME},
+    TimerConfig{ADC_TIM, Mode::TRIGGER, CounterMode::UP, 0xFFFF, MOTOR_TIM},
+    TimerConfig{LOOP_TIM, Mode::INTERRUPT, CounterMode::UP, 0, TIM_NONE, 0, 0, LOOP_FREQUENCY},
 };
 
+//---------- Compile-time routing ----------//
+constexpr uint8_t NUM_CHANNELS = 4;
+
+constexpr Timer gpioModeToTimer(Gpio::Mode mode) {
+    if (mode >= Gpio::TIM1_CH1 && mode < Gpio::TIM2_CH1)
+        return TIM1;
+    else if (mode >= Gpio::TIM2_CH1 && mode < Gpio::TIM3_CH1)
+        return TIM2;
+    else if (mode >= Gpio::TIM3_CH1 && mode < Gpio::TIM4_CH1)
+        return TIM3;
+    else if (mode >= Gpio::TIM4_CH1 && mode < Gpio::TIM5_CH1)
+        return TIM4;
+    else if (mode >= Gpio::TIM5_CH1 && mode < Gpio::TIM8_CH1)
+        return TIM5;
+    else if (mode >= Gpio::TIM8_CH1 && mode < Gpio::TIM9_CH1)
+        return TIM8;
+    else if (mode >= Gpio::TIM9_CH1 && mode < Gpio::TIM10_CH1)
+        return TIM9;
+    else if (mode >= Gpio::TIM10_CH1 && mode < Gpio::TIM11_CH1)
+        return TIM10;
+    else if (mode >= Gpio::TIM11_CH1 && mode < Gpio::TIM12_CH1)
+        return TIM11;
+    else if (mode >= Gpio::TIM12_CH1 && mode < Gpio::TIM13_CH1)
+        return TIM12;
+    else if (mode >= Gpio::TIM13_CH1 && mode < Gpio::TIM14_CH1)
+        return TIM13;
+    else if (mode == Gpio::TIM14_CH1)
+        return TIM14;
+    return TIM_NONE;
+}
+
+constexpr Channel gpioModeToChannel(Gpio::Mode mode) {
+    switch (mode) {
+        case Gpio::TIM1_CH1:
+        case Gpio::TIM1_CH1N:
+        case Gpio::TIM2_CH1:
+        case Gpio::TIM3_CH1:
+        case Gpio::TIM4_CH1:
+        case Gpio::TIM5_CH1:
+        case Gpio::TIM8_CH1:
+        case Gpio::TIM8_CH1N:
+        case Gpio::TIM9_CH1:
+        case Gpio::TIM10_CH1:
+        case Gpio::TIM11_CH1:
+        case Gpio::TIM12_CH1:
+        case Gpio::TIM13_CH1:
+        case Gpio::TIM14_CH1:
+            return CH1;
+        case Gpio::TIM1_CH2:
+        case Gpio::TIM1_CH2N:
+        case Gpio::TIM2_CH2:
+        case Gpio::TIM3_CH2:
+        case Gpio::TIM4_CH2:
+        case Gpio::TIM5_CH2:
+        case Gpio::TIM8_CH2:
+        case Gpio::TIM8_CH2N:
+        case Gpio::TIM9_CH2:
+        case Gpio::TIM12_CH2:
+            return CH2;
+        case Gpio::TIM1_CH3:
+        case Gpio::TIM1_CH3N:
+        case Gpio::TIM2_CH3:
+        case Gpio::TIM3_CH3:
+        case Gpio::TIM4_CH3:
+        case Gpio::TIM5_CH3:
+        case Gpio::TIM8_CH3:
+        case Gpio::TIM8_CH3N:
+            return CH3;
+        case Gpio::TIM1_CH4:
+        case Gpio::TIM2_CH4:
+        case Gpio::TIM3_CH4:
+        case Gpio::TIM4_CH4:
+        case Gpio::TIM5_CH4:
+        case Gpio::TIM8_CH4:
+            return CH4;
+        default:
+            return CH_NONE;
+    }
+}
+
+/**
+ * @brief Get channels of a timer with a GPIO in gpioList
+ *
+ * @param timer Timer
+ *
+ * @return Channels in use (complementary outputs count as the same channel), CH_NONE for unused entries
+ */
+constexpr std::array<Channel, NUM_CHANNELS> getChannels(Timer timer) {
+    std::array<Channel, NUM_CHANNELS> channels = {CH_NONE, CH_NONE, CH_NONE, CH_NONE};
+    for (const Gpio::GpioConfig& gpioConfig : Gpio::gpioList) {
+        Channel channel = gpioModeToChannel(gpioConfig.mode);
+        if (gpioModeToTimer(gpioConfig.mode) != timer || channel == CH_NONE)
+            continue;
+        for (Channel& c : channels) {
+            if (c == channel)
+                break;
+            if (c == CH_NONE) {
+                c = channel;
+                break;
+            }
+        }
+    }
+    return channels;
+}
+
+/**
+ * @brief Encode dead time generator setting (BDTR DTG)
+ *
+ * @param ticks Dead time in timer clock ticks
+ *
+ * @return DTG value with the smallest dead time not shorter than ticks (saturated at 1008 ticks)
+ */
+constexpr uint8_t ticksToDtg(uint32_t ticks) {
+    if (ticks <= 127)
+        return ticks; // 0xxxxxxx: DTG ticks
+    if (ticks <= 254)
+        return 0x80 | ((ticks + 1) / 2 - 64); // 10xxxxxx: (64 + x) * 2 ticks
+    if (ticks <= 504)
+        return 0xC0 | ((ticks + 7) / 8 - 32); // 110xxxxx: (32 + x) * 8 ticks
+    if (ticks <= 1008)
+        return 0xE0 | ((ticks + 15) / 16 - 32); // 111xxxxx: (32 + x) * 16 ticks
+    return 0xFF;
+}
+
+/**
+ * @brief Decode dead time generator setting (BDTR DTG)
+ *
+ * @param dtg DTG value
+ *
+ * @return Dead time in timer clock ticks
+ */
+constexpr uint32_t dtgToTicks(uint8_t dtg) {
+    if ((dtg & 0x80) == 0)
+        return dtg;
+    if ((dtg & 0xC0) == 0x80)
+        return (64 + (dtg & 0x3F)) * 2;
+    if ((dtg & 0xE0) == 0xC0)
+        return (32 + (dtg & 0x1F)) * 8;
+    return (32 + (dtg & 0x1F)) * 16;
+}
+static_assert(dtgToTicks(ticksToDtg(127)) == 127 && dtgToTicks(ticksToDtg(129)) == 130 && dtgToTicks(ticksToDtg(255)) == 256 &&
+                  dtgToTicks(ticksToDtg(505)) == 512 && dtgToTicks(ticksToDtg(1008)) == 1008,
+              "Dead time generator encoding must round up");
+
+constexpr bool hasChannel(Timer timer, Channel channel) {
+    for (Channel c : getChannels(timer))
+        if (c == channel)
+            return true;
+    return false;
+}
+
+constexpr uint32_t getTimerClock(Timer timer) {
+    bool apb2 = timer == TIM1 || timer == TIM8 || timer == TIM9 || timer == TIM10 || timer == TIM11;
+    return apb2 ? APB2_TIMER_CLOCK : APB1_TIMER_CLOCK;
+}
+
+constexpr uint32_t getMaxPeriod(Timer timer) { return (timer == TIM2 || timer == TIM5) ? 0xFFFFFFFF : 0xFFFF; }
+
+static constexpr uint32_t NO_PRESCALER = 0xFFFFFFFF;
+
+/**
+ * @brief Prescaler generating an exact update frequency
+ *
+ * @param timer Timer
+ * @param frequency Update frequency in Hz
+ *
+ * @return Smallest prescaler (PSC) dividing the period exactly, NO_PRESCALER if the frequency can not be generated
+ */
+constexpr uint32_t frequencyToPrescaler(Timer timer, uint32_t frequency) {
+    uint32_t clock = getTimerClock(timer);
+    if (frequency == 0 || clock % frequency != 0)
+        return NO_PRESCALER;
+    uint32_t ticks = clock / frequency;
+    uint64_t maxTicks = uint64_t(getMaxPeriod(timer)) + 1;
+    for (uint32_t div = (ticks + maxTicks - 1) / maxTicks; div <= 0x10000; div++)
+        if (div > 0 && ticks % div == 0)
+            return div - 1;
+    return NO_PRESCALER;
+}
+
+/**
+ * @brief Auto-reload value generating an exact update frequency
+ *
+ * @param timer Timer
+ * @param frequency Update frequency in Hz (frequencyToPrescaler() must not be NO_PRESCALER)
+ *
+ * @return Auto-reload value (ARR)
+ */
+constexpr uint32_t frequencyToPeriod(Timer timer, uint32_t frequency) {
+    return getTimerClock(timer) / frequency / (frequencyToPrescaler(timer, frequency) + 1) - 1;
+}
+
+constexpr bool validTimerConfig(const TimerConfig& cfg) {
+    switch (cfg.mode) {
+        case Mode::PWM:
+            return getChannels(cfg.timer)[0] != CH_NONE;
+        case Mode::INTERRUPT:
+            return frequencyToPrescaler(cfg.timer, cfg.frequency) != NO_PRESCALER;
+        case Mode::INPUT_CAPTURE: {
+            // Slave reset mode and a second channel for the falling edge (not available on TIM6/7/10/11/13/14)
+            bool slave = (cfg.timer >= TIM1 && cfg.timer <= TIM5) || cfg.timer == TIM8 || cfg.timer == TIM9 || cfg.timer == TIM12;
+            bool oneInput = hasChannel(cfg.timer, CH1) != hasChannel(cfg.timer, CH2) && !hasChannel(cfg.timer, CH3) &&
+                            !hasChannel(cfg.timer, CH4);
+            uint32_t clock = getTimerClock(cfg.timer);
+            bool counter = cfg.frequency != 0 && clock % cfg.frequency == 0 && clock / cfg.frequency <= 0x10000;
+            return slave && oneInput && counter;
+        }
+        case Mode::INPUT_ENCODER: {
+            bool encoder = (cfg.timer >= TIM1 && cfg.timer <= TIM5) || cfg.timer == TIM8;
+            return encoder && hasChannel(cfg.timer, CH1) && hasChannel(cfg.timer, CH2);
+        }
+        case Mode::TRIGGER:
+            return true;
+    }
+    return false;
+}
+
+constexpr bool validTimerList() {
+    for (const TimerConfig& timerConfig : timerList)
+        if (!validTimerConfig(timerConfig))
+            return false;
+    return true;
+}
+static_assert(validTimerList(), "timerList has a PWM timer without GPIOs, a frequency that can not be generated exactly, an input "
+                                "capture timer without one input on CH1 or CH2, or an encoder timer without CH1 and CH2 GPIOs");
+
 }; // namespace Timer
 
 #endif // BLDC_DRIVERS_TIMER_TIMER_H
@@ -7,7 +7,6 @@
 #include <cstring>
 #include <drivers/gpio/gpio.h>
 #include <drivers/uart/uart.h>
-#include <set>
 #include <utils/circularBuffer.h>
 #include <utils/log.h>
 
@@ -33,7 +32,7 @@ bool _txDmaLinked; ///< True if TX DMA is linked
 
 // Transmit buffer
 CircularBuffer<TX_BUFFER_SIZE> _txBuffer;
-bool _txDmaBusy;
+volatile bool _txDmaBusy;
 volatile size_t _lastTxDmaSize = 0;
 
 // Receive buffer
@@ -45,6 +44,8 @@ CircularBuffer<RX_BUFFER_SIZE> _rxBuffer;
 // Tracks the last known position of the DMA write pointer in _rxDmaBuffer
 volatile uint16_t _lastRxDmaPos = 0;
 
+// Start DMA of the next contiguous TX chunk, must be called with interrupts masked
+void startTransmit();
 // Internal function to be called by the DMA complete ISR
 void txDmaComplete();
 // Internal function to be called by the UART idle line ISR
@@ -64,25 +65,25 @@ bool Uart::init() {
     _lastRxDmaPos = 0;
     _rxDmaBusy = false;
 
-    // Get peripherals in use
-    std::set<Peripheral> inUse;
-    for (Gpio::GpioConfig conf : Gpio::gpioList) {
-        if (conf.mode == Gpio::Mode::USART1_TX || conf.mode == Gpio::Mode::USART1_RX)
-            inUse.insert(Peripheral::UART1);
-        else if (conf.mode == Gpio::Mode::USART2_TX || conf.mode == Gpio::Mode::USART2_RX)
-            inUse.insert(Peripheral::UART2);
-        else if (conf.mode == Gpio::Mode::USART3_TX || conf.mode == Gpio::Mode::USART3_RX)
-            inUse.insert(Peripheral::UART3);
-        else if (conf.mode == Gpio::Mode::UART4_TX || conf.mode == Gpio::Mode::UART4_RX)
-            inUse.insert(Peripheral::UART4);
-        else if (conf.mode == Gpio::Mode::UART5_TX || conf.mode == Gpio::Mode::UART5_RX)
-            inUse.insert(Peripheral::UART5);
-        else if (conf.mode == Gpio::Mode::USART6_TX || conf.mode == Gpio::Mode::USART6_RX)
-            inUse.insert(Peripheral::UART6);
-    }
-
-    // Initialize peripherals
-    for (Peripheral peripheral : inUse) {
+    // Get peripherals in use (resolved from gpioList at compile time, indexed by Peripheral)
+    constexpr std::array<bool, 7> inUse = {
+        false,
+        Gpio::isUsed(Gpio::Mode::USART1_TX, Gpio::Mode::USART1_RX),
+        Gpio::isUsed(Gpio::Mode::USART2_TX, Gpio::Mode::USART2_RX),
+        Gpio::isUsed(Gpio::Mode::USART3_TX, Gpio::Mode::USART3_RX),
+        Gpio::isUsed(Gpio::Mode::UART4_TX, Gpio::Mode::UART4_RX),
+        Gpio::isUsed(Gpio::Mode::UART5_TX, Gpio::Mode::UART5_RX),
+        Gpio::isUsed(Gpio::Mode::USART6_TX, Gpio::Mode::USART6_RX),
+    };
+
+    // Initialize peripherals, the first one in use is the default
+    _default = Peripheral::DEFAULT;
+    for (size_t i = 1; i < inUse.size(); i++) {
+        Peripheral peripheral = Peripheral(i);
+        if (!inUse[i])
+            continue;
+        if (_default == Peripheral::DEFAULT)
+            _default = peripheral;
         enableClock(peripheral);
 
         UART_HandleTypeDef* huart = getHandle(peripheral);
@@ -95,16 +96,12 @@ bool Uart::init() {
         huart->Init.HwFlowCtl = UART_HWCONTROL_NONE;
         huart->Init.OverSampling = UART_OVERSAMPLING_16;
         if (HAL_UART_Init(huart) != HAL_OK) {
-            Log::error("Uart", "Failed to initialize UART$0", int(peripheral));
+            LOG_ERROR("Uart", "Failed to initialize UART$0", int(peripheral));
             return false;
         }
     }
 
-    // Set default peripheral
-    if (!inUse.empty())
-        _default = *inUse.begin();
-
-    Log::success("Uart", "Initialized");
+    LOG_SUCCESS("Uart", "Initialized");
     return _initialized = true;
 }
 
@@ -114,37 +111,32 @@ void Uart::update() {
     if (!_initialized || !_txDmaLinked || !_rxDmaLinked)
         return;
 
-    // Transmit pending transactions
-    if (!_txDmaBusy) {
-        // DMA transmit
-        uint32_t transmitSize = _txBuffer.getContiguousReadSize();
-        if (transmitSize > 0) {
-            _lastTxDmaSize = transmitSize;
-            uint8_t* dataToTransmit = _txBuffer.getReadPointer();
-            if (HAL_UART_Transmit_DMA(getHandle(Peripheral::DEFAULT), dataToTransmit, transmitSize) == HAL_OK) {
-                // We advance the read pointer ONLY after the transfer is complete, which will happen in the txDmaComplete() function
-                _txDmaBusy = true;
-            } else {
-                Log::error("Uart", "Failed to transmit, DMA error");
-                _lastTxDmaSize = 0; // Reset on failure
-            }
-        }
-    }
+    // Transmit pending bytes (the DMA complete ISR chains the following chunks)
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    startTransmit();
+    __set_PRIMASK(primask);
 
-    // Start DMA circular receive (if not already started)
+    // Start DMA circular receive (if not already started), idle line events deliver partial messages
     if (!_rxDmaBusy) {
-        if (HAL_UART_Receive_DMA(getHandle(Peripheral::DEFAULT), _rxDmaBuffer, RX_BUFFER_SIZE) == HAL_OK)
+        if (HAL_UARTEx_ReceiveToIdle_DMA(getHandle(Peripheral::DEFAULT), _rxDmaBuffer, RX_BUFFER_SIZE) == HAL_OK)
             _rxDmaBusy = true;
         else
-            Log::error("Uart", "Failed to start DMA receive");
+            LOG_ERROR("Uart", "Failed to start DMA receive");
     }
 }
 
 void Uart::transmit(uint8_t* data, uint32_t size) {
     if (!_initialized || !_txDmaLinked)
         return;
-    if (!_txBuffer.push(data, size))
-        Log::error("Uart", "Failed to transmit, TX buffer full");
+    // Tasks and the DMA complete ISR share the buffer
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool pushed = _txBuffer.push(data, size);
+    startTransmit();
+    __set_PRIMASK(primask);
+    if (!pushed)
+        LOG_ERROR("Uart", "Failed to transmit, TX buffer full");
 }
 
 uint32_t Uart::receive(uint8_t* data, uint32_t size) {
@@ -180,11 +172,29 @@ void Uart::linkDmaRx(Peripheral peripheral, Dma::Handle* dmaHandle) {
     _rxDmaLinked = true;
 }
 
+void Uart::startTransmit() {
+    if (_txDmaBusy || !_txDmaLinked)
+        return;
+    uint32_t transmitSize = _txBuffer.getContiguousReadSize();
+    if (transmitSize == 0)
+        return;
+    _lastTxDmaSize = transmitSize;
+    uint8_t* dataToTransmit = _txBuffer.getReadPointer();
+    if (HAL_UART_Transmit_DMA(getHandle(Peripheral::DEFAULT), dataToTransmit, transmitSize) == HAL_OK) {
+        // We advance the read pointer ONLY after the transfer is complete, which will happen in the txDmaComplete() function
+        _txDmaBusy = true;
+    } else
+        _lastTxDmaSize = 0; // Retried on the next transmit or update
+}
+
 void Uart::txDmaComplete() {
     // Advance the read pointer by the size of the last chunk that was sent
     _txBuffer.advanceRead(_lastTxDmaSize);
     _lastTxDmaSize = 0;
     _txDmaBusy = false;
+
+    // Chain the next chunk so the buffer drains without waiting for update()
+    startTransmit();
 }
 
 void Uart::rxDmaEvent(uint16_t size) {
@@ -9,7 +9,6 @@
 #include <drivers/dma/dma.h>
 #include <string>
 #include <system/hal.h>
-#include <vector>
 
 /**
  * @brief UART Driver
@@ -23,7 +22,7 @@ namespace Uart {
 
 constexpr uint32_t baudrate = 115200;
 enum class Peripheral : uint8_t { DEFAULT = 0, UART1, UART2, UART3, UART4, UART5, UART6 };
-constexpr uint32_t TX_BUFFER_SIZE = 1024;
+constexpr uint32_t TX_BUFFER_SIZE = 4096; // Holds the telemetry burst of one AttaConnector update
 constexpr uint32_t RX_BUFFER_SIZE = 1024;
 
 using Handle = UART_HandleTypeDef;
@@ -6,6 +6,7 @@
 //--------------------------------------------------
 #include "usb_device.h"
 #include "usbd_cdc_if.h"
+#include <algorithm>
 #include <drivers/usb/usb.h>
 #include <drivers/usb/usbHid.h>
 #include <system/hal.h>
@@ -324,7 +325,7 @@ void interfaceRequest(const SetupData& setupData);
 
 bool Usb::init() {
     if (!enableClock()) {
-        Log::error("Usb", "Failed to enable clock");
+        LOG_ERROR("Usb", "Failed to enable clock");
         return false;
     }
 
@@ -341,7 +342,7 @@ bool Usb::init() {
     hpcd.Init.vbus_sensing_enable = DISABLE;
     hpcd.Init.use_dedicated_ep1 = DISABLE;
     if (HAL_PCD_Init(&hpcd) != HAL_OK) {
-        Log::error("Usb", "Failed to initialize PCD");
+        LOG_ERROR("Usb", "Failed to initialize PCD");
         return false;
     }
 
@@ -365,11 +366,11 @@ bool Usb::init() {
 
     // Start
     if (HAL_PCD_Start(&hpcd) != HAL_OK) {
-        Log::error("Usb", "Failed to start PCD");
+        LOG_ERROR("Usb", "Failed to start PCD");
         return false;
     }
 
-    Log::success("Usb", "Initialized");
+    LOG_SUCCESS("Usb", "Initialized");
     return true;
 }
 
@@ -392,7 +393,7 @@ bool Usb::enableClock() {
 }
 
 void Usb::resetCallback(PCD_HandleTypeDef* hpcd) {
-    Log::debug("Usb", "Reset");
+    LOG_DEBUG("Usb", "Reset");
 
     // Configure EN0
     HAL_PCD_EP_Open(hpcd, (uint8_t)Endpoint::OUT0, EP0_MAX_PACKET_SIZE, (uint8_t)EPType::CONTROL); // EP0 OUT
@@ -409,20 +410,20 @@ void Usb::deviceGetDescriptor(const SetupData& setupData) {
         case (uint8_t)DescriptorType::DEVICE:
             if (HAL_PCD_EP_Transmit(&hpcd, (uint8_t)Endpoint::IN0, (uint8_t*)&_deviceDescriptor,
                                     std::min((uint16_t)sizeof(_deviceDescriptor), setupData.wLength)) != HAL_OK)
-                Log::error("Usb", "Failed to transmit device descriptor");
-            Log::debug("Usb", "DEVICE");
+                LOG_ERROR("Usb", "Failed to transmit device descriptor");
+            LOG_DEBUG("Usb", "DEVICE");
             break;
         case (uint8_t)DescriptorType::CONFIGURATION:
             if (HAL_PCD_EP_Transmit(&hpcd, (uint8_t)Endpoint::IN0, (uint8_t*)&_descriptorSet,
                                     std::min((uint16_t)sizeof(DescriptorSet), setupData.wLength)) != HAL_OK)
-                Log::error("Usb", "Failed to transmit descriptor set");
-            Log::debug("Usb", "CONFIGURATION");
+                LOG_ERROR("Usb", "Failed to transmit descriptor set");
+            LOG_DEBUG("Usb", "CONFIGURATION");
             break;
         case (uint8_t)DescriptorType::DEVICE_QUALIFIER:
 
             break;
         default:
-            Log::warning("Usb", "Could not handle deviceGetDescriptor with type $0", (int)descriptorType);
+            LOG_WARNING("Usb", "Could not handle deviceGetDescriptor with type $0", (int)descriptorType);
             break;
     }
 }
@@ -434,12 +435,12 @@ void Usb::deviceRequest(const SetupData& setupData) {
                 case SetupData::BRequest::SET_ADDRESS: {
                     uint16_t address = setupData.wValue;
                     if (address > 127 || setupData.wIndex > 0 || setupData.wLength > 0) {
-                        Log::error("Usb", "Wrong setupData for SET_ADDRESS");
+                        LOG_ERROR("Usb", "Wrong setupData for SET_ADDRESS");
                         break;
                     }
                     HAL_PCD_SetAddress(&hpcd, address);
                     HAL_PCD_EP_Transmit(&hpcd, (uint8_t)Endpoint::IN0, nullptr, 0);
-                    Log::debug("Usb", "Address set to $0", address);
+                    LOG_DEBUG("Usb", "Address set to $0", address);
                 } break;
                 case SetupData::BRequest::GET_DESCRIPTOR:
                     deviceGetDescriptor(setupData);
@@ -448,7 +449,7 @@ void Usb::deviceRequest(const SetupData& setupData) {
                     HAL_PCD_EP_Open(&hpcd, (uint8_t)Endpoint::IN3, 64, (uint8_t)EPType::INTERRUPT);
                     HAL_PCD_EP_Transmit(&hpcd, (uint8_t)Endpoint::IN3, nullptr, 0);
                     HAL_PCD_EP_Transmit(&hpcd, (uint8_t)Endpoint::IN0, nullptr, 0);
-                    Log::debug("Usb", "Set configuration to $0", (int)setupData.wValue);
+                    LOG_DEBUG("Usb", "Set configuration to $0", (int)setupData.wValue);
                     break;
                 default:
                     break;
@@ -481,7 +482,7 @@ void Usb::interfaceRequest(const SetupData& setupData) {
 }
 
 void Usb::setupStageCallback(PCD_HandleTypeDef* hpcd) {
-    Log::debug("Usb", "SETUP");
+    LOG_DEBUG("Usb", "SETUP");
     uint8_t* setup = (uint8_t*)hpcd->Setup;
     SetupData setupData;
     setupData.bmRequestType = setup[0];
@@ -502,13 +503,13 @@ void Usb::setupStageCallback(PCD_HandleTypeDef* hpcd) {
 }
 
 void Usb::dataOutStageCallback(PCD_HandleTypeDef* hpcd, uint8_t epnum) {
-    // Log::debug("Usb", "EP$0 OUT -> $1 $2", (int)epnum, (int)hpcd->OUT_ep[epnum].xfer_len, (int)hpcd->OUT_ep[epnum].xfer_count);
-    Log::debug("Usb", "EP$0 OUT", (int)epnum);
+    // LOG_DEBUG("Usb", "EP$0 OUT -> $1 $2", (int)epnum, (int)hpcd->OUT_ep[epnum].xfer_len, (int)hpcd->OUT_ep[epnum].xfer_count);
+    LOG_DEBUG("Usb", "EP$0 OUT", (int)epnum);
     // uint8_t* data = hpcd->OUT_ep[epnum].xfer_buff;
 }
 
 void Usb::dataInStageCallback(PCD_HandleTypeDef* hpcd, uint8_t epnum) {
-    Log::debug("Usb", "EP$0 IN", (int)epnum);
+    LOG_DEBUG("Usb", "EP$0 IN", (int)epnum);
 
     // TODO if more packets to transmit, transmit
 
@@ -522,17 +523,17 @@ void Usb::dataInStageCallback(PCD_HandleTypeDef* hpcd, uint8_t epnum) {
         // HidReport hidReport = {.x = 5};
         // HAL_PCD_EP_Transmit(hpcd, epnum, (uint8_t*)&hidReport, sizeof(HidReport));
         HAL_PCD_EP_Transmit(hpcd, epnum, nullptr, 0);
-        Log::debug("Usb", "Transmit $0", (int)sizeof(HidReport));
+        LOG_DEBUG("Usb", "Transmit $0", (int)sizeof(HidReport));
     }
     if (epnum == 0x00)
         HAL_PCD_EP_Receive(hpcd, epnum, nullptr, 0);
 }
 
-void Usb::SOFCallback(PCD_HandleTypeDef* hpcd) { Log::debug("Usb", "SOF"); }
+void Usb::SOFCallback(PCD_HandleTypeDef* hpcd) { LOG_DEBUG("Usb", "SOF"); }
 
-void Usb::suspendCallback(PCD_HandleTypeDef* hpcd) { Log::debug("Usb", "Suspend"); }
-void Usb::resumeCallback(PCD_HandleTypeDef* hpcd) { Log::debug("Usb", "Resume"); }
-void Usb::ISOOUTIncompleteCallback(PCD_HandleTypeDef* hpcd, uint8_t epnum) { Log::debug("Usb", "ISO OUT incomplete"); }
-void Usb::ISOINIncompleteCallback(PCD_HandleTypeDef* hpcd, uint8_t epnum) { Log::debug("Usb", "ISO IN incomplete"); }
-void Usb::connectCallback(PCD_HandleTypeDef* hpcd) { Log::debug("Usb", "Connect"); }
-void Usb::disconnectCallback(PCD_HandleTypeDef* hpcd) { Log::debug("Usb", "Disconnect"); }
+void Usb::suspendCallback(PCD_HandleTypeDef* hpcd) { LOG_DEBUG("Usb", "Suspend"); }
+void Usb::resumeCallback(PCD_HandleTypeDef* hpcd) { LOG_DEBUG("Usb", "Resume"); }
+void Usb::ISOOUTIncompleteCallback(PCD_HandleTypeDef* hpcd, uint8_t epnum) { LOG_DEBUG("Usb", "ISO OUT incomplete"); }
+void Usb::ISOINIncompleteCallback(PCD_HandleTypeDef* hpcd, uint8_t epnum) { LOG_DEBUG("Usb", "ISO IN incomplete"); }
+void Usb::connectCallback(PCD_HandleTypeDef* hpcd) { LOG_DEBUG("Usb", "Connect"); }
+void Usb::disconnectCallback(PCD_HandleTypeDef* hpcd) { LOG_DEBUG("Usb", "Disconnect"); }
@@ -10,11 +10,16 @@
 
 bool Voltage::init(Gpio::Gpio gpio) {
     _gpio = gpio;
-    Log::success("Voltage", "Initialized for GPIO $0", gpio.toString());
+    _source = Adc::getSource(gpio);
+    if (_source == Adc::INVALID_SOURCE) {
+        LOG_ERROR("Voltage", "GPIO $0 is not in adcList", gpio.toString());
+        return false;
+    }
+    LOG_SUCCESS("Voltage", "Initialized for GPIO $0", gpio.toString());
     return true;
 }
 
 float Voltage::read() {
     static constexpr float multiplier = 3.33f * (R1 + R2) / R2;
-    return (Adc::read(_gpio) / float(Adc::MAX_READ)) * multiplier;
+    return (Adc::read(_source) / float(Adc::MAX_READ)) * multiplier;
 }
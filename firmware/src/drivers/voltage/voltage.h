@@ -6,6 +6,7 @@
 //--------------------------------------------------
 #ifndef BLDC_DRIVERS_VOLTAGE_VOLTAGE_H
 #define BLDC_DRIVERS_VOLTAGE_VOLTAGE_H
+#include <drivers/adc/adc.h>
 #include <drivers/gpio/gpio.h>
 
 class Voltage {
@@ -25,6 +26,7 @@ class Voltage {
     static constexpr float R2 = 10.0f;
 
     Gpio::Gpio _gpio;
+    Adc::Source _source; ///< ADC source resolved at init
 };
 
 inline Voltage volt_src;
@@ -18,7 +18,7 @@ int main() {
     if (!Hardware::init())
         Error::hardFault("Failed to initialize hardware!");
     else
-        Log::success("Main", "Hardware initialized");
+        LOG_SUCCESS("Main", "Hardware initialized");
 
     // Initialize FreeRTOS and tasks
     osKernelInitialize();
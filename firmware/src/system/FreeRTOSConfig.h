@@ -169,6 +169,15 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+/* Run time statistics on the DWT cycle counter (SystemCoreClock). The 32 bit counters wrap every 29.8s at 144MHz, so
+only differences over shorter windows are valid (Health::transmit) */
+#define configGENERATE_RUN_TIME_STATS            1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()                                                                       \
+    do {                                                                                                               \
+        (*(volatile uint32_t*)0xE000EDFCUL) |= (1UL << 24); /* CoreDebug->DEMCR |= TRCENA */                           \
+        (*(volatile uint32_t*)0xE0001000UL) |= 1UL;         /* DWT->CTRL |= CYCCNTENA */                               \
+    } while (0)
+#define portGET_RUN_TIME_COUNTER_VALUE()         (*(volatile uint32_t*)0xE0001004UL) /* DWT->CYCCNT */
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
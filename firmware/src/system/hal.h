@@ -40,5 +40,9 @@
 #undef UART4
 #undef UART5
 #undef USART6
+#undef DAC1
+#undef DCMI
+#undef QUADSPI
+#undef SDIO
 
 #endif // BLDC_SYSTEM_HAL_H
@@ -0,0 +1,70 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// periodStats.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <algorithm>
+#include <tasks/periodStats.h>
+
+void PeriodStats::setPeriod(uint32_t period, uint32_t deadline) {
+    _period = period;
+    _deadline = deadline > 0 ? deadline : period;
+}
+
+void PeriodStats::start(uint32_t now) {
+    _start = now;
+    if (!_started) {
+        _started = true;
+        _release = now;
+        _lastStart = now;
+        _report.count++;
+        return;
+    }
+
+    uint32_t period = now - _lastStart;
+    _report.minPeriod = _periodCount == 0 ? period : std::min(_report.minPeriod, period);
+    _report.maxPeriod = std::max(_report.maxPeriod, period);
+    _sumPeriod += period;
+    _periodCount++;
+    _report.meanPeriod = _sumPeriod / _periodCount;
+
+    uint32_t jitter;
+    if (_period > 0) {
+        // Signed, the tick quantization can activate the task slightly before the release in cycles
+        _release += _period;
+        int32_t latency = int32_t(now - _release);
+        jitter = latency < 0 ? uint32_t(-latency) : uint32_t(latency);
+    } else
+        jitter = _lastPeriod == 0 ? 0 : (period > _lastPeriod ? period - _lastPeriod : _lastPeriod - period);
+    _report.maxJitter = std::max(_report.maxJitter, jitter);
+
+    _lastStart = now;
+    _lastPeriod = period;
+    _report.count++;
+}
+
+void PeriodStats::finish(uint32_t now) {
+    uint32_t execution = now - _start;
+    _report.maxExecution = std::max(_report.maxExecution, execution);
+    uint32_t response = _period > 0 ? now - _release : execution;
+    if (_deadline > 0 && int32_t(response) > int32_t(_deadline))
+        _report.misses++;
+}
+
+void PeriodStats::skip(uint32_t releases) {
+    _release += releases * _period;
+    _report.misses += releases;
+}
+
+PeriodStats::Report PeriodStats::getReport() const { return _report; }
+
+void PeriodStats::reset() {
+    _report = {};
+    _sumPeriod = 0;
+    _periodCount = 0;
+}
+
+uint32_t PeriodStats::getPeriod() const { return _period; }
+
+uint32_t PeriodStats::getDeadline() const { return _deadline; }
@@ -0,0 +1,71 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// periodStats.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_TASKS_PERIOD_STATS_H
+#define BLDC_TASKS_PERIOD_STATS_H
+#include <cstdint>
+
+/**
+ * @brief Activation timing of a task
+ *
+ * Periodic tasks are released every period, starting at the first activation. The jitter is how far each activation
+ * starts from its release, and a deadline is missed when the activation finishes more than deadline after its release.
+ * Event tasks (period 0) have no release: the jitter is the change between consecutive periods, and the deadline is
+ * measured from the activation start.
+ *
+ * Times are cycle counter values passed by the caller, so it does not depend on FreeRTOS or the HAL and can be built
+ * on the host
+ */
+class PeriodStats {
+  public:
+    struct Report {
+        uint32_t count;        ///< Activations
+        uint32_t minPeriod;    ///< Shortest period between activations (cycles)
+        uint32_t maxPeriod;    ///< Longest period between activations (cycles)
+        uint32_t meanPeriod;   ///< Mean period between activations (cycles)
+        uint32_t maxJitter;    ///< Largest jitter (cycles)
+        uint32_t maxExecution; ///< Longest activation (cycles)
+        uint32_t misses;       ///< Deadline misses, including skipped releases
+    };
+
+    /**
+     * @brief Set timing constraints
+     *
+     * @param period Release period in cycles (0 for event tasks)
+     * @param deadline Deadline relative to the release in cycles (0 for the period)
+     */
+    void setPeriod(uint32_t period, uint32_t deadline);
+
+    void start(uint32_t now);  ///< Activation started
+    void finish(uint32_t now); ///< Activation finished
+
+    /**
+     * @brief Releases skipped because the task was late
+     *
+     * @param releases Number of releases that will not be activated
+     */
+    void skip(uint32_t releases);
+
+    Report getReport() const; ///< Timing since the last reset
+    void reset();             ///< Restart the report, the release phase is kept
+
+    uint32_t getPeriod() const;
+    uint32_t getDeadline() const;
+
+  private:
+    uint32_t _period = 0;
+    uint32_t _deadline = 0;
+    bool _started = false; // An activation was seen (_release and _lastStart are valid)
+    uint32_t _release = 0; // Release of the current activation
+    uint32_t _lastStart = 0;
+    uint32_t _lastPeriod = 0;
+    uint32_t _start = 0; // Start of the current activation
+    uint64_t _sumPeriod = 0;
+    uint32_t _periodCount = 0;
+    Report _report = {};
+};
+
+#endif // BLDC_TASKS_PERIOD_STATS_H
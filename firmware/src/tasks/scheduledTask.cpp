@@ -0,0 +1,129 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// scheduledTask.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <common/attaConnector.h>
+#include <common/attaConnectorCmds.h>
+#include <cstring>
+#include <system/hal.h>
+#include <tasks/scheduledTask.h>
+#include <utils/log.h>
+
+TaskHandle_t ScheduledTask::getHandle() const { return _handle; }
+
+PeriodStats::Report ScheduledTask::getReport() {
+    // Updated by the task itself, the critical section keeps the copy consistent
+    taskENTER_CRITICAL();
+    PeriodStats::Report report = _stats.getReport();
+    _stats.reset();
+    taskEXIT_CRITICAL();
+    return report;
+}
+
+bool ScheduledTask::transmit() {
+    if (_handle == nullptr)
+        return true;
+    PeriodStats::Report report = getReport();
+
+    TaskTiming cmd{};
+    std::strncpy(cmd.name.data(), _name, cmd.name.size() - 1);
+    cmd.clock = SystemCoreClock;
+    cmd.period = _stats.getPeriod();
+    cmd.deadline = _stats.getDeadline();
+    cmd.count = report.count;
+    cmd.minPeriod = report.minPeriod;
+    cmd.maxPeriod = report.maxPeriod;
+    cmd.meanPeriod = report.meanPeriod;
+    cmd.maxJitter = report.maxJitter;
+    cmd.maxExecution = report.maxExecution;
+    cmd.misses = report.misses;
+    return AttaConnector::transmit(cmd);
+}
+
+bool ScheduledTask::create(const char* name, Function function, UBaseType_t priority, uint16_t stackSize,
+                           TaskFunction_t run) {
+    _name = name;
+    _function = function;
+    if (xTaskCreate(run, name, stackSize, this, priority, &_handle) != pdPASS) {
+        LOG_ERROR("ScheduledTask", "Failed to create $0", name);
+        _handle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+uint32_t ScheduledTask::toCycles(uint32_t ms) { return uint32_t(uint64_t(ms) * SystemCoreClock / 1000); }
+
+bool PeriodicTask::start(const Config& config) {
+    _period = pdMS_TO_TICKS(config.period);
+    if (_period == 0) {
+        LOG_ERROR("PeriodicTask", "Period of $0 is shorter than a tick", config.name);
+        return false;
+    }
+    _stats.setPeriod(toCycles(config.period), toCycles(config.deadline));
+    return create(config.name, config.function, config.priority, config.stackSize, run);
+}
+
+void PeriodicTask::run(void* argument) {
+    PeriodicTask* task = static_cast<PeriodicTask*>(argument);
+    TickType_t lastWake = xTaskGetTickCount();
+    for (;;) {
+        taskENTER_CRITICAL();
+        task->_stats.start(DWT->CYCCNT);
+        taskEXIT_CRITICAL();
+        task->_function();
+        taskENTER_CRITICAL();
+        task->_stats.finish(DWT->CYCCNT);
+
+        // Skip the releases already missed, keeping the release phase
+        TickType_t late = xTaskGetTickCount() - lastWake;
+        if (late >= 2 * task->_period) {
+            TickType_t skipped = late / task->_period - 1;
+            lastWake += skipped * task->_period;
+            task->_stats.skip(skipped);
+        }
+        taskEXIT_CRITICAL();
+
+        vTaskDelayUntil(&lastWake, task->_period);
+    }
+}
+
+bool EventTask::start(const Config& config) {
+    _timeout = config.timeout > 0 ? pdMS_TO_TICKS(config.timeout) : portMAX_DELAY;
+    _stats.setPeriod(0, toCycles(config.deadline));
+    return create(config.name, config.function, config.priority, config.stackSize, run);
+}
+
+void EventTask::notify() {
+    if (_handle != nullptr)
+        xTaskNotifyGive(_handle);
+}
+
+void EventTask::notifyFromIsr() {
+    if (_handle == nullptr || xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED)
+        return;
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(_handle, &higherPriorityTaskWoken);
+    portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
+
+void EventTask::run(void* argument) {
+    EventTask* task = static_cast<EventTask*>(argument);
+    for (;;) {
+        // Timeouts run the function but are not activations
+        bool notified = ulTaskNotifyTake(pdTRUE, task->_timeout) > 0;
+        if (notified) {
+            taskENTER_CRITICAL();
+            task->_stats.start(DWT->CYCCNT);
+            taskEXIT_CRITICAL();
+        }
+        task->_function();
+        if (notified) {
+            taskENTER_CRITICAL();
+            task->_stats.finish(DWT->CYCCNT);
+            taskEXIT_CRITICAL();
+        }
+    }
+}
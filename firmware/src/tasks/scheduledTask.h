@@ -0,0 +1,115 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// scheduledTask.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_TASKS_SCHEDULED_TASK_H
+#define BLDC_TASKS_SCHEDULED_TASK_H
+#include <cstdint>
+#include <tasks/periodStats.h>
+
+// FreeRTOS includes
+#include <FreeRTOS.h>
+#include <task.h>
+
+//---------------------------------//
+//---------- Description ----------//
+//---------------------------------//
+// Tasks that run a function on each activation and measure their timing with PeriodStats
+//
+// PeriodicTask is released every period by vTaskDelayUntil, so the release times do not drift with the execution time.
+// When an activation finishes after the next release, the releases already missed are skipped (and counted as deadline
+// misses) instead of running back to back.
+//
+// EventTask is activated by a direct-to-task notification, usually given by a driver interrupt. The notifications
+// given while the function runs are merged into the next activation.
+//
+// The timing is sent as TaskTiming commands by transmit() and restarted for the next report
+
+//---------------------------------//
+//------------ Examples -----------//
+//---------------------------------//
+// static PeriodicTask ledTask;
+// ledTask.start({"LedTask", ledStep, 1000, 0, tskIDLE_PRIORITY + 1, 512});
+//
+// static EventTask vibrationTask;
+// vibrationTask.start({"VibrationTask", vibrationStep, 100, 10, tskIDLE_PRIORITY + 1, 512});
+// imu.setNotify(vibrationTask.getHandle());
+
+class ScheduledTask {
+  public:
+    using Function = void (*)();
+
+    TaskHandle_t getHandle() const;
+    PeriodStats::Report getReport(); ///< Timing since the last report
+
+    /**
+     * @brief Send the timing since the last report
+     *
+     * @return True if the command was queued
+     */
+    bool transmit();
+
+  protected:
+    bool create(const char* name, Function function, UBaseType_t priority, uint16_t stackSize, TaskFunction_t run);
+    static uint32_t toCycles(uint32_t ms);
+
+    const char* _name = nullptr;
+    Function _function = nullptr;
+    TaskHandle_t _handle = nullptr;
+    PeriodStats _stats;
+};
+
+class PeriodicTask : public ScheduledTask {
+  public:
+    struct Config {
+        const char* name;
+        Function function; ///< Called on each release
+        uint32_t period;   ///< Release period (ms)
+        uint32_t deadline; ///< Deadline relative to the release (ms, 0 for the period)
+        UBaseType_t priority;
+        uint16_t stackSize; ///< Stack size (words)
+    };
+
+    /**
+     * @brief Create the task, the first release is immediate
+     *
+     * @return True if the task was created
+     */
+    bool start(const Config& config);
+
+  private:
+    static void run(void* argument);
+
+    TickType_t _period = 0;
+};
+
+class EventTask : public ScheduledTask {
+  public:
+    struct Config {
+        const char* name;
+        Function function; ///< Called on each notification and timeout
+        uint32_t timeout;  ///< Activation without notification (ms, 0 to wait forever)
+        uint32_t deadline; ///< Deadline relative to the activation (ms, 0 for none)
+        UBaseType_t priority;
+        uint16_t stackSize; ///< Stack size (words)
+    };
+
+    /**
+     * @brief Create the task, it waits for the first notification
+     *
+     * @return True if the task was created
+     */
+    bool start(const Config& config);
+
+    void notify();        ///< Activate from a task
+    void notifyFromIsr(); ///< Activate from an interrupt
+
+  private:
+    static void run(void* argument);
+
+    TickType_t _timeout = portMAX_DELAY;
+};
+
+#endif // BLDC_TASKS_SCHEDULED_TASK_H
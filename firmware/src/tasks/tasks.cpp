@@ -4,74 +4,149 @@
 // Date: 2025-08-31
 // By Breno Cunha Queiroz
 //--------------------------------------------------
+#include <cmath>
+#include <common/attaConnector.h>
+#include <tasks/scheduledTask.h>
 #include <tasks/tasks.h>
+#include <utils/health.h>
 #include <utils/log.h>
+#include <utils/profiler.h>
 
 #include <drivers/current/current.h>
 #include <drivers/encoder/encoder.h>
 #include <drivers/imu/imu.h>
+#include <drivers/imu/vibration.h>
 #include <drivers/timer/timer.h>
+#include <drivers/uart/uart.h>
 #include <drivers/voltage/voltage.h>
 
 // FreeRTOS includes
 #include <FreeRTOS.h>
-#include <cmsis_os.h>
+#include <queue.h>
 #include <task.h>
 
-static void controllerTask(void* argument);
-static void ledTask(void* argument);
-static void attaConnectorTask(void* argument);
+static void controllerTask();
+static void ledTask();
+static void attaConnectorTask();
+static void vibrationTask();
+static void logTask();
+static void transmitTiming();
+
+static PeriodicTask controller;
+static PeriodicTask led;
+static PeriodicTask attaConnector;
+static EventTask vibration;
+static PeriodicTask logger;
+
+// AttaConnector is not thread safe, AttaConnectorTask is its only user and the other tasks queue their commands
+static constexpr UBaseType_t SPECTRUM_QUEUE_SIZE = 2; // Spectra produced during one AttaConnectorTask period
+static StaticQueue_t spectrumQueueBuffer;
+static uint8_t spectrumQueueStorage[SPECTRUM_QUEUE_SIZE * sizeof(VibrationSpectrum)];
+static QueueHandle_t spectrumQueue;
 
 bool Tasks::init() {
+    spectrumQueue = xQueueCreateStatic(SPECTRUM_QUEUE_SIZE, sizeof(VibrationSpectrum), spectrumQueueStorage, &spectrumQueueBuffer);
+
     // Create tasks
-    xTaskCreate(controllerTask, "ControllerTask", 512, NULL, configMAX_PRIORITIES - 1, NULL);
-    xTaskCreate(ledTask, "LedTask", 512, NULL, tskIDLE_PRIORITY + 1, NULL);
-    xTaskCreate(attaConnectorTask, "AttaConnectorTask", 512, NULL, tskIDLE_PRIORITY + 2, NULL);
-    return true;
+    bool success = true;
+    success &= controller.start({"ControllerTask", controllerTask, 1000, 0, configMAX_PRIORITIES - 1, 512});
+    success &= led.start({"LedTask", ledTask, 1000, 0, tskIDLE_PRIORITY + 1, 512});
+    success &= attaConnector.start({"AttaConnectorTask", attaConnectorTask, 500, 0, tskIDLE_PRIORITY + 2, 512});
+    // Woken by each IMU FIFO drain (~9.6ms), the timeout keeps the rotor speed updated without IMU
+    success &= vibration.start({"VibrationTask", vibrationTask, 20, 10, tskIDLE_PRIORITY + 1, 512});
+    success &= logger.start({"LogTask", logTask, 10, 0, tskIDLE_PRIORITY + 1, 256});
+    imu.setNotify(vibration.getHandle());
+    return success;
 }
 
-void controllerTask(void* argument) {
-    for (;;) {
-        Log::success("ControllerTask", "Running...");
-        osDelay(1000);
-    }
+void controllerTask() { LOG_SUCCESS("ControllerTask", "Running..."); }
+
+void ledTask() { LOG_SUCCESS("LedTask", "Running..."); }
+
+void attaConnectorTask() {
+    float v_src = volt_src.read();
+    float v_u = volt_u_phase.read();
+    float v_v = volt_v_phase.read();
+    float v_w = volt_w_phase.read();
+    LOG_SUCCESS("AttaConnectorTask", "Voltages: SRC=$0V, U=$1V, V=$2V, W=$3V", v_src, v_u, v_v, v_w);
+
+    // float i_u = curr_u_phase.read();
+    // float i_v = curr_v_phase.read();
+    // float i_w = curr_w_phase.read();
+    // LOG_SUCCESS("AttaConnectorTask", "Currents: U=$0A, V=$1A, W=$2A", i_u, i_v, i_w);
+
+    // std::array<int16_t, 3> acc = imu.getAcc();
+    // std::array<int16_t, 3> gyr = imu.getGyr();
+    // float temp = imu.getTemp();
+    // LOG_SUCCESS("AttaConnectorTask", "Acc: X=$0, Y=$1, Z=$2", acc[0], acc[1], acc[2]);
+    // LOG_SUCCESS("AttaConnectorTask", "Gyr: X=$0, Y=$1, Z=$2", gyr[0], gyr[1], gyr[2]);
+    // LOG_SUCCESS("AttaConnectorTask", "Temp: $0C", temp);
+
+    // std::optional<float> angle = encoder.readAngle();
+    // std::optional<uint32_t> magnitude = encoder.readMagnitude();
+    // if (angle.has_value() && magnitude.has_value())
+    //     LOG_SUCCESS("AttaConnectorTask", "Angle: $0 degrees. Magnitude: $1", angle.value(), magnitude.value());
+    // else
+    //     LOG_ERROR("AttaConnectorTask", "Failed to read angle or magnitude from encoder");
+
+    LOG_SUCCESS("AttaConnectorTask", "Running...");
+    VibrationSpectrum spectrum;
+    while (xQueueReceive(spectrumQueue, &spectrum, 0) == pdPASS)
+        AttaConnector::transmit(spectrum);
+    Profiler::transmit();
+    Health::transmit();
+    transmitTiming();
+
+    // Encode the queued commands into the UART buffer and process received commands
+    AttaConnector::update();
+    Uart::update();
 }
 
-void ledTask(void* argument) {
-    for (;;) {
-        Log::success("LedTask", "Running...");
-        osDelay(1000);
+// Vibration spectrum state, static (too large for the task stack) and kept between activations
+static constexpr uint32_t SEND_FRAMES = 8; // Averaged frames between transmissions (~0.6s)
+static Vibration vibrationSpectrum(Imu::FIFO_RATE);
+static float rotorVelocity = 0.0f; // Sum of the PLL velocities since last transmission (rad/s)
+static uint32_t rotorSamples = 0;  // Encoder samples in rotorVelocity
+static uint32_t lastCycles = 0;    // Cycle counter of the last encoder sample used
+static_assert(Vibration::NUM_BINS % VibrationSpectrum::NUM_BINS == 0, "Spectrum bins must divide the FFT bins");
+static_assert(VibrationSpectrum::NUM_PEAKS <= Vibration::NUM_HARMONICS, "Not enough harmonics for the peaks");
+
+void vibrationTask() {
+    // Mean rotor speed over the transmission period. The encoder PLL tracks every pipeline sample, so its velocity does not
+    // alias like the angle difference between two activations would above half a turn per activation
+    std::optional<Encoder::Sample> sample = encoder.getSample();
+    if (sample.has_value() && sample->cycles != lastCycles) {
+        rotorVelocity += std::fabs(sample->state.velocity);
+        rotorSamples++;
+        lastCycles = sample->cycles;
     }
-}
 
-void attaConnectorTask(void* argument) {
-    for (;;) {
-        float v_src = volt_src.read();
-        float v_u = volt_u_phase.read();
-        float v_v = volt_v_phase.read();
-        float v_w = volt_w_phase.read();
-        Log::success("AttaConnectorTask", "Voltages: SRC=$0V, U=$1V, V=$2V, W=$3V", v_src, v_u, v_v, v_w);
-
-        // float i_u = curr_u_phase.read();
-        // float i_v = curr_v_phase.read();
-        // float i_w = curr_w_phase.read();
-        // Log::success("AttaConnectorTask", "Currents: U=$0A, V=$1A, W=$2A", i_u, i_v, i_w);
-
-        // std::array<int16_t, 3> acc = imu.getAcc();
-        // std::array<int16_t, 3> gyr = imu.getGyr();
-        // float temp = imu.getTemp();
-        // Log::success("AttaConnectorTask", "Acc: X=$0, Y=$1, Z=$2", acc[0], acc[1], acc[2]);
-        // Log::success("AttaConnectorTask", "Gyr: X=$0, Y=$1, Z=$2", gyr[0], gyr[1], gyr[2]);
-        // Log::success("AttaConnectorTask", "Temp: $0C", temp);
-
-        // std::optional<float> angle = encoder.readAngle();
-        // std::optional<uint32_t> magnitude = encoder.readMagnitude();
-        // if (angle.has_value() && magnitude.has_value())
-        //     Log::success("AttaConnectorTask", "Angle: $0 degrees. Magnitude: $1", angle.value(), magnitude.value());
-        // else
-        //     Log::error("AttaConnectorTask", "Failed to read angle or magnitude from encoder");
-
-        Log::success("AttaConnectorTask", "Running...");
-        osDelay(500);
+    ImuFifo::Sample imuSample;
+    while (imu.readSample(imuSample)) {
+        if (!vibrationSpectrum.push(imuSample.acc) || vibrationSpectrum.getFrames() % SEND_FRAMES != 0)
+            continue;
+
+        VibrationSpectrum cmd;
+        cmd.rotorFrequency = rotorSamples > 0 ? rotorVelocity / rotorSamples / (2 * float(M_PI)) : 0.0f;
+        cmd.binWidth = vibrationSpectrum.getBinWidth() * (Vibration::NUM_BINS / VibrationSpectrum::NUM_BINS);
+        cmd.scale = vibrationSpectrum.compress(cmd.spectrum.data(), cmd.spectrum.size());
+        std::array<Vibration::Peak, Vibration::NUM_HARMONICS> peaks = vibrationSpectrum.findPeaks(cmd.rotorFrequency);
+        for (size_t i = 0; i < VibrationSpectrum::NUM_PEAKS; i++) {
+            cmd.peakFrequency[i] = peaks[i].frequency;
+            cmd.peakAmplitude[i] = peaks[i].amplitude;
+        }
+        if (xQueueSend(spectrumQueue, &cmd, 0) != pdPASS)
+            LOG_WARNING("VibrationTask", "Spectrum dropped, queue full");
+        rotorVelocity = 0.0f;
+        rotorSamples = 0;
     }
 }
+
+// Transmit the records queued by the other tasks and interrupts
+void logTask() { Log::flush(); }
+
+void transmitTiming() {
+    ScheduledTask* tasks[] = {&controller, &led, &attaConnector, &vibration, &logger};
+    for (ScheduledTask* task : tasks)
+        task->transmit();
+}
@@ -10,7 +10,8 @@
 #include <utils/log.h>
 
 void Error::hardFault(const char* reason) {
-    Log::error("Error", "HardFault: $0", reason);
+    LOG_ERROR("Error", "HardFault: $0", reason);
+    Log::flush();
     while (true) {
         // Gpio::write(Gpio::LED_PIN, true);
         // Hardware::delay(0.1f);
@@ -20,19 +21,22 @@ void Error::hardFault(const char* reason) {
 }
 
 void Error::memFault() {
-    Log::error("Error", "MemFault");
+    LOG_ERROR("Error", "MemFault");
+    Log::flush();
     while (true) {
     }
 }
 
 void Error::busFault() {
-    Log::error("Error", "BusFault");
+    LOG_ERROR("Error", "BusFault");
+    Log::flush();
     while (true) {
     }
 }
 
 void Error::usageFault() {
-    Log::error("Error", "UsageFault");
+    LOG_ERROR("Error", "UsageFault");
+    Log::flush();
     while (true) {
     }
 }
@@ -0,0 +1,92 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// health.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <algorithm>
+#include <array>
+#include <common/attaConnector.h>
+#include <common/attaConnectorCmds.h>
+#include <cstring>
+#include <utils/health.h>
+#include <utils/log.h>
+
+// FreeRTOS includes
+#include <FreeRTOS.h>
+#include <task.h>
+
+namespace Health {
+
+constexpr const char* IDLE_TASK_NAME = "IDLE"; // FreeRTOS default idle task name
+
+// Run time counter of each task at the previous call
+struct RunTime {
+    UBaseType_t number;
+    uint32_t counter;
+};
+
+std::array<TaskStatus_t, SystemHealth::MAX_TASKS> _status;
+std::array<RunTime, SystemHealth::MAX_TASKS> _lastRunTime;
+size_t _numLastRunTime = 0;
+uint32_t _lastTotalRunTime = 0;
+
+} // namespace Health
+
+bool Health::transmit() {
+    uint32_t totalRunTime;
+    size_t numTasks = uxTaskGetSystemState(_status.data(), _status.size(), &totalRunTime);
+    if (numTasks == 0) {
+        LOG_ERROR("Health", "More than $0 tasks", int(SystemHealth::MAX_TASKS));
+        return false;
+    }
+    uint32_t elapsed = totalRunTime - _lastTotalRunTime;
+    _lastTotalRunTime = totalRunTime;
+
+    // CPU usage since the last call
+    std::array<RunTime, SystemHealth::MAX_TASKS> runTime;
+    std::array<uint16_t, SystemHealth::MAX_TASKS> cpu;
+    uint16_t idle = 0;
+    for (size_t i = 0; i < numTasks; i++) {
+        const TaskStatus_t& status = _status[i];
+        uint32_t last = 0; // Tasks created since the last call ran only after it
+        for (size_t j = 0; j < _numLastRunTime; j++)
+            if (_lastRunTime[j].number == status.xTaskNumber)
+                last = _lastRunTime[j].counter;
+        runTime[i] = {status.xTaskNumber, status.ulRunTimeCounter};
+
+        uint64_t delta = status.ulRunTimeCounter - last;
+        cpu[i] = elapsed > 0 ? std::min<uint64_t>(delta * 10000 / elapsed, 10000) : 0;
+        if (std::strcmp(status.pcTaskName, IDLE_TASK_NAME) == 0)
+            idle = cpu[i];
+    }
+    _lastRunTime = runTime;
+    _numLastRunTime = numTasks;
+
+    SystemHealth cmd{};
+    cmd.heapFree = xPortGetFreeHeapSize();
+    cmd.heapMinFree = xPortGetMinimumEverFreeHeapSize();
+    cmd.cpuLoad = 10000 - idle;
+    cmd.numTasks = numTasks;
+
+    // Most demanding tasks first
+    std::array<uint8_t, SystemHealth::MAX_TASKS> order;
+    for (size_t i = 0; i < numTasks; i++)
+        order[i] = i;
+    std::sort(order.begin(), order.begin() + numTasks, [&cpu](uint8_t a, uint8_t b) { return cpu[a] > cpu[b]; });
+    for (size_t i = 0; i < numTasks; i++) {
+        const TaskStatus_t& status = _status[order[i]];
+        SystemHealth::Task& task = cmd.tasks[i];
+        std::strncpy(task.name.data(), status.pcTaskName, task.name.size() - 1);
+        task.cpu = cpu[order[i]];
+        task.stackHighWater = status.usStackHighWaterMark;
+        task.priority = status.uxCurrentPriority;
+        task.state = status.eCurrentState;
+    }
+
+    if (!AttaConnector::transmit(cmd)) {
+        LOG_WARNING("Health", "Failed to queue report, connector TX full");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,25 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// health.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_UTILS_HEALTH_H
+#define BLDC_UTILS_HEALTH_H
+
+namespace Health {
+
+/**
+ * @brief Send the system health
+ *
+ * Samples the CPU usage (FreeRTOS run time statistics) and stack high water mark of each task, and the free heap, and
+ * sends them as a SystemHealth command. The CPU usage is measured since the previous call, which must be less than
+ * 29.8s ago (run time counter wrap)
+ *
+ * @return True if the command was queued
+ */
+bool transmit();
+
+} // namespace Health
+
+#endif // BLDC_UTILS_HEALTH_H
@@ -4,22 +4,340 @@
 // Date: 2023-09-21
 // By Breno Cunha Queiroz
 //--------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <drivers/uart/uart.h>
 #include <utils/log.h>
 
+// FreeRTOS includes
+#include <FreeRTOS.h>
+#include <task.h>
+
 //#define ENABLE_UART_LOG
 #define ENABLE_ITM_LOG
 
-void Log::transmit(const std::string& str) {
+std::atomic<uint32_t> Log::_ring[Log::RING_WORDS] = {};
+std::atomic<uint32_t> Log::_head{0};
+std::atomic<uint32_t> Log::_tail{0};
+std::atomic<uint32_t> Log::_dropped{0};
+
+// Formats into a fixed buffer, characters that do not fit are dropped
+class Log::Writer {
+  public:
+    Writer(char* buffer, size_t size) : _buffer(buffer), _size(size), _pos(0) {}
+
+    size_t size() const { return _pos; }
+
+    void put(char c) {
+        if (_pos < _size)
+            _buffer[_pos++] = c;
+    }
+
+    void put(const char* str) {
+        for (str = str ? str : "(null)"; *str; str++)
+            put(*str);
+    }
+
+    void putUnsigned(uint32_t value) {
+        char digits[10];
+        size_t n = 0;
+        do {
+            digits[n++] = char('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        while (n > 0)
+            put(digits[--n]);
+    }
+
+    void putInt(int32_t value) {
+        if (value < 0)
+            put('-');
+        putUnsigned(value < 0 ? 0u - uint32_t(value) : uint32_t(value));
+    }
+
+    void putHex(uint32_t value) {
+        put("0x");
+        int shift = 28;
+        while (shift > 0 && ((value >> shift) & 0xF) == 0)
+            shift -= 4;
+        for (; shift >= 0; shift -= 4)
+            put("0123456789abcdef"[(value >> shift) & 0xF]);
+    }
+
+    void putBinary(uint8_t value) {
+        put("0b");
+        for (int bit = 7; bit >= 0; bit--)
+            put((value >> bit) & 1 ? '1' : '0');
+    }
+
+    // Six significant digits, same notation as the %g conversion
+    void putFloat(float value) {
+        static constexpr int PRECISION = 6;
+        if (value != value) {
+            put("nan");
+            return;
+        }
+        if (std::signbit(value)) { // -0 too, as %g
+            put('-');
+            value = -value;
+        }
+        if (value > 3.4028235e38f) {
+            put("inf");
+            return;
+        }
+        if (value == 0.0f) {
+            put('0');
+            return;
+        }
+
+        // Scale to PRECISION digits with a single multiplication to keep the rounding error low
+        int exponent = 0;
+        if (value < 1e-30f) { // Out of the pow10() range once scaled
+            value *= 1e30f;
+            exponent = -30;
+        }
+        int offset = exponent;
+        while (exponent - offset < 38 && value >= pow10(exponent - offset + 1))
+            exponent++;
+        while (value < pow10(exponent - offset))
+            exponent--;
+        int scale = PRECISION - 1 - (exponent - offset);
+        float scaled = scale >= 0 ? value * pow10(scale) : value / pow10(-scale);
+        uint32_t digits = uint32_t(scaled + 0.5f);
+        if (digits >= 1000000u) {
+            digits /= 10;
+            exponent++;
+        }
+
+        char str[PRECISION];
+        for (int i = PRECISION - 1; i >= 0; i--) {
+            str[i] = char('0' + digits % 10);
+            digits /= 10;
+        }
+        int last = PRECISION - 1; // Last digit without trailing zeros
+        while (last > 0 && str[last] == '0')
+            last--;
+
+        if (exponent < -4 || exponent >= PRECISION) {
+            put(str[0]);
+            if (last > 0)
+                put('.');
+            for (int i = 1; i <= last; i++)
+                put(str[i]);
+            put(exponent < 0 ? "e-" : "e+");
+            int absExponent = exponent < 0 ? -exponent : exponent;
+            if (absExponent < 10)
+                put('0');
+            putUnsigned(uint32_t(absExponent));
+        } else if (exponent >= 0) {
+            for (int i = 0; i <= std::max(last, exponent); i++) {
+                if (i == exponent + 1)
+                    put('.');
+                put(str[i]);
+            }
+        } else {
+            put("0.");
+            for (int i = exponent + 1; i < 0; i++)
+                put('0');
+            for (int i = 0; i <= last; i++)
+                put(str[i]);
+        }
+    }
+
+    void putArg(const Arg& arg) {
+        switch (arg.type) {
+            case Arg::INT:
+                putInt(arg.i);
+                break;
+            case Arg::UINT:
+                putUnsigned(arg.u);
+                break;
+            case Arg::FLOAT:
+                putFloat(arg.f);
+                break;
+            case Arg::CHAR:
+                put(arg.c);
+                break;
+            case Arg::STRING:
+                put(arg.s);
+                break;
+            case Arg::POINTER:
+                putHex(uint32_t(uintptr_t(arg.p)));
+                break;
+            case Arg::CUSTOM:
+                _pos += std::min(arg.format(_buffer + _pos, _size - _pos, arg.p), _size - _pos);
+                break;
+        }
+    }
+
+    static uint32_t toInteger(const Arg& arg) {
+        switch (arg.type) {
+            case Arg::FLOAT:
+                return uint32_t(int32_t(arg.f));
+            case Arg::CHAR:
+                return uint8_t(arg.c);
+            case Arg::STRING:
+            case Arg::POINTER:
+            case Arg::CUSTOM:
+                return uint32_t(uintptr_t(arg.p));
+            default:
+                return arg.u;
+        }
+    }
+
+  private:
+    static float pow10(int exponent) {
+        static constexpr float POW10[] = {1e0f,  1e1f,  1e2f,  1e3f,  1e4f,  1e5f,  1e6f,  1e7f,  1e8f,  1e9f,
+                                          1e10f, 1e11f, 1e12f, 1e13f, 1e14f, 1e15f, 1e16f, 1e17f, 1e18f, 1e19f,
+                                          1e20f, 1e21f, 1e22f, 1e23f, 1e24f, 1e25f, 1e26f, 1e27f, 1e28f, 1e29f,
+                                          1e30f, 1e31f, 1e32f, 1e33f, 1e34f, 1e35f, 1e36f, 1e37f, 1e38f};
+        if (exponent < 0)
+            return 1.0f / POW10[std::min(-exponent, 38)];
+        return POW10[std::min(exponent, 38)];
+    }
+
+    char* _buffer;
+    size_t _size;
+    size_t _pos;
+};
+
+void Log::format(const char* tag, const char* textColor, const char* text, const Arg* args, size_t numArgs) {
+    static constexpr struct {
+        char key;
+        const char* color;
+    } COLORS[] = {{'w', COLOR_WHITE}, {'r', COLOR_RED},     {'g', COLOR_GREEN}, {'b', COLOR_BLUE},
+                  {'y', COLOR_YELLOW}, {'m', COLOR_MAGENTA}, {'c', COLOR_CYAN},  {'k', COLOR_BLACK}};
+    static constexpr char END[] = "\n\r";
+
+    // Print [tag] text, the line end is always kept
+    char record[RECORD_SIZE];
+    Writer writer(record, RECORD_SIZE - (sizeof(END) - 1));
+    writer.put('[');
+    writer.put(tag);
+    writer.put("] ");
+
+    for (const char* c = text; *c; c++) {
+        if (c[0] == '[') {
+            // Color codes: [] [x] [*x]
+            if (c[1] == ']') {
+                writer.put(textColor);
+                c++;
+                continue;
+            }
+            bool bold = c[1] == '*';
+            const char* key = c + (bold ? 2 : 1);
+            const char* color = nullptr;
+            for (const auto& entry : COLORS)
+                if (entry.key == key[0])
+                    color = entry.color;
+            if (color && key[1] == ']') {
+                writer.put(COLOR_RESET);
+                if (bold)
+                    writer.put(COLOR_BOLD);
+                writer.put(color);
+                c = key + 1;
+                continue;
+            }
+        } else if (c[0] == '$') {
+            // Argument substitution: $N $xN $bN
+            char mode = (c[1] == 'x' || c[1] == 'b') ? c[1] : '\0';
+            const char* digit = c + (mode ? 2 : 1);
+            if (*digit >= '0' && *digit <= '9') {
+                size_t idx = size_t(*digit - '0');
+                if (idx < numArgs) {
+                    if (mode == 'x')
+                        writer.putHex(Writer::toInteger(args[idx]));
+                    else if (mode == 'b')
+                        writer.putBinary(uint8_t(Writer::toInteger(args[idx])));
+                    else
+                        writer.putArg(args[idx]);
+                }
+                c = digit;
+                continue;
+            }
+        }
+        writer.put(*c);
+    }
+
+    size_t size = writer.size();
+    std::memcpy(record + size, END, sizeof(END) - 1);
+    push(record, size + sizeof(END) - 1);
+}
+
+void Log::push(const char* record, size_t size) {
+    // Nothing drains the ring before the scheduler starts, and blocking is harmless there
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        transmit(record, size);
+        return;
+    }
+
+    // Reserve the words, never waits for the other callers
+    uint32_t words = 1 + (size + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    do {
+        if (head + words - _tail.load(std::memory_order_acquire) > RING_WORDS) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    } while (!_head.compare_exchange_weak(head, head + words, std::memory_order_relaxed));
+
+    // Text first, the length word publishes the record
+    for (uint32_t i = 1; i < words; i++) {
+        size_t offset = (i - 1) * sizeof(uint32_t);
+        uint32_t word = 0;
+        std::memcpy(&word, record + offset, std::min(sizeof(uint32_t), size - offset));
+        _ring[(head + i) % RING_WORDS].store(word, std::memory_order_relaxed);
+    }
+    _ring[head % RING_WORDS].store(size, std::memory_order_release);
+}
+
+size_t Log::pop(char* record) {
+    // Free words are kept at zero, so a zero length is either the end of the ring or a record not written yet
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    uint32_t size = _ring[tail % RING_WORDS].load(std::memory_order_acquire);
+    if (size == 0)
+        return 0;
+
+    uint32_t words = 1 + (size + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+    for (uint32_t i = 1; i < words; i++) {
+        size_t offset = (i - 1) * sizeof(uint32_t);
+        uint32_t word = _ring[(tail + i) % RING_WORDS].load(std::memory_order_relaxed);
+        std::memcpy(record + offset, &word, std::min(sizeof(uint32_t), size - offset));
+        _ring[(tail + i) % RING_WORDS].store(0, std::memory_order_relaxed);
+    }
+    _ring[tail % RING_WORDS].store(0, std::memory_order_relaxed);
+    _tail.store(tail + words, std::memory_order_release);
+    return size;
+}
+
+void Log::flush() {
+    static uint32_t reported = 0;
+    char record[RECORD_SIZE];
+    size_t size;
+    while ((size = pop(record)) > 0)
+        transmit(record, size);
+
+    // Reported on the next flush, once there is room in the ring
+    uint32_t dropped = _dropped.load(std::memory_order_relaxed);
+    if (dropped != reported) {
+        LOG_WARNING("Log", "$0 records dropped", dropped - reported);
+        reported = dropped;
+    }
+}
+
+uint32_t Log::getDropped() { return _dropped.load(std::memory_order_relaxed); }
+
+void Log::transmit(const char* data, size_t size) {
 #ifdef ENABLE_UART_LOG
     // Send log through UART
-    if (Uart::isInitialized() && !str.empty())
-        Uart::transmit((uint8_t*)str.data(), str.size());
+    if (Uart::isInitialized() && size > 0)
+        Uart::transmit((uint8_t*)data, size);
 #endif
 
 #ifdef ENABLE_ITM_LOG
     // Send log through ITM
-    for (size_t i = 0; i < str.size(); i++)
-        ITM_SendChar(str[i]);
+    for (size_t i = 0; i < size; i++)
+        ITM_SendChar(data[i]);
 #endif
 }
@@ -6,7 +6,16 @@
 //--------------------------------------------------
 #ifndef BLDC_UTILS_LOG_H
 #define BLDC_UTILS_LOG_H
-#include <string>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// Records below this level are compiled out (can be set by the build)
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_VERBOSE
+#endif
 
 //---------------------------------//
 //------ Terminal Color Code ------//
@@ -63,16 +72,29 @@
 // Argument substitution: $0 -> first argument
 //						  $1 -> second argument
 //						  ...
+//                        $x0 -> first argument in hexadecimal
+//                        $b0 -> first argument in binary (8 bits)
+//
+// Arguments: integers (up to 32 bits), floating point, char, strings (const char* or with c_str()), pointers, enums
+//            and custom types with an overload found by argument dependent lookup:
+//                size_t logFormat(char* buffer, size_t size, const T& value); // Returns the number of chars written
+//
+// Records are formatted on the stack of the caller (no heap allocation) and queued in a lock-free ring, which is
+// transmitted by the log task. A full ring drops the record instead of blocking the caller, so it is safe to log from
+// any task or interrupt. Before the scheduler starts, records are transmitted directly
+//
+// The LOG_* macros check the text at compile time: every $N must have an argument, and [x] or [*x] must be one of the
+// colors above. The text must be a string literal, Log::info() and the other functions take any text unchecked
 
 //---------------------------------//
 //------------ Examples -----------//
 //---------------------------------//
-// Log::error("Window", "$0 surface could not be created. [w]Error Code: $1", "Main", 123);
+// LOG_ERROR("Window", "$0 surface could not be created. [w]Error Code: $1", "Main", 123);
 //
 // Output:
 // /*boldred*/[Window] /*red*/Main surface could not be created. /*white*/Error Code: 123
 //----------------
-// Log::info("Cool", "[r]R[*g]a[y]i[*c]n[m]b[*w]o[c]w []$0", "output");
+// LOG_INFO("Cool", "[r]R[*g]a[y]i[*c]n[m]b[*w]o[c]w []$0", "output");
 //
 // Output:
 // [Cool] Rainbow output // But with colors
@@ -91,28 +113,92 @@ class Log final {
         LOG_LEVEL_ERROR,
         LOG_LEVEL_NONE,
     };
-    const static LogLevel logLevel = LOG_LEVEL_VERBOSE;
+    static constexpr LogLevel logLevel = LOG_LEVEL;
+
+    static constexpr size_t RECORD_SIZE = 128; ///< Maximum record length, longer records are truncated
+    static constexpr size_t RING_SIZE = 2048;  ///< Queued records in bytes
 
     template <class... Args>
-    static void verbose(std::string tag, std::string text, Args&&... args);
+    static void verbose(const char* tag, const char* text, const Args&... args);
     template <class... Args>
-    static void debug(std::string tag, std::string text, Args&&... args);
+    static void debug(const char* tag, const char* text, const Args&... args);
     template <class... Args>
-    static void success(std::string tag, std::string text, Args&&... args);
+    static void success(const char* tag, const char* text, const Args&... args);
     template <class... Args>
-    static void info(std::string tag, std::string text, Args&&... args);
+    static void info(const char* tag, const char* text, const Args&... args);
     template <class... Args>
-    static void warning(std::string tag, std::string text, Args&&... args);
+    static void warning(const char* tag, const char* text, const Args&... args);
     template <class... Args>
-    static void error(std::string tag, std::string text, Args&&... args);
+    static void error(const char* tag, const char* text, const Args&... args);
+
+    /**
+     * @brief Transmit the queued records
+     *
+     * Called periodically by the log task, and by the fault handlers before halting. Only one caller at a time, records
+     * still being written by preempted callers are transmitted by the next call
+     */
+    static void flush();
+
+    static uint32_t getDropped(); ///< Records dropped because the ring was full
 
   private:
+    class Writer;
+
+    // Type erased argument, built on the caller stack
+    struct Arg {
+        enum Type : uint8_t { INT, UINT, FLOAT, CHAR, STRING, POINTER, CUSTOM };
+        using Format = size_t (*)(char* buffer, size_t size, const void* value);
+
+        template <typename T>
+        Arg(const T& value);
+
+        Type type;
+        union {
+            int32_t i;
+            uint32_t u;
+            float f;
+            char c;
+            const char* s;
+            const void* p;
+        };
+        Format format; // CUSTOM only
+    };
+
     //---------- Main log function ----------//
     template <class... Args>
-    static void log(const char* tagColor, std::string tag, const char* textColor, std::string text, Args&&... args);
+    static void log(const char* tag, const char* textColor, const char* text, const Args&... args);
+    static void format(const char* tag, const char* textColor, const char* text, const Arg* args, size_t numArgs);
 
-    static void transmit(const std::string& str);
+    static void push(const char* record, size_t size);
+    static size_t pop(char* record);
+    static void transmit(const char* data, size_t size);
+
+    static constexpr size_t RING_WORDS = RING_SIZE / sizeof(uint32_t);
+    static_assert((RING_WORDS & (RING_WORDS - 1)) == 0 && RECORD_SIZE + sizeof(uint32_t) <= RING_SIZE, "Invalid ring size");
+    static std::atomic<uint32_t> _ring[RING_WORDS]; // Records: length word (0 until written) followed by the text
+    static std::atomic<uint32_t> _head;             // Next word to reserve (free running)
+    static std::atomic<uint32_t> _tail;             // Next word to transmit (free running)
+    static std::atomic<uint32_t> _dropped;
 };
 
 #include <utils/log.inl>
+
+//---------------------------------//
+//--------- Checked macros --------//
+//---------------------------------//
+#define LOG_VERBOSE(tag, text, ...) LOG_CHECKED(verbose, tag, text, ##__VA_ARGS__)
+#define LOG_DEBUG(tag, text, ...) LOG_CHECKED(debug, tag, text, ##__VA_ARGS__)
+#define LOG_SUCCESS(tag, text, ...) LOG_CHECKED(success, tag, text, ##__VA_ARGS__)
+#define LOG_INFO(tag, text, ...) LOG_CHECKED(info, tag, text, ##__VA_ARGS__)
+#define LOG_WARNING(tag, text, ...) LOG_CHECKED(warning, tag, text, ##__VA_ARGS__)
+#define LOG_ERROR(tag, text, ...) LOG_CHECKED(error, tag, text, ##__VA_ARGS__)
+
+// The arguments are only counted in an unevaluated operand, they are evaluated once by the call
+#define LOG_CHECKED(level, tag, text, ...)                                                         \
+    do {                                                                                           \
+        static_assert(LogDetail::validFormat(text, sizeof(LogDetail::countArgs(__VA_ARGS__)) - 1), \
+                      "Log text has $N without argument or unknown color");                        \
+        Log::level(tag, text, ##__VA_ARGS__);                                                      \
+    } while (0)
+
 #endif // BLDC_UTILS_LOG_H
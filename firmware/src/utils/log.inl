@@ -4,185 +4,136 @@
 // Date: 2023-09-21
 // By Breno Cunha Queiroz
 //--------------------------------------------------
-#include <array>
-#include <bitset>
-#include <climits>
-#include <cstddef>
-#include <map>
-#include <set>
-#include <sstream>
-#include <vector>
 
 template <class... Args>
-void Log::verbose(std::string tag, std::string text, Args&&... args) {
-    if (logLevel <= LOG_LEVEL_VERBOSE)
-        log(COLOR_BOLD_WHITE, tag, COLOR_RESET_WHITE, text, args...);
+void Log::verbose(const char* tag, const char* text, const Args&... args) {
+    if constexpr (logLevel <= LOG_LEVEL_VERBOSE)
+        log(tag, COLOR_RESET_WHITE, text, args...);
 }
 
 template <class... Args>
-void Log::debug(std::string tag, std::string text, Args&&... args) {
-    if (logLevel <= LOG_LEVEL_DEBUG)
-        log(COLOR_BOLD_BLUE, tag, COLOR_RESET_BLUE, text, args...);
+void Log::debug(const char* tag, const char* text, const Args&... args) {
+    if constexpr (logLevel <= LOG_LEVEL_DEBUG)
+        log(tag, COLOR_RESET_BLUE, text, args...);
 }
 
 template <class... Args>
-void Log::success(std::string tag, std::string text, Args&&... args) {
-    if (logLevel <= LOG_LEVEL_SUCCESS)
-        log(COLOR_BOLD_GREEN, tag, COLOR_RESET_GREEN, text, args...);
+void Log::success(const char* tag, const char* text, const Args&... args) {
+    if constexpr (logLevel <= LOG_LEVEL_SUCCESS)
+        log(tag, COLOR_RESET_GREEN, text, args...);
 }
 
 template <class... Args>
-void Log::info(std::string tag, std::string text, Args&&... args) {
-    if (logLevel <= LOG_LEVEL_INFO)
-        log(COLOR_BOLD_CYAN, tag, COLOR_RESET_CYAN, text, args...);
+void Log::info(const char* tag, const char* text, const Args&... args) {
+    if constexpr (logLevel <= LOG_LEVEL_INFO)
+        log(tag, COLOR_RESET_CYAN, text, args...);
 }
 
 template <class... Args>
-void Log::warning(std::string tag, std::string text, Args&&... args) {
-    if (logLevel <= LOG_LEVEL_WARNING)
-        log(COLOR_BOLD_YELLOW, tag, COLOR_RESET_YELLOW, text, args...);
+void Log::warning(const char* tag, const char* text, const Args&... args) {
+    if constexpr (logLevel <= LOG_LEVEL_WARNING)
+        log(tag, COLOR_RESET_YELLOW, text, args...);
 }
 
 template <class... Args>
-void Log::error(std::string tag, std::string text, Args&&... args) {
-    if (logLevel <= LOG_LEVEL_ERROR)
-        log(COLOR_BOLD_RED, tag, COLOR_RESET_RED, text, args...);
+void Log::error(const char* tag, const char* text, const Args&... args) {
+    if constexpr (logLevel <= LOG_LEVEL_ERROR)
+        log(tag, COLOR_RESET_RED, text, args...);
 }
 
-// std::vector overload
-template <typename Tstream, typename T>
-std::ostream& operator<<(Tstream& s, const std::vector<T>& vec) {
-    s << "{";
-    for (typename std::vector<T>::const_iterator it = vec.begin(); it != vec.end(); it++) {
-        if (it != vec.begin())
-            s << ", ";
-        s << *it;
-    }
-    s << "}";
-    return s;
-}
+namespace LogDetail {
 
-// std::array overload
-template <typename Tstream, typename T, size_t N>
-std::ostream& operator<<(Tstream& s, const std::array<T, N>& vec) {
-    s << "{";
-    for (typename std::array<T, N>::const_iterator it = vec.begin(); it != vec.end(); it++) {
-        if (it != vec.begin())
-            s << ", ";
-        s << *it;
-    }
-    s << "}";
-    return s;
-}
+template <typename T, typename = void>
+struct HasFormat : std::false_type {};
+template <typename T>
+struct HasFormat<T, std::void_t<decltype(logFormat(std::declval<char*>(), size_t(0), std::declval<const T&>()))>> : std::true_type {};
 
-// std::set overload
-template <typename Tstream, typename T>
-std::ostream& operator<<(Tstream& s, const std::set<T>& set) {
-    s << "{";
-    for (typename std::set<T>::const_iterator it = set.begin(); it != set.end(); it++) {
-        if (it != set.begin())
-            s << ", ";
-        s << *it;
-    }
-    s << "}";
-    return s;
+template <typename T, typename = void>
+struct HasCStr : std::false_type {};
+template <typename T>
+struct HasCStr<T, std::void_t<decltype(std::declval<const T&>().c_str())>> : std::true_type {};
+
+template <typename T>
+constexpr bool unsupported = false;
+
+constexpr char COLOR_KEYS[] = "wrgbymck"; // Colors of Log::format()
+
+constexpr bool isColor(char key) {
+    for (const char* k = COLOR_KEYS; *k; k++)
+        if (*k == key)
+            return true;
+    return false;
 }
 
-// std::map overload
-template <typename Tstream, typename K, typename V>
-std::ostream& operator<<(Tstream& s, const std::map<K, V>& map) {
-    s << "{";
-    for (typename std::map<K, V>::const_iterator it = map.begin(); it != map.end(); it++) {
-        if (it != map.begin())
-            s << ", ";
-        s << "{" << it->first << ", " << it->second << "}";
+// Same parsing as Log::format(), false if a $N has no argument or a color code does not exist
+constexpr bool validFormat(const char* text, size_t numArgs) {
+    for (const char* c = text; *c; c++) {
+        if (c[0] == '$') {
+            const char* digit = c + ((c[1] == 'x' || c[1] == 'b') ? 2 : 1);
+            if (*digit >= '0' && *digit <= '9' && size_t(*digit - '0') >= numArgs)
+                return false;
+        } else if (c[0] == '[') {
+            // Brackets around other text are printed, [* always starts a color
+            const char* key = c + (c[1] == '*' ? 2 : 1);
+            bool color = isColor(key[0]) && key[1] == ']';
+            if (!color && (c[1] == '*' || (key[0] >= 'a' && key[0] <= 'z' && key[1] == ']')))
+                return false;
+        }
     }
-    s << "}";
-    return s;
+    return true;
 }
 
+// Never defined, sizeof(countArgs(args...)) - 1 is the number of arguments
+template <class... Args>
+char (&countArgs(const Args&...))[sizeof...(Args) + 1];
+
+static_assert(validFormat("$0 [w]$x1 [*r]$b1 []a[0]", 2) && !validFormat("$2", 2) && !validFormat("[q]", 0) && !validFormat("[*0]", 0),
+              "Log format check");
+
+} // namespace LogDetail
+
 template <typename T>
-std::string getArgStr(const T& t) {
-    std::stringstream ss;
-    ss << t;
-    return ss.str();
+Log::Arg::Arg(const T& value) : format(nullptr) {
+    if constexpr (LogDetail::HasFormat<T>::value) {
+        type = CUSTOM;
+        p = &value;
+        format = [](char* buffer, size_t size, const void* v) -> size_t { return logFormat(buffer, size, *static_cast<const T*>(v)); };
+    } else if constexpr (std::is_same_v<T, char>) {
+        type = CHAR;
+        c = value;
+    } else if constexpr (std::is_same_v<T, bool> || (std::is_integral_v<T> && std::is_unsigned_v<T>)) {
+        static_assert(sizeof(T) <= sizeof(uintptr_t), "Integers wider than a pointer are not supported");
+        type = UINT;
+        u = uint32_t(value);
+    } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+        static_assert(sizeof(T) <= sizeof(uintptr_t), "Integers wider than a pointer are not supported");
+        type = INT;
+        i = int32_t(value);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        type = FLOAT;
+        f = float(value);
+    } else if constexpr (std::is_convertible_v<const T&, const char*>) {
+        type = STRING;
+        s = value;
+    } else if constexpr (LogDetail::HasCStr<T>::value) {
+        type = STRING;
+        s = value.c_str(); // Argument outlives the log call
+    } else if constexpr (std::is_pointer_v<T>) {
+        type = POINTER;
+        p = value;
+    } else if constexpr (std::is_convertible_v<const T&, uint32_t>) {
+        type = UINT;
+        u = uint32_t(value); // Register structs with an integer conversion
+    } else
+        static_assert(LogDetail::unsupported<T>, "Unsupported log argument, add a logFormat() overload");
 }
 
 template <class... Args>
-void Log::log(const char* tagColor, std::string tag, const char* textColor, std::string text, Args&&... args) {
-    // Replace arguments
-    std::vector<std::string> argsStr;
-    (argsStr.push_back(getArgStr(args)), ...);
-
-    std::stringstream finalText;
-    for (size_t i = 0; i < text.size(); i++) {
-        if (text[i] == '[') {
-            i++; // Skip [
-            if (text[i] == '*') {
-                finalText << COLOR_BOLD;
-                i++; // Skip *
-            } else if (text[i] == ']') {
-                finalText << textColor; // Return color to default if found []
-                continue;
-            }
-
-            switch (text[i]) {
-                case 'w':
-                    finalText << COLOR_RESET << COLOR_WHITE;
-                    break;
-                case 'r':
-                    finalText << COLOR_RESET << COLOR_RED;
-                    break;
-                case 'g':
-                    finalText << COLOR_RESET << COLOR_GREEN;
-                    break;
-                case 'b':
-                    finalText << COLOR_RESET << COLOR_BLUE;
-                    break;
-                case 'y':
-                    finalText << COLOR_RESET << COLOR_YELLOW;
-                    break;
-                case 'm':
-                    finalText << COLOR_RESET << COLOR_MAGENTA;
-                    break;
-                case 'c':
-                    finalText << COLOR_RESET << COLOR_CYAN;
-                    break;
-                case 'k':
-                    finalText << COLOR_RESET << COLOR_BLACK;
-                    break;
-                default:
-                    finalText << '[';
-                    i -= 2;
-            }
-            i++; // Skip color and ]
-        } else if (text[i] == '$') {
-            if (text[i + 1] == 'x') {
-                // Hex print
-                i++;
-                finalText << std::hex << "0x";
-                size_t idx = static_cast<size_t>(text[++i] - '0');
-                if (idx < sizeof...(Args))
-                    finalText << std::stoi(argsStr[idx]);
-                finalText << std::dec;
-            } else if (text[i + 1] == 'b') {
-                // Binary print
-                i++;
-                finalText << "0b";
-                size_t idx = static_cast<size_t>(text[++i] - '0');
-                if (idx < sizeof...(Args))
-                    finalText << std::bitset<CHAR_BIT>(std::stoi(argsStr[idx]));
-            } else {
-                // Stream print
-                size_t idx = static_cast<size_t>(text[++i] - '0');
-                if (idx < sizeof...(Args))
-                    finalText << argsStr[idx];
-            }
-        } else
-            finalText << text[i];
+void Log::log(const char* tag, const char* textColor, const char* text, const Args&... args) {
+    if constexpr (sizeof...(Args) == 0)
+        format(tag, textColor, text, nullptr, 0);
+    else {
+        const Arg argList[] = {Arg(args)...};
+        format(tag, textColor, text, argList, sizeof...(Args));
     }
-
-    // Print [tag] text
-    // transmit(std::string(tagColor) + "[" + tag + "] " + textColor + finalText.str() + COLOR_RESET + "\n");
-    transmit(std::string("[") + tag + "] " + finalText.str() + "\n\r");
 }
@@ -0,0 +1,147 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// profiler.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <common/attaConnector.h>
+#include <common/attaConnectorCmds.h>
+#include <cstring>
+#include <system/hal.h>
+#include <utils/profiler.h>
+
+namespace Profiler {
+
+constexpr const char* PROBE_NAMES[NUM_PROBES] = {"Loop", "Motor", "SPI"};
+
+// Statistics since the last report
+struct Stats {
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t sumCycles;
+    uint32_t periodCount;
+    uint32_t minPeriod;
+    uint32_t maxPeriod;
+    uint64_t sumPeriod;
+    uint32_t maxJitter;
+    std::array<uint16_t, ProfilerStats::NUM_BUCKETS> cycles;
+    std::array<uint16_t, ProfilerStats::NUM_BUCKETS> jitter;
+};
+
+struct ProbeState {
+    volatile uint32_t sequence; ///< Odd while the statistics are updated
+    volatile bool reset;        ///< Restart the statistics with the next measurement
+    uint32_t start;             ///< Start of the current measurement
+    uint32_t lastStart;         ///< Start of the previous measurement
+    uint32_t lastPeriod;        ///< Previous period (0 if not measured yet)
+    bool started;               ///< lastStart is valid
+    Stats stats;
+};
+std::array<ProbeState, NUM_PROBES> _probes{};
+
+void record(ProbeState& probe, uint32_t start, uint32_t end);
+void add(std::array<uint16_t, ProfilerStats::NUM_BUCKETS>& histogram, uint32_t cycles);
+bool read(ProbeState& probe, Stats& stats);
+
+} // namespace Profiler
+
+void Profiler::begin(Probe probe) { _probes[probe].start = DWT->CYCCNT; }
+
+void Profiler::end(Probe probe) {
+    uint32_t now = DWT->CYCCNT;
+    record(_probes[probe], _probes[probe].start, now);
+}
+
+bool Profiler::transmit() {
+    bool success = true;
+    for (size_t i = 0; i < NUM_PROBES; i++) {
+        Stats stats;
+        if (!read(_probes[i], stats) || stats.count == 0)
+            continue;
+        _probes[i].reset = true;
+
+        ProfilerStats cmd{};
+        std::strncpy(cmd.name.data(), PROBE_NAMES[i], cmd.name.size() - 1);
+        cmd.clock = SystemCoreClock;
+        cmd.count = stats.count;
+        cmd.minCycles = stats.minCycles;
+        cmd.maxCycles = stats.maxCycles;
+        cmd.meanCycles = stats.sumCycles / stats.count;
+        if (stats.periodCount > 0) {
+            cmd.minPeriod = stats.minPeriod;
+            cmd.maxPeriod = stats.maxPeriod;
+            cmd.meanPeriod = stats.sumPeriod / stats.periodCount;
+        }
+        cmd.maxJitter = stats.maxJitter;
+        cmd.cycles = stats.cycles;
+        cmd.jitter = stats.jitter;
+        success &= AttaConnector::transmit(cmd);
+    }
+    return success;
+}
+
+void Profiler::record(ProbeState& probe, uint32_t start, uint32_t end) {
+    // The reader runs in a lower priority context, it only has to detect the update (single core)
+    probe.sequence = probe.sequence + 1;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+
+    Stats& stats = probe.stats;
+    if (probe.reset) {
+        stats = {};
+        probe.reset = false;
+    }
+
+    uint32_t cycles = end - start;
+    stats.minCycles = stats.count == 0 ? cycles : std::min(stats.minCycles, cycles);
+    stats.maxCycles = std::max(stats.maxCycles, cycles);
+    stats.sumCycles += cycles;
+    stats.count++;
+    add(stats.cycles, cycles);
+
+    if (probe.started) {
+        uint32_t period = start - probe.lastStart;
+        stats.minPeriod = stats.periodCount == 0 ? period : std::min(stats.minPeriod, period);
+        stats.maxPeriod = std::max(stats.maxPeriod, period);
+        stats.sumPeriod += period;
+        stats.periodCount++;
+        if (probe.lastPeriod != 0) {
+            uint32_t jitter = period > probe.lastPeriod ? period - probe.lastPeriod : probe.lastPeriod - period;
+            stats.maxJitter = std::max(stats.maxJitter, jitter);
+            add(stats.jitter, jitter);
+        }
+        probe.lastPeriod = period;
+    }
+    probe.lastStart = start;
+    probe.started = true;
+
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    probe.sequence = probe.sequence + 1;
+}
+
+void Profiler::add(std::array<uint16_t, ProfilerStats::NUM_BUCKETS>& histogram, uint32_t cycles) {
+    size_t bucket = cycles == 0 ? 0 : std::min<size_t>(32 - __builtin_clz(cycles), histogram.size() - 1);
+    if (histogram[bucket] != UINT16_MAX)
+        histogram[bucket]++;
+}
+
+bool Profiler::read(ProbeState& probe, Stats& stats) {
+    // Retry while an interrupt updated the probe during the copy
+    for (size_t retry = 0; retry < 8; retry++) {
+        uint32_t sequence = probe.sequence;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        if (sequence & 1)
+            continue;
+        stats = probe.stats;
+        bool reset = probe.reset;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        if (sequence == probe.sequence) {
+            if (reset)
+                stats.count = 0; // Already reported, no measurement since then
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,82 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// profiler.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_UTILS_PROFILER_H
+#define BLDC_UTILS_PROFILER_H
+#include <cstdint>
+
+#define ENABLE_PROFILER
+
+//---------------------------------//
+//---------- Description ----------//
+//---------------------------------//
+// Cycle count statistics of named code sections, measured with the DWT cycle counter
+//
+// Each probe keeps min, max, mean and a log2 histogram of the measured cycles, and the period between measurement
+// starts with a histogram of its jitter (difference between consecutive periods). The statistics are sent as
+// ProfilerStats commands by transmit() and restarted for the next report.
+//
+// A probe must be measured from a single context (one task or one interrupt) and not nested with itself. Recording
+// never waits: the reader retries while an interrupt is updating the probe
+
+//---------------------------------//
+//------------ Examples -----------//
+//---------------------------------//
+// void TIM6_DAC_IRQHandler() {
+//     PROFILE_SCOPE(Profiler::PROBE_LOOP);
+//     ...
+// }
+//
+// PROFILE_BEGIN(Profiler::PROBE_MOTOR);
+// ...
+// PROFILE_END(Profiler::PROBE_MOTOR);
+
+namespace Profiler {
+
+enum Probe : uint8_t {
+    PROBE_LOOP = 0, // Control loop tick interrupt (TIM6)
+    PROBE_MOTOR,    // Modulation and PWM commit (Motor::set)
+    PROBE_SPI,      // SPI transfer completion interrupt
+    NUM_PROBES,
+};
+
+void begin(Probe probe);
+void end(Probe probe);
+
+/**
+ * @brief Send the statistics of the measured probes
+ *
+ * Called periodically by a task, the statistics restart with the next measurement of each probe
+ *
+ * @return True if all the probe commands were queued
+ */
+bool transmit();
+
+// Measurement from construction to the end of the scope
+class Scope {
+  public:
+    explicit Scope(Probe probe) : _probe(probe) { begin(probe); }
+    ~Scope() { end(_probe); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    Probe _probe;
+};
+
+} // namespace Profiler
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_BEGIN(probe) Profiler::begin(probe)
+#define PROFILE_END(probe) Profiler::end(probe)
+#define PROFILE_SCOPE(probe) Profiler::Scope profileScope(probe)
+#else
+#define PROFILE_BEGIN(probe) ((void)0)
+#define PROFILE_END(probe) ((void)0)
+#define PROFILE_SCOPE(probe) ((void)0)
+#endif
+
+#endif // BLDC_UTILS_PROFILER_H
@@ -0,0 +1,134 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// trace.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_UTILS_TRACE_H
+#define BLDC_UTILS_TRACE_H
+#include <cstdint>
+#include <system/hal.h>
+
+#define ENABLE_TRACE
+
+//---------------------------------//
+//---------- Description ----------//
+//---------------------------------//
+// Binary event tracing over the ITM stimulus ports (SWO), decoded on the host by tools/swoTrace.py
+//
+// Every event is a single 32 bit stimulus write: event id (bits 31-24) and DWT cycle counter (bits 23-0)
+//     Port 0 -> log text (Log)
+//     Port 1 -> span begin
+//     Port 2 -> span end
+//     Port 3 -> value sample, followed by the value on port 4
+//
+// The ports are enabled by the debugger (./bldc.sh --record), disabled ports cost two register reads. Writes to a full
+// ITM FIFO are dropped by the hardware and reported with an overflow packet, the caller never waits.
+// The 24 bit stamp wraps every 116 ms at 144 MHz. The decoder unwraps it as a signed delta, assuming events are closer
+// than 58 ms, so stamps written late by a preempted writer (stamp and write are not atomic) go back in time
+
+//---------------------------------//
+//------------ Examples -----------//
+//---------------------------------//
+// void SPI2_IRQHandler() {
+//     TRACE_SCOPE(Trace::ISR_SPI2);
+//     HAL_SPI_IRQHandler(...);
+// }
+//
+// TRACE_BEGIN(Trace::MOTOR_MODULATE);
+// ...
+// TRACE_END(Trace::MOTOR_MODULATE);
+//
+// TRACE_VALUE(Trace::SPI_LATENCY, latency);
+
+namespace Trace {
+
+enum Port : uint8_t {
+    PORT_BEGIN = 1,
+    PORT_END,
+    PORT_VALUE,
+    PORT_VALUE_DATA,
+};
+
+// Event ids, the decoder reads the names from this enum
+enum Id : uint8_t {
+    ISR_ADC = 0,
+    ISR_TIM1,
+    ISR_TIM2,
+    ISR_LOOP,
+    ISR_SPI2,
+    ISR_SPI3,
+    ISR_DMA1_STREAM0,
+    ISR_DMA1_STREAM3,
+    ISR_DMA1_STREAM4,
+    ISR_DMA1_STREAM5,
+    ISR_DMA1_STREAM7,
+    ISR_DMA2_STREAM0,
+    ISR_DMA2_STREAM1,
+    ISR_DMA2_STREAM6,
+    ISR_USART6,
+    ISR_USB,
+    ISR_EXTI4,
+    ISR_EXTI9_5,
+    MOTOR_MODULATE,
+    MOTOR_COMPENSATE,
+    MOTOR_COMMIT,
+    SPI1_TRANSFER, // Same order as Spi::Peripheral
+    SPI2_TRANSFER,
+    SPI3_TRANSFER,
+    SPI4_TRANSFER,
+    SPI_LATENCY,
+};
+
+inline bool isEnabled(Port port) { return (ITM->TCR & ITM_TCR_ITMENA_Msk) && (ITM->TER & (1UL << port)); }
+
+inline uint32_t stamp(Id id) { return (uint32_t(id) << 24) | (DWT->CYCCNT & 0x00FFFFFF); }
+
+inline void begin(Id id) {
+    if (isEnabled(PORT_BEGIN))
+        ITM->PORT[PORT_BEGIN].u32 = stamp(id);
+}
+
+inline void end(Id id) {
+    if (isEnabled(PORT_END))
+        ITM->PORT[PORT_END].u32 = stamp(id);
+}
+
+inline void value(Id id, int32_t value) {
+    if (!isEnabled(PORT_VALUE) || !isEnabled(PORT_VALUE_DATA))
+        return;
+    // Keep the sample and its value together when an interrupt also samples
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    ITM->PORT[PORT_VALUE].u32 = stamp(id);
+    ITM->PORT[PORT_VALUE_DATA].u32 = uint32_t(value);
+    __set_PRIMASK(primask);
+}
+
+// Span from construction to the end of the scope
+class Scope {
+  public:
+    explicit Scope(Id id) : _id(id) { begin(id); }
+    ~Scope() { end(_id); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    Id _id;
+};
+
+} // namespace Trace
+
+#ifdef ENABLE_TRACE
+#define TRACE_BEGIN(id) Trace::begin(id)
+#define TRACE_END(id) Trace::end(id)
+#define TRACE_SCOPE(id) Trace::Scope traceScope(id)
+#define TRACE_VALUE(id, sample) Trace::value(id, sample)
+#else
+#define TRACE_BEGIN(id) ((void)0)
+#define TRACE_END(id) ((void)0)
+#define TRACE_SCOPE(id) ((void)0)
+#define TRACE_VALUE(id, sample) ((void)0)
+#endif
+
+#endif // BLDC_UTILS_TRACE_H
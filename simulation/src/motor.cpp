@@ -14,9 +14,12 @@ Motor::Motor(float R, float L, float J, float F, float P, float l) : _R(R), _L(L
 void Motor::update(atta::vec3 v, float Tl, float dt) {
     _v = v;
     // Calculate voltage for floating phases
-    for (size_t i = 0; i < 3; i++)
-        if (_v[i] == -1.0f)
+    bool driven[3];
+    for (size_t i = 0; i < 3; i++) {
+        driven[i] = _v[i] != -1.0f;
+        if (!driven[i])
             _v[i] = _e[i] - _i[i] * _R;
+    }
     _Tl = Tl;
 
     for (int i = 0; i < SUBSTEPS; i++) {
@@ -35,7 +38,7 @@ void Motor::update(atta::vec3 v, float Tl, float dt) {
         dtheta = _w * _P / 2;
 
         // B
-        di += _v / _L;
+        di += (_v - deadTimeError(driven)) / _L;
         dw -= _Tl / _J;
 
         // Update state
@@ -53,6 +56,30 @@ void Motor::update(atta::vec3 v, float Tl, float dt) {
     //     LOG_DEBUG("Motor", "Phase $0: [w]$1", char('A' + i), _v[i] - _R * _i[i] - _e[i]);
 }
 
+void Motor::setDeadTime(float deadTime, float pwmPeriod, float supply) { _deadTimeVoltage = supply * deadTime / pwmPeriod; }
+
+void Motor::setVelocity(float w) { _w = w; }
+
+atta::vec3 Motor::deadTimeError(const bool* driven) const {
+    atta::vec3 err = {0.0f, 0.0f, 0.0f};
+    if (_deadTimeVoltage == 0.0f)
+        return err;
+    int numDriven = 0;
+    float mean = 0.0f;
+    for (size_t i = 0; i < 3; i++)
+        if (driven[i]) {
+            err[i] = _i[i] > 0.0f ? _deadTimeVoltage : (_i[i] < 0.0f ? -_deadTimeVoltage : 0.0f);
+            mean += err[i];
+            numDriven++;
+        }
+    // Star point takes the common mode of the driven phases
+    if (numDriven > 1)
+        for (size_t i = 0; i < 3; i++)
+            if (driven[i])
+                err[i] -= mean / numDriven;
+    return err;
+}
+
 float Motor::f(float theta, uint8_t phase) { return sin(theta - phase * (2 * M_PI / 3)); }
 
 atta::vec3 Motor::getVoltage() const { return _v; }
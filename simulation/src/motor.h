@@ -13,6 +13,13 @@ class Motor {
 
     void update(atta::vec3 v, float Tl, float dt);
 
+    // Inverter dead time model. While both switches are off, the phase voltage follows the current sign, so each driven
+    // phase loses sign(i) * supply * deadTime / pwmPeriod of its average voltage (common mode removed by the star point)
+    void setDeadTime(float deadTime, float pwmPeriod, float supply);
+
+    // Set the rotor velocity, a very large inertia then keeps the rotor at that speed (driven by an external motor)
+    void setVelocity(float w);
+
     atta::vec3 getVoltage() const;
     atta::vec3 getCurrent() const;
     float getPosition() const;
@@ -29,6 +36,9 @@ class Motor {
     // This function can be estimated by rotating the rotor at a constant speed and measuring the voltage in each phase.
     float f(float theta, uint8_t phase);
 
+    // Dead time voltage error of the driven phases
+    atta::vec3 deadTimeError(const bool* driven) const;
+
     // Parameters
     float _R; // Phase resistance
     float _L; // Phase inductance
@@ -37,6 +47,9 @@ class Motor {
     float _P; // Number of poles
     float _l; // Flux linkage
 
+    // Inverter
+    float _deadTimeVoltage = 0.0f; // Dead time voltage error (0 for an ideal inverter)
+
     // State
     atta::vec3 _i; // Phase current
     float _w;      // Angular velocity
@@ -10,6 +10,7 @@
 #include "implot.h"
 #include <atta/component/components/transform.h>
 #include <atta/component/interface.h>
+#include <chrono>
 
 namespace cmp = atta::component;
 
@@ -34,6 +35,23 @@ void ProjectScript::onStart() {
 
     _phyMotorData = {};
     _imuData = {};
+    _vibrationData = {};
+    _profilerData = {};
+    _healthData = {};
+    _sensorlessController = SensorlessController();
+    _fluxObserver = FluxObserver();
+    FluxObserver::Config observerConfig = _fluxObserver.getConfig();
+    observerConfig.resistance = R;
+    observerConfig.inductance = L;
+    observerConfig.fluxLinkage = l / (P / 2);
+    observerConfig.gain = 100.0f / (observerConfig.fluxLinkage * observerConfig.fluxLinkage);
+    observerConfig.pllBandwidth = 200.0f;
+    _fluxObserver.setConfig(observerConfig);
+    _sensorlessData = {};
+    _sensorlessRunning = false;
+    _deadTimeData = {};
+    _deadTimeData.deadTime = 1000.0f;
+    _deadTimeData.band = 0.01f;
 }
 
 void ProjectScript::onStop() {}
@@ -43,6 +61,9 @@ void ProjectScript::onUpdateBefore(float dt) {
     handleSerial();
     handleAttaConnector();
 
+    if (_sensorlessRunning)
+        simulateSensorless(dt);
+
     // Update controller
     // Controller::Control u;
     // u.position = NAN;
@@ -159,6 +180,232 @@ void ProjectScript::onUIRender() {
     }
     ImGui::End();
 
+    ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_Once);
+    ImGui::Begin("Sensorless");
+    {
+        static const char* stages[] = {"IDLE", "ALIGN", "RAMP", "RUN"};
+        ImGui::Checkbox("Run", &_sensorlessRunning);
+        ImGui::SameLine();
+        if (ImGui::Button("Clear"))
+            _sensorlessData = {};
+        ImGui::SameLine();
+        if (ImGui::Button("Speed sweep"))
+            simulateObserverSweep();
+        ImGui::Text("Stage: %s", stages[int(_sensorlessController.getStage())]);
+        ImGui::Text("Step period: %.3f ms", _sensorlessController.getStepPeriod() * 1000.0f);
+        ImGui::Text("Observer update: %.1f ns", _sensorlessData.observerTime);
+
+        if (ImPlot::BeginPlot("Velocity")) {
+            ImPlot::SetupAxes(NULL, NULL, ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::PlotLine("Estimated", _sensorlessData.velocity.data(), _sensorlessData.velocity.size());
+            ImPlot::PlotLine("Observer", _sensorlessData.observerVelocity.data(), _sensorlessData.observerVelocity.size());
+            ImPlot::PlotLine("Simulated", _sensorlessData.simVelocity.data(), _sensorlessData.simVelocity.size());
+            ImPlot::EndPlot();
+        }
+
+        if (ImPlot::BeginPlot("Observer Error")) {
+            ImPlot::SetupAxes(NULL, NULL, ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::PlotLine("Error (deg)", _sensorlessData.observerError.data(), _sensorlessData.observerError.size());
+            ImPlot::EndPlot();
+        }
+
+        if (ImPlot::BeginPlot("Commutation Error")) {
+            ImPlot::SetupAxes(NULL, NULL, ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::PlotLine("Error (deg)", _sensorlessData.commutationError.data(), _sensorlessData.commutationError.size());
+            ImPlot::EndPlot();
+        }
+
+        // Constant speed observer accuracy, the blend moves from the encoder to the observer between blendLow and blendHigh
+        const std::vector<SensorlessData::SweepResult>& sweep = _sensorlessData.sweep;
+        if (!sweep.empty() && ImGui::BeginTable("Observer Sweep", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Speed (rad/s)");
+            ImGui::TableSetupColumn("Observer weight");
+            ImGui::TableSetupColumn("Observer RMS (deg)");
+            ImGui::TableSetupColumn("Observer max (deg)");
+            ImGui::TableSetupColumn("Blended RMS (deg)");
+            ImGui::TableSetupColumn("Speed error (%)");
+            ImGui::TableHeadersRow();
+            for (const SensorlessData::SweepResult& result : sweep) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%.0f", result.speed);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", result.weight);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", result.observerError);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", result.observerMax);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", result.blendError);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", result.speedError);
+            }
+            ImGui::EndTable();
+        }
+
+        if (!sweep.empty() && ImPlot::BeginPlot("Angle Error vs Speed")) {
+            ImPlot::SetupAxes("Electrical speed (rad/s)", "RMS error (deg)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            const float* speed = &sweep[0].speed;
+            int stride = sizeof(SensorlessData::SweepResult);
+            ImPlot::PlotLine("Observer", speed, &sweep[0].observerError, sweep.size(), 0, 0, stride);
+            ImPlot::PlotLine("Blended", speed, &sweep[0].blendError, sweep.size(), 0, 0, stride);
+            ImPlot::EndPlot();
+        }
+    }
+    ImGui::End();
+
+    ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_Once);
+    ImGui::Begin("Dead Time");
+    {
+        ImGui::SliderFloat("Dead time (ns)", &_deadTimeData.deadTime, 0.0f, 2000.0f);
+        ImGui::SliderFloat("Band (A)", &_deadTimeData.band, 0.001f, 0.1f);
+        if (ImGui::Button("Run"))
+            simulateDeadTime();
+        ImGui::Text("RMS error without compensation: %.2f mA", _deadTimeData.uncompensatedError * 1000.0f);
+        ImGui::Text("RMS error with compensation: %.2f mA", _deadTimeData.compensatedError * 1000.0f);
+        ImGui::Text("Compensation compute: %.1f ns", _deadTimeData.computeTime);
+
+        if (ImPlot::BeginPlot("Phase U Current")) {
+            ImPlot::SetupAxes(NULL, NULL, ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::PlotLine("Ideal", _deadTimeData.ideal.data(), _deadTimeData.ideal.size());
+            ImPlot::PlotLine("Dead time", _deadTimeData.uncompensated.data(), _deadTimeData.uncompensated.size());
+            ImPlot::PlotLine("Compensated", _deadTimeData.compensated.data(), _deadTimeData.compensated.size());
+            ImPlot::EndPlot();
+        }
+    }
+    ImGui::End();
+
+    ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_Once);
+    ImGui::Begin("Vibration");
+    {
+        const VibrationSpectrum& last = _vibrationData.last;
+        ImGui::Text("Spectra received: %zu", _vibrationData.received);
+        ImGui::Text("Rotor frequency: %.2f Hz", last.rotorFrequency);
+        for (size_t i = 0; i < last.peakFrequency.size(); i++)
+            ImGui::Text("%zux: %.2f Hz, %.1f LSB", i + 1, last.peakFrequency[i], last.peakAmplitude[i]);
+
+        if (ImPlot::BeginPlot("Accelerometer Spectrum")) {
+            ImPlot::SetupAxes("Frequency (Hz)", "Amplitude (LSB)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::PlotLine("Amplitude", _vibrationData.frequency.data(), _vibrationData.amplitude.data(), _vibrationData.frequency.size());
+            ImPlot::EndPlot();
+        }
+    }
+    ImGui::End();
+
+    ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_Once);
+    ImGui::Begin("Profiler");
+    {
+        ImGui::Text("Statistics received: %zu", _profilerData.received);
+        for (const auto& [name, stats] : _profilerData.probes) {
+            if (!ImGui::CollapsingHeader(name.c_str(), ImGuiTreeNodeFlags_DefaultOpen))
+                continue;
+            float us = stats.clock > 0 ? 1e6f / stats.clock : 0.0f; // Microseconds per cycle
+            ImGui::Text("Count: %u", stats.count);
+            ImGui::Text("Duration: min %.2f us, mean %.2f us, max %.2f us", stats.minCycles * us, stats.meanCycles * us, stats.maxCycles * us);
+            ImGui::Text("Period: min %.2f us, mean %.2f us, max %.2f us", stats.minPeriod * us, stats.meanPeriod * us, stats.maxPeriod * us);
+            ImGui::Text("Max jitter: %.2f us", stats.maxJitter * us);
+
+            // Bucket b holds [2^(b-1), 2^b) cycles
+            std::string plot = "Histograms##" + name;
+            if (ImPlot::BeginPlot(plot.c_str(), ImVec2(-1, 200))) {
+                ImPlot::SetupAxes("log2(cycles)", "Count", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+                ImPlot::PlotBars("Duration", stats.cycles.data(), stats.cycles.size(), 0.4, -0.2);
+                ImPlot::PlotBars("Period jitter", stats.jitter.data(), stats.jitter.size(), 0.4, 0.2);
+                ImPlot::EndPlot();
+            }
+        }
+    }
+    ImGui::End();
+
+    ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_Once);
+    ImGui::Begin("System Health");
+    {
+        static constexpr const char* STATES[] = {"Running", "Ready", "Blocked", "Suspended", "Deleted", "Invalid"};
+        const SystemHealth& last = _healthData.last;
+        ImGui::Text("Reports received: %zu", _healthData.received);
+        ImGui::Text("CPU load: %.2f%%", last.cpuLoad / 100.0f);
+        ImGui::Text("Heap: %u bytes free, %u bytes minimum ever free", last.heapFree, last.heapMinFree);
+
+        if (ImGui::BeginTable("Tasks", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Task");
+            ImGui::TableSetupColumn("CPU (%)");
+            ImGui::TableSetupColumn("Stack free (words)");
+            ImGui::TableSetupColumn("Priority");
+            ImGui::TableSetupColumn("State");
+            ImGui::TableHeadersRow();
+            for (size_t i = 0; i < std::min<size_t>(last.numTasks, last.tasks.size()); i++) {
+                const SystemHealth::Task& task = last.tasks[i];
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", task.name.data());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", task.cpu / 100.0f);
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", task.stackHighWater);
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", task.priority);
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", STATES[std::min<size_t>(task.state, std::size(STATES) - 1)]);
+            }
+            ImGui::EndTable();
+        }
+
+        // Timing of the scheduled tasks since the last report (us)
+        if (ImGui::BeginTable("Task Timing", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Task");
+            ImGui::TableSetupColumn("Period (us)");
+            ImGui::TableSetupColumn("Observed min/mean/max (us)");
+            ImGui::TableSetupColumn("Max jitter (us)");
+            ImGui::TableSetupColumn("Max execution (us)");
+            ImGui::TableSetupColumn("Deadline (us)");
+            ImGui::TableSetupColumn("Activations");
+            ImGui::TableSetupColumn("Misses");
+            ImGui::TableHeadersRow();
+            for (const auto& [name, timing] : _healthData.timing) {
+                float us = timing.clock > 0 ? 1e6f / timing.clock : 0.0f;
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", name.c_str());
+                ImGui::TableNextColumn();
+                if (timing.period > 0)
+                    ImGui::Text("%.1f", timing.period * us);
+                else
+                    ImGui::Text("Event");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f / %.1f / %.1f", timing.minPeriod * us, timing.meanPeriod * us, timing.maxPeriod * us);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", timing.maxJitter * us);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", timing.maxExecution * us);
+                ImGui::TableNextColumn();
+                if (timing.deadline > 0)
+                    ImGui::Text("%.1f", timing.deadline * us);
+                else
+                    ImGui::Text("-");
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", timing.count);
+                ImGui::TableNextColumn();
+                if (timing.misses > 0)
+                    ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%u", timing.misses);
+                else
+                    ImGui::Text("0");
+            }
+            ImGui::EndTable();
+        }
+
+        if (ImPlot::BeginPlot("CPU Load")) {
+            ImPlot::SetupAxes(NULL, "%", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::PlotLine("Load", _healthData.cpuLoad.data(), _healthData.cpuLoad.size());
+            ImPlot::EndPlot();
+        }
+        if (ImPlot::BeginPlot("Free Heap")) {
+            ImPlot::SetupAxes(NULL, "bytes", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::PlotLine("Free", _healthData.heapFree.data(), _healthData.heapFree.size());
+            ImPlot::EndPlot();
+        }
+    }
+    ImGui::End();
+
     ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_Once);
     ImGui::Begin("Motor State");
     {
@@ -250,6 +497,239 @@ void ProjectScript::onUIRender() {
     ImGui::End();
 }
 
+void ProjectScript::simulateSensorless(float dt) {
+    constexpr float PWM_DT = 1.0f / 24000.0f; // Controller is called once per PWM period
+    constexpr float V = 7.8f;                 // Supply voltage
+    constexpr float Tl = 0.01f;               // Load torque
+
+    static Controller::Output output;
+    Controller::Control u;
+    u.position = NAN;
+    u.velocity = 0.0f;
+    u.torque = NAN;
+
+    float observerTime = 0.0f;
+    size_t observerCalls = 0;
+    for (float t = 0.0f; t < dt; t += PWM_DT) {
+        // Terminal voltages as measured by the phase voltage ADCs (star point at half supply when two phases are driven)
+        atta::vec3 emf = _motor.getEMF();
+        auto terminal = [&](bool h, bool l, int i) {
+            if (h && !l)
+                return V;
+            else if (!h && l)
+                return 0.0f;
+            else
+                return emf[i] + V / 2;
+        };
+        Controller::State x;
+        x.voltage = V;
+        x.currents = {_motor.getCurrent()[0], _motor.getCurrent()[1], _motor.getCurrent()[2]};
+        x.theta = NAN;
+        x.velocity = NAN;
+        x.phaseVoltages = {terminal(output.uh, output.ul, 0), terminal(output.vh, output.vl, 1), terminal(output.wh, output.wl, 2)};
+        output = _sensorlessController.control(x, u, PWM_DT);
+
+        // Ideal commutation is 30 degrees after the back-EMF zero crossing
+        if (_sensorlessController.hasCommutated() && _sensorlessController.getStage() == SensorlessController::Stage::RUN) {
+            float err = std::fmod(_motor.getPosition() - M_PI / 6, M_PI / 3);
+            if (err < 0.0f)
+                err += M_PI / 3;
+            if (err >= M_PI / 6)
+                err -= M_PI / 3;
+            _sensorlessData.commutationError.push_back(err * 180.0f / M_PI);
+        }
+
+        auto calcV = [](bool h, bool l) {
+            if (h && !l)
+                return V;
+            else if (!h && l)
+                return 0.0f;
+            else
+                return -1.0f;
+        };
+        atta::vec3 Vs = {calcV(output.uh, output.ul), calcV(output.vh, output.vl), calcV(output.wh, output.wl)};
+        _motor.update(Vs, Tl, PWM_DT);
+
+        // Observer fed by the same currents and voltages the firmware would have
+        atta::vec3 i = _motor.getCurrent();
+        atta::vec3 v = _motor.getVoltage();
+        auto start = std::chrono::steady_clock::now();
+        _fluxObserver.update({i[0], i[1], i[2]}, {v[0], v[1], v[2]}, PWM_DT);
+        auto end = std::chrono::steady_clock::now();
+        observerTime += std::chrono::duration<float, std::nano>(end - start).count();
+        observerCalls++;
+    }
+    if (observerCalls)
+        _sensorlessData.observerTime = observerTime / observerCalls;
+
+    // Model back-EMF is sin(theta), so its rotor flux points at theta + pi
+    float err = std::fmod(_fluxObserver.getAngle() - _motor.getPosition() - M_PI, 2 * M_PI);
+    if (err < -M_PI)
+        err += 2 * M_PI;
+    if (err >= M_PI)
+        err -= 2 * M_PI;
+    _sensorlessData.observerError.push_back(err * 180.0f / M_PI);
+    _sensorlessData.observerVelocity.push_back(_fluxObserver.getSpeed() / Controller::NUM_POLE_PAIRS);
+    _sensorlessData.stepPeriod.push_back(_sensorlessController.getStepPeriod());
+    _sensorlessData.velocity.push_back(_sensorlessController.getVelocity());
+    _sensorlessData.simVelocity.push_back(_motor.getVelocity());
+}
+
+void ProjectScript::simulateObserverSweep() {
+    constexpr float PWM_DT = 1.0f / 24000.0f; // Observer is called once per PWM period
+    constexpr float RAMP = 0.25f;             // Time accelerating to the swept speed, so the PLL does not have to pull in (s)
+    constexpr float SETTLE = 0.5f;            // Time for the flux estimate and the PLL to converge (s)
+    constexpr float DURATION = 1.0f;          // Simulated time per speed (s), errors are measured after SETTLE
+    constexpr float CURRENT_VOLTAGE = 0.5f;   // Voltage on top of the back-EMF feedforward (q axis current)
+    constexpr float ENCODER_RESOLUTION = 2 * M_PI / (1 << 14);
+
+    // Rotor driven at a constant speed (very large inertia), speeds cover the blend region and the observer-only region
+    float R = 3.6f;
+    float L = 0.1f;
+    float P = 14;
+    float l = 1.0f;
+    const FluxObserver::Config config = _fluxObserver.getConfig();
+    std::vector<float> speeds = {0.5f * config.blendLow, config.blendLow, 0.5f * (config.blendLow + config.blendHigh), config.blendHigh};
+    for (float factor : {2.0f, 4.0f, 8.0f, 16.0f})
+        speeds.push_back(factor * config.blendHigh);
+
+    auto wrap = [](float angle) {
+        angle = std::fmod(angle, 2 * M_PI);
+        if (angle < -M_PI)
+            angle += 2 * M_PI;
+        if (angle >= M_PI)
+            angle -= 2 * M_PI;
+        return angle;
+    };
+
+    _sensorlessData.sweep.clear();
+    for (float speed : speeds) {
+        Motor motor(R, L, 1e6f, 0.0f, P, l);
+        FluxObserver observer;
+        observer.setConfig(config);
+
+        float observerError = 0.0f;
+        float observerMax = 0.0f;
+        float blendError = 0.0f;
+        float observerSpeed = 0.0f;
+        float startPosition = 0.0f;
+        size_t measured = 0;
+        for (float t = 0.0f; t < DURATION; t += PWM_DT) {
+            float w = speed * std::min(t / RAMP, 1.0f);
+            motor.setVelocity(w / (P / 2));
+
+            // Back-EMF feedforward plus a small voltage in phase with it, so the observer also sees the resistive and inductive drops
+            float theta = motor.getPosition();
+            float magnitude = l / (P / 2) * w + CURRENT_VOLTAGE;
+            atta::vec3 v;
+            for (size_t k = 0; k < 3; k++)
+                v[k] = magnitude * std::sin(theta - k * (2 * M_PI / 3));
+            motor.update(v, 0.0f, PWM_DT);
+
+            atta::vec3 i = motor.getCurrent();
+            observer.update({i[0], i[1], i[2]}, {v[0], v[1], v[2]}, PWM_DT);
+            if (t < SETTLE)
+                continue;
+            if (!measured)
+                startPosition = motor.getPosition();
+
+            // Model back-EMF is sin(theta), so its rotor flux points at theta + pi. The encoder angle is quantized to 14 bits per mechanical turn
+            float flux = motor.getPosition() + M_PI;
+            float mechanical = std::floor(motor.getPosition() / (P / 2) / ENCODER_RESOLUTION) * ENCODER_RESOLUTION;
+            float encoderAngle = std::fmod(mechanical * (P / 2) + M_PI, 2 * M_PI);
+            float err = std::fabs(wrap(observer.getAngle() - flux)) * 180.0f / M_PI;
+            float blendErr = wrap(observer.blend(encoderAngle) - flux) * 180.0f / M_PI;
+            observerError += err * err;
+            observerMax = std::max(observerMax, err);
+            blendError += blendErr * blendErr;
+            observerSpeed += observer.getSpeed();
+            measured++;
+        }
+
+        SensorlessData::SweepResult result{};
+        result.speed = speed;
+        result.weight = std::clamp((speed - config.blendLow) / (config.blendHigh - config.blendLow), 0.0f, 1.0f);
+        if (measured > 1) {
+            // Speed from the simulated angle, the float rotor position rounds every substep so it differs from the set speed
+            float simSpeed = (motor.getPosition() - startPosition) / ((measured - 1) * PWM_DT);
+            result.observerError = std::sqrt(observerError / measured);
+            result.observerMax = observerMax;
+            result.blendError = std::sqrt(blendError / measured);
+            result.speedError = (observerSpeed / measured - simSpeed) / simSpeed * 100.0f;
+        }
+        _sensorlessData.sweep.push_back(result);
+        LOG_DEBUG("ProjectScript", "Observer at [w]$0 rad/s: $1 deg RMS ($2 deg max), blended $3 deg RMS", speed, result.observerError,
+                  result.observerMax, result.blendError);
+    }
+}
+
+void ProjectScript::simulateDeadTime() {
+    constexpr float PWM_DT = 1.0f / 24000.0f; // Averaged over each PWM period
+    constexpr float V = 7.8f;                 // Supply voltage
+    constexpr float FREQUENCY = 20.0f;        // Electrical frequency of the voltage vector (Hz)
+    constexpr float MAGNITUDE = 0.3f;         // Voltage vector magnitude
+    constexpr float DURATION = 0.5f;          // Simulated time (s), errors are measured on the second half
+
+    // Locked rotor (very large inertia), so only the inverter changes between the runs
+    float R = 3.6f;
+    float L = 0.1f;
+    float P = 14;
+    Motor ideal(R, L, 1e6f, 1.0f, P, 1.0f);
+    Motor uncompensated = ideal;
+    Motor compensated = ideal;
+    uncompensated.setDeadTime(_deadTimeData.deadTime * 1e-9f, PWM_DT, V);
+    compensated.setDeadTime(_deadTimeData.deadTime * 1e-9f, PWM_DT, V);
+
+    DeadTimeCompensation compensation;
+    compensation.setDeadTime(_deadTimeData.deadTime * 1e-9f, PWM_DT);
+    compensation.setBand(_deadTimeData.band);
+
+    _deadTimeData.ideal.clear();
+    _deadTimeData.uncompensated.clear();
+    _deadTimeData.compensated.clear();
+    float uncompensatedError = 0.0f;
+    float compensatedError = 0.0f;
+    float computeTime = 0.0f;
+    size_t steps = 0;
+    size_t measured = 0;
+    for (float t = 0.0f; t < DURATION; t += PWM_DT, steps++) {
+        // Sinusoidal duty cycles centered on half supply (voltages relative to the star point)
+        std::array<float, 3> duty;
+        for (size_t i = 0; i < 3; i++)
+            duty[i] = 0.5f + 0.5f * MAGNITUDE * std::cos(2 * M_PI * FREQUENCY * t - i * (2 * M_PI / 3));
+
+        atta::vec3 i = compensated.getCurrent();
+        auto start = std::chrono::steady_clock::now();
+        std::array<float, 3> correction = compensation.compute({i[0], i[1], i[2]});
+        auto end = std::chrono::steady_clock::now();
+        computeTime += std::chrono::duration<float, std::nano>(end - start).count();
+
+        atta::vec3 v, vc;
+        for (size_t k = 0; k < 3; k++) {
+            v[k] = V * (duty[k] - 0.5f);
+            vc[k] = V * (duty[k] + correction[k] - 0.5f);
+        }
+        ideal.update(v, 0.0f, PWM_DT);
+        uncompensated.update(v, 0.0f, PWM_DT);
+        compensated.update(vc, 0.0f, PWM_DT);
+
+        float iu = ideal.getCurrent()[0];
+        _deadTimeData.ideal.push_back(iu);
+        _deadTimeData.uncompensated.push_back(uncompensated.getCurrent()[0]);
+        _deadTimeData.compensated.push_back(compensated.getCurrent()[0]);
+        if (t >= DURATION / 2) {
+            uncompensatedError += std::pow(_deadTimeData.uncompensated.back() - iu, 2);
+            compensatedError += std::pow(_deadTimeData.compensated.back() - iu, 2);
+            measured++;
+        }
+    }
+    _deadTimeData.uncompensatedError = measured ? std::sqrt(uncompensatedError / measured) : 0.0f;
+    _deadTimeData.compensatedError = measured ? std::sqrt(compensatedError / measured) : 0.0f;
+    _deadTimeData.computeTime = steps ? computeTime / steps : 0.0f;
+    LOG_DEBUG("ProjectScript", "Dead time RMS error: [w]$0 mA uncompensated, $1 mA compensated", _deadTimeData.uncompensatedError * 1000.0f,
+              _deadTimeData.compensatedError * 1000.0f);
+}
+
 std::weak_ptr<atta::io::Serial> _gSerial;
 
 void ProjectScript::handleSerial() {
@@ -310,6 +790,41 @@ void ProjectScript::handleAttaConnector() {
         _imuData.acc.push_back(atta::vec3(imu.acc[0], imu.acc[1], imu.acc[2]));
         _imuData.gyr.push_back(atta::vec3(imu.gyr[0], imu.gyr[1], imu.gyr[2]));
     }
+
+    VibrationSpectrum vibration;
+    while (AttaConnector::receive<VibrationSpectrum>(&vibration)) {
+        _vibrationData.frequency.resize(vibration.spectrum.size());
+        _vibrationData.amplitude.resize(vibration.spectrum.size());
+        for (size_t i = 0; i < vibration.spectrum.size(); i++) {
+            _vibrationData.frequency[i] = (i + 0.5f) * vibration.binWidth;
+            _vibrationData.amplitude[i] = vibration.spectrum[i] * vibration.scale;
+        }
+        _vibrationData.last = vibration;
+        _vibrationData.received++;
+    }
+
+    ProfilerStats profiler;
+    while (AttaConnector::receive<ProfilerStats>(&profiler)) {
+        profiler.name.back() = '\0';
+        _profilerData.probes[profiler.name.data()] = profiler;
+        _profilerData.received++;
+    }
+
+    SystemHealth health;
+    while (AttaConnector::receive<SystemHealth>(&health)) {
+        for (SystemHealth::Task& task : health.tasks)
+            task.name.back() = '\0';
+        _healthData.last = health;
+        _healthData.cpuLoad.push_back(health.cpuLoad / 100.0f);
+        _healthData.heapFree.push_back(health.heapFree);
+        _healthData.received++;
+    }
+
+    TaskTiming timing;
+    while (AttaConnector::receive<TaskTiming>(&timing)) {
+        timing.name.back() = '\0';
+        _healthData.timing[timing.name.data()] = timing;
+    }
 }
 
 #include "attaConnectorPlatform.cpp"
@@ -8,9 +8,14 @@
 #include "motor.h"
 // #include "trapezoidalController.h"
 // #include "focController.h"
+#include "deadTimeCompensation.h"
+#include "fluxObserver.h"
+#include "sensorlessController.h"
 #include "attaConnector.h"
+#include "attaConnectorCmds.h"
 #include <atta/io/interface.h>
 #include <atta/script/projectScript.h>
+#include <map>
 
 namespace scr = atta::script;
 
@@ -31,6 +36,9 @@ class ProjectScript : public scr::ProjectScript {
   private:
     void handleSerial();
     void handleAttaConnector();
+    void simulateSensorless(float dt);
+    void simulateObserverSweep();
+    void simulateDeadTime();
 
     struct MotorData {
         std::vector<float> position;
@@ -55,12 +63,72 @@ class ProjectScript : public scr::ProjectScript {
         std::vector<atta::vec3> gyr;
     };
 
+    struct VibrationData {
+        std::vector<float> frequency; // Bin center frequency (Hz)
+        std::vector<float> amplitude; // Bin amplitude (accelerometer LSB)
+        VibrationSpectrum last;       // Last received spectrum (peaks)
+        size_t received;              // Number of received spectra
+    };
+
+    struct ProfilerData {
+        std::map<std::string, ProfilerStats> probes; // Last statistics of each probe
+        size_t received;                             // Number of received statistics
+    };
+
+    struct HealthData {
+        SystemHealth last;                        // Last received health
+        std::vector<float> cpuLoad;               // CPU load history (%)
+        std::vector<float> heapFree;              // Free heap history (bytes)
+        size_t received;                          // Number of received health commands
+        std::map<std::string, TaskTiming> timing; // Last timing of each scheduled task
+    };
+
+    struct SensorlessData {
+        std::vector<float> stepPeriod;       // Estimated step period
+        std::vector<float> velocity;         // Estimated mechanical velocity
+        std::vector<float> simVelocity;      // Simulated velocity
+        std::vector<float> commutationError; // Commutation angle error (electrical degrees)
+        std::vector<float> observerError;    // Observer angle error (electrical degrees)
+        std::vector<float> observerVelocity; // Observer mechanical velocity
+        float observerTime;                  // Mean observer update time (ns)
+
+        // Observer accuracy at constant speed, one result per swept speed
+        struct SweepResult {
+            float speed;         // Electrical speed (rad/s)
+            float weight;        // Observer weight in the blended angle
+            float observerError; // RMS observer angle error (electrical degrees)
+            float observerMax;   // Maximum observer angle error (electrical degrees)
+            float blendError;    // RMS blended angle error (electrical degrees)
+            float speedError;    // Observer speed error (%)
+        };
+        std::vector<SweepResult> sweep;
+    };
+
+    struct DeadTimeData {
+        float deadTime;                   // Simulated dead time (ns)
+        float band;                       // Compensation sign ramp band (A)
+        std::vector<float> ideal;         // Phase U current with an ideal inverter
+        std::vector<float> uncompensated; // Phase U current with dead time
+        std::vector<float> compensated;   // Phase U current with dead time and compensation
+        float uncompensatedError;         // RMS current error without compensation (A)
+        float compensatedError;           // RMS current error with compensation (A)
+        float computeTime;                // Mean compensation compute time (ns)
+    };
+
     Motor _motor;
     MotorData _motorData;
     PhysicalMotorData _phyMotorData;
     ImuData _imuData;
+    VibrationData _vibrationData;
+    ProfilerData _profilerData;
+    HealthData _healthData;
     // TrapezoidalController _tController;
     // FocController _focController;
+    SensorlessController _sensorlessController;
+    FluxObserver _fluxObserver;
+    SensorlessData _sensorlessData;
+    DeadTimeData _deadTimeData;
+    bool _sensorlessRunning;
     std::shared_ptr<atta::io::Serial> _serial;
 };
 
@@ -0,0 +1,152 @@
+//--------------------------------------------------
+// BLDC Controller
+// cascadeControllerTest.cpp
+// Date: 2026-10-19
+//--------------------------------------------------
+#include "cascadeController.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr float DT = 1.0f / 24000;
+constexpr float SQRT3 = 1.73205080757f;
+
+// Plant state with the phase currents of the given D/Q currents
+Controller::State plant(float theta, float velocity, float iD = 0.0f, float iQ = 0.0f, float voltage = 24.0f) {
+    float thetaE = theta * Controller::NUM_POLE_PAIRS;
+    float iAlpha = iD * std::cos(thetaE) - iQ * std::sin(thetaE);
+    float iBeta = iD * std::sin(thetaE) + iQ * std::cos(thetaE);
+    float ib = (iBeta * SQRT3 - iAlpha) / 2;
+    Controller::State s{};
+    s.voltage = voltage;
+    s.currents = {iAlpha, ib, -iAlpha - ib};
+    s.theta = theta;
+    s.velocity = velocity;
+    return s;
+}
+
+Controller::Control torque(float t) { return {NAN, NAN, t}; }
+Controller::Control velocity(float w, float t = NAN) { return {NAN, w, t}; }
+Controller::Control position(float p, float t = NAN) { return {p, NAN, t}; }
+const Controller::Control idle = {NAN, NAN, NAN};
+
+// Run whole velocity loop periods
+void run(CascadeController& controller, const Controller::State& s, const Controller::Control& c, size_t iterations) {
+    for (size_t i = 0; i < iterations; i++)
+        controller.control(s, c, DT);
+}
+
+} // namespace
+
+TEST(CascadeController, ModeSelection) {
+    CascadeController controller;
+    Controller::State s = plant(0.0f, 0.0f);
+    controller.control(s, idle, DT);
+    EXPECT_EQ(controller.getMode(), CascadeController::Mode::IDLE);
+    EXPECT_EQ(controller.getVoltageMagnitude(), 0.0f);
+
+    // The first control signal that is not NAN selects the mode
+    controller.control(s, torque(0.01f), DT);
+    EXPECT_EQ(controller.getMode(), CascadeController::Mode::TORQUE);
+    controller.control(s, velocity(10.0f, 0.01f), DT);
+    EXPECT_EQ(controller.getMode(), CascadeController::Mode::VELOCITY);
+    controller.control(s, {1.0f, 10.0f, 0.01f}, DT);
+    EXPECT_EQ(controller.getMode(), CascadeController::Mode::POSITION);
+    controller.control(s, idle, DT);
+    EXPECT_EQ(controller.getMode(), CascadeController::Mode::IDLE);
+    EXPECT_EQ(controller.getCurrentReference(), 0.0f);
+    EXPECT_EQ(controller.getVoltageMagnitude(), 0.0f);
+}
+
+TEST(CascadeController, TorqueFeedforward) {
+    CascadeController controller;
+    Controller::State s = plant(0.0f, 0.0f);
+    controller.control(s, torque(0.01f), DT);
+    EXPECT_NEAR(controller.getCurrentReference(), 0.01f / controller.getGains().torqueConstant, 1e-6f);
+    run(controller, s, torque(1.0f), 8);
+    EXPECT_EQ(controller.getCurrentReference(), controller.getGains().currentLimit);
+}
+
+TEST(CascadeController, BumplessTorqueToVelocity) {
+    // Rotor at the requested velocity, the velocity loop must keep the Q reference the torque mode applied
+    CascadeController controller;
+    Controller::State s = plant(0.0f, 10.0f);
+    run(controller, s, torque(0.01f), 80);
+    float reference = controller.getCurrentReference();
+    ASSERT_NEAR(reference, 0.5f, 1e-6f);
+
+    controller.control(s, velocity(10.0f, 0.01f), DT);
+    EXPECT_NEAR(controller.getCurrentReference(), reference, 1e-6f);
+    run(controller, s, velocity(10.0f, 0.01f), 80);
+    EXPECT_NEAR(controller.getCurrentReference(), reference, 1e-6f);
+}
+
+TEST(CascadeController, BumplessTorqueToPosition) {
+    CascadeController controller;
+    Controller::State s = plant(1.0f, 0.0f);
+    run(controller, s, torque(-0.004f), 80);
+    float reference = controller.getCurrentReference();
+    ASSERT_NEAR(reference, -0.2f, 1e-6f);
+
+    // Target at the current position, no velocity error
+    controller.control(s, position(1.0f, -0.004f), DT);
+    EXPECT_NEAR(controller.getCurrentReference(), reference, 1e-6f);
+}
+
+TEST(CascadeController, BumplessSaturatedTorque) {
+    // The clamped torque reference is kept, the integral takes the part of the feedforward above the limit
+    CascadeController controller;
+    Controller::State s = plant(0.0f, 0.0f);
+    run(controller, s, torque(0.05f), 8);
+    ASSERT_EQ(controller.getCurrentReference(), 1.0f);
+    run(controller, s, velocity(0.0f, 0.05f), 80);
+    EXPECT_NEAR(controller.getCurrentReference(), 1.0f, 1e-6f);
+}
+
+TEST(CascadeController, VelocityEstimatedWhileIdle) {
+    // 100 rad/s without a PLL velocity, the estimate must be current when a mode is selected
+    CascadeController controller;
+    constexpr float w = 100.0f;
+    float theta = 0.0f;
+    for (size_t i = 0; i < 24000; i++) {
+        theta = std::fmod(theta + w * DT, 2 * float(M_PI));
+        controller.control(plant(theta, NAN), idle, DT);
+    }
+    EXPECT_NEAR(controller.getVelocity(), w, w * 1e-2f);
+}
+
+TEST(CascadeController, AntiWindup) {
+    // Rotor blocked, the velocity loop saturates for one second
+    CascadeController controller;
+    Controller::State s = plant(0.0f, 0.0f);
+    run(controller, s, velocity(300.0f), 24000);
+    EXPECT_EQ(controller.getCurrentReference(), controller.getGains().currentLimit);
+
+    // Without the integral wound up, the output follows the new error immediately
+    run(controller, s, velocity(0.0f), 8);
+    EXPECT_NEAR(controller.getCurrentReference(), 0.0f, 1e-3f);
+}
+
+TEST(CascadeController, VoltageSaturation) {
+    // Low supply, the Q current can not be reached
+    CascadeController controller;
+    constexpr float theta = 0.1f;
+    Controller::State s = plant(theta, 0.0f, 0.0f, 0.0f, 0.5f);
+    for (size_t i = 0; i < 2400; i++) {
+        controller.control(s, velocity(300.0f), DT);
+        ASSERT_LE(controller.getVoltageMagnitude(), 1.0f + 1e-5f);
+    }
+    EXPECT_NEAR(controller.getVoltageMagnitude(), 1.0f, 1e-5f);
+
+    // D axis has priority: with a large D current error the whole voltage goes to D
+    s = plant(theta, 0.0f, 5.0f, 0.0f, 0.5f);
+    run(controller, s, velocity(300.0f), 2400);
+    float thetaE = std::fmod(theta * Controller::NUM_POLE_PAIRS + float(M_PI), 2 * float(M_PI));
+    EXPECT_NEAR(controller.getVoltageAngle(), thetaE, 1e-3f);
+    EXPECT_NEAR(controller.getVoltageMagnitude(), 1.0f, 1e-5f);
+
+    // Supply restored and currents reached, the current integrals did not wind up during saturation
+    s = plant(theta, 0.0f, 0.0f, controller.getCurrentReference(), 24.0f);
+    controller.control(s, velocity(300.0f), DT);
+    EXPECT_LT(controller.getVoltageMagnitude(), 0.05f);
+}
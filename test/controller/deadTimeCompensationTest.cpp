@@ -0,0 +1,113 @@
+//--------------------------------------------------
+// BLDC Controller
+// deadTimeCompensationTest.cpp
+// Date: 2026-10-19
+//--------------------------------------------------
+#include "deadTimeCompensation.h"
+#include "motor.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr float DT = 1.0f / 24000;    // PWM period, the motor model averages over it
+constexpr float DEAD_TIME = 1000e-9f; // Dead time inserted at each edge (s)
+constexpr float V = 7.8f;             // Supply voltage
+
+struct TrackingError {
+    float uncompensated; // RMS current error of the inverter with dead time (A)
+    float compensated;   // RMS current error with the compensation (A)
+};
+
+// Locked rotor driven by a rotating voltage vector, phase U current of inverters with dead time against an ideal one
+TrackingError track(float frequency, float magnitude, float band) {
+    constexpr float DURATION = 0.5f; // Errors are measured on the second half
+    Motor ideal(3.6f, 1e-3f, 1e6f, 1.0f, Controller::NUM_POLES, 0.02f);
+    Motor uncompensated = ideal;
+    Motor compensated = ideal;
+    uncompensated.setDeadTime(DEAD_TIME, DT, V);
+    compensated.setDeadTime(DEAD_TIME, DT, V);
+
+    DeadTimeCompensation compensation;
+    compensation.setDeadTime(DEAD_TIME, DT);
+    compensation.setBand(band);
+
+    float uncompensatedError = 0.0f;
+    float compensatedError = 0.0f;
+    size_t measured = 0;
+    for (float t = 0.0f; t < DURATION; t += DT) {
+        // Sinusoidal duty cycles centered on half supply (voltages relative to the star point)
+        std::array<float, 3> duty;
+        for (size_t k = 0; k < 3; k++)
+            duty[k] = 0.5f + 0.5f * magnitude * std::cos(2 * float(M_PI) * frequency * t - k * (2 * float(M_PI) / 3));
+
+        atta::vec3 i = compensated.getCurrent();
+        std::array<float, 3> correction = compensation.compute({i[0], i[1], i[2]});
+        atta::vec3 v, vc;
+        for (size_t k = 0; k < 3; k++) {
+            v[k] = V * (duty[k] - 0.5f);
+            vc[k] = V * (duty[k] + correction[k] - 0.5f);
+        }
+        ideal.update(v, 0.0f, DT);
+        uncompensated.update(v, 0.0f, DT);
+        compensated.update(vc, 0.0f, DT);
+        if (t < DURATION / 2)
+            continue;
+
+        float iu = ideal.getCurrent()[0];
+        uncompensatedError += std::pow(uncompensated.getCurrent()[0] - iu, 2);
+        compensatedError += std::pow(compensated.getCurrent()[0] - iu, 2);
+        measured++;
+    }
+    return {std::sqrt(uncompensatedError / measured), std::sqrt(compensatedError / measured)};
+}
+
+} // namespace
+
+TEST(DeadTimeCompensation, PlantTracking) {
+    // The correction uses the current of the previous PWM period, so some error is left
+    for (float frequency : {5.0f, 20.0f, 100.0f})
+        for (float magnitude : {0.1f, 0.8f}) {
+            TrackingError error = track(frequency, magnitude, 0.01f);
+            EXPECT_GT(error.uncompensated, 0.01f) << frequency << " Hz, magnitude " << magnitude;
+            EXPECT_LT(error.compensated, 0.5f * error.uncompensated) << frequency << " Hz, magnitude " << magnitude;
+        }
+}
+
+TEST(DeadTimeCompensation, BandRamp) {
+    DeadTimeCompensation compensation;
+    compensation.setDeadTime(DEAD_TIME, DT);
+    compensation.setBand(0.1f);
+    float c = compensation.getCorrection();
+    EXPECT_NEAR(c, DEAD_TIME / DT, 1e-6f);
+    EXPECT_EQ(compensation.getBand(), 0.1f);
+
+    // Linear inside the band, odd in the current
+    std::array<float, 3> correction = compensation.compute({0.05f, -0.025f, 0.0f});
+    EXPECT_NEAR(correction[0], 0.5f * c, 1e-6f);
+    EXPECT_NEAR(correction[1], -0.25f * c, 1e-6f);
+    EXPECT_EQ(correction[2], 0.0f);
+
+    // A wider band lowers the slope, the full correction is unchanged
+    compensation.setBand(0.2f);
+    EXPECT_NEAR(compensation.compute({0.05f, 0.0f, 0.0f})[0], 0.25f * c, 1e-6f);
+    EXPECT_EQ(compensation.compute({0.3f, 0.0f, 0.0f})[0], c);
+}
+
+TEST(DeadTimeCompensation, Clamp) {
+    DeadTimeCompensation compensation;
+    compensation.setDeadTime(DEAD_TIME, DT);
+    compensation.setBand(0.01f);
+    float c = compensation.getCorrection();
+
+    // Full correction at the band edge and beyond
+    std::array<float, 3> correction = compensation.compute({0.01f, -5.0f, 100.0f});
+    EXPECT_NEAR(correction[0], c, 1e-6f);
+    EXPECT_EQ(correction[1], -c);
+    EXPECT_EQ(correction[2], c);
+
+    // Invalid timing disables the correction
+    compensation.setDeadTime(-DEAD_TIME, DT);
+    EXPECT_EQ(compensation.compute({1.0f, -1.0f, 0.0f}), (std::array<float, 3>{0.0f, 0.0f, 0.0f}));
+    compensation.setDeadTime(DEAD_TIME, 0.0f);
+    EXPECT_EQ(compensation.getCorrection(), 0.0f);
+}
@@ -0,0 +1,158 @@
+//--------------------------------------------------
+// BLDC Controller
+// encoderPllTest.cpp
+// Date: 2026-10-19
+//--------------------------------------------------
+#include "encoderPll.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr float DT = 1.0f / 24000;
+constexpr int32_t TURN = EncoderPll::COUNTS_PER_TURN;
+constexpr float RAD_PER_COUNT = 2 * float(M_PI) / TURN;
+
+// Feed a constant velocity from an unwrapped start position, returns the unwrapped position of the last sample
+int64_t ramp(EncoderPll& pll, int64_t position, int32_t step, size_t updates) {
+    for (size_t i = 0; i < updates; i++) {
+        position += step;
+        pll.update(uint16_t(position & (TURN - 1)), DT);
+    }
+    return position;
+}
+
+// Expect the estimate at the unwrapped position, turns must floor negative positions
+void expectPosition(const EncoderPll::State& s, int64_t position, float tolerance) {
+    int64_t turns = position >= 0 ? position / TURN : -((-position + TURN - 1) / TURN);
+    float angle = float(position - turns * TURN) * RAD_PER_COUNT;
+    float error = float(s.turns - turns) * 2 * float(M_PI) + s.angle - angle;
+    EXPECT_NEAR(error, 0.0f, tolerance);
+}
+
+} // namespace
+
+TEST(EncoderPll, UnwrapForward) {
+    // Crosses 16383 -> 0 every 164 updates
+    EncoderPll pll;
+    pll.reset(TURN - 20);
+    int64_t position = ramp(pll, TURN - 20, 100, 1000);
+    expectPosition(pll.predict(0.0f), position, 1e-3f);
+    EXPECT_EQ(pll.predict(0.0f).turns, 7);
+    EXPECT_NEAR(pll.predict(0.0f).velocity, 100 * RAD_PER_COUNT / DT, 1e-2f);
+}
+
+TEST(EncoderPll, UnwrapBackward) {
+    // Crosses 0 -> 16383 into negative turns
+    EncoderPll pll;
+    pll.reset(5);
+    int64_t position = ramp(pll, 5, -50, 1000);
+    ASSERT_EQ(position, -49995);
+    EncoderPll::State s = pll.predict(0.0f);
+    EXPECT_EQ(s.turns, -4);
+    EXPECT_NEAR(s.angle, 15541 * RAD_PER_COUNT, 1e-3f);
+    EXPECT_NEAR(s.velocity, -50 * RAD_PER_COUNT / DT, 1e-2f);
+}
+
+TEST(EncoderPll, SingleStepAcrossZero) {
+    // One count across the wrap in each direction
+    EncoderPll pll;
+    pll.reset(TURN - 1);
+    pll.update(0, DT);
+    EXPECT_GE(pll.predict(0.0f).turns, 0);
+    pll.reset(0);
+    pll.update(TURN - 1, DT);
+    EncoderPll::State s = pll.predict(0.0f);
+    EXPECT_EQ(s.turns, -1);
+    EXPECT_GT(s.angle, float(M_PI));
+}
+
+TEST(EncoderPll, BeyondInt32Counts) {
+    // 2^31 counts are 131072 turns, a quarter turn per update
+    EncoderPll pll;
+    pll.reset(0);
+    constexpr int32_t turns = 140000;
+    int64_t position = ramp(pll, 0, TURN / 4, size_t(turns) * 4 + 2);
+    EncoderPll::State s = pll.predict(0.0f);
+    EXPECT_EQ(s.turns, turns);
+    expectPosition(s, position, 1e-3f);
+    EXPECT_GT(s.velocity, 0.0f);
+}
+
+TEST(EncoderPll, Predict) {
+    EncoderPll pll;
+    pll.reset(0);
+    ramp(pll, 0, 40, 2000);
+    EncoderPll::State now = pll.predict(0.0f);
+    constexpr float LATENCY = 40e-6f;
+    EncoderPll::State ahead = pll.predict(LATENCY);
+    EXPECT_NEAR(ahead.angle - now.angle, now.velocity * LATENCY, 1e-5f);
+    EXPECT_EQ(ahead.turns, now.turns);
+
+    // Configured latency applies to getState()
+    EXPECT_EQ(pll.getState().angle, now.angle);
+    pll.setLatency(LATENCY);
+    EXPECT_EQ(pll.getLatency(), LATENCY);
+    EXPECT_EQ(pll.getState().angle, ahead.angle);
+
+    // Prediction of one turn ahead carries into the next turn
+    EncoderPll::State next = pll.predict(2 * float(M_PI) / now.velocity);
+    EXPECT_EQ(next.turns, now.turns + 1);
+    EXPECT_NEAR(next.angle, now.angle, 1e-3f);
+}
+
+TEST(EncoderPll, ConstantAcceleration) {
+    // Third order loop, no steady state error on a velocity ramp
+    EncoderPll pll;
+    pll.reset(0);
+    double position = 0.0;
+    double velocity = 0.0;
+    constexpr float ACC = 0.05f; // counts/update^2
+    for (size_t i = 0; i < 4000; i++) {
+        velocity += ACC;
+        position += velocity;
+        pll.update(uint16_t(int64_t(std::floor(position)) & (TURN - 1)), DT);
+    }
+    EncoderPll::State s = pll.predict(0.0f);
+    float expected = float(velocity) * RAD_PER_COUNT / DT;
+    EXPECT_NEAR(s.velocity, expected, 1e-3f * expected);
+    expected = ACC * RAD_PER_COUNT / (DT * DT);
+    EXPECT_NEAR(s.acceleration, expected, 0.02f * expected);
+}
+
+TEST(EncoderPll, BandwidthStepResponse) {
+    // Velocity step from rest, the settling time scales with 1/bandwidth
+    auto settle = [](float bandwidth) {
+        EncoderPll pll;
+        pll.setBandwidth(bandwidth);
+        EXPECT_EQ(pll.getBandwidth(), bandwidth);
+        pll.reset(0);
+        int64_t position = 0;
+        float target = 30 * RAD_PER_COUNT / DT;
+        size_t settled = 0;
+        for (size_t i = 1; i <= 2000; i++) {
+            position = ramp(pll, position, 30, 1);
+            if (std::fabs(pll.predict(0.0f).velocity - target) > 0.02f * target)
+                settled = i;
+        }
+        EXPECT_NEAR(pll.predict(0.0f).velocity, target, 1e-3f * target);
+        return settled;
+    };
+    size_t slow = settle(500.0f);
+    size_t fast = settle(1000.0f);
+    EXPECT_GT(fast, 0u);
+    EXPECT_NEAR(float(slow) / fast, 2.0f, 0.4f);
+}
+
+TEST(EncoderPll, DtJitter) {
+    // Measured dt with +-0.5% jitter, the estimate follows the real time between samples
+    EncoderPll pll;
+    pll.reset(0);
+    constexpr float VELOCITY = 60 / DT; // counts/s
+    double position = 0.0;
+    for (size_t i = 0; i < 4000; i++) {
+        float dt = DT * (i % 3 == 0 ? 1.005f : (i % 3 == 1 ? 0.995f : 1.0f));
+        position += VELOCITY * dt;
+        pll.update(uint16_t(int64_t(position) & (TURN - 1)), dt);
+    }
+    EXPECT_NEAR(pll.predict(0.0f).velocity, VELOCITY * RAD_PER_COUNT, 1e-3f * VELOCITY * RAD_PER_COUNT);
+}
@@ -0,0 +1,71 @@
+//--------------------------------------------------
+// BLDC Controller
+// fluxObserverBenchmark.cpp
+// Date: 2026-10-19
+//--------------------------------------------------
+#include "fluxObserver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr uint32_t ITERATIONS = 1 << 20;
+constexpr uint32_t REPEATS = 4; // Speeds are interleaved and the best time is kept, so clock ramps and noise hit all of them
+constexpr float DT = 1.0f / 24000;
+
+// Observer inputs of a rotor at a constant electrical speed, generated before timing
+struct Inputs {
+    static constexpr uint32_t SIZE = 1024;
+    std::array<std::array<float, 3>, SIZE> currents;
+    std::array<std::array<float, 3>, SIZE> voltages;
+
+    explicit Inputs(float speed) {
+        for (uint32_t n = 0; n < SIZE; n++)
+            for (size_t k = 0; k < 3; k++) {
+                float theta = speed * n * DT - k * (2 * float(M_PI) / 3);
+                currents[n][k] = 0.1f * std::sin(theta);
+                voltages[n][k] = (0.002f * speed + 0.5f) * std::sin(theta);
+            }
+    }
+};
+
+// Mean time of one observer step in nanoseconds, the angle is accumulated so the calls are not optimized away
+double benchmark(const Inputs& inputs) {
+    FluxObserver observer;
+    volatile float sink = 0.0f;
+    float acc = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        observer.update(inputs.currents[i % Inputs::SIZE], inputs.voltages[i % Inputs::SIZE], DT);
+        acc += observer.blend(float(i % 8));
+    }
+    sink = acc;
+    (void)sink;
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+}
+
+} // namespace
+
+TEST(FluxObserverBenchmark, Update) {
+    FluxObserver::Config config = FluxObserver().getConfig();
+    const std::array<const char*, 3> names = {"Observer (encoder)", "Observer (blended)", "Observer (sensorless)"};
+    const std::array<Inputs, 3> inputs = {Inputs(0.5f * config.blendLow), Inputs(0.5f * (config.blendLow + config.blendHigh)),
+                                          Inputs(8.0f * config.blendHigh)};
+    std::array<double, 3> ns = {INFINITY, INFINITY, INFINITY};
+    for (uint32_t r = 0; r < REPEATS; r++)
+        for (size_t i = 0; i < inputs.size(); i++)
+            ns[i] = std::min(ns[i], benchmark(inputs[i]));
+    for (size_t i = 0; i < inputs.size(); i++)
+        std::printf("%-24s %6.2f ns/call\n", names[i], ns[i]);
+    RecordProperty("encoderNs", std::to_string(ns[0]));
+    RecordProperty("blendedNs", std::to_string(ns[1]));
+    RecordProperty("sensorlessNs", std::to_string(ns[2]));
+
+    // Fixed cost (no loops), the step must not get slower with speed and must fit in the current loop
+    double fastest = *std::min_element(ns.begin(), ns.end());
+    double slowest = *std::max_element(ns.begin(), ns.end());
+    EXPECT_LT(slowest, 1.5 * fastest);
+    EXPECT_LT(slowest, 0.01 * DT * 1e9);
+}
@@ -0,0 +1,149 @@
+//--------------------------------------------------
+// BLDC Controller
+// fluxObserverTest.cpp
+// Date: 2026-10-19
+//--------------------------------------------------
+#include "fluxObserver.h"
+#include "motor.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr float DT = 1.0f / 24000;      // Observer is called once per PWM period
+constexpr float RAMP = 0.25f;           // Time accelerating to the swept speed, so the PLL does not have to pull in (s)
+constexpr float SETTLE = 0.5f;          // Time for the flux estimate and the PLL to converge (s)
+constexpr float DURATION = 1.0f;        // Simulated time per speed (s), errors are measured after SETTLE
+constexpr float CURRENT_VOLTAGE = 0.5f; // Voltage on top of the back-EMF feedforward (q axis current)
+constexpr float ENCODER_RESOLUTION = 2 * M_PI / (1 << 14);
+constexpr float R = 3.6f;       // Phase resistance
+constexpr float L = 1e-3f;      // Phase inductance
+constexpr float LAMBDA = 0.02f; // Flux linkage of the motor model (per mechanical rad/s)
+constexpr float P = Controller::NUM_POLES;
+
+// Wrap angle to [-pi, pi)
+float wrap(float angle) {
+    angle = std::fmod(angle, 2 * float(M_PI));
+    if (angle < -M_PI)
+        angle += 2 * M_PI;
+    if (angle >= M_PI)
+        angle -= 2 * M_PI;
+    return angle;
+}
+
+// Observer matched to the motor model
+FluxObserver makeObserver() {
+    FluxObserver observer;
+    FluxObserver::Config config = observer.getConfig();
+    config.resistance = R;
+    config.inductance = L;
+    config.fluxLinkage = LAMBDA / (P / 2);
+    config.gain = 100.0f / (config.fluxLinkage * config.fluxLinkage);
+    config.pllBandwidth = 200.0f;
+    observer.setConfig(config);
+    return observer;
+}
+
+struct SweepResult {
+    float angleError; // RMS observer angle error (degrees)
+    float blendError; // RMS blended angle error with a 14-bit encoder (degrees)
+    float speedError; // Mean observer speed error (%)
+    float flux;       // Rotor flux angle at the end (rad)
+    float encoder;    // Encoder electrical angle at the end (rad)
+};
+
+// Rotor driven at a constant electrical speed (very large inertia), errors measured after the observer settled
+SweepResult sweep(FluxObserver& observer, float speed) {
+    Motor motor(R, L, 1e6f, 0.0f, P, LAMBDA);
+    SweepResult result{};
+    float angleError = 0.0f;
+    float blendError = 0.0f;
+    float observerSpeed = 0.0f;
+    float startPosition = 0.0f;
+    size_t measured = 0;
+    for (float t = 0.0f; t < DURATION; t += DT) {
+        float w = speed * std::min(t / RAMP, 1.0f);
+        motor.setVelocity(w / (P / 2));
+
+        // Back-EMF feedforward plus a small voltage in phase with it, so the observer also sees the resistive and inductive drops
+        float theta = motor.getPosition();
+        float magnitude = LAMBDA / (P / 2) * w + CURRENT_VOLTAGE;
+        atta::vec3 v;
+        for (size_t k = 0; k < 3; k++)
+            v[k] = magnitude * std::sin(theta - k * (2 * M_PI / 3));
+        motor.update(v, 0.0f, DT);
+
+        atta::vec3 i = motor.getCurrent();
+        observer.update({i[0], i[1], i[2]}, {v[0], v[1], v[2]}, DT);
+        if (t < SETTLE)
+            continue;
+        if (!measured)
+            startPosition = motor.getPosition();
+
+        // Model back-EMF is sin(theta), so its rotor flux points at theta + pi. The encoder angle is quantized to 14 bits per mechanical turn
+        result.flux = std::fmod(motor.getPosition() + float(M_PI), 2 * float(M_PI));
+        float mechanical = std::floor(motor.getPosition() / (P / 2) / ENCODER_RESOLUTION) * ENCODER_RESOLUTION;
+        result.encoder = std::fmod(mechanical * (P / 2) + float(M_PI), 2 * float(M_PI));
+        float err = wrap(observer.getAngle() - result.flux) * 180.0f / M_PI;
+        float blendErr = wrap(observer.blend(result.encoder) - result.flux) * 180.0f / M_PI;
+        angleError += err * err;
+        blendError += blendErr * blendErr;
+        observerSpeed += observer.getSpeed();
+        measured++;
+    }
+
+    // Speed from the simulated angle, the float rotor position rounds every substep so it differs from the set speed
+    float simSpeed = (motor.getPosition() - startPosition) / ((measured - 1) * DT);
+    result.angleError = std::sqrt(angleError / measured);
+    result.blendError = std::sqrt(blendError / measured);
+    result.speedError = (observerSpeed / measured - simSpeed) / simSpeed * 100.0f;
+    return result;
+}
+
+} // namespace
+
+TEST(FluxObserver, SweepBlendRange) {
+    // The 14-bit encoder is within 0.1 electrical degrees, the blended angle must not be worse than the observer
+    FluxObserver::Config config = makeObserver().getConfig();
+    for (float speed : {config.blendLow, 0.75f * config.blendLow + 0.25f * config.blendHigh, 0.5f * (config.blendLow + config.blendHigh),
+                        config.blendHigh, 2.0f * config.blendHigh}) {
+        FluxObserver observer = makeObserver();
+        SweepResult result = sweep(observer, speed);
+        EXPECT_LT(result.angleError, 0.5f) << "at " << speed << " rad/s";
+        EXPECT_LT(result.blendError, 0.5f) << "at " << speed << " rad/s";
+        EXPECT_LT(std::fabs(result.speedError), 0.1f) << "at " << speed << " rad/s";
+    }
+}
+
+TEST(FluxObserver, Blend) {
+    FluxObserver::Config config = makeObserver().getConfig();
+    constexpr float OFFSET = 0.2f; // Encoder angle error, so the blend weight is visible
+
+    // Encoder only at blendLow and below
+    for (float speed : {0.5f * config.blendLow, 0.98f * config.blendLow}) {
+        FluxObserver observer = makeObserver();
+        SweepResult result = sweep(observer, speed);
+        float encoder = std::fmod(result.encoder + OFFSET, 2 * float(M_PI));
+        EXPECT_EQ(observer.blend(encoder), encoder) << "at " << speed << " rad/s";
+    }
+
+    // Halfway along the short arc at the middle of the range (the PLL speed ripple moves the weight a little). Large
+    // offsets put the encoder on the other side of 0, the result must stay in [0, 2pi)
+    FluxObserver observer = makeObserver();
+    sweep(observer, 0.5f * (config.blendLow + config.blendHigh));
+    for (float offset : {-3.0f, -1.5f, -OFFSET, OFFSET, 1.5f, 3.0f}) {
+        float encoder = std::fmod(observer.getAngle() + offset + 2 * float(M_PI), 2 * float(M_PI));
+        float blended = observer.blend(encoder);
+        EXPECT_GE(blended, 0.0f);
+        EXPECT_LT(blended, 2 * float(M_PI));
+        EXPECT_NEAR(wrap(blended - observer.getAngle()), 0.5f * offset, 0.01f * std::fabs(offset)) << "offset " << offset;
+    }
+
+    // Observer only at blendHigh and above, and without an encoder
+    for (float speed : {1.02f * config.blendHigh, 2.0f * config.blendHigh}) {
+        observer = makeObserver();
+        SweepResult result = sweep(observer, speed);
+        float encoder = std::fmod(result.encoder + OFFSET, 2 * float(M_PI));
+        EXPECT_EQ(observer.blend(encoder), observer.getAngle()) << "at " << speed << " rad/s";
+        EXPECT_EQ(observer.blend(NAN), observer.getAngle());
+    }
+}
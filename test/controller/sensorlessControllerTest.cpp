@@ -0,0 +1,164 @@
+//--------------------------------------------------
+// BLDC Controller
+// sensorlessControllerTest.cpp
+// Date: 2026-10-19
+//--------------------------------------------------
+#include "motor.h"
+#include "sensorlessController.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+using Stage = SensorlessController::Stage;
+
+constexpr float DT = 1.0f / 24000; // Controller is called once per PWM period
+constexpr float V = 7.8f;          // Supply voltage
+constexpr float TL = 1e-3f;        // Load torque
+
+// Six-step inverter driving the motor model of the simulation. Small gimbal motor, the parameters of the simulation
+// project are placeholders with a back-EMF above the supply at the ramp end speed
+class Plant {
+  public:
+    Plant() : _motor(3.6f, 1e-3f, 1e-4f, 1e-4f, Controller::NUM_POLES, 0.02f) {}
+
+    // Terminal voltages as measured by the phase voltage ADCs (star point at half supply when two phases are driven)
+    Controller::State state() const {
+        atta::vec3 emf = _motor.getEMF();
+        auto terminal = [&](bool h, bool l, int i) { return h ? V : (l ? 0.0f : emf[i] + V / 2); };
+        Controller::State x;
+        x.voltage = V;
+        x.currents = {_motor.getCurrent()[0], _motor.getCurrent()[1], _motor.getCurrent()[2]};
+        x.theta = NAN;
+        x.velocity = NAN;
+        x.phaseVoltages = {terminal(_output.uh, _output.ul, 0), terminal(_output.vh, _output.vl, 1), terminal(_output.wh, _output.wl, 2)};
+        return x;
+    }
+
+    void update(const Controller::Output& output) {
+        _output = output;
+        auto drive = [](bool h, bool l) { return h ? V : (l ? 0.0f : -1.0f); }; // -1 is a floating phase
+        _motor.update({drive(output.uh, output.ul), drive(output.vh, output.vl), drive(output.wh, output.wl)}, TL, DT);
+    }
+
+    // Commutation angle error, the ideal commutation is 30 electrical degrees after the back-EMF zero crossing (degrees)
+    float commutationError() const {
+        float err = std::fmod(_motor.getPosition() - float(M_PI) / 6, float(M_PI) / 3);
+        if (err < 0.0f)
+            err += M_PI / 3;
+        if (err >= M_PI / 6)
+            err -= M_PI / 3;
+        return err * 180.0f / M_PI;
+    }
+
+    Motor& motor() { return _motor; }
+
+  private:
+    Motor _motor;
+    Controller::Output _output;
+};
+
+const Controller::Control start = {NAN, 0.0f, NAN};
+const Controller::Control release = {NAN, NAN, NAN};
+
+// Run the closed loop for a duration
+void run(SensorlessController& controller, Plant& plant, float duration) {
+    for (float t = 0.0f; t < duration; t += DT)
+        plant.update(controller.control(plant.state(), start, DT));
+}
+
+} // namespace
+
+TEST(SensorlessController, StartUp) {
+    SensorlessController controller;
+    Plant plant;
+    const SensorlessController::Config& config = controller.getConfig();
+
+    // Align holds the last step
+    plant.update(controller.control(plant.state(), start, DT));
+    EXPECT_EQ(controller.getStage(), Stage::ALIGN);
+    EXPECT_EQ(controller.getStep(), 5);
+    run(controller, plant, config.alignTime - 2 * DT);
+    EXPECT_EQ(controller.getStage(), Stage::ALIGN);
+
+    // Open-loop ramp, locks in after consecutive zero crossings
+    size_t rampSteps = 0;
+    float t = 0.0f;
+    while (controller.getStage() != Stage::RUN && t < 1.0f) {
+        plant.update(controller.control(plant.state(), start, DT));
+        rampSteps += controller.hasCommutated();
+        if (t == 0.0f)
+            EXPECT_EQ(controller.getStage(), Stage::RAMP);
+        t += DT;
+    }
+    ASSERT_EQ(controller.getStage(), Stage::RUN);
+    EXPECT_GE(rampSteps, config.lockInSteps);
+
+    // Let the step period filter settle, then measure one second of closed-loop commutations
+    run(controller, plant, 1.0f);
+    float sum = 0.0f;
+    float early = 0.0f;
+    float late = 0.0f;
+    size_t steps = 0;
+    for (t = 0.0f; t < 1.0f; t += DT) {
+        plant.update(controller.control(plant.state(), start, DT));
+        ASSERT_EQ(controller.getStage(), Stage::RUN);
+        if (controller.hasCommutated()) {
+            // Zero crossings are detected on PWM samples of the previous period, bound the error in PWM periods
+            float err = plant.commutationError();
+            float pwmAngle = plant.motor().getVelocity() * Controller::NUM_POLE_PAIRS * DT * 180.0f / M_PI;
+            sum += err * err;
+            early = std::min(early, err / pwmAngle);
+            late = std::max(late, err / pwmAngle);
+            steps++;
+        }
+    }
+    ASSERT_GT(steps, 500u);
+    EXPECT_LT(std::sqrt(sum / steps), 5.0f);
+    EXPECT_GT(early, -1.0f);
+    EXPECT_LT(late, 3.5f);
+    EXPECT_NEAR(controller.getVelocity(), plant.motor().getVelocity(), 0.05f * plant.motor().getVelocity());
+}
+
+TEST(SensorlessController, RestartOnLostZeroCrossing) {
+    SensorlessController controller;
+    Plant plant;
+    run(controller, plant, 2.0f);
+    ASSERT_EQ(controller.getStage(), Stage::RUN);
+
+    // Rotor blocked, no back-EMF. The controller must go back to align two step periods after the last commutation
+    float stepPeriod = controller.getStepPeriod();
+    size_t periods = 0;
+    while (controller.getStage() == Stage::RUN && periods < 1000) {
+        plant.motor().setVelocity(0.0f);
+        plant.update(controller.control(plant.state(), start, DT));
+        periods++;
+    }
+    EXPECT_EQ(controller.getStage(), Stage::ALIGN);
+    EXPECT_EQ(controller.getStep(), 5);
+    EXPECT_LE(periods * DT, 3 * stepPeriod);
+
+    // Without back-EMF the ramp never locks in
+    for (float t = 0.0f; t < 1.0f; t += DT) {
+        plant.motor().setVelocity(0.0f);
+        plant.update(controller.control(plant.state(), start, DT));
+        ASSERT_NE(controller.getStage(), Stage::RUN);
+    }
+    EXPECT_EQ(controller.getStage(), Stage::RAMP);
+}
+
+TEST(SensorlessController, Release) {
+    SensorlessController controller;
+    Plant plant;
+    run(controller, plant, 1.0f);
+    ASSERT_EQ(controller.getStage(), Stage::RUN);
+
+    Controller::Output output = controller.control(plant.state(), release, DT);
+    EXPECT_EQ(controller.getStage(), Stage::IDLE);
+    EXPECT_EQ(controller.getVelocity(), 0.0f);
+    EXPECT_FALSE(output.uh || output.ul || output.vh || output.vl || output.wh || output.wl);
+
+    // Starting again aligns first
+    controller.control(plant.state(), start, DT);
+    EXPECT_EQ(controller.getStage(), Stage::ALIGN);
+}
@@ -0,0 +1,45 @@
+//--------------------------------------------------
+// BLDC Controller
+// trapezoidalControllerBenchmark.cpp
+// Date: 2026-10-19
+//--------------------------------------------------
+#include "trapezoidalControllerReference.h"
+#include <chrono>
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr uint32_t ITERATIONS = 1 << 24;
+
+// Mean time of one call in nanoseconds, the outputs are accumulated so the calls are not optimized away
+template <typename Function>
+double benchmark(const char* name, Function function) {
+    volatile uint32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        Controller::Output o = function(uint16_t((i * 2654435761u) >> 18)); // Scrambled counts defeat the branch predictor
+        acc += o.uh + 2 * o.vh + 4 * o.wh + 8 * o.ul;
+    }
+    sink = acc;
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+    std::printf("%-24s %6.2f ns/call\n", name, ns);
+    (void)sink;
+    return ns;
+}
+
+} // namespace
+
+TEST(TrapezoidalControllerBenchmark, Commutation) {
+    TrapezoidalController controller;
+    uint8_t polePairs = TrapezoidalController::NUM_POLE_PAIRS;
+    uint16_t offset = controller.getOffset();
+    constexpr float RAD_PER_COUNT = 2 * M_PI / TrapezoidalController::COUNTS_PER_TURN;
+
+    double fixedPoint = benchmark("Fixed point commutate", [&](uint16_t counts) { return controller.commutate(counts); });
+    double floatingPoint =
+        benchmark("Float commutation", [&](uint16_t counts) { return referenceCommutateFloat(counts * RAD_PER_COUNT, polePairs, offset); });
+    RecordProperty("fixedPointNs", std::to_string(fixedPoint));
+    RecordProperty("floatNs", std::to_string(floatingPoint));
+    EXPECT_LT(fixedPoint, floatingPoint);
+}
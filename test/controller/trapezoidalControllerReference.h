@@ -0,0 +1,42 @@
+//--------------------------------------------------
+// BLDC Controller
+// trapezoidalControllerReference.h
+// Date: 2026-10-19
+//--------------------------------------------------
+#ifndef BLDC_TEST_TRAPEZOIDAL_CONTROLLER_REFERENCE_H
+#define BLDC_TEST_TRAPEZOIDAL_CONTROLLER_REFERENCE_H
+#include <trapezoidalController.h>
+
+// Floating point commutation, as TrapezoidalController::control() computed it before the fixed point angle
+
+inline uint8_t referenceSector(uint16_t counts, uint8_t numPoles, uint16_t offset) {
+    double theta = counts * (2 * M_PI / TrapezoidalController::COUNTS_PER_TURN) * (numPoles / 2); // Electrical angle
+    theta = std::fmod(theta, 2 * M_PI);
+    double section = theta / (2 * M_PI / 6) + offset * (6.0 / 65536.0);
+    if (section >= 6.0)
+        section -= 6.0;
+    return uint8_t(section);
+}
+
+inline Controller::Output referenceCommutate(uint16_t counts, uint8_t numPoles, uint16_t offset) {
+    static const Controller::Output commutations[6] = {
+        {HIGH, LOW, Z}, {HIGH, Z, LOW}, {Z, HIGH, LOW}, {LOW, HIGH, Z}, {LOW, Z, HIGH}, {Z, LOW, HIGH},
+    };
+    return commutations[referenceSector(counts, numPoles, offset)];
+}
+
+// Single precision float path, as it runs on the microcontroller
+inline Controller::Output referenceCommutateFloat(float theta, uint8_t polePairs, uint16_t offset) {
+    static const Controller::Output commutations[6] = {
+        {HIGH, LOW, Z}, {HIGH, Z, LOW}, {Z, HIGH, LOW}, {LOW, HIGH, Z}, {LOW, Z, HIGH}, {Z, LOW, HIGH},
+    };
+    theta = std::fmod(theta * polePairs, float(2 * M_PI));
+    if (theta < 0)
+        theta += 2 * M_PI;
+    float section = theta / float(2 * M_PI / 6) + offset * (6.0f / 65536.0f);
+    if (section >= 6.0f)
+        section -= 6.0f;
+    return commutations[int(section)];
+}
+
+#endif // BLDC_TEST_TRAPEZOIDAL_CONTROLLER_REFERENCE_H
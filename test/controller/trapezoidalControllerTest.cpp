@@ -0,0 +1,61 @@
+//--------------------------------------------------
+// BLDC Controller
+// trapezoidalControllerTest.cpp
+// Date: 2026-10-19
+//--------------------------------------------------
+#include "trapezoidalControllerReference.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr uint8_t POLES[] = {2, 4, 8, 14, 28};
+constexpr uint16_t OFFSETS[] = {0, 1, 10922, 10923, TrapezoidalController::DEFAULT_OFFSET, 65535};
+
+bool operator==(const Controller::Output& a, const Controller::Output& b) {
+    return a.ul == b.ul && a.uh == b.uh && a.vl == b.vl && a.vh == b.vh && a.wl == b.wl && a.wh == b.wh;
+}
+
+} // namespace
+
+TEST(TrapezoidalController, IntegerMatchesFloatEverywhere) {
+    // Every count of every configuration, the fixed point sector must be exact (the 8-bit sector table was not)
+    TrapezoidalController controller;
+    for (uint8_t poles : POLES)
+        for (uint16_t offset : OFFSETS) {
+            controller.setNumPoles(poles);
+            controller.setOffset(offset);
+            int mismatches = 0;
+            for (uint32_t counts = 0; counts < TrapezoidalController::COUNTS_PER_TURN; counts++)
+                if (!(controller.commutate(counts) == referenceCommutate(counts, poles, offset)))
+                    mismatches++;
+            EXPECT_EQ(mismatches, 0) << "poles " << int(poles) << ", offset " << offset;
+        }
+}
+
+TEST(TrapezoidalController, SectorBoundaries) {
+    // 7 pole pairs: one electrical turn is 16384 / 7 counts, the sector changes every 390.1 counts
+    TrapezoidalController controller;
+    controller.setOffset(0);
+    uint8_t last = referenceSector(0, TrapezoidalController::NUM_POLES, 0);
+    int changes = 0;
+    for (uint32_t counts = 1; counts < TrapezoidalController::COUNTS_PER_TURN; counts++) {
+        uint8_t sector = referenceSector(counts, TrapezoidalController::NUM_POLES, 0);
+        if (sector != last) {
+            changes++;
+            EXPECT_TRUE(controller.commutate(counts) == referenceCommutate(counts, TrapezoidalController::NUM_POLES, 0));
+            EXPECT_TRUE(controller.commutate(counts - 1) == referenceCommutate(counts - 1, TrapezoidalController::NUM_POLES, 0));
+        }
+        last = sector;
+    }
+    EXPECT_EQ(changes, 6 * TrapezoidalController::NUM_POLE_PAIRS - 1); // Last change is at the wrap
+}
+
+TEST(TrapezoidalController, ControlQuantizesToCounts) {
+    TrapezoidalController controller;
+    for (int turn : {-3, 0, 5})
+        for (uint32_t counts = 0; counts < TrapezoidalController::COUNTS_PER_TURN; counts += 7) {
+            Controller::State s{};
+            s.theta = (turn + (counts + 0.5) / TrapezoidalController::COUNTS_PER_TURN) * 2 * M_PI;
+            EXPECT_TRUE(controller.control(s, {}, 0.0f) == controller.commutate(counts)) << "counts " << counts << ", turn " << turn;
+        }
+}
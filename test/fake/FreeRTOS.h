@@ -0,0 +1,37 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// FreeRTOS.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_TEST_FAKE_FREERTOS_H
+#define BLDC_TEST_FAKE_FREERTOS_H
+#include <stdint.h>
+
+//---------------------------------//
+//---------- Description ----------//
+//---------------------------------//
+// Subset of the FreeRTOS API used by the drivers, the host tests run without a scheduler. Task notifications are
+// counted per handle so the tests can check which task a completion wakes. Created tasks are run on the test thread
+// by FakeRtos::runTask(), the blocking calls advance the tick count instead of waiting
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef struct FakeTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFu)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+#define portSET_INTERRUPT_MASK_FROM_ISR() __get_PRIMASK(); __disable_irq()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(mask) __set_PRIMASK(mask)
+#define portYIELD_FROM_ISR(woken) ((void)(woken))
+#define taskENTER_CRITICAL() __disable_irq()
+#define taskEXIT_CRITICAL() __enable_irq()
+
+#endif // BLDC_TEST_FAKE_FREERTOS_H
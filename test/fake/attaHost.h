@@ -0,0 +1,45 @@
+//--------------------------------------------------
+// BLDC Simulation
+// attaHost.h
+// Date: 2026-10-19
+//--------------------------------------------------
+#ifndef BLDC_TEST_FAKE_ATTA_HOST_H
+#define BLDC_TEST_FAKE_ATTA_HOST_H
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+//---------------------------------//
+//---------- Description ----------//
+//---------------------------------//
+// Forced include of the simulation plant in the host tests (-include), replaces the atta vector type used by the
+// motor model so it compiles without the atta engine. Only the operations the model uses are implemented
+
+namespace atta {
+
+struct vec3 {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+
+    vec3() = default;
+    vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+    float& operator[](size_t i) { return i == 0 ? x : (i == 1 ? y : z); }
+    float operator[](size_t i) const { return i == 0 ? x : (i == 1 ? y : z); }
+
+    vec3& operator+=(const vec3& o) {
+        x += o.x;
+        y += o.y;
+        z += o.z;
+        return *this;
+    }
+    vec3 operator+(const vec3& o) const { return {x + o.x, y + o.y, z + o.z}; }
+    vec3 operator-(const vec3& o) const { return {x - o.x, y - o.y, z - o.z}; }
+    vec3 operator*(float s) const { return {x * s, y * s, z * s}; }
+    vec3 operator/(float s) const { return {x / s, y / s, z / s}; }
+};
+
+} // namespace atta
+
+#endif // BLDC_TEST_FAKE_ATTA_HOST_H
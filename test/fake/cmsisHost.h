@@ -0,0 +1,68 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// cmsisHost.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_TEST_FAKE_CMSIS_HOST_H
+#define BLDC_TEST_FAKE_CMSIS_HOST_H
+#include <stdint.h>
+
+//---------------------------------//
+//---------- Description ----------//
+//---------------------------------//
+// Forced include of the host tests (-include), replaces the CMSIS GCC intrinsics (ARM assembly) with host versions so
+// the firmware compiles with the real device and HAL headers. core_cm4.h includes cmsis_gcc.h from its own directory,
+// defining its include guard here is the only way to replace it
+//
+// The interrupt mask is a variable, the tests run the interrupt handlers from the test thread
+
+#define __CMSIS_GCC_H
+
+#define __ASM __asm
+#define __INLINE inline
+#define __STATIC_INLINE static inline
+#define __STATIC_FORCEINLINE static inline
+#define __NO_RETURN __attribute__((__noreturn__))
+#define __USED __attribute__((used))
+#define __WEAK __attribute__((weak))
+#define __PACKED __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x) __attribute__((aligned(x)))
+#define __RESTRICT __restrict
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+extern volatile uint32_t fakePrimask; // 1 while interrupts are masked
+#ifdef __cplusplus
+}
+#endif
+
+__STATIC_INLINE uint32_t __get_PRIMASK(void) { return fakePrimask; }
+__STATIC_INLINE void __set_PRIMASK(uint32_t priMask) { fakePrimask = priMask; }
+__STATIC_INLINE void __disable_irq(void) { fakePrimask = 1; }
+__STATIC_INLINE void __enable_irq(void) { fakePrimask = 0; }
+__STATIC_INLINE uint32_t __get_IPSR(void) { return 0; }
+__STATIC_INLINE uint32_t __get_BASEPRI(void) { return 0; }
+__STATIC_INLINE void __set_BASEPRI(uint32_t basePri) { (void)basePri; }
+__STATIC_INLINE void __ISB(void) { __sync_synchronize(); }
+__STATIC_INLINE void __DSB(void) { __sync_synchronize(); }
+__STATIC_INLINE void __DMB(void) { __sync_synchronize(); }
+__STATIC_INLINE uint32_t __REV(uint32_t value) { return __builtin_bswap32(value); }
+__STATIC_INLINE uint32_t __REV16(uint32_t value) { return (value & 0xFF00FF00u) >> 8 | (value & 0x00FF00FFu) << 8; }
+__STATIC_INLINE uint32_t __RBIT(uint32_t value) {
+    uint32_t result = 0;
+    for (int i = 0; i < 32; i++)
+        result |= ((value >> i) & 1u) << (31 - i);
+    return result;
+}
+#define __CLZ (uint8_t) __builtin_clz
+#define __NOP() ((void)0)
+#define __WFI() ((void)0)
+#define __WFE() ((void)0)
+#define __SEV() ((void)0)
+#define __BKPT(value) ((void)0)
+
+#endif // BLDC_TEST_FAKE_CMSIS_HOST_H
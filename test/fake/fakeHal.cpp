@@ -0,0 +1,525 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// fakeHal.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "fakeHal.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <map>
+#include <string>
+#include <common/attaConnector.h>
+#include <drivers/hardware.h>
+#include <drivers/motor/motor.h>
+#include <drivers/storage/storage.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <vector>
+#include <utils/profiler.h>
+
+volatile uint32_t fakePrimask = 0;
+uint32_t SystemCoreClock = 144000000;
+
+namespace FakeHal {
+
+// Address ranges accessed through the CMSIS/HAL register definitions
+struct Region {
+    uintptr_t base;
+    size_t size;
+};
+constexpr std::array<Region, 2> regions{
+    Region{PERIPH_BASE, 0x80000}, // APB1, APB2 and AHB1 (GPIO, RCC, DMA, SPI, timers)
+    Region{ITM_BASE, 0x100000},   // Private peripheral bus (ITM, DWT, SCB)
+};
+
+struct SpiState {
+    SPI_HandleTypeDef* hspi;
+    Exchange exchange;
+    void* context;
+    bool pending;
+    Transfer transfer;
+    uint32_t transfers;
+    uint32_t aborts;
+};
+std::array<SpiState, 4> _spis{};
+std::array<DMA_Stream_TypeDef, 2 * size_t(Spi::Peripheral::NUM)> _dmaStreams{};
+std::array<Dma::Handle, 2 * size_t(Spi::Peripheral::NUM)> _dmaHandles{};
+bool _autoComplete = false;
+uint32_t _tick = 0;
+std::array<Timer::Callback, 15> _timerCallbacks{};
+std::array<float, 15> _updatePeriods{};
+std::array<Gpio::Callback, 16> _gpioCallbacks{}; // EXTI lines
+bool _zeroVector = true;
+std::map<Storage::Id, std::vector<uint8_t>> _records; // Storage records, the flash sector is not mapped
+std::map<uint8_t, std::vector<uint8_t>> _commands;    // Last command of each id sent to the connector
+
+// Registers protected while recording, every access traps and the instruction is single stepped
+struct Recording {
+    Region region;
+    bool enabled;
+};
+Recording _gpio{{GPIOA_BASE, GPIOH_BASE + 0x400 - GPIOA_BASE}, false};
+Recording _itm{{ITM_BASE, 0x1000}, false};
+Recording* _stepping = nullptr; // Region of the instruction being stepped
+constexpr uint8_t NUM_PORTS = uint8_t(Gpio::Port::G) + 1;
+constexpr uint32_t ITM_IDLE = 0x100; // Stimulus port 0 before a step: FIFO ready, no character
+std::vector<GpioWrite> _gpioWrites;
+std::string _itmOutput;
+
+SpiState& getSpi(SPI_HandleTypeDef* hspi) {
+    for (SpiState& spi : _spis)
+        if (spi.hspi == hspi)
+            return spi;
+    for (SpiState& spi : _spis)
+        if (spi.hspi == nullptr) {
+            spi.hspi = hspi;
+            return spi;
+        }
+    std::fprintf(stderr, "FakeHal: too many SPI handles\n");
+    std::abort();
+}
+
+HAL_StatusTypeDef startTransfer(SPI_HandleTypeDef* hspi, const uint8_t* txData, uint8_t* rxData, uint16_t len) {
+    SpiState& spi = getSpi(hspi);
+    if (spi.pending)
+        return HAL_BUSY;
+    spi.pending = true;
+    spi.transfer = {txData, rxData, len};
+    spi.transfers++;
+    return HAL_OK;
+}
+
+// Transfer without DMA, completes immediately
+HAL_StatusTypeDef blockingTransfer(SPI_HandleTypeDef* hspi, const uint8_t* txData, uint8_t* rxData, uint16_t len) {
+    SpiState& spi = getSpi(hspi);
+    if (spi.pending)
+        return HAL_BUSY;
+    if (spi.exchange)
+        spi.exchange({txData, rxData, len}, spi.context);
+    return HAL_OK;
+}
+
+void protect(const Recording& recording, bool protect) {
+    void* address = reinterpret_cast<void*>(recording.region.base);
+    if (mprotect(address, recording.region.size, protect ? PROT_NONE : PROT_READ | PROT_WRITE) != 0) {
+        std::perror("FakeHal: failed to protect the recorded registers");
+        std::abort();
+    }
+}
+
+#if defined(__x86_64__)
+constexpr greg_t TRAP_FLAG = 0x100; // EFLAGS.TF, single step
+
+// Recorded register access: unprotect and run the instruction alone
+void registerAccess(int, siginfo_t* info, void* context) {
+    uintptr_t address = uintptr_t(info->si_addr);
+    _stepping = nullptr;
+    for (Recording* recording : {&_gpio, &_itm})
+        if (recording->enabled && address >= recording->region.base && address < recording->region.base + recording->region.size)
+            _stepping = recording;
+    if (_stepping == nullptr) {
+        std::signal(SIGSEGV, SIG_DFL); // Not a recorded register, fault again without the handler
+        return;
+    }
+    protect(*_stepping, false);
+    if (_stepping == &_itm)
+        ITM->PORT[0].u32 = ITM_IDLE;
+    static_cast<ucontext_t*>(context)->uc_mcontext.gregs[REG_EFL] |= TRAP_FLAG;
+}
+
+// Apply the BSRR writes to ODR as the port would
+void gpioStep() {
+    for (uint8_t port = 0; port < NUM_PORTS; port++) {
+        GPIO_TypeDef* gpio = reinterpret_cast<GPIO_TypeDef*>(GPIOA_BASE + port * (GPIOB_BASE - GPIOA_BASE));
+        uint32_t bsrr = gpio->BSRR;
+        if (bsrr == 0)
+            continue;
+        gpio->BSRR = 0; // Write only, reads as zero
+        for (uint8_t pin = 0; pin < 16; pin++) {
+            bool set = bsrr & (1u << pin);
+            bool reset = bsrr & (1u << (pin + 16));
+            if (!set && !reset)
+                continue;
+            // Set has priority over reset. The signal is raised by the store itself, never inside the allocator
+            _gpioWrites.push_back({{Gpio::Port(port), pin}, set});
+            gpio->ODR = set ? gpio->ODR | (1u << pin) : gpio->ODR & ~(1u << pin);
+        }
+    }
+}
+
+// Instruction done: handle the writes, then protect the registers again
+void registerStep(int, siginfo_t*, void* context) {
+    static_cast<ucontext_t*>(context)->uc_mcontext.gregs[REG_EFL] &= ~TRAP_FLAG;
+    if (_stepping == &_gpio)
+        gpioStep();
+    else if (ITM->PORT[0].u32 != ITM_IDLE)
+        _itmOutput += char(ITM->PORT[0].u8); // Character written to the stimulus port
+    protect(*_stepping, true);
+}
+#endif
+
+// Start or stop trapping the accesses to the registers of a recording
+bool record(Recording& recording, bool enabled) {
+#if defined(__x86_64__)
+    if (enabled == recording.enabled)
+        return true;
+    if (enabled && !_gpio.enabled && !_itm.enabled) {
+        struct sigaction action = {};
+        action.sa_flags = SA_SIGINFO;
+        action.sa_sigaction = registerAccess;
+        sigaction(SIGSEGV, &action, nullptr);
+        action.sa_sigaction = registerStep;
+        sigaction(SIGTRAP, &action, nullptr);
+    }
+    recording.enabled = enabled;
+    protect(recording, enabled);
+    if (!_gpio.enabled && !_itm.enabled) {
+        std::signal(SIGSEGV, SIG_DFL);
+        std::signal(SIGTRAP, SIG_DFL);
+    }
+    return true;
+#else
+    return !enabled;
+#endif
+}
+
+} // namespace FakeHal
+
+void FakeHal::reset() {
+    static bool mapped = false;
+    recordGpio(false);
+    recordItm(false);
+    for (const Region& region : regions) {
+        void* address = reinterpret_cast<void*>(region.base);
+        if (!mapped && mmap(address, region.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) != address) {
+            std::perror("FakeHal: failed to map the peripheral registers");
+            std::abort();
+        }
+        std::fill_n(reinterpret_cast<volatile uint8_t*>(region.base), region.size, 0);
+    }
+    mapped = true;
+    _spis = {};
+    _autoComplete = false;
+    _tick = 0;
+    _timerCallbacks = {};
+    _updatePeriods = {};
+    _gpioCallbacks = {};
+    _zeroVector = true;
+    _records.clear();
+    _commands.clear();
+    fakePrimask = 0;
+}
+
+void FakeHal::initSpi() {
+    if (!Spi::init()) {
+        std::fprintf(stderr, "FakeHal: failed to initialize SPI\n");
+        std::abort();
+    }
+    _dmaStreams = {};
+    _dmaHandles = {};
+    for (size_t i = 0; i < size_t(Spi::Peripheral::NUM); i++) {
+        _dmaHandles[2 * i].Instance = &_dmaStreams[2 * i];
+        _dmaHandles[2 * i + 1].Instance = &_dmaStreams[2 * i + 1];
+        Spi::linkDmaTx(Spi::Peripheral(i), &_dmaHandles[2 * i]);
+        Spi::linkDmaRx(Spi::Peripheral(i), &_dmaHandles[2 * i + 1]);
+    }
+}
+
+void FakeHal::setSpiDevice(SPI_HandleTypeDef* hspi, Exchange exchange, void* context) {
+    SpiState& spi = getSpi(hspi);
+    spi.exchange = exchange;
+    spi.context = context;
+}
+
+void FakeHal::setAutoComplete(bool autoComplete) { _autoComplete = autoComplete; }
+
+bool FakeHal::isPending(SPI_HandleTypeDef* hspi) { return getSpi(hspi).pending; }
+
+FakeHal::Transfer FakeHal::getPending(SPI_HandleTypeDef* hspi) { return getSpi(hspi).transfer; }
+
+bool FakeHal::completeTransfer(SPI_HandleTypeDef* hspi, bool success) {
+    SpiState& spi = getSpi(hspi);
+    if (!spi.pending)
+        return false;
+    // Peripheral is ready before the callback runs, so the callback can start the next transfer
+    spi.pending = false;
+    Transfer transfer = spi.transfer;
+    if (!success) {
+        HAL_SPI_ErrorCallback(hspi);
+        return true;
+    }
+    if (spi.exchange)
+        spi.exchange(transfer, spi.context);
+    if (transfer.txData && transfer.rxData)
+        HAL_SPI_TxRxCpltCallback(hspi);
+    else if (transfer.txData)
+        HAL_SPI_TxCpltCallback(hspi);
+    else
+        HAL_SPI_RxCpltCallback(hspi);
+    return true;
+}
+
+uint32_t FakeHal::getTransfers(SPI_HandleTypeDef* hspi) { return getSpi(hspi).transfers; }
+
+uint32_t FakeHal::getAborts(SPI_HandleTypeDef* hspi) { return getSpi(hspi).aborts; }
+
+bool FakeHal::completeDma(Dma::Handle* hdma, const void* data, bool success) {
+    DMA_Stream_TypeDef* stream = hdma->Instance;
+    if (hdma->State != HAL_DMA_STATE_BUSY)
+        return false;
+    if (!success) {
+        // Transfer errors disable the stream
+        stream->CR &= ~DMA_SxCR_EN;
+        hdma->State = HAL_DMA_STATE_READY;
+        hdma->ErrorCode = HAL_DMA_ERROR_TE;
+        if (hdma->XferErrorCallback)
+            hdma->XferErrorCallback(hdma);
+        return true;
+    }
+
+    bool doubleBuffer = stream->CR & DMA_SxCR_DBM;
+    bool target = doubleBuffer && (stream->CR & DMA_SxCR_CT);
+    if (data && hdma->Init.Direction == DMA_PERIPH_TO_MEMORY) {
+        size_t itemSize = 1u << (hdma->Init.MemDataAlignment >> DMA_SxCR_MSIZE_Pos);
+        std::memcpy(reinterpret_cast<void*>(uintptr_t(target ? stream->M1AR : stream->M0AR)), data, stream->NDTR * itemSize);
+    }
+    if (doubleBuffer)
+        stream->CR ^= DMA_SxCR_CT;
+    else if (hdma->Init.Mode == DMA_NORMAL) {
+        stream->CR &= ~DMA_SxCR_EN;
+        hdma->State = HAL_DMA_STATE_READY;
+    }
+
+    void (*callback)(Dma::Handle*) = target ? hdma->XferM1CpltCallback : hdma->XferCpltCallback;
+    if (callback)
+        callback(hdma);
+    return true;
+}
+
+void FakeHal::completeInjected(const std::array<uint16_t, 3>& samples) {
+    std::array<uintptr_t, 3> instances = {ADC1_BASE, ADC2_BASE, ADC3_BASE}; // system/hal.h undefines ADC1-3 (driver peripheral names)
+    for (size_t i = 0; i < samples.size(); i++)
+        reinterpret_cast<ADC_TypeDef*>(instances[i])->JDR1 = samples[i];
+    HAL_ADCEx_InjectedConvCpltCallback(Adc::getHandle(Adc::Peripheral::ADC1));
+}
+
+void FakeHal::setZeroVector(bool zeroVector) { _zeroVector = zeroVector; }
+
+void FakeHal::advanceCycles(uint32_t cycles) { DWT->CYCCNT = DWT->CYCCNT + cycles; }
+
+bool FakeHal::recordGpio(bool enabled) {
+    if (enabled)
+        _gpioWrites.clear();
+    return record(_gpio, enabled);
+}
+
+const std::vector<FakeHal::GpioWrite>& FakeHal::getGpioWrites() { return _gpioWrites; }
+
+bool FakeHal::recordItm(bool enabled) {
+    if (enabled) {
+        _itmOutput.clear();
+        ITM->TCR |= ITM_TCR_ITMENA_Msk;
+        ITM->TER |= 1;
+    }
+    return record(_itm, enabled);
+}
+
+std::string FakeHal::takeItm() { return std::move(_itmOutput); }
+
+bool FakeHal::getTransmitted(uint8_t cmdId, void* data, uint32_t size) {
+    auto command = _commands.find(cmdId);
+    if (command == _commands.end() || command->second.size() != size)
+        return false;
+    std::memcpy(data, command->second.data(), size);
+    return true;
+}
+
+void FakeHal::setUpdatePeriod(Timer::Timer timer, float period) {
+    if (timer < _updatePeriods.size())
+        _updatePeriods[timer] = period;
+}
+
+void FakeHal::fireTimerUpdate(Timer::Timer timer) {
+    if (timer < _timerCallbacks.size() && _timerCallbacks[timer])
+        _timerCallbacks[timer]();
+}
+
+void FakeHal::fireGpioInterrupt(Gpio::Gpio gpio) {
+    if (gpio.pin < _gpioCallbacks.size() && _gpioCallbacks[gpio.pin])
+        _gpioCallbacks[gpio.pin]();
+}
+
+//---------- HAL ----------//
+extern "C" {
+
+uint32_t HAL_GetTick() {
+    if (!FakeHal::_autoComplete)
+        return FakeHal::_tick++;
+    for (FakeHal::SpiState& spi : FakeHal::_spis)
+        if (spi.pending)
+            FakeHal::completeTransfer(spi.hspi);
+    return FakeHal::_tick;
+}
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* hspi) {
+    hspi->State = HAL_SPI_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_DeInit(SPI_HandleTypeDef* hspi) {
+    hspi->State = HAL_SPI_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t) {
+    return FakeHal::blockingTransfer(hspi, pData, nullptr, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t) {
+    return FakeHal::blockingTransfer(hspi, nullptr, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size, uint32_t) {
+    return FakeHal::blockingTransfer(hspi, pTxData, pRxData, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size) {
+    return FakeHal::startTransfer(hspi, pData, nullptr, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive_DMA(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size) {
+    return FakeHal::startTransfer(hspi, nullptr, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size) {
+    return FakeHal::startTransfer(hspi, pTxData, pRxData, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef* hspi) {
+    FakeHal::SpiState& spi = FakeHal::getSpi(hspi);
+    spi.pending = false;
+    spi.aborts++;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef* hdma) {
+    hdma->Instance->CR = hdma->Init.Channel | hdma->Init.Direction | hdma->Init.PeriphInc | hdma->Init.MemInc | hdma->Init.PeriphDataAlignment |
+                         hdma->Init.MemDataAlignment | hdma->Init.Mode | hdma->Init.Priority;
+    hdma->ErrorCode = HAL_DMA_ERROR_NONE;
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef* hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength) {
+    if (hdma->State != HAL_DMA_STATE_READY)
+        return HAL_BUSY;
+    DMA_Stream_TypeDef* stream = hdma->Instance;
+    stream->NDTR = DataLength;
+    stream->PAR = hdma->Init.Direction == DMA_MEMORY_TO_PERIPH ? DstAddress : SrcAddress;
+    stream->M0AR = hdma->Init.Direction == DMA_MEMORY_TO_PERIPH ? SrcAddress : DstAddress;
+    stream->CR |= DMA_SxCR_EN;
+    hdma->ErrorCode = HAL_DMA_ERROR_NONE;
+    hdma->State = HAL_DMA_STATE_BUSY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMAEx_MultiBufferStart_IT(DMA_HandleTypeDef* hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t SecondMemAddress,
+                                                uint32_t DataLength) {
+    if (hdma->State != HAL_DMA_STATE_READY)
+        return HAL_BUSY;
+    hdma->Instance->CR = (hdma->Instance->CR | DMA_SxCR_DBM) & ~DMA_SxCR_CT;
+    hdma->Instance->M1AR = SecondMemAddress;
+    return HAL_DMA_Start_IT(hdma, SrcAddress, DstAddress, DataLength);
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef* hdma) {
+    hdma->Instance->CR &= ~DMA_SxCR_EN;
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef* hadc) {
+    hadc->State = HAL_ADC_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_DeInit(ADC_HandleTypeDef* hadc) {
+    hadc->State = HAL_ADC_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef*, ADC_ChannelConfTypeDef*) { return HAL_OK; }
+
+HAL_StatusTypeDef HAL_ADCEx_InjectedConfigChannel(ADC_HandleTypeDef*, ADC_InjectionConfTypeDef*) { return HAL_OK; }
+
+HAL_StatusTypeDef HAL_ADCEx_MultiModeConfigChannel(ADC_HandleTypeDef*, ADC_MultiModeTypeDef*) { return HAL_OK; }
+
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef* hadc) {
+    hadc->Instance->CR2 |= ADC_CR2_ADON;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef* hadc) {
+    hadc->Instance->CR2 &= ~ADC_CR2_ADON;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_InjectedStart_IT(ADC_HandleTypeDef* hadc) {
+    hadc->Instance->CR2 |= ADC_CR2_ADON;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_InjectedStop_IT(ADC_HandleTypeDef*) { return HAL_OK; }
+
+} // extern "C"
+
+//---------- Drivers ----------//
+void Timer::setUpdateCallback(Timer timer, Callback callback) {
+    if (timer < FakeHal::_timerCallbacks.size())
+        FakeHal::_timerCallbacks[timer] = callback;
+}
+
+float Timer::getUpdatePeriod(Timer timer) { return timer < FakeHal::_updatePeriods.size() ? FakeHal::_updatePeriods[timer] : 0.0f; }
+
+void Gpio::setInterruptCallback(Gpio gpio, Callback callback) {
+    if (gpio.pin < FakeHal::_gpioCallbacks.size())
+        FakeHal::_gpioCallbacks[gpio.pin] = callback;
+}
+
+bool AttaConnector::transmit(uint8_t cmdId, uint8_t* data, uint32_t size) {
+    FakeHal::_commands[cmdId].assign(data, data + size);
+    return true;
+}
+
+bool Motor::isZeroVector() const { return FakeHal::_zeroVector; }
+
+bool Storage::load(Id id, void* data, uint16_t size) {
+    auto record = FakeHal::_records.find(id);
+    if (record == FakeHal::_records.end() || record->second.size() != size)
+        return false;
+    std::memcpy(data, record->second.data(), size);
+    return true;
+}
+
+bool Storage::store(Id id, const void* data, uint16_t size) {
+    if (size > MAX_RECORD_SIZE)
+        return false;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    FakeHal::_records[id].assign(bytes, bytes + size);
+    return true;
+}
+
+void Hardware::delay(float s) { FakeHal::advanceCycles(uint32_t(s * SystemCoreClock)); }
+
+void Hardware::delayMs(uint32_t ms) { FakeHal::advanceCycles(ms * (SystemCoreClock / 1000)); }
+
+void Hardware::delayUs(uint32_t us) { FakeHal::advanceCycles(us * (SystemCoreClock / 1000000)); }
+
+void Profiler::begin(Probe) {}
+
+void Profiler::end(Probe) {}
@@ -0,0 +1,168 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// fakeHal.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_TEST_FAKE_FAKE_HAL_H
+#define BLDC_TEST_FAKE_FAKE_HAL_H
+#include <array>
+#include <cstdint>
+#include <drivers/adc/adc.h>
+#include <drivers/gpio/gpio.h>
+#include <drivers/spi/spi.h>
+#include <drivers/timer/timer.h>
+#include <string>
+#include <system/hal.h>
+#include <vector>
+
+//---------------------------------//
+//---------- Description ----------//
+//---------------------------------//
+// Host replacement of the HAL functions and drivers used by the firmware under test
+//
+// The peripheral and core (ITM, DWT, SCB) address ranges are mapped to zeroed memory, so the firmware register
+// accesses (FastPin, Spi::configure, DWT->CYCCNT) work unchanged. DMA transfers are kept pending until the test
+// completes them, the completion runs the SPI device model and then the same HAL callback as the interrupt would.
+// Streams started by the DMA driver itself are completed one buffer at a time with completeDma()
+//
+// Example:
+// FakeHal::reset();
+// FakeHal::initSpi();
+// FakeHal::setSpiDevice(Spi::getHandle(Spi::Peripheral::SPI3), exchange, &device);
+// Spi::submit(&transaction);
+// FakeHal::completeTransfer(Spi::getHandle(Spi::Peripheral::SPI3));
+
+namespace FakeHal {
+
+/// DMA transfer started by the firmware
+struct Transfer {
+    const uint8_t* txData; ///< Data to transmit (nullptr when only receiving)
+    uint8_t* rxData;       ///< Received data (nullptr when only transmitting)
+    uint16_t len;          ///< Length in words
+};
+
+/**
+ * @brief SPI device model
+ *
+ * Called when a transfer completes, fills the received data from the transmitted data
+ *
+ * @param transfer Completed transfer
+ * @param context Device context
+ */
+using Exchange = void (*)(const Transfer& transfer, void* context);
+
+/// Restore the initial state (no pending transfers, no devices, manual completion, time zero)
+void reset();
+
+/// Initialize the SPI driver and link DMA handles to the peripherals in use
+void initSpi();
+
+void setSpiDevice(SPI_HandleTypeDef* hspi, Exchange exchange, void* context);
+
+/**
+ * @brief Complete pending transfers when the firmware polls HAL_GetTick
+ *
+ * Blocking transfers (Spi::transfer) busy wait on HAL_GetTick, with auto complete their transfers succeed as soon as
+ * they start. Without it every call advances the tick by 1 ms, so the blocking transfers time out
+ */
+void setAutoComplete(bool autoComplete);
+
+bool isPending(SPI_HandleTypeDef* hspi);
+Transfer getPending(SPI_HandleTypeDef* hspi);
+
+/**
+ * @brief Complete the pending transfer
+ *
+ * Runs the device model (only on success) and the transfer complete or error callback
+ *
+ * @return False if no transfer was pending
+ */
+bool completeTransfer(SPI_HandleTypeDef* hspi, bool success = true);
+
+uint32_t getTransfers(SPI_HandleTypeDef* hspi); ///< DMA transfers started since the reset
+uint32_t getAborts(SPI_HandleTypeDef* hspi);    ///< HAL_SPI_Abort calls since the reset
+
+/**
+ * @brief Complete the current buffer of a stream started by Dma::start() or Dma::startDoubleBuffer()
+ *
+ * Writes the data into the buffer of a peripheral to memory stream, switches the buffer of a double buffer stream
+ * and runs the transfer complete or error callback. Memory addresses are read back from the stream registers, so the
+ * buffers must be in static storage (linked below 4 GB)
+ *
+ * @param hdma DMA handle
+ * @param data Received data, one buffer of items (nullptr to leave the buffer unchanged)
+ * @param success False to end the transfer with a transfer error
+ *
+ * @return False if the stream was not running
+ */
+bool completeDma(Dma::Handle* hdma, const void* data = nullptr, bool success = true);
+
+/**
+ * @brief Complete a triple simultaneous injected conversion
+ *
+ * Writes the injected data register of each ADC and runs the injected conversion complete callback of ADC1
+ *
+ * @param samples Raw sample of each ADC (ADC1, ADC2, ADC3)
+ */
+void completeInjected(const std::array<uint16_t, 3>& samples);
+
+void setZeroVector(bool zeroVector); ///< Result of Motor::isZeroVector (the motor driver is not built for the host)
+
+void advanceCycles(uint32_t cycles); ///< Advance the DWT cycle counter
+
+/// Pin write to a GPIO port set/reset register (BSRR)
+struct GpioWrite {
+    Gpio::Gpio gpio; ///< Pin
+    bool level;      ///< True when set, false when reset
+
+    bool operator==(const GpioWrite& o) const { return gpio == o.gpio && level == o.level; }
+};
+
+/**
+ * @brief Record the GPIO pin writes
+ *
+ * While recording, the GPIO registers are protected and every access is single stepped, so each BSRR write is recorded
+ * in order and applied to ODR (BSRR then reads as zero, as on the device). Starting clears the recorded writes,
+ * reset() stops recording
+ *
+ * @param record Start or stop recording
+ *
+ * @return False if recording is not supported on this host (x86-64 Linux only)
+ */
+bool recordGpio(bool record);
+const std::vector<GpioWrite>& getGpioWrites(); ///< Writes recorded since recording started, one per pin
+
+/**
+ * @brief Record the characters sent to the ITM stimulus port 0
+ *
+ * Enables the ITM and the port so ITM_SendChar() transmits (the log output), and traps the ITM registers the same way
+ * as recordGpio(). Port 0 always reads as ready
+ *
+ * @param record Start or stop recording
+ *
+ * @return False if recording is not supported on this host (x86-64 Linux only)
+ */
+bool recordItm(bool record);
+std::string takeItm(); ///< Characters recorded since the last call
+
+/**
+ * @brief Last command of a type sent with AttaConnector::transmit
+ *
+ * @param cmd Command to fill
+ *
+ * @return True if a command of this type was sent since the reset
+ */
+bool getTransmitted(uint8_t cmdId, void* data, uint32_t size);
+template <typename T>
+bool getTransmitted(T* cmd) {
+    return getTransmitted(T::CMD_ID, cmd, sizeof(T));
+}
+
+void setUpdatePeriod(Timer::Timer timer, float period); ///< Result of Timer::getUpdatePeriod in seconds (zero after reset)
+void fireTimerUpdate(Timer::Timer timer);               ///< Run the callback set by Timer::setUpdateCallback
+void fireGpioInterrupt(Gpio::Gpio gpio);                ///< Run the callback set by Gpio::setInterruptCallback
+
+} // namespace FakeHal
+
+#endif // BLDC_TEST_FAKE_FAKE_HAL_H
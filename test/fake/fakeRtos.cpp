@@ -0,0 +1,102 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// fakeRtos.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "fakeRtos.h"
+#include "fakeHal.h"
+#include <deque>
+
+namespace {
+
+struct Blocked {}; // Thrown to return from the task function
+
+FakeTask _testTask{}; // Test thread
+std::deque<FakeTask> _tasks;
+FakeTask* _currentTask = &_testTask;
+TickType_t _tick = 0;
+uint32_t _waits = 0;  // Blocking calls the running task can make
+uint32_t _waited = 0; // Blocking calls made
+
+// Blocking call of the running task
+void wait() {
+    if (_currentTask == &_testTask)
+        return;
+    if (_waited == _waits)
+        throw Blocked{};
+    _waited++;
+}
+
+} // namespace
+
+void FakeRtos::reset() {
+    _testTask = {};
+    _tasks.clear();
+    _currentTask = &_testTask;
+    _tick = 0;
+}
+
+void FakeRtos::advanceTicks(TickType_t ticks) {
+    _tick += ticks;
+    FakeHal::advanceCycles(ticks * (SystemCoreClock / 1000));
+}
+
+uint32_t FakeRtos::runTask(TaskHandle_t task, uint32_t waits) {
+    _currentTask = task;
+    _waits = waits;
+    _waited = 0;
+    try {
+        task->function(task->argument);
+    } catch (const Blocked&) {
+    }
+    _currentTask = &_testTask;
+    return _waited;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char*, uint16_t, void* argument, UBaseType_t, TaskHandle_t* handle) {
+    _tasks.push_back({0, function, argument});
+    *handle = &_tasks.back();
+    return pdPASS;
+}
+
+TickType_t xTaskGetTickCount() { return _tick; }
+
+void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment) {
+    wait();
+    *previousWakeTime += increment;
+    if (TickType_t(*previousWakeTime - _tick) < 0x80000000u)
+        FakeRtos::advanceTicks(*previousWakeTime - _tick);
+}
+
+BaseType_t xTaskGetSchedulerState() { return taskSCHEDULER_RUNNING; }
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return _currentTask; }
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    task->notifications++;
+    if (higherPriorityTaskWoken)
+        *higherPriorityTaskWoken = pdTRUE;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    task->notifications++;
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+    uint32_t count = _currentTask->notifications;
+    if (count > 0) {
+        _currentTask->notifications = clearCountOnExit ? 0 : count - 1;
+        if (_currentTask != &_testTask)
+            wait();
+        return count;
+    }
+    if (_currentTask != &_testTask) {
+        if (ticksToWait == portMAX_DELAY)
+            throw Blocked{}; // Would never return
+        wait();
+        FakeRtos::advanceTicks(ticksToWait);
+    }
+    return 0;
+}
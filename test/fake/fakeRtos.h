@@ -0,0 +1,46 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// fakeRtos.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_TEST_FAKE_FAKE_RTOS_H
+#define BLDC_TEST_FAKE_FAKE_RTOS_H
+#include <FreeRTOS.h>
+#include <task.h>
+
+//---------------------------------//
+//---------- Description ----------//
+//---------------------------------//
+// Control of the fake FreeRTOS scheduler. One tick is one millisecond (pdMS_TO_TICKS), advancing the ticks also
+// advances the DWT cycle counter
+//
+// Example:
+// FakeRtos::reset();
+// task.start(config); // xTaskCreate only keeps the task function
+// FakeRtos::runTask(task.getHandle(), 3); // Three periods of a periodic task
+
+namespace FakeRtos {
+
+/// Forget the created tasks and the notifications of the test thread, the tick count restarts at zero
+void reset();
+
+void advanceTicks(TickType_t ticks); ///< Time passing while a task runs (execution time)
+
+/**
+ * @brief Run a task created with xTaskCreate on the test thread
+ *
+ * The task function returns at its next blocking call once it made waits of them, or when it would wait forever for a
+ * notification. vTaskDelayUntil moves the tick count to the next wake time if it is in the future. ulTaskNotifyTake
+ * takes the pending notifications, or moves the tick count by the timeout when there is none
+ *
+ * @param task Task handle
+ * @param waits Calls to the blocking functions
+ *
+ * @return Blocking calls made (less than waits if the task would wait forever)
+ */
+uint32_t runTask(TaskHandle_t task, uint32_t waits);
+
+} // namespace FakeRtos
+
+#endif // BLDC_TEST_FAKE_FAKE_RTOS_H
@@ -0,0 +1,31 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// task.h
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef BLDC_TEST_FAKE_TASK_H
+#define BLDC_TEST_FAKE_TASK_H
+#include <FreeRTOS.h>
+
+#define taskSCHEDULER_SUSPENDED ((BaseType_t)0)
+#define taskSCHEDULER_NOT_STARTED ((BaseType_t)1)
+#define taskSCHEDULER_RUNNING ((BaseType_t)2)
+
+struct FakeTask {
+    uint32_t notifications; // Notifications given and not taken
+    TaskFunction_t function;
+    void* argument;
+};
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint16_t stackSize, void* argument, UBaseType_t priority,
+                       TaskHandle_t* handle);
+TickType_t xTaskGetTickCount();
+void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment);
+BaseType_t xTaskGetSchedulerState();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait);
+
+#endif // BLDC_TEST_FAKE_TASK_H
@@ -0,0 +1,97 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// adcTest.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <array>
+#include <drivers/adc/adc.h>
+#include <fakeHal.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr uint8_t NUM_REGULAR = Adc::countChannels(Adc::Peripheral::ADC1, Adc::Group::REGULAR);
+using Frame = std::array<uint16_t, NUM_REGULAR>;
+
+const uint16_t* lastFrame = nullptr;
+size_t frames = 0;
+
+class AdcTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        FakeHal::reset();
+        ASSERT_TRUE(Adc::init());
+        ASSERT_TRUE(Dma::init());
+        lastFrame = nullptr;
+        frames = 0;
+    }
+
+    void TearDown() override {
+        Adc::setCallback(Adc::Peripheral::ADC1, nullptr);
+        Adc::deinit();
+    }
+
+    // One trigger: the DMA writes the frame of the regular sequence
+    bool trigger(const Frame& frame) { return FakeHal::completeDma(Dma::getHandle(Dma::ADC_DMA, Dma::ADC_VOLT_STREAM), frame.data()); }
+};
+
+} // namespace
+
+TEST_F(AdcTest, RegularFramesOnStreamBuffer) {
+    ASSERT_TRUE(Adc::start());
+    ADC_HandleTypeDef* handle = Adc::getHandle(Adc::Peripheral::ADC1);
+    EXPECT_TRUE(handle->Instance->CR2 & ADC_CR2_DMA);
+    EXPECT_TRUE(handle->Instance->CR2 & ADC_CR2_ADON);
+
+    // Double buffer stream of one frame per buffer, reading the ADC data register
+    Dma::Handle* hdma = Dma::getHandle(Dma::ADC_DMA, Dma::ADC_VOLT_STREAM);
+    EXPECT_TRUE(hdma->Instance->CR & DMA_SxCR_DBM);
+    EXPECT_EQ(hdma->Instance->PAR, uint32_t(uintptr_t(&handle->Instance->DR)));
+    EXPECT_EQ(hdma->Instance->NDTR, NUM_REGULAR);
+
+    EXPECT_EQ(Adc::read(Gpio::VOLT_U_PIN), 0xFFFF);
+    EXPECT_EQ(Adc::getFrame(Adc::Peripheral::ADC1), nullptr);
+
+    // Samples are in adcList order
+    ASSERT_TRUE(trigger({100, 200, 300, 400}));
+    EXPECT_EQ(Adc::read(Gpio::VOLT_SRC_PIN), 100);
+    EXPECT_EQ(Adc::read(Gpio::VOLT_U_PIN), 200);
+    EXPECT_EQ(Adc::read(Gpio::VOLT_W_PIN), 400);
+    const uint16_t* first = Adc::getFrame(Adc::Peripheral::ADC1);
+
+    // The next frame is written to the other buffer, the previous one stays valid until then
+    ASSERT_TRUE(trigger({101, 201, 301, 401}));
+    const uint16_t* second = Adc::getFrame(Adc::Peripheral::ADC1);
+    EXPECT_NE(second, first);
+    EXPECT_EQ(first[1], 200);
+    EXPECT_EQ(Adc::read(Gpio::VOLT_V_PIN), 301);
+
+    ASSERT_TRUE(trigger({102, 202, 302, 402}));
+    EXPECT_EQ(Adc::getFrame(Adc::Peripheral::ADC1), first);
+    EXPECT_EQ(Adc::read(Gpio::VOLT_SRC_PIN), 102);
+}
+
+TEST_F(AdcTest, FrameCallback) {
+    Adc::setCallback(Adc::Peripheral::ADC1, [](Adc::Peripheral peripheral, const uint16_t* frame) {
+        EXPECT_EQ(peripheral, Adc::Peripheral::ADC1);
+        lastFrame = frame;
+        frames++;
+    });
+    ASSERT_TRUE(Adc::start());
+    trigger({1, 2, 3, 4});
+    trigger({5, 6, 7, 8});
+    EXPECT_EQ(frames, 2u);
+    ASSERT_NE(lastFrame, nullptr);
+    EXPECT_EQ(lastFrame, Adc::getFrame(Adc::Peripheral::ADC1));
+    EXPECT_EQ(lastFrame[2], 7);
+}
+
+TEST_F(AdcTest, Deinit) {
+    ASSERT_TRUE(Adc::start());
+    Adc::deinit();
+    Dma::Handle* hdma = Dma::getHandle(Dma::ADC_DMA, Dma::ADC_VOLT_STREAM);
+    EXPECT_EQ(hdma->Instance->CR & DMA_SxCR_EN, 0u);
+    EXPECT_FALSE(Adc::getHandle(Adc::Peripheral::ADC1)->Instance->CR2 & ADC_CR2_DMA);
+    EXPECT_FALSE(trigger({1, 2, 3, 4}));
+}
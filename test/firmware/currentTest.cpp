@@ -0,0 +1,100 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// currentTest.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <drivers/current/current.h>
+#include <fakeHal.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr double NOMINAL_OFFSET = Adc::MAX_READ / 2.0;
+constexpr uint32_t PERIODS = 16 * 1024; // Online filter time constant is 1024 PWM periods
+
+// Zero current raw value of a phase, from its calibration
+double rawOffset(const Current& phase) {
+    Current::Calibration calibration = phase.getCalibration();
+    return -double(calibration.offset) / calibration.scale;
+}
+
+class CurrentTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        FakeHal::reset();
+        ASSERT_TRUE(Adc::init());
+        ASSERT_TRUE(Dma::init());
+        ASSERT_TRUE(curr_u_phase.init(Gpio::CURR_U_PIN));
+        ASSERT_TRUE(curr_v_phase.init(Gpio::CURR_V_PIN));
+        ASSERT_TRUE(curr_w_phase.init(Gpio::CURR_W_PIN));
+        Current::startOnlineCalibration();
+    }
+
+    void TearDown() override {
+        Current::stopOnlineCalibration();
+        Adc::deinit();
+    }
+
+    // Injected conversions at the PWM rate, the same sample on the three phases
+    void convert(uint16_t raw, uint32_t periods) {
+        for (uint32_t i = 0; i < periods; i++)
+            FakeHal::completeInjected({raw, raw, raw});
+    }
+};
+
+} // namespace
+
+TEST_F(CurrentTest, OnlineOffsetFromAbove) {
+    ASSERT_NEAR(rawOffset(curr_u_phase), NOMINAL_OFFSET, 0.1);
+    convert(2000, PERIODS);
+    for (Current* phase : {&curr_u_phase, &curr_v_phase, &curr_w_phase})
+        EXPECT_NEAR(rawOffset(*phase), 2000.0, 1.0 / 128);
+    EXPECT_NEAR(curr_u_phase.read(), 0.0f, 1e-4f);
+}
+
+TEST_F(CurrentTest, OnlineOffsetFromBelow) {
+    // Errors below 4 LSB used to floor to zero and stop the filter
+    convert(2100, PERIODS);
+    for (Current* phase : {&curr_u_phase, &curr_v_phase, &curr_w_phase})
+        EXPECT_NEAR(rawOffset(*phase), 2100.0, 1.0 / 128);
+    EXPECT_NEAR(curr_u_phase.read(), 0.0f, 1e-4f);
+}
+
+TEST_F(CurrentTest, OnlineOffsetUnbiased) {
+    // Noise of one LSB around the nominal offset, the estimate must not drift low
+    for (uint32_t i = 0; i < PERIODS; i++)
+        convert(i & 1 ? 2048 : 2047, 1);
+    EXPECT_NEAR(rawOffset(curr_u_phase), NOMINAL_OFFSET, 1.0 / 64);
+}
+
+TEST_F(CurrentTest, OnlineOffsetOnlyOnZeroVector) {
+    // Active vectors drive current through the shunts
+    double initial = rawOffset(curr_u_phase);
+    FakeHal::setZeroVector(false);
+    convert(2100, PERIODS);
+    EXPECT_EQ(rawOffset(curr_u_phase), initial);
+
+    // The current decays for a few milliseconds after the last active vector
+    FakeHal::setZeroVector(true);
+    convert(2100, 200);
+    EXPECT_EQ(rawOffset(curr_u_phase), initial);
+    convert(2100, PERIODS);
+    EXPECT_NEAR(rawOffset(curr_u_phase), 2100.0, 1.0 / 128);
+
+    // Stopped refinement keeps the offset
+    Current::stopOnlineCalibration();
+    convert(2000, PERIODS);
+    EXPECT_NEAR(rawOffset(curr_u_phase), 2100.0, 1.0 / 128);
+}
+
+TEST_F(CurrentTest, CalibrationStorage) {
+    convert(2100, PERIODS);
+    ASSERT_TRUE(Current::saveCalibration());
+    Current::Calibration refined = curr_v_phase.getCalibration();
+    ASSERT_TRUE(curr_v_phase.init(Gpio::CURR_V_PIN));
+    ASSERT_NE(curr_v_phase.getCalibration().offset, refined.offset);
+    ASSERT_TRUE(Current::loadCalibration());
+    EXPECT_EQ(curr_v_phase.getCalibration().offset, refined.offset);
+    EXPECT_EQ(curr_v_phase.getCalibration().scale, refined.scale);
+}
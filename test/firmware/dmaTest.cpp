@@ -0,0 +1,176 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// dmaTest.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <array>
+#include <drivers/dma/streamBuffer.h>
+#include <fakeHal.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+// Double buffer stream from dmaList (ADC voltage scan), the ADC driver is not started by these tests
+constexpr Dma::Dma DMA = Dma::ADC_DMA;
+constexpr Dma::Stream STREAM = Dma::ADC_VOLT_STREAM;
+constexpr size_t N = 4;
+constexpr uint32_t PERIPHERAL = ADC1_BASE + 0x4C; // ADC_DR
+
+using Buffer = std::array<uint16_t, N>;
+
+// Buffers must be in static storage (the fake reads the 32-bit addresses back from the stream registers)
+Dma::StreamBuffer<DMA, STREAM, uint16_t, N> stream;
+std::array<uint32_t, 8> ledData;
+
+struct Event {
+    Dma::Event event;
+    uint8_t buffer;
+};
+std::vector<Event> events;
+std::vector<uint16_t*> completed;
+
+class DmaTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        FakeHal::reset();
+        ASSERT_TRUE(Dma::init());
+        events.clear();
+        completed.clear();
+    }
+
+    void TearDown() override {
+        stream.stop();
+        Dma::stop(Dma::LED_DMA, Dma::LED_STREAM);
+        Dma::setCallback(Dma::LED_DMA, Dma::LED_STREAM, nullptr);
+    }
+
+    bool complete(const Buffer& data) { return FakeHal::completeDma(Dma::getHandle(DMA, STREAM), data.data()); }
+};
+
+} // namespace
+
+TEST_F(DmaTest, DoubleBufferStart) {
+    ASSERT_TRUE(stream.start(PERIPHERAL));
+    Dma::Handle* hdma = Dma::getHandle(DMA, STREAM);
+    EXPECT_EQ(hdma->Instance->CR & (DMA_SxCR_EN | DMA_SxCR_DBM | DMA_SxCR_CIRC), DMA_SxCR_EN | DMA_SxCR_DBM | DMA_SxCR_CIRC);
+    EXPECT_EQ(hdma->Instance->CR & DMA_SxCR_DIR, DMA_PERIPH_TO_MEMORY);
+    EXPECT_EQ(hdma->Instance->PAR, PERIPHERAL);
+    EXPECT_NE(hdma->Instance->M0AR, hdma->Instance->M1AR);
+    EXPECT_EQ(hdma->Instance->NDTR, N);
+    EXPECT_EQ(Dma::getTarget(DMA, STREAM), 0);
+    EXPECT_EQ(stream.acquire(), nullptr);
+
+    // A running stream can not be started again
+    EXPECT_FALSE(stream.start(PERIPHERAL));
+}
+
+TEST_F(DmaTest, AcquireRelease) {
+    ASSERT_TRUE(stream.start(PERIPHERAL));
+
+    ASSERT_TRUE(complete({1, 2, 3, 4}));
+    EXPECT_EQ(Dma::getTarget(DMA, STREAM), 1);
+    uint16_t* first = stream.acquire();
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(Buffer({first[0], first[1], first[2], first[3]}), Buffer({1, 2, 3, 4}));
+    EXPECT_EQ(stream.acquire(), nullptr); // Already taken
+    stream.release();
+
+    // The stream wrote the other buffer, no data is copied
+    ASSERT_TRUE(complete({5, 6, 7, 8}));
+    EXPECT_EQ(Dma::getTarget(DMA, STREAM), 0);
+    uint16_t* second = stream.acquire();
+    ASSERT_NE(second, nullptr);
+    EXPECT_NE(second, first);
+    EXPECT_EQ(Buffer({second[0], second[1], second[2], second[3]}), Buffer({5, 6, 7, 8}));
+    stream.release();
+
+    ASSERT_TRUE(complete({9, 10, 11, 12}));
+    EXPECT_EQ(stream.acquire(), first);
+    stream.release();
+    EXPECT_EQ(stream.getOverruns(), 0u);
+}
+
+TEST_F(DmaTest, Overruns) {
+    ASSERT_TRUE(stream.start(PERIPHERAL));
+
+    // Buffer never taken before the stream completed the other one
+    complete({1, 1, 1, 1});
+    complete({2, 2, 2, 2});
+    EXPECT_EQ(stream.getOverruns(), 1u);
+    uint16_t* buffer = stream.acquire();
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_EQ(buffer[0], 2);
+
+    // Buffer still held when the stream completed the other one (it is being written again)
+    complete({3, 3, 3, 3});
+    EXPECT_EQ(stream.getOverruns(), 2u);
+    stream.release();
+    EXPECT_EQ(stream.acquire()[0], 3);
+    stream.release();
+
+    complete({4, 4, 4, 4});
+    EXPECT_EQ(stream.getOverruns(), 2u);
+
+    // Restart clears the state
+    stream.stop();
+    ASSERT_TRUE(stream.start(PERIPHERAL));
+    EXPECT_EQ(stream.getOverruns(), 0u);
+    EXPECT_EQ(stream.acquire(), nullptr);
+}
+
+TEST_F(DmaTest, Callback) {
+    int context = 0;
+    auto callback = [](uint16_t* buffer, void* context) {
+        EXPECT_NE(context, nullptr);
+        completed.push_back(buffer);
+    };
+    ASSERT_TRUE(stream.start(PERIPHERAL, callback, &context));
+
+    complete({1, 2, 3, 4});
+    complete({5, 6, 7, 8});
+    complete({9, 10, 11, 12});
+    ASSERT_EQ(completed.size(), 3u);
+    EXPECT_NE(completed[0], completed[1]);
+    EXPECT_EQ(completed[0], completed[2]);
+    EXPECT_EQ(completed[1][0], 5);
+    EXPECT_EQ(completed[2][3], 12);
+
+    // Buffers go to the callback only
+    EXPECT_EQ(stream.acquire(), nullptr);
+    EXPECT_EQ(stream.getOverruns(), 0u);
+}
+
+TEST_F(DmaTest, Stop) {
+    ASSERT_TRUE(stream.start(PERIPHERAL));
+    complete({1, 2, 3, 4});
+    stream.stop();
+    Dma::Handle* hdma = Dma::getHandle(DMA, STREAM);
+    EXPECT_EQ(hdma->Instance->CR & (DMA_SxCR_EN | DMA_SxCR_DBM), 0u);
+    EXPECT_FALSE(complete({5, 6, 7, 8}));
+}
+
+TEST_F(DmaTest, SingleBufferStart) {
+    // LED stream: memory to peripheral, circular, 32-bit
+    constexpr uint32_t ccr = TIM2_BASE + 0x34;
+    Dma::setCallback(Dma::LED_DMA, Dma::LED_STREAM, [](Dma::Event event, uint8_t buffer, void*) { events.push_back({event, buffer}); });
+    ASSERT_TRUE(Dma::start(Dma::LED_DMA, Dma::LED_STREAM, ccr, ledData.data(), ledData.size()));
+    Dma::Handle* hdma = Dma::getHandle(Dma::LED_DMA, Dma::LED_STREAM);
+    EXPECT_EQ(hdma->Instance->PAR, ccr);
+    EXPECT_EQ(hdma->Instance->M0AR, uint32_t(uintptr_t(ledData.data())));
+    EXPECT_EQ(hdma->Instance->CR & DMA_SxCR_DBM, 0u);
+    EXPECT_EQ(Dma::getRemaining(Dma::LED_DMA, Dma::LED_STREAM), ledData.size());
+
+    ASSERT_TRUE(FakeHal::completeDma(hdma));
+    ASSERT_TRUE(FakeHal::completeDma(hdma)); // Circular
+    ASSERT_TRUE(FakeHal::completeDma(hdma, nullptr, false));
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].event, Dma::EVENT_COMPLETE);
+    EXPECT_EQ(events[1].event, Dma::EVENT_COMPLETE);
+    EXPECT_EQ(events[1].buffer, 0);
+    EXPECT_EQ(events[2].event, Dma::EVENT_ERROR);
+
+    // Transfer errors disable the stream
+    EXPECT_FALSE(FakeHal::completeDma(hdma));
+}
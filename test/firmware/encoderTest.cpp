@@ -0,0 +1,306 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// encoderTest.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <cstring>
+#include <drivers/encoder/encoder.h>
+#include <fakeHal.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+// Register addresses and frame layout from the AS5048A datasheet
+constexpr uint16_t REG_NOP = 0x0000;
+constexpr uint16_t REG_CLEAR_ERROR = 0x0001;
+constexpr uint16_t REG_MAGNITUDE = 0x3FFE;
+constexpr uint16_t REG_ANGLE = 0x3FFF;
+constexpr uint16_t FRAME_READ = 1 << 14;
+constexpr uint16_t FRAME_ERROR = 1 << 14;
+constexpr uint16_t FRAME_PARITY = 1 << 15;
+constexpr uint16_t ERROR_PARITY = 1 << 2; // Clear Error Flag register
+
+constexpr Spi::Peripheral PERIPHERAL = Spi::Peripheral::SPI3;
+constexpr Gpio::Gpio CHIP_SELECT = Gpio::ENC_CS_PIN;
+constexpr Timer::Timer TIMER = Timer::MOTOR_TIM;
+constexpr uint32_t PERIOD_CYCLES = 144000000 / 24000; // One PWM period
+
+// Even parity over the 16 bits
+uint16_t withParity(uint16_t frame) {
+    frame &= ~FRAME_PARITY;
+    return __builtin_parity(frame) ? frame | FRAME_PARITY : frame;
+}
+
+// AS5048A SPI slave, 16-bit frames: each frame returns the result of the previous command
+struct As5048a {
+    uint16_t angle = 0;
+    uint16_t magnitude = 0x1234;
+    bool errorFlag = false;
+    uint16_t errorRegister = 0;
+    uint16_t response = 0;
+    bool corruptNext = false;       // Flip a data bit of the next response (parity error on the bus)
+    std::vector<uint16_t> commands; // Received commands
+
+    static void exchange(const FakeHal::Transfer& transfer, void* context) {
+        As5048a* enc = static_cast<As5048a*>(context);
+        ASSERT_EQ(transfer.len, 1);
+        ASSERT_NE(transfer.txData, nullptr);
+        ASSERT_NE(transfer.rxData, nullptr);
+        uint16_t command;
+        std::memcpy(&command, transfer.txData, sizeof(command));
+        enc->commands.push_back(command);
+
+        uint16_t response = enc->response;
+        if (enc->corruptNext) {
+            response ^= 1 << 3;
+            enc->corruptNext = false;
+        }
+        std::memcpy(transfer.rxData, &response, sizeof(response));
+        enc->response = enc->process(command);
+    }
+
+    // Response of the next frame
+    uint16_t process(uint16_t command) {
+        if (__builtin_parity(command)) {
+            errorFlag = true;
+            errorRegister |= ERROR_PARITY;
+            return frame(0);
+        }
+        if (!(command & FRAME_READ))
+            return frame(0);
+        switch (command & 0x3FFF) {
+            case REG_CLEAR_ERROR: {
+                // Reading the error register clears it and the error flag, the flag is still sent with this result
+                uint16_t result = frame(errorRegister);
+                errorFlag = false;
+                errorRegister = 0;
+                return result;
+            }
+            case REG_MAGNITUDE:
+                return frame(magnitude);
+            case REG_ANGLE:
+                return frame(angle);
+            default:
+                return frame(0);
+        }
+    }
+
+    uint16_t frame(uint16_t data) const { return withParity((errorFlag ? FRAME_ERROR : 0) | (data & 0x3FFF)); }
+};
+
+uint16_t readCommand(uint16_t reg) { return withParity(FRAME_READ | reg); }
+
+class EncoderTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        FakeHal::reset();
+        FakeHal::initSpi();
+        FakeHal::setSpiDevice(Spi::getHandle(PERIPHERAL), As5048a::exchange, &device);
+        FakeHal::setAutoComplete(true);
+        ASSERT_TRUE(encoder.init(PERIPHERAL, CHIP_SELECT));
+        device.commands.clear();
+    }
+
+    void TearDown() override {
+        SPI_HandleTypeDef* hspi = Spi::getHandle(PERIPHERAL);
+        while (FakeHal::completeTransfer(hspi)) {
+        }
+        encoder.stopPipeline();
+    }
+
+    // One PWM period: timer update, then the frame completes before the next one
+    void period(bool success = true) {
+        FakeHal::advanceCycles(PERIOD_CYCLES);
+        FakeHal::fireTimerUpdate(TIMER);
+        FakeHal::completeTransfer(Spi::getHandle(PERIPHERAL), success);
+    }
+
+    As5048a device;
+    Encoder encoder;
+};
+
+} // namespace
+
+TEST_F(EncoderTest, BlockingReads) {
+    device.angle = 0x2A5B;
+    device.magnitude = 0x0FED;
+    EXPECT_EQ(encoder.readCounts(), 0x2A5B);
+    EXPECT_EQ(encoder.readMagnitude(), 0x0FED);
+    EXPECT_NEAR(encoder.readAngle().value(), 0x2A5B / 16383.0f * 360.0f, 1e-3f);
+
+    // Command, then NOP to clock out its result
+    const std::vector<uint16_t> commands = {readCommand(REG_ANGLE), withParity(REG_NOP), readCommand(REG_MAGNITUDE), withParity(REG_NOP),
+                                            readCommand(REG_ANGLE), withParity(REG_NOP)};
+    EXPECT_EQ(device.commands, commands);
+
+    device.errorFlag = true;
+    EXPECT_FALSE(encoder.readCounts().has_value());
+}
+
+TEST_F(EncoderTest, PipelinePreviousCommandResult) {
+    ASSERT_TRUE(encoder.startPipeline(TIMER));
+    EXPECT_FALSE(encoder.getSample().has_value());
+
+    // The first frame returns the result of the last blocking command (NOP), it is not an angle
+    device.angle = 1000;
+    period();
+    EXPECT_FALSE(encoder.getSample().has_value());
+    EXPECT_EQ(encoder.getPipelineErrors(), 0u);
+
+    // Each frame returns the angle read by the frame before
+    device.angle = 2000;
+    period();
+    ASSERT_TRUE(encoder.getSample().has_value());
+    EXPECT_EQ(encoder.getSample()->counts, 1000);
+    EXPECT_EQ(encoder.getSample()->cycles, DWT->CYCCNT);
+    EXPECT_EQ(encoder.readCounts(), 1000);
+
+    period();
+    EXPECT_EQ(encoder.getSample()->counts, 2000);
+    for (uint16_t command : device.commands)
+        EXPECT_EQ(command, readCommand(REG_ANGLE));
+    EXPECT_EQ(device.commands.size(), 3u);
+
+    // Blocking reads would interleave with the pipeline frames
+    EXPECT_FALSE(encoder.readMagnitude().has_value());
+    EXPECT_EQ(device.commands.size(), 3u);
+}
+
+TEST_F(EncoderTest, PipelineParityError) {
+    ASSERT_TRUE(encoder.startPipeline(TIMER));
+    device.angle = 500;
+    period();
+    period();
+    ASSERT_EQ(encoder.getSample()->counts, 500);
+
+    // Corrupted frame is counted and the last sample is kept
+    device.angle = 600;
+    device.corruptNext = true;
+    period();
+    EXPECT_EQ(encoder.getPipelineErrors(), 1u);
+    EXPECT_EQ(encoder.getSample()->counts, 500);
+
+    // No error flag on the encoder side, so the pipeline keeps reading the angle
+    period();
+    EXPECT_EQ(encoder.getSample()->counts, 600);
+    EXPECT_EQ(device.commands.back(), readCommand(REG_ANGLE));
+    EXPECT_EQ(encoder.getPipelineErrors(), 1u);
+}
+
+TEST_F(EncoderTest, PipelineClearErrorRetry) {
+    ASSERT_TRUE(encoder.startPipeline(TIMER));
+    device.angle = 700;
+    period();
+    period();
+    ASSERT_EQ(encoder.getSample()->counts, 700);
+
+    // Encoder flags an error, the angle in that frame is not published and the next command clears the flag
+    device.errorFlag = true;
+    device.errorRegister = ERROR_PARITY;
+    device.response = device.frame(device.angle);
+    device.angle = 800;
+    period();
+    EXPECT_EQ(encoder.getPipelineErrors(), 1u);
+    EXPECT_EQ(encoder.getSample()->counts, 700);
+
+    period();
+    EXPECT_EQ(device.commands.back(), readCommand(REG_CLEAR_ERROR));
+    EXPECT_EQ(encoder.getPipelineErrors(), 2u); // The angle read before the clear still carries the flag
+    EXPECT_FALSE(device.errorFlag);
+
+    // Error register result is not an angle, then the angle reads recover
+    period();
+    EXPECT_EQ(device.commands.back(), readCommand(REG_ANGLE));
+    EXPECT_EQ(encoder.getSample()->counts, 700);
+    EXPECT_EQ(encoder.getPipelineErrors(), 2u);
+
+    period();
+    EXPECT_EQ(encoder.getSample()->counts, 800);
+    EXPECT_EQ(encoder.getPipelineErrors(), 2u);
+}
+
+TEST_F(EncoderTest, PipelineOverrunAndFailure) {
+    ASSERT_TRUE(encoder.startPipeline(TIMER));
+    period();
+
+    // Trigger while the frame is still in flight
+    FakeHal::fireTimerUpdate(TIMER);
+    FakeHal::fireTimerUpdate(TIMER);
+    EXPECT_EQ(encoder.getPipelineOverruns(), 1u);
+    FakeHal::completeTransfer(Spi::getHandle(PERIPHERAL));
+
+    // Failed transfer: counted, nothing published, the next frame still works
+    size_t commands = device.commands.size();
+    device.angle = 900;
+    period(false);
+    EXPECT_EQ(encoder.getPipelineErrors(), 1u);
+    EXPECT_EQ(device.commands.size(), commands);
+    period();
+    period();
+    EXPECT_EQ(encoder.getSample()->counts, 900);
+    EXPECT_EQ(encoder.getPipelineOverruns(), 1u);
+}
+
+TEST_F(EncoderTest, PipelineVelocity) {
+    // 100 counts per PWM period at 24 kHz, about 1.5 turns between two 10 ms task activations
+    ASSERT_TRUE(encoder.startPipeline(TIMER));
+    constexpr uint16_t STEP = 100;
+    for (size_t i = 0; i < 2000; i++) {
+        device.angle = (device.angle + STEP) & 0x3FFF;
+        period();
+    }
+    float expected = STEP * 24000.0f * 2 * float(M_PI) / 16384;
+    EXPECT_NEAR(encoder.getSample()->state.velocity, expected, expected * 1e-3f);
+    EXPECT_NEAR(encoder.getSample()->state.acceleration, 0.0f, 10.0f);
+}
+
+TEST_F(EncoderTest, PipelineLatency) {
+    // Center aligned PWM at 24 kHz updates at the peak and at the valley
+    constexpr float UPDATE = 1.0f / 48000;
+    constexpr float LATENCY = 2 * UPDATE - 16 * 4 / 36e6f;
+    FakeHal::setUpdatePeriod(TIMER, UPDATE);
+    ASSERT_TRUE(encoder.startPipeline(TIMER));
+    EXPECT_NEAR(encoder.getPllLatency(), LATENCY, 1e-9f);
+
+    // The published angle leads the last sample by the velocity times the latency
+    constexpr uint16_t STEP = 100;
+    for (size_t i = 0; i < 2000; i++) {
+        device.angle = (device.angle + STEP) & 0x3FFF;
+        period();
+    }
+    Encoder::Sample sample = *encoder.getSample();
+    float angle = sample.counts * 2 * float(M_PI) / 16384;
+    EXPECT_NEAR(std::remainder(sample.state.angle - angle, 2 * float(M_PI)), sample.state.velocity * LATENCY, 1e-4f);
+
+    encoder.setPllLatency(0.0f);
+    period();
+    sample = *encoder.getSample();
+    EXPECT_NEAR(std::remainder(sample.state.angle - sample.counts * 2 * float(M_PI) / 16384, 2 * float(M_PI)), 0.0f, 1e-4f);
+}
+
+TEST_F(EncoderTest, PipelineBandwidth) {
+    ASSERT_TRUE(encoder.startPipeline(TIMER));
+    encoder.setPllBandwidth(500.0f);
+    EXPECT_EQ(encoder.getPllBandwidth(), 500.0f);
+
+    // A lower bandwidth takes longer to follow a velocity step
+    constexpr uint16_t STEP = 100;
+    for (size_t i = 0; i < 24; i++) {
+        device.angle = (device.angle + STEP) & 0x3FFF;
+        period();
+    }
+    float expected = STEP * 24000.0f * 2 * float(M_PI) / 16384;
+    float slow = encoder.getSample()->state.velocity;
+    EXPECT_LT(slow, 0.9f * expected);
+
+    encoder.stopPipeline();
+    ASSERT_TRUE(encoder.startPipeline(TIMER));
+    encoder.setPllBandwidth(4000.0f);
+    for (size_t i = 0; i < 24; i++) {
+        device.angle = (device.angle + STEP) & 0x3FFF;
+        period();
+    }
+    EXPECT_GT(encoder.getSample()->state.velocity, slow);
+}
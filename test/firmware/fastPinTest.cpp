@@ -0,0 +1,76 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// fastPinTest.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <drivers/gpio/fastPin.h>
+#include <fakeHal.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+using Writes = std::vector<FakeHal::GpioWrite>;
+
+class FastPinTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        FakeHal::reset();
+        if (!FakeHal::recordGpio(true))
+            GTEST_SKIP() << "GPIO writes can not be recorded on this host";
+    }
+
+    void TearDown() override { FakeHal::recordGpio(false); }
+};
+
+} // namespace
+
+TEST_F(FastPinTest, Writes) {
+    Gpio::FastPin pin(Gpio::DEBUG0_PIN);
+    pin.set();
+    pin.clear();
+    pin.write(true);
+    pin.toggle();
+    pin.toggle();
+    EXPECT_EQ(FakeHal::getGpioWrites(), Writes({{Gpio::DEBUG0_PIN, true},
+                                                {Gpio::DEBUG0_PIN, false},
+                                                {Gpio::DEBUG0_PIN, true},
+                                                {Gpio::DEBUG0_PIN, false},
+                                                {Gpio::DEBUG0_PIN, true}}));
+
+    // Unassigned pin
+    Gpio::FastPin none;
+    none.set();
+    EXPECT_EQ(FakeHal::getGpioWrites().size(), 5u);
+}
+
+TEST_F(FastPinTest, Probe) {
+    {
+        Gpio::Probe outer(Gpio::DEBUG0_PIN);
+        {
+            Gpio::Probe inner(Gpio::DEBUG1_PIN);
+        }
+    }
+    EXPECT_EQ(FakeHal::getGpioWrites(), Writes({{Gpio::DEBUG0_PIN, true},
+                                                {Gpio::DEBUG1_PIN, true},
+                                                {Gpio::DEBUG1_PIN, false},
+                                                {Gpio::DEBUG0_PIN, false}}));
+}
+
+TEST_F(FastPinTest, ChipSelect) {
+    // Released when leaving the scope
+    {
+        Gpio::ChipSelect chipSelect(Gpio::ENC_CS_PIN);
+        EXPECT_EQ(FakeHal::getGpioWrites(), Writes({{Gpio::ENC_CS_PIN, false}}));
+    }
+    EXPECT_EQ(FakeHal::getGpioWrites(), Writes({{Gpio::ENC_CS_PIN, false}, {Gpio::ENC_CS_PIN, true}}));
+
+    // Held, the owner releases it
+    {
+        Gpio::ChipSelect chipSelect(Gpio::ENC_CS_PIN);
+        chipSelect.hold();
+    }
+    EXPECT_EQ(FakeHal::getGpioWrites().size(), 3u);
+    EXPECT_EQ(FakeHal::getGpioWrites().back(), FakeHal::GpioWrite({Gpio::ENC_CS_PIN, false}));
+}
@@ -0,0 +1,244 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// imuFifoTest.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <drivers/imu/imuFifo.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+// FIFO_DATA_OUT_TAG sensor tags (ISM330DHCX datasheet, table 123)
+constexpr uint8_t TAG_GYRO_NC = 0x01;
+constexpr uint8_t TAG_ACC_NC = 0x02;
+constexpr uint8_t TAG_TEMPERATURE = 0x03;
+constexpr uint8_t TAG_TIMESTAMP = 0x04;
+constexpr uint8_t TAG_CFG_CHANGE = 0x05;
+
+// FIFO byte stream as drained from FIFO_DATA_OUT_TAG..FIFO_DATA_OUT_Z_H
+class Stream {
+  public:
+    Stream& word(uint8_t tag, uint8_t count, const std::array<uint8_t, 6>& data) {
+        uint8_t tagByte = uint8_t(tag << 3 | (count & 0x03) << 1);
+        tagByte |= __builtin_parity(tagByte); // Parity bit (not checked by the decoder)
+        _bytes.push_back(tagByte);
+        _bytes.insert(_bytes.end(), data.begin(), data.end());
+        return *this;
+    }
+    Stream& axes(uint8_t tag, uint8_t count, int16_t x, int16_t y, int16_t z) {
+        return word(tag, count, {uint8_t(x), uint8_t(x >> 8), uint8_t(y), uint8_t(y >> 8), uint8_t(z), uint8_t(z >> 8)});
+    }
+    Stream& gyr(uint8_t count, int16_t x, int16_t y, int16_t z) { return axes(TAG_GYRO_NC, count, x, y, z); }
+    Stream& acc(uint8_t count, int16_t x, int16_t y, int16_t z) { return axes(TAG_ACC_NC, count, x, y, z); }
+    Stream& timestamp(uint8_t count, uint32_t ticks) {
+        return word(TAG_TIMESTAMP, count, {uint8_t(ticks), uint8_t(ticks >> 8), uint8_t(ticks >> 16), uint8_t(ticks >> 24), 0, 0});
+    }
+    // Gyroscope and accelerometer batch with distinct values
+    Stream& batch(uint8_t count, int16_t value) { return gyr(count, value, value + 1, value + 2).acc(count, -value, -value - 1, -value - 2); }
+
+    const uint8_t* data() const { return _bytes.data(); }
+    size_t size() const { return _bytes.size(); }
+
+  private:
+    std::vector<uint8_t> _bytes;
+};
+
+std::vector<ImuFifo::Sample> popAll(ImuFifo& fifo) {
+    std::vector<ImuFifo::Sample> samples;
+    ImuFifo::Sample sample;
+    while (fifo.pop(sample))
+        samples.push_back(sample);
+    return samples;
+}
+
+// Drain of a FIFO with timestamp batching every sample, byte layout of the FIFO_DATA_OUT registers: three batches
+// (counters 1, 2, 3) of timestamp, gyroscope and accelerometer words, 1 g on Z and 6 ticks (150 us) between batches
+constexpr uint8_t CAPTURE[] = {
+    0x23, 0x10, 0x2C, 0x71, 0x00, 0x00, 0x00, // Timestamp 0x00712C10
+    0x0B, 0xFE, 0xFF, 0x03, 0x00, 0x01, 0x00, // Gyroscope (-2, 3, 1)
+    0x13, 0x2A, 0x00, 0xD6, 0xFF, 0x3A, 0x40, // Accelerometer (42, -42, 16442)
+    0x25, 0x16, 0x2C, 0x71, 0x00, 0x00, 0x00, // Timestamp 0x00712C16
+    0x0C, 0xFF, 0xFF, 0x04, 0x00, 0x00, 0x00, // Gyroscope (-1, 4, 0)
+    0x15, 0x28, 0x00, 0xD5, 0xFF, 0x3C, 0x40, // Accelerometer (40, -43, 16444)
+    0x26, 0x1C, 0x2C, 0x71, 0x00, 0x00, 0x00, // Timestamp 0x00712C1C
+    0x0F, 0x00, 0x00, 0x02, 0x00, 0x01, 0x00, // Gyroscope (0, 2, 1)
+    0x16, 0x29, 0x00, 0xD7, 0xFF, 0x3B, 0x40, // Accelerometer (41, -41, 16443)
+};
+
+} // namespace
+
+TEST(ImuFifo, CapturedStream) {
+    ImuFifo fifo;
+    fifo.decode(CAPTURE, sizeof(CAPTURE));
+
+    // Last batch is pending until a word of the next batch arrives
+    std::vector<ImuFifo::Sample> samples = popAll(fifo);
+    ASSERT_EQ(samples.size(), 2u);
+    EXPECT_EQ(samples[0].timestamp, 0x00712C10u);
+    EXPECT_EQ(samples[0].gyr, (std::array<int16_t, 3>{-2, 3, 1}));
+    EXPECT_EQ(samples[0].acc, (std::array<int16_t, 3>{42, -42, 16442}));
+    EXPECT_EQ(samples[1].timestamp, 0x00712C16u);
+    EXPECT_EQ(samples[1].gyr, (std::array<int16_t, 3>{-1, 4, 0}));
+    EXPECT_EQ(samples[1].acc, (std::array<int16_t, 3>{40, -43, 16444}));
+
+    fifo.decode(Stream().batch(0, 7).data(), ImuFifo::WORD_SIZE);
+    samples = popAll(fifo);
+    ASSERT_EQ(samples.size(), 1u);
+    EXPECT_EQ(samples[0].timestamp, 0x00712C1Cu);
+    EXPECT_EQ(samples[0].acc, (std::array<int16_t, 3>{41, -41, 16443}));
+
+    const ImuFifo::Stats& stats = fifo.getStats();
+    EXPECT_EQ(stats.words, 10u);
+    EXPECT_EQ(stats.samples, 3u);
+    EXPECT_EQ(stats.unknown, 0u);
+}
+
+TEST(ImuFifo, TagCounterGrouping) {
+    // Record order inside a batch is not fixed, the counter (wrapping after 3) separates the batches
+    Stream stream;
+    stream.gyr(1, 10, 11, 12).acc(1, 20, 21, 22);
+    stream.acc(2, 30, 31, 32).gyr(2, 40, 41, 42);
+    stream.gyr(3, 50, 51, 52).acc(3, 60, 61, 62);
+    stream.acc(0, 70, 71, 72).gyr(0, 80, 81, 82);
+    stream.gyr(1, 90, 91, 92).acc(1, 100, 101, 102);
+    stream.gyr(2, 0, 0, 0);
+
+    ImuFifo fifo;
+    fifo.decode(stream.data(), stream.size());
+    std::vector<ImuFifo::Sample> samples = popAll(fifo);
+    ASSERT_EQ(samples.size(), 5u);
+    const int16_t gyrs[] = {10, 40, 50, 80, 90};
+    const int16_t accs[] = {20, 30, 60, 70, 100};
+    for (size_t i = 0; i < samples.size(); i++) {
+        int16_t gyr = gyrs[i];
+        int16_t acc = accs[i];
+        EXPECT_EQ(samples[i].gyr[0], gyr) << "batch " << i;
+        EXPECT_EQ(samples[i].gyr[2], gyr + 2) << "batch " << i;
+        EXPECT_EQ(samples[i].acc[0], acc) << "batch " << i;
+        EXPECT_EQ(samples[i].acc[2], acc + 2) << "batch " << i;
+    }
+    EXPECT_EQ(fifo.getStats().incomplete, 0u);
+}
+
+TEST(ImuFifo, BatchesSplitAcrossDrains) {
+    Stream stream;
+    stream.timestamp(1, 100).gyr(1, 1, 2, 3).acc(1, 4, 5, 6).timestamp(2, 104).gyr(2, 7, 8, 9).acc(2, 10, 11, 12).timestamp(3, 0);
+
+    // Watermark drains end in the middle of a batch
+    ImuFifo fifo;
+    fifo.decode(stream.data(), 2 * ImuFifo::WORD_SIZE);
+    EXPECT_EQ(fifo.size(), 0u);
+    fifo.decode(stream.data() + 2 * ImuFifo::WORD_SIZE, 3 * ImuFifo::WORD_SIZE);
+    EXPECT_EQ(fifo.size(), 1u);
+    fifo.decode(stream.data() + 5 * ImuFifo::WORD_SIZE, stream.size() - 5 * ImuFifo::WORD_SIZE);
+
+    std::vector<ImuFifo::Sample> samples = popAll(fifo);
+    ASSERT_EQ(samples.size(), 2u);
+    EXPECT_EQ(samples[0].timestamp, 100u);
+    EXPECT_EQ(samples[0].acc[2], 6);
+    EXPECT_EQ(samples[1].timestamp, 104u);
+    EXPECT_EQ(samples[1].gyr[0], 7);
+}
+
+TEST(ImuFifo, TimestampAttribution) {
+    // The timestamp of a batch opens it, so it must not be applied to the batch it closes. Batches without a
+    // timestamp record (timestamp decimation) keep the one of the preceding batch
+    Stream stream;
+    stream.timestamp(1, 1000).gyr(1, 1, 0, 0).acc(1, 1, 0, 0);
+    stream.gyr(2, 2, 0, 0).acc(2, 2, 0, 0);
+    stream.gyr(3, 3, 0, 0).timestamp(3, 1012).acc(3, 3, 0, 0); // Timestamp after a record of its batch
+    stream.timestamp(0, 1016).gyr(0, 4, 0, 0).acc(0, 4, 0, 0);
+    stream.timestamp(1, 1020);
+
+    ImuFifo fifo;
+    fifo.decode(stream.data(), stream.size());
+    std::vector<ImuFifo::Sample> samples = popAll(fifo);
+    ASSERT_EQ(samples.size(), 4u);
+    EXPECT_EQ(samples[0].timestamp, 1000u);
+    EXPECT_EQ(samples[1].timestamp, 1000u);
+    EXPECT_EQ(samples[2].timestamp, 1012u);
+    EXPECT_EQ(samples[3].timestamp, 1016u);
+    EXPECT_EQ(samples[3].gyr[0], 4);
+}
+
+TEST(ImuFifo, IncompleteBatches) {
+    Stream stream;
+    stream.gyr(1, 1, 0, 0);                                                     // No accelerometer record
+    stream.timestamp(2, 8).acc(2, 2, 0, 0);                                     // No gyroscope record
+    stream.timestamp(3, 12).word(TAG_TEMPERATURE, 3, {0x10, 0x01, 0, 0, 0, 0}); // Only timestamp and temperature
+    stream.word(TAG_CFG_CHANGE, 0, {}).gyr(0, 4, 0, 0).acc(0, 4, 0, 0);
+    stream.word(0x1F, 1, {}).gyr(1, 5, 0, 0).acc(1, 5, 0, 0); // Unknown tag
+    stream.gyr(2, 0, 0, 0);
+
+    ImuFifo fifo;
+    fifo.decode(stream.data(), stream.size());
+    std::vector<ImuFifo::Sample> samples = popAll(fifo);
+    ASSERT_EQ(samples.size(), 2u);
+    EXPECT_EQ(samples[0].gyr[0], 4);
+    EXPECT_EQ(samples[0].acc[0], 4);
+    EXPECT_EQ(samples[0].timestamp, 12u);
+    EXPECT_EQ(samples[1].gyr[0], 5);
+
+    const ImuFifo::Stats& stats = fifo.getStats();
+    EXPECT_EQ(stats.incomplete, 2u); // Batches without any sensor record are not counted
+    EXPECT_EQ(stats.unknown, 1u);
+    EXPECT_EQ(stats.samples, 2u);
+}
+
+TEST(ImuFifo, PartialWordIgnored) {
+    Stream stream;
+    stream.batch(1, 1).batch(2, 2);
+    ImuFifo fifo;
+    fifo.decode(stream.data(), stream.size() - 1);
+    EXPECT_EQ(fifo.getStats().words, 3u);
+}
+
+TEST(ImuFifo, RingOverrun) {
+    constexpr size_t CAPACITY = ImuFifo::RING_SIZE - 1;
+    constexpr size_t BATCHES = CAPACITY + 5;
+    Stream stream;
+    for (size_t i = 0; i <= BATCHES; i++) // Last batch closes the previous one
+        stream.timestamp(uint8_t(i), uint32_t(i)).batch(uint8_t(i), int16_t(i));
+
+    ImuFifo fifo;
+    fifo.decode(stream.data(), stream.size());
+    EXPECT_EQ(fifo.size(), CAPACITY);
+    EXPECT_EQ(fifo.getStats().samples, CAPACITY);
+    EXPECT_EQ(fifo.getStats().overruns, BATCHES - CAPACITY);
+
+    // Newest batches are dropped, the ring keeps the oldest ones in order
+    ImuFifo::Sample sample;
+    ASSERT_TRUE(fifo.pop(sample));
+    EXPECT_EQ(sample.timestamp, 0u);
+    EXPECT_EQ(fifo.size(), CAPACITY - 1);
+
+    // Space freed by the consumer is used again
+    Stream next;
+    next.batch(uint8_t(BATCHES + 1), 1000).batch(uint8_t(BATCHES + 2), 0);
+    fifo.decode(next.data(), next.size());
+    EXPECT_EQ(fifo.size(), CAPACITY);
+    std::vector<ImuFifo::Sample> samples = popAll(fifo);
+    ASSERT_EQ(samples.size(), CAPACITY);
+    EXPECT_EQ(samples.front().timestamp, 1u);
+    EXPECT_EQ(samples[CAPACITY - 2].gyr[0], int16_t(CAPACITY - 1));
+    EXPECT_EQ(samples.back().gyr[0], int16_t(BATCHES));
+}
+
+TEST(ImuFifo, Reset) {
+    Stream stream;
+    stream.batch(1, 1).batch(2, 2).timestamp(3, 50).gyr(3, 3, 0, 0);
+    ImuFifo fifo;
+    fifo.decode(stream.data(), stream.size());
+    fifo.reset();
+    EXPECT_EQ(fifo.size(), 0u);
+    EXPECT_EQ(fifo.getStats().words, 0u);
+
+    // Pending batch is dropped
+    Stream next;
+    next.acc(3, 3, 0, 0).batch(0, 0);
+    fifo.decode(next.data(), next.size());
+    EXPECT_EQ(fifo.getStats().incomplete, 1u);
+    EXPECT_EQ(fifo.size(), 0u);
+}
@@ -0,0 +1,149 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// logTest.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <cmath>
+#include <cstdio>
+#include <fakeHal.h>
+#include <gtest/gtest.h>
+#include <limits>
+#include <string>
+#include <utils/log.h>
+#include <vector>
+
+namespace {
+
+constexpr char END[] = "\n\r";
+
+// The fake scheduler is running, records are queued until flushed
+class LogTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        FakeHal::reset();
+        if (!FakeHal::recordItm(true))
+            GTEST_SKIP() << "ITM output can not be recorded on this host";
+        records();
+        dropped = Log::getDropped();
+    }
+
+    void TearDown() override { FakeHal::recordItm(false); }
+
+    // Transmitted records without the line end
+    static std::vector<std::string> records() {
+        Log::flush();
+        Log::flush(); // Dropped records are reported into the ring by the previous flush
+        std::string output = FakeHal::takeItm();
+        std::vector<std::string> lines;
+        for (size_t pos = 0, end; (end = output.find(END, pos)) != std::string::npos; pos = end + 2)
+            lines.push_back(output.substr(pos, end - pos));
+        return lines;
+    }
+
+    static std::string record() {
+        std::vector<std::string> lines = records();
+        EXPECT_EQ(lines.size(), 1u);
+        return lines.empty() ? "" : lines[0];
+    }
+
+    uint32_t dropped;
+};
+
+std::string printfFloat(float value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%g", double(value));
+    return buffer;
+}
+
+} // namespace
+
+TEST_F(LogTest, Substitution) {
+    LOG_INFO("Tag", "$1 $0 $2 $3", -12, 34u, 'c', "text");
+    EXPECT_EQ(record(), "[Tag] 34 -12 c text");
+
+    // Index without argument is removed by the unchecked functions
+    Log::info("Tag", "a$5b", 1);
+    EXPECT_EQ(record(), "[Tag] ab");
+
+    LOG_WARNING("Tag", "[r]red[]", 0);
+    EXPECT_EQ(record(), "[Tag] " COLOR_RESET COLOR_RED "red" COLOR_RESET_YELLOW);
+}
+
+TEST_F(LogTest, Hex) {
+    LOG_INFO("Hex", "$x0 $x1 $x2 $x3", 0, 0xABCDEFu, 0xFFFFFFFFu, -1);
+    EXPECT_EQ(record(), "[Hex] 0x0 0xabcdef 0xffffffff 0xffffffff");
+    LOG_INFO("Hex", "$x0 $x1", 0x10000000u, 'A');
+    EXPECT_EQ(record(), "[Hex] 0x10000000 0x41");
+
+    // Pointers are printed in hexadecimal without the x
+    const void* pointer = reinterpret_cast<const void*>(uintptr_t(0x20001234));
+    LOG_INFO("Hex", "$0", pointer);
+    EXPECT_EQ(record(), "[Hex] 0x20001234");
+
+    LOG_INFO("Bin", "$b0 $b1", 5, 0x1FF);
+    EXPECT_EQ(record(), "[Bin] 0b00000101 0b11111111");
+}
+
+TEST_F(LogTest, FloatSpecial) {
+    constexpr float INF = std::numeric_limits<float>::infinity();
+    LOG_INFO("F", "$0 $1 $2 $3 $4", 0.0f, -0.0f, NAN, INF, -INF);
+    EXPECT_EQ(record(), "[F] 0 -0 nan inf -inf");
+}
+
+TEST_F(LogTest, FloatAsPrintf) {
+    // Same notation and six significant digits as %g
+    const std::vector<float> values = {1.0f,   -1.0f,  0.5f,      3.14159265f, 100.0f,          123456.0f, 999999.4f, 999999.6f, 1234567.0f,
+                                       1e-4f,  1e-5f,  1.5e-5f,   0.000123456f, 1e10f,          -2.5e-7f,  9.9999996f, 1e38f,    3.4e38f,
+                                       1e-30f, 1e-35f, 0.1f,      0.3f,        1.17549435e-38f, 65536.0f,  24000.0f,  -42.125f};
+    for (float value : values) {
+        LOG_INFO("F", "$0", value);
+        EXPECT_EQ(record(), "[F] " + printfFloat(value)) << "value " << value;
+    }
+}
+
+TEST_F(LogTest, Truncated) {
+    // Text beyond the record size is dropped, the line end is kept
+    std::string text(200, 'a');
+    Log::info("T", text.c_str());
+    std::string line = record();
+    EXPECT_EQ(line.size(), Log::RECORD_SIZE - (sizeof(END) - 1));
+    EXPECT_EQ(line.substr(0, 6), "[T] aa");
+}
+
+TEST_F(LogTest, RingWrap) {
+    // Records of 22 words, not a divisor of the ring size, so they are split across its end
+    for (int i = 0; i < 120; i++) {
+        LOG_INFO("Wrap", "record $0 abcdefghijklmnopqrstuvwxyz0123456789 abcdefghijklmnopqrstuvwxyz", 1000 + i);
+        if (i % 7 == 6) {
+            std::vector<std::string> lines = records();
+            ASSERT_EQ(lines.size(), 7u);
+            for (int j = 0; j < 7; j++)
+                EXPECT_EQ(lines[j], "[Wrap] record " + std::to_string(1000 + i - 6 + j) +
+                                        " abcdefghijklmnopqrstuvwxyz0123456789 abcdefghijklmnopqrstuvwxyz");
+        }
+    }
+    records();
+    EXPECT_EQ(Log::getDropped(), dropped);
+}
+
+TEST_F(LogTest, Drop) {
+    // Full ring, records are dropped instead of overwriting the queued ones
+    constexpr int N = 100;
+    for (int i = 0; i < N; i++)
+        LOG_INFO("Drop", "$0 ----------------------------------------", i);
+    uint32_t lost = Log::getDropped() - dropped;
+    EXPECT_GT(lost, 0u);
+
+    // The queued records are intact and in order, the drops are reported after them
+    std::vector<std::string> lines = records();
+    ASSERT_EQ(lines.size(), N - lost + 1);
+    for (size_t i = 0; i + 1 < lines.size(); i++)
+        EXPECT_EQ(lines[i], "[Drop] " + std::to_string(i) + " ----------------------------------------");
+    EXPECT_EQ(lines.back(), "[Log] " + std::to_string(lost) + " records dropped");
+
+    // The ring has room again
+    LOG_INFO("Drop", "after");
+    EXPECT_EQ(record(), "[Drop] after");
+    EXPECT_EQ(Log::getDropped() - dropped, lost);
+}
@@ -0,0 +1,142 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// periodStatsTest.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <gtest/gtest.h>
+#include <tasks/periodStats.h>
+
+namespace {
+
+constexpr uint32_t PERIOD = 1000;
+
+// Activation that starts at start and lasts execution cycles
+void activate(PeriodStats& stats, uint32_t start, uint32_t execution) {
+    stats.start(start);
+    stats.finish(start + execution);
+}
+
+} // namespace
+
+TEST(PeriodStats, PeriodicReleaseJitter) {
+    PeriodStats stats;
+    stats.setPeriod(PERIOD, 0);
+    EXPECT_EQ(stats.getDeadline(), PERIOD); // Deadline defaults to the period
+
+    // Releases at 0, 1000, 2000 and 3000
+    activate(stats, 0, 100);
+    activate(stats, 1010, 100);
+    activate(stats, 1990, 100); // Early activations (tick quantization) also count as jitter
+    activate(stats, 3000, 300);
+
+    PeriodStats::Report report = stats.getReport();
+    EXPECT_EQ(report.count, 4u);
+    EXPECT_EQ(report.minPeriod, 980u);
+    EXPECT_EQ(report.maxPeriod, 1010u);
+    EXPECT_EQ(report.meanPeriod, 1000u);
+    EXPECT_EQ(report.maxJitter, 10u);
+    EXPECT_EQ(report.maxExecution, 300u);
+    EXPECT_EQ(report.misses, 0u);
+}
+
+TEST(PeriodStats, JitterIsMeasuredFromTheRelease) {
+    // Jitter does not accumulate: each activation is compared with its release, not with the previous activation
+    PeriodStats stats;
+    stats.setPeriod(PERIOD, 0);
+    activate(stats, 0, 10);
+    activate(stats, 1020, 10);
+    activate(stats, 2040, 10); // 20 cycles after the previous period, 40 after the release
+    EXPECT_EQ(stats.getReport().maxJitter, 40u);
+}
+
+TEST(PeriodStats, CounterWrap) {
+    PeriodStats stats;
+    stats.setPeriod(PERIOD, 0);
+    uint32_t start = 0xFFFFFFFFu - 1500;
+    activate(stats, start, 100);
+    activate(stats, start + 1005, 100);
+    activate(stats, start + 2000, 100); // Cycle counter wrapped
+
+    PeriodStats::Report report = stats.getReport();
+    EXPECT_EQ(report.minPeriod, 995u);
+    EXPECT_EQ(report.maxPeriod, 1005u);
+    EXPECT_EQ(report.maxJitter, 5u);
+    EXPECT_EQ(report.misses, 0u);
+}
+
+TEST(PeriodStats, DeadlineMiss) {
+    PeriodStats stats;
+    stats.setPeriod(PERIOD, 500);
+    activate(stats, 0, 500);    // Finishes at the deadline
+    activate(stats, 1000, 501); // Finishes one cycle late
+    activate(stats, 2300, 300); // Starts late, finishes 600 after the release
+
+    PeriodStats::Report report = stats.getReport();
+    EXPECT_EQ(report.count, 3u);
+    EXPECT_EQ(report.misses, 2u);
+    EXPECT_EQ(report.maxJitter, 300u);
+}
+
+TEST(PeriodStats, SkippedReleases) {
+    // Same sequence as PeriodicTask::run: the activation released at 1000 finishes at 3200, so the release at 2000
+    // is skipped and the release at 3000 is activated late
+    PeriodStats stats;
+    stats.setPeriod(PERIOD, 0);
+    activate(stats, 0, 100);
+    activate(stats, 1000, 2200);
+    stats.skip(1);
+    activate(stats, 3200, 100);
+    activate(stats, 4000, 100);
+
+    PeriodStats::Report report = stats.getReport();
+    EXPECT_EQ(report.count, 4u);
+    EXPECT_EQ(report.misses, 2u);      // Late activation and skipped release
+    EXPECT_EQ(report.maxJitter, 200u); // Release phase is kept after the skip
+    EXPECT_EQ(report.maxPeriod, 2200u);
+    EXPECT_EQ(report.minPeriod, 800u);
+}
+
+TEST(PeriodStats, EventTaskPeriod) {
+    // Event tasks have no release, jitter is the change between consecutive periods
+    PeriodStats stats;
+    stats.setPeriod(0, 500);
+    EXPECT_EQ(stats.getPeriod(), 0u);
+    activate(stats, 0, 100);
+    activate(stats, 1000, 100);
+    activate(stats, 2500, 600); // Deadline is measured from the start
+    activate(stats, 3000, 500);
+
+    PeriodStats::Report report = stats.getReport();
+    EXPECT_EQ(report.count, 4u);
+    EXPECT_EQ(report.minPeriod, 500u);
+    EXPECT_EQ(report.maxPeriod, 1500u);
+    EXPECT_EQ(report.meanPeriod, 1000u);
+    EXPECT_EQ(report.maxJitter, 1000u);
+    EXPECT_EQ(report.maxExecution, 600u);
+    EXPECT_EQ(report.misses, 1u);
+}
+
+TEST(PeriodStats, EventTaskWithoutDeadline) {
+    PeriodStats stats;
+    stats.setPeriod(0, 0);
+    activate(stats, 0, 100000);
+    activate(stats, 200000, 100000);
+    EXPECT_EQ(stats.getReport().misses, 0u);
+}
+
+TEST(PeriodStats, ResetKeepsReleasePhase) {
+    PeriodStats stats;
+    stats.setPeriod(PERIOD, 0);
+    activate(stats, 0, 100);
+    activate(stats, 1050, 100);
+    stats.reset();
+    EXPECT_EQ(stats.getReport().count, 0u);
+
+    activate(stats, 2000, 100);
+    PeriodStats::Report report = stats.getReport();
+    EXPECT_EQ(report.count, 1u);
+    EXPECT_EQ(report.maxJitter, 0u);
+    EXPECT_EQ(report.minPeriod, 950u);
+    EXPECT_EQ(report.meanPeriod, 950u);
+}
@@ -0,0 +1,167 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// phaseTest.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <array>
+#include <drivers/phase/phase.h>
+#include <fakeHal.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Register addresses and values from the INA239-Q1 datasheet
+constexpr uint8_t REG_CONFIG = 0x00;
+constexpr uint8_t REG_VSHUNT = 0x04;
+constexpr uint8_t REG_VBUS = 0x05;
+constexpr uint8_t REG_DIETEMP = 0x06;
+constexpr uint8_t REG_DIAG_ALRT = 0x0B;
+constexpr uint8_t REG_MANUFACTURER_ID = 0x3E;
+constexpr uint8_t REG_DEVICE_ID = 0x3F;
+constexpr uint16_t DIAG_MEMSTAT = 1 << 0;
+constexpr uint16_t DIAG_MATHOF = 1 << 9;
+constexpr float SHUNT_RESISTANCE = 0.150f;
+
+constexpr Spi::Peripheral PERIPHERAL = Spi::Peripheral::SPI2;
+constexpr Gpio::Gpio CHIP_SELECT = Gpio::PB12;
+constexpr Gpio::Gpio ALERT = Gpio::PC6;
+
+// INA239 register file, 24-bit frames: address (bits 7-2) and read bit (bit 0), then 16-bit data
+struct Ina239 {
+    std::array<uint16_t, 64> regs{};
+
+    Ina239() {
+        regs[REG_MANUFACTURER_ID] = 0x5449;
+        regs[REG_DEVICE_ID] = 0x2391;
+        regs[REG_DIAG_ALRT] = DIAG_MEMSTAT;
+    }
+
+    static void exchange(const FakeHal::Transfer& transfer, void* context) {
+        Ina239* ina = static_cast<Ina239*>(context);
+        ASSERT_EQ(transfer.len, 3);
+        ASSERT_NE(transfer.txData, nullptr);
+        uint8_t reg = transfer.txData[0] >> 2;
+        if (transfer.txData[0] & 0b1) {
+            ASSERT_NE(transfer.rxData, nullptr);
+            transfer.rxData[0] = 0;
+            transfer.rxData[1] = ina->regs[reg] >> 8;
+            transfer.rxData[2] = ina->regs[reg] & 0xFF;
+        } else {
+            uint16_t value = (transfer.txData[1] << 8) | transfer.txData[2];
+            ina->regs[reg] = reg == REG_CONFIG ? value & 0x7FFF : value; // Reset bit self clears
+        }
+    }
+};
+
+class PhaseTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        FakeHal::reset();
+        FakeHal::initSpi();
+        FakeHal::setSpiDevice(Spi::getHandle(PERIPHERAL), Ina239::exchange, &ina);
+        FakeHal::setAutoComplete(true);
+    }
+
+    void TearDown() override {
+        phase.stopContinuous();
+        FakeHal::setAutoComplete(true);
+    }
+
+    // Conversion ready: the reads queued by the ALERT interrupt complete one by one
+    void convert() {
+        FakeHal::setAutoComplete(false);
+        FakeHal::fireGpioInterrupt(ALERT);
+        SPI_HandleTypeDef* hspi = Spi::getHandle(PERIPHERAL);
+        while (FakeHal::completeTransfer(hspi)) {
+        }
+        FakeHal::setAutoComplete(true);
+    }
+
+    Ina239 ina;
+    Phase phase;
+};
+
+} // namespace
+
+TEST(PhaseDecode, Current) {
+    // 5 uV/LSB (163.84 mV range) and 1.25 uV/LSB (40.96 mV range) across the shunt
+    EXPECT_FLOAT_EQ(Phase::decodeCurrent(0x0000, 0), 0.0f);
+    EXPECT_FLOAT_EQ(Phase::decodeCurrent(0x0001, 0), 5e-6f / SHUNT_RESISTANCE);
+    EXPECT_FLOAT_EQ(Phase::decodeCurrent(0x7FFF, 0), 32767 * 5e-6f / SHUNT_RESISTANCE);
+    EXPECT_FLOAT_EQ(Phase::decodeCurrent(0xFFFF, 0), -5e-6f / SHUNT_RESISTANCE);
+    EXPECT_FLOAT_EQ(Phase::decodeCurrent(0x8000, 0), -32768 * 5e-6f / SHUNT_RESISTANCE);
+    EXPECT_FLOAT_EQ(Phase::decodeCurrent(0x7530, 0), 1.0f); // 30000 LSB = 150 mV = 1 A
+    EXPECT_FLOAT_EQ(Phase::decodeCurrent(0x7530, 1), 0.25f);
+    EXPECT_FLOAT_EQ(Phase::decodeCurrent(0x8AD0, 1), -0.25f);
+}
+
+TEST(PhaseDecode, Voltage) {
+    // 3.125 mV/LSB, two's complement
+    EXPECT_FLOAT_EQ(Phase::decodeVoltage(0x0000), 0.0f);
+    EXPECT_FLOAT_EQ(Phase::decodeVoltage(0x0001), 3.125e-3f);
+    EXPECT_FLOAT_EQ(Phase::decodeVoltage(0x1E00), 24.0f);
+    EXPECT_FLOAT_EQ(Phase::decodeVoltage(0x7FFF), 32767 * 3.125e-3f);
+    EXPECT_FLOAT_EQ(Phase::decodeVoltage(0xFFFF), -3.125e-3f);
+}
+
+TEST(PhaseDecode, Temperature) {
+    // 125 m°C/LSB, 12-bit two's complement in bits 15-4 (bits 3-0 are reserved)
+    EXPECT_FLOAT_EQ(Phase::decodeTemperature(0x0000), 0.0f);
+    EXPECT_FLOAT_EQ(Phase::decodeTemperature(0x0010), 0.125f);
+    EXPECT_FLOAT_EQ(Phase::decodeTemperature(0x0C80), 25.0f);
+    EXPECT_FLOAT_EQ(Phase::decodeTemperature(0x7FF0), 255.875f);
+    EXPECT_FLOAT_EQ(Phase::decodeTemperature(0xFFF0), -0.125f);
+    EXPECT_FLOAT_EQ(Phase::decodeTemperature(0xEC00), -40.0f);
+    EXPECT_FLOAT_EQ(Phase::decodeTemperature(0x8000), -256.0f);
+    EXPECT_FLOAT_EQ(Phase::decodeTemperature(0x0C8F), 25.0f); // Reserved bits are ignored
+}
+
+TEST(PhaseDecode, DiagAlrt) {
+    EXPECT_TRUE(Phase::isConversionValid(DIAG_MEMSTAT));
+    EXPECT_TRUE(Phase::isConversionValid(DIAG_MEMSTAT | (0xF0FE & ~DIAG_MATHOF))); // Limit and alert flags are not errors
+    EXPECT_FALSE(Phase::isConversionValid(0x0000));                                // Memory checksum error
+    EXPECT_FALSE(Phase::isConversionValid(DIAG_MEMSTAT | DIAG_MATHOF));
+    EXPECT_FALSE(Phase::isConversionValid(DIAG_MATHOF));
+}
+
+TEST_F(PhaseTest, ContinuousSnapshot) {
+    ASSERT_TRUE(phase.init(Phase::U, PERIPHERAL, CHIP_SELECT));
+    ASSERT_TRUE(phase.startContinuous(ALERT));
+    EXPECT_FALSE(phase.getSnapshot().has_value());
+
+    ina.regs[REG_VSHUNT] = 0xFFFF;
+    ina.regs[REG_VBUS] = 0x1E00;
+    ina.regs[REG_DIETEMP] = 0xFFF0;
+    ina.regs[REG_DIAG_ALRT] = DIAG_MEMSTAT;
+    FakeHal::advanceCycles(1000);
+    convert();
+
+    std::optional<Phase::Snapshot> snapshot = phase.getSnapshot();
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_FLOAT_EQ(snapshot->current, -5e-6f / SHUNT_RESISTANCE);
+    EXPECT_FLOAT_EQ(snapshot->voltage, 24.0f);
+    EXPECT_FLOAT_EQ(snapshot->temperature, -0.125f);
+    EXPECT_EQ(snapshot->cycles, DWT->CYCCNT);
+    EXPECT_EQ(phase.getErrors(), 0u);
+}
+
+TEST_F(PhaseTest, ContinuousDiagnosticErrors) {
+    ASSERT_TRUE(phase.init(Phase::U, PERIPHERAL, CHIP_SELECT));
+    ASSERT_TRUE(phase.startContinuous(ALERT));
+
+    // Conversions flagged by DIAG_ALRT are not published
+    ina.regs[REG_DIETEMP] = 0x0C80;
+    ina.regs[REG_DIAG_ALRT] = DIAG_MEMSTAT | DIAG_MATHOF;
+    convert();
+    ina.regs[REG_DIAG_ALRT] = 0x0000;
+    convert();
+    EXPECT_FALSE(phase.getSnapshot().has_value());
+    EXPECT_EQ(phase.getErrors(), 2u);
+
+    ina.regs[REG_DIAG_ALRT] = DIAG_MEMSTAT;
+    convert();
+    ASSERT_TRUE(phase.getSnapshot().has_value());
+    EXPECT_FLOAT_EQ(phase.getSnapshot()->temperature, 25.0f);
+    EXPECT_EQ(phase.getErrors(), 2u);
+}
@@ -0,0 +1,176 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// scheduledTaskTest.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <common/attaConnectorCmds.h>
+#include <fakeHal.h>
+#include <fakeRtos.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <tasks/scheduledTask.h>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t PERIOD = 10;                    // ms (ticks)
+constexpr uint32_t TICK_CYCLES = 144000000 / 1000; // Cycles per tick
+
+// Task function: records the activation ticks and runs for the execution time of each activation
+std::vector<TickType_t> activations;
+std::vector<TickType_t> executions;
+EventTask* notifySelf = nullptr; // Notified by the first activation
+
+void step() {
+    size_t i = activations.size();
+    activations.push_back(xTaskGetTickCount());
+    if (notifySelf && i == 0)
+        notifySelf->notifyFromIsr();
+    FakeRtos::advanceTicks(i < executions.size() ? executions[i] : 1);
+}
+
+class ScheduledTaskTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        FakeHal::reset();
+        FakeRtos::reset();
+        activations.clear();
+        executions.clear();
+        notifySelf = nullptr;
+    }
+
+    // Periodic task of PERIOD with the deadline at the next release
+    PeriodicTask::Config periodic() { return {"Periodic", step, PERIOD, 0, 1, 512}; }
+};
+
+} // namespace
+
+TEST_F(ScheduledTaskTest, PeriodicOnTime) {
+    PeriodicTask task;
+    ASSERT_TRUE(task.start(periodic()));
+    executions = {2, 2, 2, 2};
+    EXPECT_EQ(FakeRtos::runTask(task.getHandle(), 3), 3u);
+    EXPECT_EQ(activations, std::vector<TickType_t>({0, 10, 20, 30}));
+
+    PeriodStats::Report report = task.getReport();
+    EXPECT_EQ(report.count, 4u);
+    EXPECT_EQ(report.meanPeriod, PERIOD * TICK_CYCLES);
+    EXPECT_EQ(report.maxExecution, 2 * TICK_CYCLES);
+    EXPECT_EQ(report.maxJitter, 0u);
+    EXPECT_EQ(report.misses, 0u);
+}
+
+TEST_F(ScheduledTaskTest, PeriodicLateLessThanTwoPeriods) {
+    // Finishes 9 ticks after the next release, which is activated at once without skipping
+    PeriodicTask task;
+    ASSERT_TRUE(task.start(periodic()));
+    executions = {1, 19, 1, 1};
+    FakeRtos::runTask(task.getHandle(), 3);
+    EXPECT_EQ(activations, std::vector<TickType_t>({0, 10, 29, 30}));
+
+    PeriodStats::Report report = task.getReport();
+    EXPECT_EQ(report.count, 4u);
+    EXPECT_EQ(report.maxJitter, 9 * TICK_CYCLES);
+    EXPECT_EQ(report.misses, 1u);
+}
+
+TEST_F(ScheduledTaskTest, PeriodicSkipOneRelease) {
+    // Late by exactly two periods: the release at 20 is skipped, the one at 30 is on time
+    PeriodicTask task;
+    ASSERT_TRUE(task.start(periodic()));
+    executions = {1, 20, 1, 1};
+    FakeRtos::runTask(task.getHandle(), 3);
+    EXPECT_EQ(activations, std::vector<TickType_t>({0, 10, 30, 40}));
+
+    PeriodStats::Report report = task.getReport();
+    EXPECT_EQ(report.count, 4u);
+    EXPECT_EQ(report.maxJitter, 0u);
+    EXPECT_EQ(report.misses, 2u); // Late activation and the skipped release
+}
+
+TEST_F(ScheduledTaskTest, PeriodicSkipKeepsPhase) {
+    // Finishes at 45: the releases at 20 and 30 are skipped, the one at 40 runs late and 50 is back on time
+    PeriodicTask task;
+    ASSERT_TRUE(task.start(periodic()));
+    executions = {1, 35, 1, 1, 1};
+    FakeRtos::runTask(task.getHandle(), 4);
+    EXPECT_EQ(activations, std::vector<TickType_t>({0, 10, 45, 50, 60}));
+
+    PeriodStats::Report report = task.getReport();
+    EXPECT_EQ(report.count, 5u);
+    EXPECT_EQ(report.maxJitter, 5 * TICK_CYCLES);
+    EXPECT_EQ(report.misses, 3u);
+}
+
+TEST_F(ScheduledTaskTest, PeriodicShorterThanTick) {
+    PeriodicTask task;
+    PeriodicTask::Config config = periodic();
+    config.period = 0;
+    EXPECT_FALSE(task.start(config));
+    EXPECT_EQ(task.getHandle(), nullptr);
+    EXPECT_TRUE(task.transmit()); // Nothing to send
+}
+
+TEST_F(ScheduledTaskTest, EventNotifications) {
+    EventTask task;
+    task.notify(); // Not started, ignored
+    task.notifyFromIsr();
+    ASSERT_TRUE(task.start({"Event", step, 0, 0, 1, 512}));
+
+    // Waits forever without a notification
+    EXPECT_EQ(FakeRtos::runTask(task.getHandle(), 10), 0u);
+    EXPECT_TRUE(activations.empty());
+
+    // Notifications given before the task runs are merged into one activation
+    task.notify();
+    task.notifyFromIsr();
+    EXPECT_EQ(FakeRtos::runTask(task.getHandle(), 10), 1u);
+    EXPECT_EQ(activations.size(), 1u);
+
+    // Notification given while the function runs activates it again
+    activations.clear();
+    notifySelf = &task;
+    task.notify();
+    EXPECT_EQ(FakeRtos::runTask(task.getHandle(), 10), 2u);
+    EXPECT_EQ(activations.size(), 2u);
+    EXPECT_EQ(task.getReport().count, 3u);
+}
+
+TEST_F(ScheduledTaskTest, EventTimeout) {
+    // Timeouts run the function without counting activations
+    EventTask task;
+    ASSERT_TRUE(task.start({"Event", step, 5, 3, 1, 512}));
+    EXPECT_EQ(FakeRtos::runTask(task.getHandle(), 3), 3u);
+    EXPECT_EQ(activations, std::vector<TickType_t>({5, 11, 17}));
+    EXPECT_EQ(task.getReport().count, 0u);
+
+    // Notified activation longer than the deadline
+    activations.clear();
+    executions = {4};
+    task.notify();
+    FakeRtos::runTask(task.getHandle(), 1);
+    ASSERT_EQ(activations.size(), 1u);
+    PeriodStats::Report report = task.getReport();
+    EXPECT_EQ(report.count, 1u);
+    EXPECT_EQ(report.maxExecution, 4 * TICK_CYCLES);
+    EXPECT_EQ(report.misses, 1u);
+}
+
+TEST_F(ScheduledTaskTest, Transmit) {
+    PeriodicTask task;
+    ASSERT_TRUE(task.start(periodic()));
+    FakeRtos::runTask(task.getHandle(), 2);
+    ASSERT_TRUE(task.transmit());
+
+    TaskTiming cmd{};
+    ASSERT_TRUE(FakeHal::getTransmitted(&cmd));
+    EXPECT_EQ(std::string(cmd.name.data()), "Periodic");
+    EXPECT_EQ(cmd.clock, 144000000u);
+    EXPECT_EQ(cmd.period, PERIOD * TICK_CYCLES);
+    EXPECT_EQ(cmd.deadline, PERIOD * TICK_CYCLES);
+    EXPECT_EQ(cmd.count, 3u);
+
+    // The report restarts
+    EXPECT_EQ(task.getReport().count, 0u);
+}
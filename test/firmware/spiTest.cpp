@@ -0,0 +1,329 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// spiTest.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <drivers/spi/spi.h>
+#include <fakeHal.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr Spi::Peripheral PERIPHERAL = Spi::Peripheral::SPI2;
+constexpr Gpio::Gpio CS_A = Gpio::PB12;
+constexpr Gpio::Gpio CS_B = Gpio::PC7;
+
+// Bus model: records the first transmitted word of each transfer and answers with its complement
+struct Bus {
+    std::string order;
+
+    static void exchange(const FakeHal::Transfer& transfer, void* context) {
+        Bus* bus = static_cast<Bus*>(context);
+        if (transfer.txData == nullptr)
+            return;
+        bus->order += char(transfer.txData[0]);
+        if (transfer.rxData)
+            transfer.rxData[0] = ~transfer.txData[0];
+    }
+};
+
+// Queued transaction transmitting a single identifying byte
+struct Frame {
+    Spi::Transaction transaction;
+    uint8_t tx;
+    uint8_t rx = 0;
+    int callbacks = 0;
+    bool lastSuccess = false;
+    int resubmit = 0; // Times the callback submits the transaction again
+
+    Frame(const Spi::Device& device, char id, Spi::Priority priority = Spi::Priority::NORMAL) : tx(id) {
+        transaction.device = &device;
+        transaction.txData = &tx;
+        transaction.rxData = &rx;
+        transaction.len = 1;
+        transaction.priority = priority;
+        transaction.callback = callback;
+        transaction.context = this;
+    }
+
+    static void callback(Spi::Transaction* transaction, bool success) {
+        Frame* frame = static_cast<Frame*>(transaction->context);
+        frame->callbacks++;
+        frame->lastSuccess = success;
+        if (frame->resubmit > 0) {
+            frame->resubmit--;
+            Spi::submit(transaction);
+        }
+    }
+};
+
+GPIO_TypeDef* port(Gpio::Gpio gpio) { return reinterpret_cast<GPIO_TypeDef*>(GPIOA_BASE + uint32_t(gpio.port) * (GPIOB_BASE - GPIOA_BASE)); }
+
+bool selected(Gpio::Gpio gpio) { return port(gpio)->BSRR == (1u << (gpio.pin + 16)); } // Last BSRR write cleared the pin
+
+class SpiTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        FakeHal::reset();
+        FakeHal::initSpi();
+        FakeHal::setSpiDevice(hspi, Bus::exchange, &bus);
+        Spi::resetStats(PERIPHERAL);
+    }
+
+    void TearDown() override {
+        // The scheduler state outlives the test, leave the bus idle
+        while (FakeHal::completeTransfer(hspi)) {
+        }
+    }
+
+    // Complete transfers until the bus is idle
+    void drain() {
+        while (FakeHal::completeTransfer(hspi)) {
+        }
+    }
+
+    SPI_HandleTypeDef* hspi = Spi::getHandle(PERIPHERAL);
+    Spi::Device deviceA{PERIPHERAL, CS_A, Spi::SpiConfig::MODE_3, Spi::SpiConfig::DATA_SIZE_8BIT, Spi::SpiConfig::PRESCALER_4};
+    Spi::Device deviceB{PERIPHERAL, CS_B, Spi::SpiConfig::MODE_1, Spi::SpiConfig::DATA_SIZE_16BIT, Spi::SpiConfig::PRESCALER_16};
+    Bus bus;
+};
+
+} // namespace
+
+TEST_F(SpiTest, SubmitRejected) {
+    Frame frame(deviceA, 'a');
+    frame.transaction.len = 0;
+    EXPECT_FALSE(Spi::submit(&frame.transaction));
+    frame.transaction.len = 1;
+    frame.transaction.txData = nullptr;
+    frame.transaction.rxData = nullptr;
+    EXPECT_FALSE(Spi::submit(&frame.transaction));
+    frame.transaction.device = nullptr;
+    EXPECT_FALSE(Spi::submit(&frame.transaction));
+    EXPECT_EQ(FakeHal::getTransfers(hspi), 0u);
+}
+
+TEST_F(SpiTest, PriorityOrder) {
+    // First transaction starts on the idle bus, the others are served by priority and in submission order within a priority
+    Frame active(deviceA, 'a');
+    Frame low(deviceA, 'l', Spi::Priority::LOW);
+    Frame normal1(deviceA, 'n', Spi::Priority::NORMAL);
+    Frame high1(deviceA, 'h', Spi::Priority::HIGH);
+    Frame normal2(deviceA, 'm', Spi::Priority::NORMAL);
+    Frame high2(deviceA, 'i', Spi::Priority::HIGH);
+    for (Frame* frame : {&active, &low, &normal1, &high1, &normal2, &high2})
+        ASSERT_TRUE(Spi::submit(&frame->transaction));
+    EXPECT_EQ(FakeHal::getTransfers(hspi), 1u);
+
+    drain();
+    EXPECT_EQ(bus.order, "ahinml");
+    for (Frame* frame : {&active, &low, &normal1, &high1, &normal2, &high2}) {
+        EXPECT_TRUE(frame->transaction.done);
+        EXPECT_TRUE(frame->transaction.success);
+        EXPECT_EQ(frame->callbacks, 1);
+        EXPECT_EQ(frame->rx, uint8_t(~frame->tx));
+    }
+}
+
+TEST_F(SpiTest, CancelQueued) {
+    Frame active(deviceA, 'a');
+    Frame first(deviceA, 'b');
+    Frame middle(deviceA, 'c');
+    Frame last(deviceA, 'd');
+    for (Frame* frame : {&active, &first, &middle, &last})
+        ASSERT_TRUE(Spi::submit(&frame->transaction));
+
+    // Unlinked from the head, middle and tail of the list without touching the transfer in progress
+    Spi::cancel(&middle.transaction);
+    Spi::cancel(&first.transaction);
+    Spi::cancel(&last.transaction);
+    for (Frame* frame : {&first, &middle, &last}) {
+        EXPECT_TRUE(frame->transaction.done);
+        EXPECT_FALSE(frame->transaction.success);
+        EXPECT_EQ(frame->callbacks, 0); // Canceled by the caller, it already knows
+    }
+    EXPECT_EQ(FakeHal::getAborts(hspi), 0u);
+
+    // Tail was reset, a new transaction queues behind the active one only
+    Frame next(deviceA, 'e');
+    ASSERT_TRUE(Spi::submit(&next.transaction));
+    drain();
+    EXPECT_EQ(bus.order, "ae");
+
+    // Canceling a completed transaction does nothing
+    Spi::cancel(&active.transaction);
+    EXPECT_EQ(active.callbacks, 1);
+    EXPECT_TRUE(active.lastSuccess);
+    EXPECT_EQ(FakeHal::getAborts(hspi), 0u);
+}
+
+TEST_F(SpiTest, CancelActive) {
+    Frame active(deviceA, 'a');
+    Frame queued(deviceA, 'b');
+    ASSERT_TRUE(Spi::submit(&active.transaction));
+    ASSERT_TRUE(Spi::submit(&queued.transaction));
+    EXPECT_TRUE(selected(CS_A));
+
+    // Transfer is aborted, the callback reports the failure and the next transaction starts
+    Spi::cancel(&active.transaction);
+    EXPECT_EQ(FakeHal::getAborts(hspi), 1u);
+    EXPECT_EQ(active.callbacks, 1);
+    EXPECT_FALSE(active.lastSuccess);
+    EXPECT_TRUE(active.transaction.done);
+    EXPECT_FALSE(active.transaction.success);
+    EXPECT_TRUE(FakeHal::isPending(hspi));
+    EXPECT_EQ(FakeHal::getPending(hspi).txData, &queued.tx);
+    EXPECT_EQ(FakeHal::getTransfers(hspi), 2u);
+
+    drain();
+    EXPECT_EQ(bus.order, "b");
+    EXPECT_EQ(queued.callbacks, 1);
+    Spi::Stats stats = Spi::getStats(PERIPHERAL);
+    EXPECT_EQ(stats.transactions, 2u);
+    EXPECT_EQ(stats.errors, 1u);
+}
+
+TEST_F(SpiTest, CallbackResubmit) {
+    // The callback runs before the next transaction starts, a resubmitted transaction still waits for higher priorities
+    Frame periodic(deviceA, 'p');
+    periodic.resubmit = 2;
+    Frame urgent(deviceA, 'u', Spi::Priority::HIGH);
+    ASSERT_TRUE(Spi::submit(&periodic.transaction));
+    ASSERT_TRUE(Spi::submit(&urgent.transaction));
+
+    drain();
+    EXPECT_EQ(bus.order, "pupp");
+    EXPECT_EQ(periodic.callbacks, 3);
+    EXPECT_EQ(urgent.callbacks, 1);
+
+    // Resubmitted from the callback of a failed transfer, it is started right away on the idle bus
+    periodic.resubmit = 1;
+    ASSERT_TRUE(Spi::submit(&periodic.transaction));
+    FakeHal::completeTransfer(hspi, false);
+    EXPECT_FALSE(periodic.lastSuccess);
+    EXPECT_TRUE(FakeHal::isPending(hspi));
+    drain();
+    EXPECT_TRUE(periodic.lastSuccess);
+    EXPECT_EQ(bus.order, "puppp");
+
+    // Resubmitted from the callback of a canceled transfer
+    periodic.resubmit = 1;
+    ASSERT_TRUE(Spi::submit(&periodic.transaction));
+    Spi::cancel(&periodic.transaction);
+    EXPECT_TRUE(FakeHal::isPending(hspi));
+    EXPECT_FALSE(periodic.transaction.done);
+    drain();
+    EXPECT_EQ(bus.order, "pupppp");
+}
+
+TEST_F(SpiTest, ChipSelectAndConfiguration) {
+    // Devices with different settings share the peripheral, it is reconfigured when the bus switches between them
+    Frame frameA(deviceA, 'a');
+    Frame frameB(deviceB, 'b');
+    Frame frameA2(deviceA, 'c');
+    ASSERT_TRUE(Spi::submit(&frameA.transaction));
+    ASSERT_TRUE(Spi::submit(&frameB.transaction));
+    ASSERT_TRUE(Spi::submit(&frameA2.transaction));
+    EXPECT_TRUE(selected(CS_A));
+
+    FakeHal::completeTransfer(hspi);
+    EXPECT_FALSE(selected(CS_A));
+    EXPECT_TRUE(selected(CS_B));
+    uint32_t cr1 = hspi->Instance->CR1;
+    EXPECT_TRUE(cr1 & SPI_CR1_SPE);
+    EXPECT_TRUE(cr1 & SPI_CR1_DFF);
+    EXPECT_FALSE(cr1 & SPI_CR1_CPOL);
+    EXPECT_TRUE(cr1 & SPI_CR1_CPHA);
+    EXPECT_EQ(cr1 & SPI_CR1_BR, SPI_BAUDRATEPRESCALER_16);
+    EXPECT_EQ(hspi->hdmatx->Instance->CR & DMA_SxCR_PSIZE, DMA_PDATAALIGN_HALFWORD);
+    EXPECT_EQ(hspi->hdmarx->Instance->CR & DMA_SxCR_MSIZE, DMA_MDATAALIGN_HALFWORD);
+
+    FakeHal::completeTransfer(hspi);
+    EXPECT_FALSE(selected(CS_B));
+    EXPECT_TRUE(selected(CS_A));
+    cr1 = hspi->Instance->CR1;
+    EXPECT_FALSE(cr1 & SPI_CR1_DFF);
+    EXPECT_TRUE(cr1 & SPI_CR1_CPOL);
+    EXPECT_TRUE(cr1 & SPI_CR1_CPHA);
+    EXPECT_EQ(cr1 & SPI_CR1_BR, SPI_BAUDRATEPRESCALER_4);
+    EXPECT_EQ(hspi->hdmatx->Instance->CR & DMA_SxCR_PSIZE, DMA_PDATAALIGN_BYTE);
+
+    FakeHal::completeTransfer(hspi);
+    EXPECT_FALSE(selected(CS_A));
+    EXPECT_EQ(bus.order, "abc");
+}
+
+TEST_F(SpiTest, ChipSelectEdges) {
+    // Each chip select goes low when its transfer starts and high when it completes, before the next one is selected
+    if (!FakeHal::recordGpio(true))
+        GTEST_SKIP() << "GPIO writes can not be recorded on this host";
+    Frame frameA(deviceA, 'a');
+    Frame frameB(deviceB, 'b');
+    ASSERT_TRUE(Spi::submit(&frameA.transaction));
+    ASSERT_TRUE(Spi::submit(&frameB.transaction));
+    using Writes = std::vector<FakeHal::GpioWrite>;
+    EXPECT_EQ(FakeHal::getGpioWrites(), Writes({{CS_A, false}}));
+
+    FakeHal::completeTransfer(hspi);
+    EXPECT_EQ(FakeHal::getGpioWrites(), Writes({{CS_A, false}, {CS_A, true}, {CS_B, false}}));
+    FakeHal::completeTransfer(hspi, false);
+    EXPECT_EQ(FakeHal::getGpioWrites(), Writes({{CS_A, false}, {CS_A, true}, {CS_B, false}, {CS_B, true}}));
+    FakeHal::recordGpio(false);
+}
+
+TEST_F(SpiTest, BlockingTransfer) {
+    // Completes when the DMA interrupt runs while waiting
+    FakeHal::setAutoComplete(true);
+    uint8_t tx = 'x';
+    uint8_t rx = 0;
+    EXPECT_TRUE(Spi::transfer(deviceA, &tx, &rx, 1));
+    EXPECT_EQ(rx, uint8_t(~tx));
+
+    // Interrupt never comes, the transaction is canceled after the timeout and the bus is free again
+    FakeHal::setAutoComplete(false);
+    EXPECT_FALSE(Spi::transfer(deviceA, &tx, &rx, 1));
+    EXPECT_EQ(FakeHal::getAborts(hspi), 1u);
+    EXPECT_FALSE(FakeHal::isPending(hspi));
+
+    Frame frame(deviceA, 'f');
+    ASSERT_TRUE(Spi::submit(&frame.transaction));
+    EXPECT_TRUE(FakeHal::isPending(hspi));
+    drain();
+    EXPECT_EQ(bus.order, "xf");
+}
+
+TEST_F(SpiTest, NotifyAndStats) {
+    ulTaskNotifyTake(pdTRUE, 0);
+    Frame first(deviceA, 'a');
+    Frame second(deviceA, 'b');
+    first.transaction.notify = xTaskGetCurrentTaskHandle();
+    second.transaction.notify = xTaskGetCurrentTaskHandle();
+
+    // Second waits 100 cycles for the first, each transfer takes 100 cycles, then the bus is idle for 200 cycles
+    ASSERT_TRUE(Spi::submit(&first.transaction));
+    ASSERT_TRUE(Spi::submit(&second.transaction));
+    FakeHal::advanceCycles(100);
+    FakeHal::completeTransfer(hspi);
+    FakeHal::advanceCycles(100);
+    FakeHal::completeTransfer(hspi, false);
+    FakeHal::advanceCycles(200);
+    EXPECT_EQ(ulTaskNotifyTake(pdTRUE, 0), 2u);
+
+    Spi::Stats stats = Spi::getStats(PERIPHERAL);
+    EXPECT_EQ(stats.transactions, 2u);
+    EXPECT_EQ(stats.errors, 1u);
+    EXPECT_EQ(stats.lastLatency, 200u);
+    EXPECT_EQ(stats.maxLatency, 200u);
+    EXPECT_EQ(stats.sumLatency, 300u);
+    EXPECT_EQ(stats.busyCycles, 200u);
+    EXPECT_FLOAT_EQ(Spi::getUtilization(PERIPHERAL), 0.5f);
+
+    Spi::resetStats(PERIPHERAL);
+    stats = Spi::getStats(PERIPHERAL);
+    EXPECT_EQ(stats.transactions, 0u);
+    EXPECT_EQ(stats.resetCycles, DWT->CYCCNT);
+    EXPECT_FLOAT_EQ(Spi::getUtilization(PERIPHERAL), 0.0f);
+}
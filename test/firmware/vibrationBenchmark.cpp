@@ -0,0 +1,91 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// vibrationBenchmark.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <chrono>
+#include <cmath>
+#include <drivers/imu/vibration.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+constexpr float SAMPLE_RATE = 1666.0f;
+constexpr size_t FRAMES = 2048;
+
+// Windowed direct DFT power of all the bins of one axis, the transform the FFT replaces
+void referenceDft(const std::vector<float>& input, const std::vector<float>& window, std::vector<float>& power) {
+    size_t n = input.size();
+    for (size_t k = 0; k < power.size(); k++) {
+        float re = 0.0f;
+        float im = 0.0f;
+        for (size_t i = 0; i < n; i++) {
+            float phase = 2.0f * float(M_PI) * float((k * i) % n) / n;
+            re += input[i] * window[i] * std::cos(phase);
+            im -= input[i] * window[i] * std::sin(phase);
+        }
+        power[k] = re * re + im * im;
+    }
+}
+
+} // namespace
+
+TEST(VibrationBenchmark, Frame) {
+    // Accelerometer samples of a 3 axis tone, generated before timing
+    std::vector<std::array<int16_t, 3>> samples(Vibration::FFT_SIZE + FRAMES * Vibration::HOP_SIZE);
+    for (size_t n = 0; n < samples.size(); n++) {
+        float s = 1000.0f * std::sin(2.0f * float(M_PI) * 100.3f * n / SAMPLE_RATE);
+        samples[n] = {int16_t(s), int16_t(-s), int16_t(16393 + s / 2)};
+    }
+
+    static Vibration vibration(SAMPLE_RATE);
+    auto start = std::chrono::steady_clock::now();
+    for (const std::array<int16_t, 3>& sample : samples)
+        vibration.push(sample);
+    double fftUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / vibration.getFrames();
+    ASSERT_EQ(vibration.getFrames(), FRAMES + 1);
+
+    std::vector<float> input(Vibration::FFT_SIZE);
+    std::vector<float> window(Vibration::FFT_SIZE);
+    std::vector<float> power(Vibration::NUM_BINS);
+    for (size_t n = 0; n < Vibration::FFT_SIZE; n++) {
+        input[n] = samples[n][0];
+        window[n] = 0.5f - 0.5f * std::cos(2.0f * float(M_PI) * n / Vibration::FFT_SIZE);
+    }
+    constexpr size_t DFT_FRAMES = 64;
+    volatile float sink = 0.0f;
+    start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < DFT_FRAMES; frame++) {
+        for (size_t axis = 0; axis < Vibration::NUM_AXES; axis++) {
+            input[frame % Vibration::FFT_SIZE] += 1.0f;
+            referenceDft(input, window, power);
+            sink = sink + power[15];
+        }
+    }
+    double dftUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / DFT_FRAMES;
+
+    std::printf("%-24s %8.2f us/frame\n", "FFT (3 axes)", fftUs);
+    std::printf("%-24s %8.2f us/frame\n", "Direct DFT (3 axes)", dftUs);
+    RecordProperty("fftUs", std::to_string(fftUs));
+    RecordProperty("dftUs", std::to_string(dftUs));
+    EXPECT_LT(fftUs, dftUs);
+}
+
+TEST(VibrationBenchmark, FindPeaks) {
+    static Vibration vibration(SAMPLE_RATE);
+    for (size_t n = 0; n < Vibration::FFT_SIZE * 4; n++) {
+        int16_t s = int16_t(1000.0f * std::sin(2.0f * float(M_PI) * 100.3f * n / SAMPLE_RATE));
+        vibration.push({s, 0, 0});
+    }
+
+    constexpr size_t ITERATIONS = 1 << 16;
+    volatile float sink = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ITERATIONS; i++)
+        sink = sink + vibration.findPeaks(25.0f + float(i % 64))[0].amplitude;
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+    std::printf("%-24s %8.2f ns/call\n", "findPeaks", ns);
+    RecordProperty("findPeaksNs", std::to_string(ns));
+}
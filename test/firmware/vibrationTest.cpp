@@ -0,0 +1,157 @@
+//--------------------------------------------------
+// BLDC Motor Controller
+// vibrationTest.cpp
+// Date: 2026-10-19
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include <cmath>
+#include <drivers/imu/vibration.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+constexpr float SAMPLE_RATE = 1666.0f; // Imu::FIFO_RATE
+constexpr float GRAVITY = 16393.0f;    // 1 g at 0.061 mg/LSB
+constexpr size_t FRAMES = 16;
+
+// Tolerances of the interpolated peaks for a single tone anywhere between two bins
+constexpr float FREQUENCY_TOLERANCE = 0.02f; // Bins
+constexpr float AMPLITUDE_TOLERANCE = 0.01f; // Relative
+
+struct Tone {
+    size_t axis;
+    float frequency; // Hz
+    float amplitude; // LSB
+};
+
+// Push samples of the sum of the tones, on top of gravity on Z
+void push(Vibration& vibration, const std::vector<Tone>& tones, size_t samples, size_t start = 0) {
+    for (size_t n = start; n < start + samples; n++) {
+        std::array<float, 3> acc = {0.0f, 0.0f, GRAVITY};
+        for (const Tone& tone : tones)
+            acc[tone.axis] += tone.amplitude * std::sin(2.0 * M_PI * tone.frequency * n / SAMPLE_RATE + 0.3 * tone.axis);
+        vibration.push({int16_t(std::lround(acc[0])), int16_t(std::lround(acc[1])), int16_t(std::lround(acc[2]))});
+    }
+}
+
+// Samples until the given number of frames is averaged
+size_t samplesFor(size_t frames) { return Vibration::FFT_SIZE + (frames - 1) * Vibration::HOP_SIZE; }
+
+} // namespace
+
+TEST(Vibration, FrameCadence) {
+    Vibration vibration(SAMPLE_RATE);
+    size_t frames = 0;
+    for (size_t n = 1; n <= samplesFor(4); n++) {
+        bool frame = vibration.push({0, 0, 0});
+        EXPECT_EQ(frame, n >= Vibration::FFT_SIZE && (n - Vibration::FFT_SIZE) % Vibration::HOP_SIZE == 0) << "sample " << n;
+        frames += frame;
+    }
+    EXPECT_EQ(frames, 4u);
+    EXPECT_EQ(vibration.getFrames(), 4u);
+    EXPECT_FLOAT_EQ(vibration.getBinWidth(), SAMPLE_RATE / Vibration::FFT_SIZE);
+
+    vibration.reset();
+    EXPECT_EQ(vibration.getFrames(), 0u);
+    EXPECT_FLOAT_EQ(vibration.getAmplitude(0, 1), 0.0f);
+}
+
+TEST(Vibration, BinCenteredTone) {
+    Vibration vibration(SAMPLE_RATE);
+    float binWidth = vibration.getBinWidth();
+    push(vibration, {{0, 20 * binWidth, 1000.0f}}, samplesFor(FRAMES));
+
+    EXPECT_NEAR(vibration.getAmplitude(0, 20), 1000.0f, 1000.0f * AMPLITUDE_TOLERANCE);
+    EXPECT_NEAR(vibration.getAmplitude(0, 19), 500.0f, 1000.0f * AMPLITUDE_TOLERANCE); // Hann main lobe
+    EXPECT_LT(vibration.getAmplitude(0, 23), 1.0f);
+    EXPECT_LT(vibration.getAmplitude(1, 20), 1.0f);
+    EXPECT_NEAR(vibration.getAmplitude(Vibration::NUM_AXES, 20), 1000.0f, 1000.0f * AMPLITUDE_TOLERANCE);
+}
+
+TEST(Vibration, GravityRemoved) {
+    Vibration vibration(SAMPLE_RATE);
+    push(vibration, {}, samplesFor(FRAMES));
+    for (size_t bin = 0; bin < Vibration::NUM_BINS; bin++)
+        EXPECT_LT(vibration.getAmplitude(Vibration::NUM_AXES, bin), 0.5f) << "bin " << bin;
+}
+
+TEST(Vibration, PeakAccuracy) {
+    // Tones swept across one bin, at low and high frequency and on each axis
+    Vibration vibration(SAMPLE_RATE);
+    float binWidth = vibration.getBinWidth();
+    for (float base : {100.3f, 15.0f * binWidth, 410.0f, 700.0f}) {
+        for (float offset = 0.0f; offset < 1.0f; offset += 0.125f) {
+            float frequency = base + offset * binWidth;
+            size_t axis = size_t(offset * 8) % Vibration::NUM_AXES;
+            vibration.reset();
+            push(vibration, {{axis, frequency, 2000.0f}}, samplesFor(FRAMES));
+
+            Vibration::Peak peak = vibration.findPeaks(frequency)[0];
+            EXPECT_NEAR(peak.frequency, frequency, FREQUENCY_TOLERANCE * binWidth) << frequency << " Hz";
+            EXPECT_NEAR(peak.amplitude, 2000.0f, 2000.0f * AMPLITUDE_TOLERANCE) << frequency << " Hz";
+        }
+    }
+}
+
+TEST(Vibration, Harmonics) {
+    // Rotor at 37 Hz, harmonics on different axes, the search absorbs a rotor speed error of one bin
+    Vibration vibration(SAMPLE_RATE);
+    float rotor = 37.0f;
+    std::vector<Tone> tones = {{0, rotor, 800.0f}, {1, 2 * rotor, 400.0f}, {2, 3 * rotor, 1200.0f}, {0, 4 * rotor, 100.0f}, {1, 4 * rotor, 100.0f}};
+    push(vibration, tones, samplesFor(FRAMES));
+
+    std::array<Vibration::Peak, Vibration::NUM_HARMONICS> peaks = vibration.findPeaks(rotor + 1.5f);
+    const float amplitudes[] = {800.0f, 400.0f, 1200.0f, 100.0f * std::sqrt(2.0f)};
+    for (size_t h = 0; h < Vibration::NUM_HARMONICS; h++) {
+        EXPECT_NEAR(peaks[h].frequency, (h + 1) * rotor, 0.05f * vibration.getBinWidth()) << "harmonic " << h + 1;
+        EXPECT_NEAR(peaks[h].amplitude, amplitudes[h], amplitudes[h] * 0.02f) << "harmonic " << h + 1;
+    }
+}
+
+TEST(Vibration, HarmonicsAboveNyquist) {
+    Vibration vibration(SAMPLE_RATE);
+    float rotor = 300.0f;
+    push(vibration, {{0, rotor, 1000.0f}, {0, 2 * rotor, 1000.0f}}, samplesFor(FRAMES));
+
+    std::array<Vibration::Peak, Vibration::NUM_HARMONICS> peaks = vibration.findPeaks(rotor);
+    EXPECT_NEAR(peaks[0].frequency, rotor, FREQUENCY_TOLERANCE * vibration.getBinWidth());
+    EXPECT_NEAR(peaks[1].frequency, 2 * rotor, FREQUENCY_TOLERANCE * vibration.getBinWidth());
+    EXPECT_EQ(peaks[2].frequency, 0.0f); // 900 Hz is above fs/2
+    EXPECT_EQ(peaks[2].amplitude, 0.0f);
+    EXPECT_EQ(peaks[3].frequency, 0.0f);
+
+    // No rotor speed or no frame yet
+    EXPECT_EQ(vibration.findPeaks(0.0f)[0].frequency, 0.0f);
+    vibration.reset();
+    EXPECT_EQ(vibration.findPeaks(rotor)[0].frequency, 0.0f);
+}
+
+TEST(Vibration, RunningAverage) {
+    // Amplitude converges to the new tone with the running average coefficient
+    Vibration vibration(SAMPLE_RATE, 0.5f);
+    float frequency = 30 * vibration.getBinWidth();
+    push(vibration, {{0, frequency, 1000.0f}}, samplesFor(4));
+    EXPECT_NEAR(vibration.getAmplitude(0, 30), 1000.0f, 10.0f);
+
+    // Two frames after the amplitude change (first one overlaps both amplitudes)
+    push(vibration, {{0, frequency, 2000.0f}}, 3 * Vibration::HOP_SIZE, samplesFor(4));
+    EXPECT_GT(vibration.getAmplitude(0, 30), 1500.0f);
+    EXPECT_LT(vibration.getAmplitude(0, 30), 2000.0f);
+}
+
+TEST(Vibration, Compress) {
+    Vibration vibration(SAMPLE_RATE);
+    float binWidth = vibration.getBinWidth();
+    push(vibration, {{0, 40 * binWidth, 1000.0f}, {1, 80 * binWidth, 250.0f}}, samplesFor(FRAMES));
+
+    constexpr size_t SIZE = Vibration::NUM_BINS / 4;
+    std::array<uint16_t, SIZE> spectrum{};
+    float lsb = vibration.compress(spectrum.data(), SIZE);
+    EXPECT_NEAR(lsb, 1000.0f / UINT16_MAX, 0.01f * 1000.0f / UINT16_MAX);
+    EXPECT_EQ(spectrum[10], UINT16_MAX); // Bins 40-43
+    EXPECT_NEAR(spectrum[20] * lsb, 250.0f, 2.5f);
+    EXPECT_LT(spectrum[30] * lsb, 1.0f);
+
+    EXPECT_EQ(vibration.compress(spectrum.data(), 3), 0.0f); // Does not divide the bins
+}
@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+#--------------------------------------------------
+# BLDC Motor Controller
+# swoTraceTest.py
+# Date: 2026-10-19
+# By Breno Cunha Queiroz
+#--------------------------------------------------
+"""Tests of the SWO trace decoder (tools/swoTrace.py)
+
+trace.swo is a synthesized capture, regenerate it with `./swoTraceTest.py --write-fixture`. Cycles of its events:
+    sync packet, log text "ok\\n"
+    ISR_LOOP        begin 1000, end 1500
+    MOTOR_MODULATE  stamp 5000, preempted before the write by
+    ISR_SPI3        begin 5100, end 5300
+    MOTOR_MODULATE  begin 5000 (written late), end 5800
+    local timestamp packet
+    SPI_LATENCY     value 1234 at 6000, value -5 at 6100
+    ISR_LOOP        begin 11000, end 11600
+    ISR_LOOP        begin 21000, end 21400
+    MOTOR_MODULATE  begin 22000
+    overflow packet (the open span is lost)
+    MOTOR_MODULATE  end 22500 (unmatched)
+    ISR_LOOP        begin 31000, end 31300
+"""
+import os
+import sys
+import unittest
+
+TOOLS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "tools")
+sys.path.insert(0, TOOLS_DIR)
+import swoTrace  # noqa: E402
+
+FIXTURE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "trace.swo")
+CLOCK = 144e6
+
+NAMES = swoTrace.readIdNames(swoTrace.DEFAULT_HEADER)
+IDS = {name: id for id, name in NAMES.items()}
+LOOP = IDS["ISR_LOOP"]
+SPI3 = IDS["ISR_SPI3"]
+MODULATE = IDS["MOTOR_MODULATE"]
+LATENCY = IDS["SPI_LATENCY"]
+
+
+#---------- ITM stream ----------#
+def stimulus(port, value, size=4):
+    code = {1: 1, 2: 2, 4: 3}[size]
+    return bytes([(port << 3) | code]) + (value & ((1 << (8 * size)) - 1)).to_bytes(size, "little")
+
+
+def event(port, id, cycles):
+    return stimulus(port, (id << swoTrace.STAMP_BITS) | (cycles & swoTrace.STAMP_MASK))
+
+
+def begin(id, cycles):
+    return event(swoTrace.PORT_BEGIN, id, cycles)
+
+
+def end(id, cycles):
+    return event(swoTrace.PORT_END, id, cycles)
+
+
+def value(id, cycles, sample):
+    return event(swoTrace.PORT_VALUE, id, cycles) + stimulus(swoTrace.PORT_VALUE_DATA, sample)
+
+
+def log(text):
+    return b"".join(stimulus(swoTrace.PORT_LOG, c, 1) for c in text.encode())
+
+
+SYNC = bytes([0x00] * 5 + [0x80])
+OVERFLOW = bytes([0x70])
+LOCAL_TIMESTAMP = bytes([0xC0, 0x85, 0x03])
+
+
+def fixture():
+    return b"".join([
+        SYNC,
+        log("ok\n"),
+        begin(LOOP, 1000), end(LOOP, 1500),
+        begin(SPI3, 5100), end(SPI3, 5300),
+        begin(MODULATE, 5000), end(MODULATE, 5800),
+        LOCAL_TIMESTAMP,
+        value(LATENCY, 6000, 1234), value(LATENCY, 6100, -5),
+        begin(LOOP, 11000), end(LOOP, 11600),
+        begin(LOOP, 21000), end(LOOP, 21400),
+        begin(MODULATE, 22000),
+        OVERFLOW,
+        end(MODULATE, 22500),
+        begin(LOOP, 31000), end(LOOP, 31300),
+    ])
+
+
+def decode(data):
+    decoder = swoTrace.Decoder(CLOCK, NAMES)
+    decoder.decode(data)
+    return decoder
+
+
+#---------- Tests ----------#
+class FixtureTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        with open(FIXTURE, "rb") as f:
+            cls.decoder = decode(f.read())
+
+    def testSpans(self):
+        loop = self.decoder.durations[LOOP]
+        self.assertEqual(loop.count, 4)
+        self.assertEqual((loop.min, loop.max, loop.mean()), (300, 600, 450))
+        self.assertEqual(loop.buckets, {9: 3, 10: 1})  # [256, 512) and [512, 1024)
+        self.assertEqual(self.decoder.durations[SPI3].min, 200)
+
+    def testPeriods(self):
+        # Off by a full wrap (2^24 cycles) if the late MOTOR_MODULATE stamp is unwrapped forward
+        periods = self.decoder.periods[LOOP]
+        self.assertEqual(periods.count, 3)
+        self.assertEqual((periods.min, periods.max), (10000, 10000))
+
+    def testPreemptedSpan(self):
+        modulate = self.decoder.durations[MODULATE]
+        self.assertEqual(modulate.count, 1)  # The second span was lost in the overflow
+        self.assertEqual(modulate.min, 800)
+
+    def testValues(self):
+        values = self.decoder.values[LATENCY]
+        self.assertEqual((values.count, values.min, values.max), (2, 5, 1234))
+        counters = [e["args"]["value"] for e in self.decoder.events if e["ph"] == "C"]
+        self.assertEqual(counters, [1234, -5])
+
+    def testOverflow(self):
+        self.assertEqual(self.decoder.overflows, 1)
+        self.assertEqual(self.decoder.unmatched, 1)
+
+    def testLog(self):
+        self.assertEqual("".join(self.decoder.text), "ok\n")
+
+    def testChromeTrace(self):
+        trace = self.decoder.chromeTrace()
+        spans = [e for e in trace["traceEvents"] if e["ph"] == "X"]
+        self.assertEqual(len(spans), 6)
+        first = spans[0]
+        self.assertEqual(first["name"], "ISR_LOOP")
+        self.assertAlmostEqual(first["dur"], 500 * 1e6 / CLOCK)
+
+
+class UnwrapTest(unittest.TestCase):
+    def testFixtureIsUpToDate(self):
+        with open(FIXTURE, "rb") as f:
+            self.assertEqual(f.read(), fixture())
+
+    def testCounterWrap(self):
+        start = swoTrace.STAMP_MASK - 100
+        decoder = decode(begin(LOOP, start) + end(LOOP, start + 400) + begin(LOOP, start + 1000))
+        self.assertEqual(decoder.durations[LOOP].min, 400)
+        self.assertEqual(decoder.periods[LOOP].min, 1000)
+
+    def testOutOfOrderStamp(self):
+        # Stamp read before an interrupt that wrote its events first, then written
+        decoder = decode(begin(SPI3, 2000) + end(SPI3, 2100) + begin(MODULATE, 1900) + end(MODULATE, 2500))
+        self.assertEqual(decoder.durations[SPI3].min, 100)
+        self.assertEqual(decoder.durations[MODULATE].min, 600)
+        self.assertEqual(decoder.time, 500)  # Cycles since the first event
+
+    def testLongestForwardStep(self):
+        step = (1 << (swoTrace.STAMP_BITS - 1)) - 1
+        decoder = decode(begin(LOOP, 0) + end(LOOP, step))
+        self.assertEqual(decoder.durations[LOOP].min, step)
+
+
+if __name__ == "__main__":
+    if "--write-fixture" in sys.argv:
+        with open(FIXTURE, "wb") as f:
+            f.write(fixture())
+        print(f"Fixture written to {FIXTURE}")
+    else:
+        unittest.main()
@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+#--------------------------------------------------
+# BLDC Motor Controller
+# swoTrace.py
+# Date: 2026-10-19
+# By Breno Cunha Queiroz
+#--------------------------------------------------
+"""Decode a raw SWO capture of the firmware trace (firmware/src/utils/trace.h)
+
+Reads the ITM byte stream recorded by `./bldc.sh --record` and:
+  - exports the spans and value samples as Chrome trace JSON (chrome://tracing or https://ui.perfetto.dev)
+  - prints duration, period and value histograms (log2 buckets) of each event id
+  - optionally prints the log text sent on stimulus port 0
+
+Only the capture file is needed, so it runs on any host without the board.
+
+Example: ./tools/swoTrace.py firmware/build/trace.swo -o trace.json
+"""
+import argparse
+import json
+import os
+import re
+import sys
+
+PORT_LOG = 0
+PORT_BEGIN = 1
+PORT_END = 2
+PORT_VALUE = 3
+PORT_VALUE_DATA = 4
+
+STAMP_BITS = 24
+STAMP_MASK = (1 << STAMP_BITS) - 1
+STAMP_HALF = 1 << (STAMP_BITS - 1)
+
+DEFAULT_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "firmware", "src", "utils", "trace.h")
+
+
+def readIdNames(header):
+    """Event id names from the Trace::Id enum"""
+    names = {}
+    if not os.path.exists(header):
+        return names
+    with open(header) as f:
+        text = f.read()
+    match = re.search(r"enum Id\s*:\s*\w+\s*\{(.*?)\};", text, re.S)
+    if not match:
+        return names
+    value = 0
+    for line in match.group(1).splitlines():
+        line = line.split("//")[0].strip().rstrip(",")
+        if not line:
+            continue
+        entry = re.match(r"(\w+)(?:\s*=\s*(\d+))?$", line)
+        if not entry:
+            continue
+        if entry.group(2) is not None:
+            value = int(entry.group(2))
+        names[value] = entry.group(1)
+        value += 1
+    return names
+
+
+def parseItm(data):
+    """ITM packets of the byte stream
+
+    Yields ("stimulus", port, value, size) for software source packets and ("overflow",) for overflow packets.
+    Synchronization, timestamp, extension and hardware source (DWT) packets are skipped
+    """
+    i = 0
+    n = len(data)
+    while i < n:
+        header = data[i]
+        i += 1
+        if header == 0x00:
+            # Synchronization: zeros followed by 0x80
+            while i < n and data[i] == 0x00:
+                i += 1
+            if i < n and data[i] == 0x80:
+                i += 1
+        elif header == 0x70:
+            yield ("overflow",)
+        elif header & 0x03:
+            # Source packet, 1, 2 or 4 payload bytes
+            size = {1: 1, 2: 2, 3: 4}[header & 0x03]
+            if i + size > n:
+                return
+            value = int.from_bytes(data[i : i + size], "little")
+            i += size
+            if not header & 0x04:
+                yield ("stimulus", header >> 3, value, size)
+        elif (header & 0x0F) == 0x00 or (header & 0x0B) == 0x08 or (header & 0xDF) == 0x94:
+            # Local timestamp, extension or global timestamp, continuation bytes while bit 7 is set
+            if header & 0x80:
+                while i < n and data[i] & 0x80:
+                    i += 1
+                i += 1
+        # Reserved headers are skipped
+
+
+class Histogram:
+    """Count, min, max, mean and log2 buckets of non-negative samples"""
+
+    def __init__(self):
+        self.count = 0
+        self.sum = 0
+        self.min = None
+        self.max = None
+        self.buckets = {}
+
+    def add(self, sample):
+        self.count += 1
+        self.sum += sample
+        self.min = sample if self.min is None else min(self.min, sample)
+        self.max = sample if self.max is None else max(self.max, sample)
+        bucket = max(int(sample), 0).bit_length()  # [2^(b-1), 2^b)
+        self.buckets[bucket] = self.buckets.get(bucket, 0) + 1
+
+    def mean(self):
+        return self.sum / self.count if self.count else 0.0
+
+    def format(self, unit, scale):
+        lines = [f"    count {self.count}, min {self.min * scale:.3f}{unit}, mean {self.mean() * scale:.3f}{unit}, "
+                 f"max {self.max * scale:.3f}{unit}"]
+        peak = max(self.buckets.values())
+        for bucket in sorted(self.buckets):
+            low = 0 if bucket == 0 else 1 << (bucket - 1)
+            high = 1 << bucket
+            count = self.buckets[bucket]
+            bar = "#" * max(1, round(40 * count / peak))
+            lines.append(f"    [{low * scale:10.3f}, {high * scale:10.3f}){unit} {count:8d} {bar}")
+        return "\n".join(lines)
+
+
+class Decoder:
+    def __init__(self, clock, names):
+        self.clock = clock
+        self.names = names
+        self.time = None       # Unwrapped cycles of the last event
+        self.lastStamp = None  # 24 bit stamp of the last event
+        self.open = {}         # Begin time of the open spans
+        self.lastBegin = {}    # Begin time of the previous span (period)
+        self.pendingValue = None
+        self.events = []
+        self.durations = {}
+        self.periods = {}
+        self.values = {}
+        self.overflows = 0
+        self.unmatched = 0
+        self.text = []
+
+    def name(self, id):
+        return self.names.get(id, f"ID_{id}")
+
+    def unwrap(self, stamp):
+        """Cycles since the first event
+
+        The stamp is read before the stimulus write, so a writer preempted in between sends its stamp after newer ones.
+        Deltas are signed 24 bit values, these out of order stamps step back in time instead of forward by a full wrap
+        """
+        if self.lastStamp is None:
+            self.time = 0
+        else:
+            delta = (stamp - self.lastStamp) & STAMP_MASK
+            if delta >= STAMP_HALF:
+                delta -= 1 << STAMP_BITS
+            self.time += delta
+        self.lastStamp = stamp
+        return self.time
+
+    def us(self, cycles):
+        return cycles * 1e6 / self.clock
+
+    def decode(self, data):
+        for packet in parseItm(data):
+            if packet[0] == "overflow":
+                # Lost writes, the pairing state can not be trusted anymore
+                self.overflows += 1
+                self.open.clear()
+                self.pendingValue = None
+                continue
+            _, port, value, size = packet
+            if port == PORT_LOG:
+                self.text.append(value.to_bytes(size, "little").decode("ascii", "replace"))
+                continue
+            if port == PORT_VALUE_DATA:
+                if self.pendingValue is not None:
+                    self.sample(*self.pendingValue, value - (1 << 32) if value & 0x80000000 else value)
+                self.pendingValue = None
+                continue
+            if size != 4 or port not in (PORT_BEGIN, PORT_END, PORT_VALUE):
+                continue
+
+            id = value >> STAMP_BITS
+            time = self.unwrap(value & STAMP_MASK)
+            if port == PORT_BEGIN:
+                self.begin(id, time)
+            elif port == PORT_END:
+                self.end(id, time)
+            else:
+                self.pendingValue = (id, time)
+
+    def begin(self, id, time):
+        if id in self.lastBegin:
+            self.periods.setdefault(id, Histogram()).add(time - self.lastBegin[id])
+        self.lastBegin[id] = time
+        self.open[id] = time
+
+    def end(self, id, time):
+        start = self.open.pop(id, None)
+        if start is None:
+            self.unmatched += 1
+            return
+        duration = time - start
+        self.durations.setdefault(id, Histogram()).add(duration)
+        # One track per id, spans of different ids are not always nested (transfers started and finished in ISRs)
+        self.events.append({"name": self.name(id), "ph": "X", "pid": 0, "tid": id, "ts": self.us(start),
+                            "dur": self.us(duration)})
+
+    def sample(self, id, time, value):
+        self.values.setdefault(id, Histogram()).add(abs(value))
+        self.events.append({"name": self.name(id), "ph": "C", "pid": 0, "ts": self.us(time),
+                            "args": {"value": value}})
+
+    def chromeTrace(self):
+        metadata = [{"name": "process_name", "ph": "M", "pid": 0, "args": {"name": "BLDC"}}]
+        ids = set(self.durations)
+        for id in sorted(ids):
+            metadata.append({"name": "thread_name", "ph": "M", "pid": 0, "tid": id, "args": {"name": self.name(id)}})
+            metadata.append({"name": "thread_sort_index", "ph": "M", "pid": 0, "tid": id, "args": {"sort_index": id}})
+        return {"traceEvents": metadata + self.events, "displayTimeUnit": "ns"}
+
+    def report(self):
+        scale = 1e6 / self.clock
+        out = []
+        for title, histograms, unit, factor in (("Duration", self.durations, "us", scale),
+                                                 ("Period", self.periods, "us", scale),
+                                                 ("Value (absolute)", self.values, "", 1)):
+            for id in sorted(histograms):
+                out.append(f"{title} of {self.name(id)}")
+                out.append(histograms[id].format(unit, factor))
+        out.append(f"Overflow packets: {self.overflows}, unmatched ends: {self.unmatched}")
+        return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a raw SWO capture of the firmware trace")
+    parser.add_argument("capture", help="Raw SWO byte stream")
+    parser.add_argument("-o", "--output", help="Chrome trace JSON file")
+    parser.add_argument("--clock", type=float, default=144e6, help="DWT cycle counter frequency in Hz (default 144e6)")
+    parser.add_argument("--header", default=DEFAULT_HEADER, help="trace.h with the event id names")
+    parser.add_argument("--log", action="store_true", help="Print the log text (stimulus port 0)")
+    args = parser.parse_args()
+
+    with open(args.capture, "rb") as f:
+        data = f.read()
+
+    decoder = Decoder(args.clock, readIdNames(args.header))
+    decoder.decode(data)
+
+    if args.log:
+        sys.stdout.write("".join(decoder.text))
+    print(decoder.report())
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(decoder.chromeTrace(), f)
+        print(f"Chrome trace written to {args.output} ({len(decoder.events)} events)")
+
+
+if __name__ == "__main__":
+    main()